@@ -1,21 +1,45 @@
 // assets/shaders/Line.glsl
+// 场景线缓冲：所有实体的边框线在同一个缓冲里，每个顶点带着所属实体的区间号 (Slot)
 
 #type vertex
 #version 450 core
 
 layout(location = 0) in vec3 a_Position;
 layout(location = 1) in int a_EdgeID;
+layout(location = 2) in int a_Slot;
+
+struct EdgeRange
+{
+    mat4 Transform;
+    vec4 Color;
+    int EntityID;
+    int SelectedEdgeID;
+    int _pad0;
+    int _pad1;
+};
+
+layout(std430, binding = 11) readonly buffer EdgeRanges
+{
+    EdgeRange Ranges[];
+};
 
 uniform mat4 u_ViewProjection;
-uniform mat4 u_Transform;
 
 // 传给片元着色器 (flat 表示不插值，保证整数传递准确)
 flat out int v_EdgeID;
+flat out int v_EntityID;
+flat out int v_SelectedEdgeID;
+flat out vec4 v_Color;
 
 void main()
 {
+    EdgeRange range = Ranges[a_Slot];
+
     v_EdgeID = a_EdgeID;
-    gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+    v_EntityID = range.EntityID;
+    v_SelectedEdgeID = range.SelectedEdgeID;
+    v_Color = range.Color;
+    gl_Position = u_ViewProjection * range.Transform * vec4(a_Position, 1.0);
 }
 
 #type fragment
@@ -24,27 +48,26 @@ void main()
 layout(location = 0) out vec4 color;
 layout(location = 1) out ivec4 idOutput; // 输出到实体 ID 纹理
 
-uniform vec4 u_Color;        // 默认颜色 (黑色)
-uniform int u_EntityID;      // 当前画的物体 ID
-uniform int u_SelectedEdgeID;// 当前选中的边 ID (用于高亮)
-
 uniform int u_HoveredEntityID;
 uniform int u_HoveredEdgeID;
 
 flat in int v_EdgeID;
+flat in int v_EntityID;      // 当前画的物体 ID
+flat in int v_SelectedEdgeID;// 当前选中的边 ID (用于高亮)
+flat in vec4 v_Color;        // 默认颜色
 
 void main()
 {
 // 1. 颜色逻辑
-    vec4 finalColor = u_Color;
+    vec4 finalColor = v_Color;
 
     // 1. 选中高亮 (橙色)
-    if (u_SelectedEdgeID != -1 && v_EdgeID == u_SelectedEdgeID)
+    if (v_SelectedEdgeID != -1 && v_EdgeID == v_SelectedEdgeID)
     {
-        finalColor = vec4(1.0, 0.6, 0.0, 1.0); 
+        finalColor = vec4(1.0, 0.6, 0.0, 1.0);
     }
     // 2. 悬停高亮 (青色/亮白) - 仅当未被选中时
-    else if (u_HoveredEntityID == u_EntityID && u_HoveredEdgeID != -1 && v_EdgeID == u_HoveredEdgeID)
+    else if (u_HoveredEntityID == v_EntityID && u_HoveredEdgeID != -1 && v_EdgeID == u_HoveredEdgeID)
     {
         finalColor = vec4(0.5, 0.8, 1.0, 1.0); // 悬停：青色
     }
@@ -54,6 +77,5 @@ void main()
     // 2. 拾取逻辑
     // 写入 (物体ID, 边ID)
     // 这样鼠标读到这里时，就知道是哪个物体的哪条边
-    idOutput = ivec4(u_EntityID, -1, v_EdgeID, -1);
-    //idOutput = ivec4(-1);
-}
\ No newline at end of file
+    idOutput = ivec4(v_EntityID, -1, v_EdgeID, -1);
+}
@@ -25,10 +25,12 @@ struct GPUVertex {
     vec2 TexCoord; vec2 _pad3;
 };
 
+// 与 C++ GPUBVHNode 一致 (节点格式版本 2：整数子节点索引，叶子标记与数量打包)
 struct BVHNode {
-    vec4 Data1; // Min, Left
-    vec4 Data2; // Max, Right
+    vec3 Min; uint LeftFirst;    // 内部节点: 左子节点; 叶子: 第一个三角形在索引表中的位置
+    vec3 Max; uint RightOrCount; // 内部节点: 右子节点; 叶子: BVH_LEAF_FLAG | 三角形数量
 };
+const uint BVH_LEAF_FLAG = 0x80000000u;
 
 struct OctreeNode {
     vec3 Center;  float Size;
@@ -36,6 +38,12 @@ struct OctreeNode {
     float TriStart; float TriCount; float _pad1; float _pad2;
 };
 
+// 两层结构的实例 (与 C++ GPUInstance 一致)
+struct InstanceData {
+    mat4 InverseTransform; // 世界 -> 局部
+    uvec4 Info;            // x=BLAS 根节点, y=三角形偏移, z=三角形数量
+};
+
 struct TriangleData {
     uint v0, v1, v2;
     uint MaterialID;
@@ -62,6 +70,8 @@ layout(std430, binding = 3) readonly buffer MaterialsBuffer { GPUMaterial Materi
 layout(std430, binding = 6) readonly buffer BVHBuffer { BVHNode BVHNodes[]; };
 layout(std430, binding = 7) readonly buffer OctreeBuffer { OctreeNode OctreeNodes[]; };
 layout(std430, binding = 8) readonly buffer IndexMapBuffer { uint GlobalIndices[]; };
+layout(std430, binding = 9) readonly buffer TLASBuffer { BVHNode TLASNodes[]; };
+layout(std430, binding = 10) readonly buffer InstanceBuffer { InstanceData Instances[]; };
 
 // ==================== Uniforms ====================
 uniform float u_Time;
@@ -69,7 +79,7 @@ uniform mat4 u_InverseProjection;
 uniform mat4 u_InverseView;
 uniform vec3 u_CameraPos;
 uniform int u_FrameIndex;
-uniform int u_AccelType; 
+uniform int u_AccelType; // 0=None, 1=BVH, 2=Octree, 3=TwoLevel
 
 // ==================== 辅助函数 ====================
 uint seed = 0;
@@ -147,16 +157,12 @@ void TraverseBVH(vec3 rayOrigin, vec3 rayDir, inout float closestT, inout int hi
     while (stackPtr > 0) {
         int nodeIdx = stack[--stackPtr];
         BVHNode node = BVHNodes[nodeIdx];
-        vec3 aabbMin = node.Data1.xyz;
-        float leftChild = node.Data1.w;
-        vec3 aabbMax = node.Data2.xyz;
-        float rightChild = node.Data2.w;
 
-        if (!IntersectAABB(rayOrigin, invDir, aabbMin, aabbMax, closestT)) continue;
+        if (!IntersectAABB(rayOrigin, invDir, node.Min, node.Max, closestT)) continue;
 
-        if (leftChild < 0.0) { 
-            int startIdx = int(-leftChild - 1.0);
-            int count = int(rightChild);
+        if ((node.RightOrCount & BVH_LEAF_FLAG) != 0u) { 
+            int startIdx = int(node.LeftFirst);
+            int count = int(node.RightOrCount & ~BVH_LEAF_FLAG);
             for (int i = 0; i < count; i++) {
                 int triIdx = int(GlobalIndices[startIdx + i]);
                 TriangleData tri = Triangles[triIdx];
@@ -164,19 +170,101 @@ void TraverseBVH(vec3 rayOrigin, vec3 rayDir, inout float closestT, inout int hi
                 if (t > 0.0 && t < closestT) { closestT = t; hitIndex = triIdx; }
             }
         } else {
-            stack[stackPtr++] = int(leftChild);
-            stack[stackPtr++] = int(rightChild);
+            stack[stackPtr++] = int(node.LeftFirst);
+            stack[stackPtr++] = int(node.RightOrCount);
+        }
+    }
+}
+
+// =========================================================
+// 两层结构遍历：世界空间走 TLAS，命中实例后把光线变换到局部空间走 BLAS
+// 局部方向不归一化，因此局部 t 与世界 t 相同；两层结构上传的是局部空间顶点，直接用局部光线求交
+// 只改变换时顶点不用重新上传，只更新 TLAS 和实例 (Binding 9/10)
+// =========================================================
+void TraverseBLAS(int rootIdx, vec3 localOrigin, vec3 localDir, inout float closestT, inout int hitIndex) {
+    vec3 invDir = 1.0 / localDir;
+    int stack[32];
+    int stackPtr = 0;
+    stack[stackPtr++] = rootIdx;
+
+    while (stackPtr > 0) {
+        BVHNode node = BVHNodes[stack[--stackPtr]];
+        if (!IntersectAABB(localOrigin, invDir, node.Min, node.Max, closestT)) continue;
+
+        if ((node.RightOrCount & BVH_LEAF_FLAG) != 0u) {
+            int startIdx = int(node.LeftFirst);
+            int count = int(node.RightOrCount & ~BVH_LEAF_FLAG);
+            for (int i = 0; i < count; i++) {
+                int triIdx = int(GlobalIndices[startIdx + i]);
+                TriangleData tri = Triangles[triIdx];
+                float t = HitTriangle(localOrigin, localDir, Vertices[tri.v0].Position, Vertices[tri.v1].Position, Vertices[tri.v2].Position);
+                if (t > 0.0 && t < closestT) { closestT = t; hitIndex = triIdx; }
+            }
+        } else {
+            stack[stackPtr++] = int(node.LeftFirst);
+            stack[stackPtr++] = int(node.RightOrCount);
+        }
+    }
+}
+
+// hitInstance 返回命中三角形所属的实例，着色时用它把局部法线变回世界空间
+void TraverseTwoLevel(vec3 rayOrigin, vec3 rayDir, inout float closestT, inout int hitIndex, inout int hitInstance) {
+    vec3 invDir = 1.0 / rayDir;
+    int stack[32];
+    int stackPtr = 0;
+    stack[stackPtr++] = 0;
+
+    while (stackPtr > 0) {
+        BVHNode node = TLASNodes[stack[--stackPtr]];
+        if (!IntersectAABB(rayOrigin, invDir, node.Min, node.Max, closestT)) continue;
+
+        if ((node.RightOrCount & BVH_LEAF_FLAG) != 0u) {
+            // 叶子：一个实例
+            InstanceData inst = Instances[node.LeftFirst];
+            vec3 localOrigin = (inst.InverseTransform * vec4(rayOrigin, 1.0)).xyz;
+            vec3 localDir = (inst.InverseTransform * vec4(rayDir, 0.0)).xyz;
+            int previousHit = hitIndex;
+            TraverseBLAS(int(inst.Info.x), localOrigin, localDir, closestT, hitIndex);
+            if (hitIndex != previousHit) hitInstance = int(node.LeftFirst);
+        } else {
+            stack[stackPtr++] = int(node.LeftFirst);
+            stack[stackPtr++] = int(node.RightOrCount);
         }
     }
 }
 
 void TraverseOctree(vec3 rayOrigin, vec3 rayDir, inout float closestT, inout int hitIndex) {
-    // 简化的占位，实际应与 Spectral 版本一致
-    uint numTriangles = Triangles.length();
-    for (uint i = 0; i < numTriangles; i++) {
-        TriangleData tri = Triangles[i];
-        float t = HitTriangle(rayOrigin, rayDir, Vertices[tri.v0].Position, Vertices[tri.v1].Position, Vertices[tri.v2].Position);
-        if (t > 0.0 && t < closestT) { closestT = t; hitIndex = int(i); }
+    // 每个内部节点最多压入 8 个子节点，深度上限 8 时栈最多 57 项
+    vec3 invDir = 1.0 / rayDir;
+    int stack[64];
+    int stackPtr = 0;
+    stack[stackPtr++] = 0;
+
+    while (stackPtr > 0) {
+        int nodeIdx = stack[--stackPtr];
+        OctreeNode node = OctreeNodes[nodeIdx];
+
+        // 检查八叉树节点包围盒 (Box = Center +/- Size)
+        vec3 bMin = node.Center - vec3(node.Size);
+        vec3 bMax = node.Center + vec3(node.Size);
+        if (!IntersectAABB(rayOrigin, invDir, bMin, bMax, closestT)) continue;
+
+        // 如果是叶子 (TriCount > 0)
+        if (node.TriCount > 0.0) {
+            int start = int(node.TriStart);
+            int count = int(node.TriCount);
+            for (int i = 0; i < count; i++) {
+                int triIdx = int(GlobalIndices[start + i]);
+                TriangleData tri = Triangles[triIdx];
+                float t = HitTriangle(rayOrigin, rayDir, Vertices[tri.v0].Position, Vertices[tri.v1].Position, Vertices[tri.v2].Position);
+                if (t > 0.0 && t < closestT) { closestT = t; hitIndex = triIdx; }
+            }
+        } else {
+            // 压入存在的子节点
+            for (int i = 0; i < 8; i++) {
+                if (node.Children[i] >= 0.0) stack[stackPtr++] = int(node.Children[i]);
+            }
+        }
     }
 }
 
@@ -202,9 +290,11 @@ void main()
     {
         float closestT = INFINITY;
         int hitIndex = -1;
+        int hitInstance = -1; // 只有两层结构会设置
 
         if (u_AccelType == 1) TraverseBVH(rayOrigin, rayDir, closestT, hitIndex);
         else if (u_AccelType == 2) TraverseOctree(rayOrigin, rayDir, closestT, hitIndex);
+        else if (u_AccelType == 3) TraverseTwoLevel(rayOrigin, rayDir, closestT, hitIndex, hitInstance);
         else {
             uint numTriangles = Triangles.length();
             for (uint i = 0; i < numTriangles; i++) {
@@ -231,6 +321,8 @@ void main()
         vec3 v1 = Vertices[tri.v1].Position;
         vec3 v2 = Vertices[tri.v2].Position;
         vec3 N = normalize(cross(v1 - v0, v2 - v0));
+        // 两层结构的顶点在实例局部空间，法线乘逆变换的转置回到世界空间
+        if (hitInstance >= 0) N = normalize(transpose(mat3(Instances[hitInstance].InverseTransform)) * N);
         bool frontFace = dot(rayDir, N) < 0.0;
         vec3 normal = frontFace ? N : -N;
 
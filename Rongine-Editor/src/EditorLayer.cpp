@@ -88,10 +88,14 @@ void EditorLayer::onAttach()
 	m_sceneHierarchyPanel.setSceneChangedCallback([this]() {
 		m_SceneChanged = true;
 	});
+
+	//后台网格任务
+	Rongine::MeshJobSystem::Init();
 }
 
 void EditorLayer::onDetach()
 {
+	Rongine::MeshJobSystem::Shutdown();
 	Rongine::Renderer3D::shutdown();
 }
 
@@ -113,6 +117,10 @@ void EditorLayer::onUpdate(Rongine::Timestep ts)
 	if (m_viewportFocused)
 		m_cameraContorller.onUpdate(ts);
 
+	// 后台完成的网格替换占位，场景几何变了需要重建加速结构
+	if (Rongine::MeshJobSystem::Update(m_activeScene.get()) > 0)
+		m_SceneChanged = true;
+
 
 	//////////////////////////////////////////////////////////////////////////////////////////
 	if (Rongine::Input::isKeyPressed(Rongine::Key::Q)) m_gizmoType = -1;
@@ -127,7 +135,7 @@ void EditorLayer::onUpdate(Rongine::Timestep ts)
 	bool cameraMoved = (s_LastViewProj != currentViewProj);
 	s_LastViewProj = currentViewProj;
 
-	bool reset = m_SceneChanged || cameraMoved;
+	bool reset = m_SceneChanged || m_TransformChanged || cameraMoved;
 	//////////////////////////////////////////////////////////////////////////////////////////
 	//草图交互逻辑
 	if (m_IsSketchMode && m_SketchPlaneEntity)
@@ -451,11 +459,24 @@ void EditorLayer::onUpdate(Rongine::Timestep ts)
 	// 光追渲染
 	if (m_ShowRayTracing)
 	{
-		if (m_SceneChanged)
+		// 拖拽 Gizmo 期间用 LBVH 快速重建，松手后再按设定的质量重建一次
+		bool interactiveBuild = m_GizmoEditing;
+		if (m_SceneChanged || m_TransformChanged)
 		{
-			Rongine::Renderer3D::UploadSceneDataToGPU(m_activeScene.get());
-			Rongine::Renderer3D::BuildAccelerationStructures(m_activeScene.get());
+			// 两层结构的顶点在局部空间，只改变换时只重建 TLAS 并上传实例数据
+			bool transformOnly = !m_SceneChanged && Rongine::Renderer3D::getAccelType() == Rongine::AccelType::TwoLevel;
+			if (!transformOnly)
+				Rongine::Renderer3D::UploadSceneDataToGPU(m_activeScene.get());
+			Rongine::Renderer3D::BuildAccelerationStructures(m_activeScene.get(),
+				interactiveBuild ? Rongine::BVHBuildQuality::LBVH : Rongine::Renderer3D::getBVHBuildQuality());
+			m_AccelBuiltInteractive = interactiveBuild;
 			m_SceneChanged = false;
+			m_TransformChanged = false;
+		}
+		else if (m_AccelBuiltInteractive && !interactiveBuild)
+		{
+			Rongine::Renderer3D::BuildAccelerationStructures(m_activeScene.get());
+			m_AccelBuiltInteractive = false;
 		}
 
 		Rongine::Renderer3D::RenderComputeFrame(m_cameraContorller.getCamera(),
@@ -816,6 +837,30 @@ void EditorLayer::onImGuiRender()
 	ImGui::Text("Renderer3D Stats:");
 	ImGui::Text("Draw Calls: %d", stats.DrawCalls);
 
+	auto meshCache = Rongine::CADMesher::GetMeshCacheStats();
+	ImGui::Text("Mesh Cache: %.1f%% Hit (Last %u/%u Faces), %u Entries, %llu Tris",
+		meshCache.GetHitRate() * 100.0f, meshCache.LastHits, meshCache.LastHits + meshCache.LastMisses,
+		meshCache.Entries, (unsigned long long)meshCache.CachedTriangles);
+	ImGui::Text("Pending Mesh Jobs: %u", Rongine::MeshJobSystem::GetPendingCount());
+	const auto& uploadStats = Rongine::MeshBuffer::getTotalStats();
+	ImGui::Text("Mesh Upload: %.1f / %.1f KB (%.1f%%), Faces Kept %u, Rewritten %u, Moved %u",
+		uploadStats.BytesUploaded / 1024.0, uploadStats.BytesFull / 1024.0,
+		uploadStats.BytesFull > 0 ? 100.0 * (double)uploadStats.BytesUploaded / (double)uploadStats.BytesFull : 100.0,
+		uploadStats.FacesKept, uploadStats.FacesRewritten, uploadStats.FacesMoved);
+
+	// 视距相关 LOD
+	ImGui::Checkbox("Mesh LOD", &m_LODSettings.Enabled);
+	ImGui::DragFloat("LOD Pixel Error", &m_LODSettings.MaxPixelError, 0.05f, 0.1f, 16.0f);
+	const auto& lodStats = Rongine::MeshLOD::GetStats();
+	ImGui::Text("LOD Tris: %llu / %llu (%.1f%%), L0 %u, L1 %u, L2 %u, L3 %u",
+		(unsigned long long)lodStats.DrawnTriangles, (unsigned long long)lodStats.FullTriangles,
+		lodStats.FullTriangles > 0 ? 100.0 * (double)lodStats.DrawnTriangles / (double)lodStats.FullTriangles : 100.0,
+		lodStats.LevelCounts[0], lodStats.LevelCounts[1], lodStats.LevelCounts[2], lodStats.LevelCounts[3]);
+
+	auto edgeStats = Rongine::Renderer3D::getEdgeBufferStats();
+	ImGui::Text("Edge Buffer: %u Entities, %u Verts, %u Indices, %u Rebuilds | Drawn %u -> %u Ranges",
+		edgeStats.Entities, edgeStats.Vertices, edgeStats.Indices, edgeStats.Rebuilds, edgeStats.SubmittedRanges, edgeStats.DrawRanges);
+
 	ImGui::Separator();
 	for (auto& result : m_profileResult)
 		if(result.name=="EditorLayer::OnUpdate")ImGui::Text("FPS: %.3f", 1000.0f/result.time);
@@ -851,18 +896,20 @@ void EditorLayer::onImGuiRender()
 
 	ImGui::Separator();
 	// 加速结构选择器
-	const char* accelItems[] = { "None (Brute Force)", "BVH (Bounding Volume)", "Octree (Spatial)" };
+	const char* accelItems[] = { "None (Brute Force)", "BVH (Bounding Volume)", "Octree (Spatial)", "Two-Level (BLAS + TLAS)" };
 	static int currentItem = 0; // 默认 None
 
 	// 同步初始状态
 	if (Rongine::Renderer3D::getAccelType() == Rongine::AccelType::BVH) currentItem = 1;
 	if (Rongine::Renderer3D::getAccelType() == Rongine::AccelType::Octree) currentItem = 2;
+	if (Rongine::Renderer3D::getAccelType() == Rongine::AccelType::TwoLevel) currentItem = 3;
 
 	if (ImGui::Combo("Acceleration Structure", &currentItem, accelItems, IM_ARRAYSIZE(accelItems)))
 	{
 		Rongine::AccelType type = Rongine::AccelType::None;
 		if (currentItem == 1) type = Rongine::AccelType::BVH;
 		if (currentItem == 2) type = Rongine::AccelType::Octree;
+		if (currentItem == 3) type = Rongine::AccelType::TwoLevel;
 
 		Rongine::Renderer3D::setAccelType(type);
 
@@ -871,10 +918,130 @@ void EditorLayer::onImGuiRender()
 		m_SceneChanged = true;
 	}
 
+	if (currentItem == 1 || currentItem == 3)
+	{
+		// BVH 构建策略 (两层结构中用于 BLAS)
+		const char* qualityItems[] = { "Midpoint (Fast Build)", "SAH (Fast Trace)", "LBVH (Morton, Fastest Build)" };
+		int quality = (int)Rongine::Renderer3D::getBVHBuildQuality();
+		if (ImGui::Combo("BVH Build", &quality, qualityItems, IM_ARRAYSIZE(qualityItems)))
+		{
+			Rongine::Renderer3D::setBVHBuildQuality((Rongine::BVHBuildQuality)quality);
+			Rongine::Renderer3D::BuildAccelerationStructures(m_activeScene.get());
+			m_SceneChanged = true;
+		}
+		bool parallelBuild = Rongine::Renderer3D::isBVHParallelBuild();
+		if (ImGui::Checkbox("Parallel Build", &parallelBuild))
+		{
+			Rongine::Renderer3D::setBVHParallelBuild(parallelBuild);
+			Rongine::Renderer3D::BuildAccelerationStructures(m_activeScene.get());
+		}
+		ImGui::Text("Build Time: %.2f ms", Rongine::Renderer3D::getBVHBuildTime());
+
+		if (currentItem == 1)
+		{
+			// 拓扑不变的编辑 (拖拽、缩放、控制点) 只更新包围盒
+			bool refit = Rongine::Renderer3D::isBVHRefitEnabled();
+			if (ImGui::Checkbox("Refit On Deform", &refit))
+				Rongine::Renderer3D::setBVHRefitEnabled(refit);
+
+			auto update = Rongine::Renderer3D::getBVHUpdateStats();
+			if (update.Refitted)
+				ImGui::Text("Last Update: Refit (SAH x%.2f, %u ranges, %.1f KB)", update.SAHGrowth, update.UploadRanges, update.UploadedBytes / 1024.0f);
+			else
+				ImGui::Text("Last Update: Full Build (%.1f KB)", update.UploadedBytes / 1024.0f);
+		}
+	}
+	else if (currentItem == 2)
+	{
+		// 八叉树参数：松开滑块后才重建，避免拖动时反复构建
+		Rongine::OctreeSettings octreeSettings = Rongine::Renderer3D::getOctreeSettings();
+		bool octreeChanged = false;
+		if (ImGui::SliderInt("Max Depth", &octreeSettings.MaxDepth, 1, Rongine::OctreeBuilder::MaxSupportedDepth))
+			Rongine::Renderer3D::setOctreeSettings(octreeSettings);
+		octreeChanged |= ImGui::IsItemDeactivatedAfterEdit();
+		if (ImGui::SliderInt("Max Leaf Size", &octreeSettings.MaxLeafSize, 1, 64))
+			Rongine::Renderer3D::setOctreeSettings(octreeSettings);
+		octreeChanged |= ImGui::IsItemDeactivatedAfterEdit();
+
+		if (octreeChanged)
+		{
+			Rongine::Renderer3D::BuildAccelerationStructures(m_activeScene.get());
+			m_SceneChanged = true;
+		}
+		ImGui::Text("Build Time: %.2f ms", Rongine::Renderer3D::getBVHBuildTime());
+	}
+
 	if (currentItem != 0)
 	{
 		ImGui::TextColored(ImVec4(0.5, 1, 0.5, 1), "Active Nodes: %d",
-			(currentItem == 1) ? Rongine::Renderer3D::getBVHNodeCount() : Rongine::Renderer3D::getOctreeNodeCount());
+			(currentItem == 2) ? Rongine::Renderer3D::getOctreeNodeCount() : Rongine::Renderer3D::getBVHNodeCount());
+	}
+
+	if (ImGui::Button("Run Accel Benchmark"))
+		Rongine::Renderer3D::BenchmarkAccelerationStructures(m_activeScene.get());
+
+	// 光追上传前焊接面与面交界处的重复顶点
+	bool weldRT = Rongine::Renderer3D::isRTVertexWelding();
+	if (ImGui::Checkbox("Weld RT Vertices", &weldRT))
+	{
+		Rongine::Renderer3D::setRTVertexWelding(weldRT);
+		m_SceneChanged = true;
+	}
+	auto rtUpload = Rongine::Renderer3D::getRTUploadStats();
+	ImGui::Text("RT Upload: %u -> %u Verts, %u Tris, %.1f B/Tri", rtUpload.SourceVertices, rtUpload.UploadedVertices, rtUpload.Triangles,
+		rtUpload.Triangles > 0 ? (double)rtUpload.UploadedBytes / (double)rtUpload.Triangles : 0.0);
+
+	// 自带示例资源与当前场景的网格显存占用 (字节/三角形)
+	if (ImGui::Button("Report Mesh Memory"))
+	{
+		Rongine::CADMesher::ReportMeshMemory("assets/models/mypage.stp");
+		Rongine::CADMesher::ReportMeshMemory("assets/models/j01.rong");
+		Rongine::CADMesher::ReportSceneMeshMemory(m_activeScene.get(), "Active Scene");
+	}
+
+	ImGui::Checkbox("Save Mesh Cache", &m_SaveMeshCache);
+
+	// 合成场景上对比 YAML 与二进制场景格式的保存/加载耗时和内存峰值
+	if (ImGui::Button("Run Scene Format Benchmark"))
+		Rongine::SceneSerializer::BenchmarkFormats(50000);
+
+	// 约 2 GB 的网格缓存，对比整体读入复制和内存映射的冷加载耗时与缺页次数
+	if (ImGui::Button("Run Mesh Cache Load Benchmark"))
+		Rongine::SceneMeshCache::BenchmarkLoad();
+
+	// 不创建 GL 资源的场景加载 (串行/并行对比)，检查结果一致并输出各阶段耗时
+	if (ImGui::Button("Run Headless Load Test"))
+		Rongine::SceneSerializer::TestHeadlessLoad(500);
+
+	// 局部上传自检：没变的网格不写显存，只改一个面时只写这个面的区间
+	if (ImGui::Button("Run Mesh Upload Self-Test"))
+		Rongine::MeshBuffer::SelfTest();
+
+	// 500 个零件的装配改动一个零件后保存：BRep 仓库对比原来每次都写全部 ASCII BRep
+	if (ImGui::Button("Run BRep Store Benchmark"))
+		Rongine::SceneSerializer::BenchmarkShapeStore(500);
+
+	// CPU 参考渲染 (与 Raytrace.glsl 相同的路径追踪)，用于在没有 GPU 的机器上对比结果
+	static int referenceSamples = 64;
+	ImGui::DragInt("Reference Samples", &referenceSamples, 1.0f, 1, 4096);
+	if (ImGui::Button("Render CPU Reference"))
+		m_SpectralRenderer->RenderToFile(*m_activeScene, m_cameraContorller.getCamera(),
+			(uint32_t)m_viewportSize.x, (uint32_t)m_viewportSize.y, (uint32_t)referenceSamples, "cpu_reference.pfm");
+
+	// 对选中的 CAD 物体测试离散化与并行提取的加速比
+	if (ImGui::Button("Run Meshing Benchmark") && m_selectedEntity && m_selectedEntity.HasComponent<Rongine::CADGeometryComponent>())
+	{
+		auto& cad = m_selectedEntity.GetComponent<Rongine::CADGeometryComponent>();
+		// 复制形状时后台任务不能同时往上面挂三角网格，网格还没生成完就先不测
+		if (Rongine::MeshJobSystem::IsPending(m_selectedEntity))
+		{
+			RONG_CLIENT_WARN("Meshing Benchmark: mesh job for the selected entity is still running, try again later");
+		}
+		else if (cad.ShapeHandle)
+		{
+			Rongine::CADMesher::BenchmarkMeshing(*static_cast<TopoDS_Shape*>(cad.ShapeHandle), cad.LinearDeflection);
+			Rongine::CADMesher::BenchmarkFilletRebuild(*static_cast<TopoDS_Shape*>(cad.ShapeHandle), cad.LinearDeflection, cad.FilletRadius);
+		}
 	}
 
 	ImGui::Separator();
@@ -1191,7 +1358,7 @@ void EditorLayer::onImGuiRender()
 
 				// 生成预览网格
 				auto& cadComp = m_selectedEntity.GetComponent<Rongine::CADGeometryComponent>();
-				void* previewShape = Rongine::CADFeature::ExtrudeFace(cadComp.ShapeHandle, m_selectedFace, m_ExtrudeHeight);
+				void* previewShape = Rongine::CADFeature::ExtrudeFace(Rongine::TopologyIndex::Get(cadComp), m_selectedFace, m_ExtrudeHeight);
 
 				if (previewShape)
 				{
@@ -1301,7 +1468,7 @@ void EditorLayer::onImGuiRender()
 				auto& cadComp = m_selectedEntity.GetComponent<Rongine::CADGeometryComponent>();
 
 				// 需要一个静态函数：MakeFilletShape(originalShape, edgeID, radius) -> newShape*
-				void* previewShape = Rongine::CADFeature::MakeFilletShape(cadComp.ShapeHandle, m_selectedEdge, m_FilletRadius);
+				void* previewShape = Rongine::CADFeature::MakeFilletShape(Rongine::TopologyIndex::Get(cadComp), m_selectedEdge, m_FilletRadius);
 
 				if (previewShape)
 				{
@@ -1404,12 +1571,9 @@ void EditorLayer::onImGuiRender()
 					TopoDS_Shape* shape = (TopoDS_Shape*)cadComp.ShapeHandle;
 					BRepTools::Clean(*shape);
 
-					std::vector<Rongine::LineVertex> lines;
-					mesh.m_IDToEdgeMap.clear();
-					mesh.EdgeVA = Rongine::CADMesher::CreateEdgeMeshFromShape(*shape, lines, mesh.m_IDToEdgeMap, cadComp.LinearDeflection);
-					mesh.LocalLines = lines;
+					Rongine::CADMesher::RebuildEdges(mesh, cadComp, cadComp.LinearDeflection);
 					mesh.VA = nullptr; // 曲线没有面
-					mesh.LocalVertices.clear();
+					mesh.SetGeometry({}, {});
 				}
 
 				m_SceneChanged = true;
@@ -1540,7 +1704,7 @@ void EditorLayer::onImGuiRender()
 				tc.Rotation = glm::eulerAngles(orientation);
 			}
 
-			m_SceneChanged = true;
+			m_TransformChanged = true;
 		}
 		else
 		{
@@ -1687,25 +1851,11 @@ void EditorLayer::ImportSTEP()
 
 		TopoDS_Shape shape = Rongine::CADImporter::ImportSTEP(filepath);
 
-		std::vector<Rongine::CubeVertex> verticesData;
-		std::vector<uint32_t> indices;
-		auto cadMeshVA = Rongine::CADMesher::CreateMeshFromShape(shape, verticesData, indices);
-
-		if (cadMeshVA) {
+		if (!shape.IsNull()) {
 			auto cadEntity = m_activeScene->createEntity("Imported CAD");
-			auto& tc = cadEntity.GetComponent<Rongine::TransformComponent>();
-
-			auto& meshComp = cadEntity.AddComponent<Rongine::MeshComponent>(cadMeshVA, verticesData);
 
-			// ==================== 生成边框线 ====================
-			std::vector<Rongine::LineVertex> lineVerts;
-			auto edgeVA = Rongine::CADMesher::CreateEdgeMeshFromShape(shape, lineVerts, meshComp.m_IDToEdgeMap, 0.1f);
-			meshComp.EdgeVA = edgeVA;
-			meshComp.LocalLines = lineVerts;
-			meshComp.LocalIndices = indices;
-			// ===========================================================
-
-			meshComp.BoundingBox = Rongine::CADImporter::CalculateAABB(shape);
+			// 网格交给后台任务，先显示包围盒占位 (大模型导入时界面不卡住)
+			Rongine::MeshJobSystem::Submit(cadEntity, shape, 0.1f);
 
 			m_SceneChanged = true;
 
@@ -1766,13 +1916,9 @@ void EditorLayer::CreatePrimitive(Rongine::CADGeometryComponent::GeometryType ty
 			// 创建 Mesh 组件，并存入 CPU 顶点数据 (这对 Gizmo 吸附很重要！)
 			auto& meshComp=entity.AddComponent<Rongine::MeshComponent>(va, verticesData);
 
-			std::vector<Rongine::LineVertex> lineVerts;
 			// 默认精度 0.1f
-			auto edgeVA = Rongine::CADMesher::CreateEdgeMeshFromShape(*occShape, lineVerts, meshComp.m_IDToEdgeMap, 0.1f);
-
-			meshComp.EdgeVA = edgeVA;
-			meshComp.LocalLines = lineVerts;
-			meshComp.LocalIndices = indices;
+			Rongine::CADMesher::RebuildEdges(meshComp, cadComp, 0.1f);
+			meshComp.SetIndices(std::move(indices));
 
 			// 计算包围盒
 			meshComp.BoundingBox = Rongine::CADImporter::CalculateAABB(*occShape);
@@ -1786,14 +1932,20 @@ void EditorLayer::CreatePrimitive(Rongine::CADGeometryComponent::GeometryType ty
 
 void EditorLayer::SaveSceneAs()
 {
-	// 打开保存文件对话框，过滤 .rong 文件
-	std::string filepath = Rongine::FileDialogs::SaveFile("Rongine Scene (*.rong)\0*.rong\0");
+	// 打开保存文件对话框：.rong 为 YAML (可读/交换用)，.rongb 为二进制 (加载更快)
+	std::string filepath = Rongine::FileDialogs::SaveFile("Rongine Scene (*.rong)\0*.rong\0Rongine Binary Scene (*.rongb)\0*.rongb\0");
 
 	if (!filepath.empty())
 	{
 		// 创建序列化器并保存当前场景
+		// 保存前会等后台网格任务完成并直接装进组件，下一帧的 MeshJobSystem::Update 就看不到了
+		bool meshesPending = Rongine::MeshJobSystem::GetPendingCount() > 0;
+
 		Rongine::SceneSerializer serializer(m_activeScene);
+		serializer.SetWriteMeshCache(m_SaveMeshCache);
 		serializer.Serialize(filepath);
+		if (meshesPending)
+			m_SceneChanged = true;
 
 		RONG_CLIENT_INFO("Scene saved to: {0}", filepath);
 	}
@@ -1802,11 +1954,12 @@ void EditorLayer::SaveSceneAs()
 void EditorLayer::OpenScene()
 {
 	// 打开文件对话框
-	std::string filepath = Rongine::FileDialogs::OpenFile("Rongine Scene (*.rong)\0*.rong\0");
+	std::string filepath = Rongine::FileDialogs::OpenFile("Rongine Scene (*.rong;*.rongb)\0*.rong;*.rongb\0");
 
 	if (!filepath.empty())
 	{
-		// 1. 创建一个新的空场景（把旧的扔掉）
+		// 1. 创建一个新的空场景（把旧的扔掉），旧场景还没完成的网格任务一并作废
+		Rongine::MeshJobSystem::CancelAll();
 		m_activeScene = Rongine::CreateRef<Rongine::Scene>();
 
 		// 2. 如果视口大小已知，调整新场景视口（防止画面拉伸）
@@ -1901,25 +2054,9 @@ void EditorLayer::OnBooleanOperation(Rongine::CADBoolean::Operation op)
 		resCad.Type = Rongine::CADGeometryComponent::GeometryType::Imported;
 		resCad.ShapeHandle = resultShapeHandle;
 
-		// 生成 Mesh
-		std::vector<Rongine::CubeVertex> vertices;
-		std::vector<uint32_t> indices;
-		auto va = Rongine::CADMesher::CreateMeshFromShape(*occShape, vertices,indices);
-
-		if (va)
+		// 生成 Mesh (后台任务，完成前显示包围盒占位)
+		if (Rongine::MeshJobSystem::Submit(resultEntity, *occShape, resCad.LinearDeflection))
 		{
-			auto& meshComp = resultEntity.AddComponent<Rongine::MeshComponent>(va, vertices);
-
-			// ==================== 生成边框线 ====================
-			std::vector<Rongine::LineVertex> lineVerts;
-			// 这里如果有 cadComp，最好用 cadComp.LinearDeflection，这里简化用 0.1f 或继承
-			auto edgeVA = Rongine::CADMesher::CreateEdgeMeshFromShape(*occShape, lineVerts, meshComp.m_IDToEdgeMap, 0.1f);
-			meshComp.EdgeVA = edgeVA;
-			meshComp.LocalLines = lineVerts;
-			meshComp.LocalIndices = indices;
-			// ===========================================================
-			meshComp.BoundingBox = Rongine::CADImporter::CalculateAABB(*occShape);
-
 			if (m_selectedEntity.HasComponent<Rongine::TagComponent>())
 				m_selectedEntity.GetComponent<Rongine::TagComponent>().Tag += " (Hidden)";
 			if (m_ToolEntity.HasComponent<Rongine::TagComponent>())
@@ -1955,7 +2092,7 @@ void EditorLayer::EnterExtrudeMode()
 	auto& tc = m_selectedEntity.GetComponent<Rongine::TransformComponent>();
 	auto& cadComp = m_selectedEntity.GetComponent<Rongine::CADGeometryComponent>();
 
-	glm::mat4 faceLocalMatrix = Rongine::CADFeature::GetFaceTransform(cadComp.ShapeHandle, m_selectedFace);
+	glm::mat4 faceLocalMatrix = Rongine::CADFeature::GetFaceTransform(Rongine::TopologyIndex::Get(cadComp), m_selectedFace);
 	glm::mat4 objectWorldMatrix = tc.GetTransform();
 
 	// 组合：Gizmo 世界矩阵 = 物体变换 * 面局部变换
@@ -1987,7 +2124,7 @@ void EditorLayer::ExitExtrudeMode(bool apply)
 		auto& currentCad = m_selectedEntity.GetComponent<Rongine::CADGeometryComponent>();
 
 		// 2. 生成拉伸体 (Tool Shape)
-		void* toolShapePtr = Rongine::CADFeature::ExtrudeFace(currentCad.ShapeHandle, m_selectedFace, m_ExtrudeHeight);
+		void* toolShapePtr = Rongine::CADFeature::ExtrudeFace(Rongine::TopologyIndex::Get(currentCad), m_selectedFace, m_ExtrudeHeight);
 
 		if (toolShapePtr)
 		{
@@ -2020,6 +2157,7 @@ void EditorLayer::ExitExtrudeMode(bool apply)
 				try
 				{
 					TopoDS_Shape resultShape;
+					Handle(BRepTools_History) history; // 基底形状 -> 结果，用来延续基底的面/边 ID
 					bool opSuccess = false;
 
 					// 注意：OpenCASCADE 的布尔运算要求形状在同一个坐标系下。
@@ -2028,12 +2166,12 @@ void EditorLayer::ExitExtrudeMode(bool apply)
 					if (m_ExtrudeHeight < 0.0f) // 挖孔 (Cut)
 					{
 						BRepAlgoAPI_Cut cut(*baseShape, *toolShape);
-						if (cut.IsDone()) { resultShape = cut.Shape(); opSuccess = true; }
+						if (cut.IsDone()) { resultShape = cut.Shape(); history = cut.History(); opSuccess = true; }
 					}
 					else // 凸起/融合 (Fuse)
 					{
 						BRepAlgoAPI_Fuse fuse(*baseShape, *toolShape);
-						if (fuse.IsDone()) { resultShape = fuse.Shape(); opSuccess = true; }
+						if (fuse.IsDone()) { resultShape = fuse.Shape(); history = fuse.History(); opSuccess = true; }
 					}
 
 					if (opSuccess)
@@ -2041,6 +2179,9 @@ void EditorLayer::ExitExtrudeMode(bool apply)
 						// 将结果应用到【目标物体】(即原来的立方体)，而不是草图
 						auto& targetCad = targetEntity.GetComponent<Rongine::CADGeometryComponent>();
 
+						// 旧形状的索引表 (替换形状之前取，之后按布尔历史延续 ID)
+						Rongine::TopologyIndex::Get(targetCad);
+
 						// 释放旧形状内存
 						if (targetCad.ShapeHandle) delete (TopoDS_Shape*)targetCad.ShapeHandle;
 
@@ -2048,6 +2189,10 @@ void EditorLayer::ExitExtrudeMode(bool apply)
 						targetCad.ShapeHandle = new TopoDS_Shape(resultShape);
 						targetCad.Type = Rongine::CADGeometryComponent::GeometryType::Imported;
 
+						Rongine::TopologyRemap remap = Rongine::TopologyIndex::Transfer(targetCad, history);
+						RONG_CLIENT_INFO("Topology Remap: {0} Faces Kept, {1} Modified, {2} Deleted, {3} Generated",
+							remap.KeptFaces, remap.ModifiedFaces, remap.DeletedFaces, remap.GeneratedFaces);
+
 						// 重建网格
 						Rongine::CADMesher::RebuildMesh(targetEntity);
 
@@ -2122,7 +2267,7 @@ void EditorLayer::EnterFilletMode()
 	auto& tc = m_selectedEntity.GetComponent<Rongine::TransformComponent>();
 	auto& cadComp = m_selectedEntity.GetComponent<Rongine::CADGeometryComponent>();
 
-	glm::mat4 edgeLocalMatrix = Rongine::CADFeature::GetEdgeTransform(cadComp.ShapeHandle, m_selectedEdge);
+	glm::mat4 edgeLocalMatrix = Rongine::CADFeature::GetEdgeTransform(Rongine::TopologyIndex::Get(cadComp), m_selectedEdge);
 	glm::mat4 objectWorldMatrix = tc.GetTransform();
 
 	// Gizmo 位于边的中心
@@ -2147,10 +2292,9 @@ void EditorLayer::EnterFilletMode()
 		//复制srcMesh，因为操作AddComponent后，内存池可能会满，会重新申请一片内存，释放原来的内存扩容
 		auto srcVA = srcMesh.VA;
 		auto srcVertices = srcMesh.LocalVertices;
-		auto srcEdgeVA = srcMesh.EdgeVA;
 		auto srcLines = srcMesh.LocalLines;
+		auto srcLineIndices = srcMesh.LocalLineIndices;
 		auto srcBoundingBox = srcMesh.BoundingBox;
-		auto srcIDMap = srcMesh.m_IDToEdgeMap;
 
 		if (m_PreviewEntity.HasComponent<Rongine::MeshComponent>())
 			m_PreviewEntity.RemoveComponent<Rongine::MeshComponent>();
@@ -2159,15 +2303,14 @@ void EditorLayer::EnterFilletMode()
 		auto& dstMesh = m_PreviewEntity.AddComponent<Rongine::MeshComponent>(srcMesh.VA, srcMesh.LocalVertices);
 
 
-		dstMesh.EdgeVA = srcEdgeVA;
-		dstMesh.LocalLines = srcLines;
+		dstMesh.SetEdges(std::move(srcLines), std::move(srcLineIndices));
 		dstMesh.BoundingBox = srcBoundingBox;
 	}
 
 	// 强制触发一次预览更新
 	// 因为设置了初始半径 0.2
 	{
-		void* previewShape = Rongine::CADFeature::MakeFilletShape(cadComp.ShapeHandle, m_selectedEdge, m_FilletRadius);
+		void* previewShape = Rongine::CADFeature::MakeFilletShape(Rongine::TopologyIndex::Get(cadComp), m_selectedEdge, m_FilletRadius);
 		RONG_CLIENT_INFO("MakeFilletShape");
 		if (previewShape)
 		{
@@ -2201,14 +2344,15 @@ void EditorLayer::ExitFilletMode(bool apply)
 		// 1. 创建 Undo 命令 (备份当前状态)
 		auto* cmd = new Rongine::CADModifyCommand(m_selectedEntity);
 		// B. 执行操作
-		Rongine::CADMesher::ApplyFillet(m_selectedEntity,m_FilletEdge,m_FilletRadius);
+		Rongine::TopologyRemap remap = Rongine::CADMesher::ApplyFillet(m_selectedEntity,m_FilletEdge,m_FilletRadius);
 
 		// C. 备份新状态并提交
 		cmd->CaptureNewState();
 		Rongine::CommandHistory::Push(cmd);
 
-		// D. 强制取消选择 (防止拓扑变动导致崩溃)
-		m_selectedEdge = -1;
+		// D. 按操作历史更新选择 (倒角的边本身被删除，会变成 -1；倒角失败时 Remap 为空，同样取消选择)
+		m_selectedEdge = remap.MapEdge(m_selectedEdge);
+		m_selectedFace = remap.MapFace(m_selectedFace);
 
 		m_SceneChanged = true;
 	}
@@ -2245,7 +2389,7 @@ void EditorLayer::EnterSketchMode()
 	gp_Ax3 sketchAx3;
 	glm::mat4 sketchMat;
 
-	if (Rongine::CADFeature::GetPlanarFaceCoordinateSystem(*(TopoDS_Shape*)cad.ShapeHandle, m_selectedFace, sketchAx3, sketchMat))
+	if (Rongine::CADFeature::GetPlanarFaceCoordinateSystem(Rongine::TopologyIndex::Get(cad), m_selectedFace, sketchAx3, sketchMat))
 	{
 		m_IsSketchMode = true;
 		m_SketchPlaneEntity = m_selectedEntity;
@@ -2350,6 +2494,8 @@ void EditorLayer::buildRenderGraph()
 
 			// 遍历并绘制所有 Mesh 实体
 			auto view = m_activeScene->getAllEntitiesWith<Rongine::TransformComponent, Rongine::MeshComponent>();
+			Rongine::MeshLOD::ResetStats();
+			Rongine::Renderer3D::beginEdges(m_activeScene.get());
 
 			for (auto entityHandle : view)
 			{
@@ -2358,7 +2504,7 @@ void EditorLayer::buildRenderGraph()
 
 				if (mesh.VA)
 				{
-					if (m_selectedEntity == entityHandle && mesh.EdgeVA)
+					if (m_selectedEntity == entityHandle && mesh.HasEdges())
 					{
 						Rongine::RenderCommand::setDepthTest(true);
 						// 通过 RenderCommand 设置 polygon offset 防止 Z-fighting
@@ -2368,21 +2514,28 @@ void EditorLayer::buildRenderGraph()
 						Rongine::Renderer3D::drawModel(mesh.VA, transform.GetTransform(), (int)entityHandle, mat);
 						glDisable(GL_POLYGON_OFFSET_FILL);
 
-						Rongine::Renderer3D::drawEdges(mesh.EdgeVA, transform.GetTransform(), { 0.0f, 0.0f, 0.0f, 1.0f }, (int)entityHandle, m_selectedEdge);
+						Rongine::Renderer3D::submitEdges(entityHandle, transform.GetTransform(), { 0.0f, 0.0f, 0.0f, 1.0f }, m_selectedEdge);
 						continue;
 					}
 
-					Rongine::Renderer3D::drawModel(mesh.VA, transform.GetTransform(), (int)entityHandle, mat);
+					// 未选中的实体按屏幕上的大小选 LOD (选中的实体要和边框线对齐，始终用 LOD0)
+					glm::mat4 model = transform.GetTransform();
+					auto va = Rongine::MeshLOD::Select({ entityHandle, m_activeScene.get() }, model,
+						m_cameraContorller.getCamera(), m_viewportSize.y, m_LODSettings);
+					Rongine::Renderer3D::drawModel(va, model, (int)entityHandle, mat);
 				}
-				else if (mesh.EdgeVA)
+				else if (mesh.HasEdges())
 				{
 					glm::vec4 edgeColor = (m_selectedEntity == entityHandle) ?
 						glm::vec4(1.0f, 0.5f, 0.0f, 1.0f) :
 						glm::vec4(0.2f, 0.8f, 1.0f, 1.0f);
 
-					Rongine::Renderer3D::drawEdges(mesh.EdgeVA, transform.GetTransform(), edgeColor, (int)entityHandle, m_selectedEdge);
+					Rongine::Renderer3D::submitEdges(entityHandle, transform.GetTransform(), edgeColor, m_selectedEdge);
 				}
 			}
+
+			// 所有实体的边框线一次画完
+			Rongine::Renderer3D::endEdges();
 		});
 	}
 
@@ -137,6 +137,11 @@ private:
 
 	//光追 computer shader
 	bool m_SceneChanged = true;
+	bool m_TransformChanged = false; // 只有实体变换变了 (拖拽 Gizmo)，两层结构不用重新上传顶点
+	bool m_AccelBuiltInteractive = false; // 加速结构是否是拖拽期间用 LBVH 临时构建的
+
+	Rongine::MeshLODSettings m_LODSettings; // GeometryPass 中按屏幕大小选择 CAD 网格的 LOD
+	bool m_SaveMeshCache = true; // 保存场景时附带网格缓存 (.rongmesh)，下次打开跳过离散化
 
 	//材质面板
 	Rongine::ContentBrowserPanel m_contentBrowserPanel;
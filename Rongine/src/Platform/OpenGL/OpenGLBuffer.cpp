@@ -1,5 +1,6 @@
 #include "Rongpch.h"
 #include "OpenGLBuffer.h"
+#include "Rongine/Core/Log.h"
 #include <glad/glad.h>
 
 namespace Rongine {
@@ -37,30 +38,43 @@ namespace Rongine {
 		glBindBuffer(GL_ARRAY_BUFFER,0);
 	}
 
-	void OpenGLVertexBuffer::setData(const void* data, uint32_t size)
+	void OpenGLVertexBuffer::setData(const void* data, uint32_t size, uint32_t offset)
 	{
+		if (size + offset > m_size)
+		{
+			RONG_CORE_ERROR("VertexBuffer overflow! Trying to set {0} bytes at offset {1}, but capacity is {2}", size, offset, m_size);
+			return;
+		}
 		glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
 	}
 
 	////////////////////////IndexBuffer/////////////////////////////
 
-	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t count)
-		:m_count(count)
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t count, uint32_t indexSize)
+		:m_count(count), m_capacity(count), m_indexSize(indexSize)
 	{
 		glCreateBuffers(1, &m_rendererID);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * indexSize, nullptr, GL_DYNAMIC_DRAW);
 	}
 
 	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count)
-		:m_count(count)
+		:m_count(count), m_capacity(count)
 	{
 		glCreateBuffers(1, &m_rendererID);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count*sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint16_t* indices, uint32_t count)
+		:m_count(count), m_capacity(count), m_indexSize(sizeof(uint16_t))
+	{
+		glCreateBuffers(1, &m_rendererID);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), indices, GL_STATIC_DRAW);
+	}
+
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
 	{
 		glDeleteBuffers(1, &m_rendererID);
@@ -76,4 +90,25 @@ namespace Rongine {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 
+	void OpenGLIndexBuffer::setData(const void* data, uint32_t size, uint32_t offset)
+	{
+		if (size + offset > m_capacity * m_indexSize)
+		{
+			RONG_CORE_ERROR("IndexBuffer overflow! Trying to set {0} bytes at offset {1}, but capacity is {2}", size, offset, m_capacity * m_indexSize);
+			return;
+		}
+		// DSA 写入：绑定到 GL_ELEMENT_ARRAY_BUFFER 会改掉当前 VAO 的索引缓冲
+		glNamedBufferSubData(m_rendererID, offset, size, data);
+	}
+
+	void OpenGLIndexBuffer::setCount(uint32_t count)
+	{
+		if (count > m_capacity)
+		{
+			RONG_CORE_ERROR("IndexBuffer::setCount {0} exceeds capacity {1}", count, m_capacity);
+			return;
+		}
+		m_count = count;
+	}
+
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace Rongine {
 		virtual void bind() const override;
 		virtual void unbind() const override;
 
-		virtual void setData(const void* data, uint32_t size) override;
+		virtual void setData(const void* data, uint32_t size, uint32_t offset = 0) override;
 
 		virtual const BufferLayout& getLayout()const override { return m_layout; }
 		virtual void setLayout(const BufferLayout& layout) override { m_layout = layout; }
@@ -27,16 +27,23 @@ namespace Rongine {
 	class OpenGLIndexBuffer :public IndexBuffer
 	{
 	public:
-		OpenGLIndexBuffer(uint32_t count);
+		OpenGLIndexBuffer(uint32_t count, uint32_t indexSize = sizeof(uint32_t));
 		OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
+		OpenGLIndexBuffer(uint16_t* indices, uint32_t count);
 		virtual ~OpenGLIndexBuffer();
 
 		inline uint32_t getCount() const override{ return m_count; }
+		virtual uint32_t getIndexSize() const override { return m_indexSize; }
+		virtual uint32_t getCapacity() const override { return m_capacity; }
+		virtual void setData(const void* data, uint32_t size, uint32_t offset) override;
+		virtual void setCount(uint32_t count) override;
 		virtual void bind() const override;
 		virtual void unbind() const override;
 	private:
 		uint32_t m_rendererID;
 		uint32_t m_count;
+		uint32_t m_capacity;
+		uint32_t m_indexSize = sizeof(uint32_t);
 	};
 
 }
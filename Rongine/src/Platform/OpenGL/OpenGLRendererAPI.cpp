@@ -26,9 +26,16 @@ namespace Rongine {
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 	}
 
+	// 索引缓冲可能是 16 位 (小网格) 或 32 位
+	static GLenum getIndexType(const Ref<VertexArray>& vertexArray)
+	{
+		const auto& indexBuffer = vertexArray->getIndexBuffer();
+		return (indexBuffer && indexBuffer->getIndexSize() == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
 	void OpenGLRendererAPI::drawIndexed(const Ref<VertexArray>& vertexArray, uint32_t count)
 	{
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, count, getIndexType(vertexArray), nullptr);
 	}
 
 	void OpenGLRendererAPI::drawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
@@ -38,7 +45,7 @@ namespace Rongine {
 
 	void OpenGLRendererAPI::drawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount)
 	{
-		glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount);
+		glDrawElementsInstanced(GL_TRIANGLES, indexCount, getIndexType(vertexArray), nullptr, instanceCount);
 	}
 
 	void OpenGLRendererAPI::drawArrays(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
@@ -46,6 +53,26 @@ namespace Rongine {
 		glDrawArrays(GL_TRIANGLES, 0, vertexCount);
 	}
 
+	void OpenGLRendererAPI::drawLineStrips(const Ref<VertexArray>& vertexArray, const uint32_t* firstIndices, const uint32_t* counts, uint32_t drawCount)
+	{
+		if (drawCount == 0) return;
+
+		GLenum indexType = getIndexType(vertexArray);
+		uint32_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		std::vector<GLsizei> glCounts(drawCount);
+		std::vector<const void*> offsets(drawCount);
+		for (uint32_t i = 0; i < drawCount; i++)
+		{
+			glCounts[i] = (GLsizei)counts[i];
+			offsets[i] = (const void*)(uintptr_t)(firstIndices[i] * indexSize);
+		}
+
+		glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+		glMultiDrawElements(GL_LINE_STRIP, glCounts.data(), indexType, offsets.data(), (GLsizei)drawCount);
+		glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+	}
+
 	void OpenGLRendererAPI::setDepthTest(bool enabled)
 	{
 		if (enabled)
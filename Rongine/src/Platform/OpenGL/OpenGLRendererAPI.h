@@ -15,6 +15,7 @@ namespace Rongine {
 
 		virtual void drawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount) override;
 		virtual void drawArrays(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void drawLineStrips(const Ref<VertexArray>& vertexArray, const uint32_t* firstIndices, const uint32_t* counts, uint32_t drawCount) override;
 
 		virtual void setDepthTest(bool enabled) override;
 		virtual void setDepthWrite(bool enabled) override;
@@ -19,6 +19,8 @@ namespace Rongine {
 		case ShaderDataType::Int3:
 		case ShaderDataType::Int4: return GL_INT;
 		case ShaderDataType::Bool: return GL_BOOL;
+		case ShaderDataType::Short2: return GL_SHORT;
+		case ShaderDataType::UShort4: return GL_UNSIGNED_SHORT;
 		}
 		RONG_CORE_ASSERT(false, "Unknown ShaderDataType!");
 		return 0;
@@ -61,6 +63,8 @@ namespace Rongine {
 			case ShaderDataType::Float4:
 			case ShaderDataType::Mat3:
 			case ShaderDataType::Mat4:
+			case ShaderDataType::Short2:
+			case ShaderDataType::UShort4:
 			{
 				glEnableVertexAttribArray(index);
 				glVertexAttribPointer(
@@ -23,6 +23,8 @@
 #include "Rongine/Renderer/Buffer.h"
 #include "Rongine/Renderer/Shader.h"
 #include "Rongine/Renderer/VertexArray.h"
+#include "Rongine/Renderer/MeshBuffer.h"
+#include "Rongine/Renderer/MeshArray.h"
 #include "Rongine/Renderer/Texture.h"
 #include "Rongine/Renderer/Framebuffer.h"
 #include "Rongine/Renderer/UniformBuffer.h"
@@ -41,9 +43,13 @@
 
 #include "Rongine/CAD/CADImporter.h" 
 #include "Rongine/CAD/CADMesher.h"
+#include "Rongine/CAD/MeshJobSystem.h"
+#include "Rongine/CAD/MeshLOD.h"
 #include "Rongine/CAD/CADModeler.h"
 #include "Rongine/CAD/CADBoolean.h"
 #include "Rongine/CAD/CADFeature.h"
+#include "Rongine/CAD/TopologyIndex.h"
+#include "Rongine/CAD/ShapeStore.h"
 
 #include "Rongine/Commands/Command.h"
 #include "Rongine/Commands/TransformCommand.h"
@@ -52,11 +58,15 @@
 
 #include "Rongine/Utils/GeometryUtils.h"
 #include "Rongine/Utils/PlatformUtils.h"
+#include "Rongine/Utils/ProcessMemory.h"
+#include "Rongine/Utils/MappedFile.h"
 
 #include "Rongine/Scene/Components.h"
 #include "Rongine/Scene/Entity.h"
 #include "Rongine/Scene/Scene.h"
 #include "Rongine/Scene/SceneSerializer.h"
+#include "Rongine/Scene/SceneBinary.h"
+#include "Rongine/Scene/SceneMeshCache.h"
 #include "Rongine/Scene/SpectralAssetManager.h"
 
 #include "Rongine/Math/Math.h"
@@ -4,7 +4,6 @@
 // --- OCCT 头文件 ---
 #include <TopoDS.hxx>
 #include <TopoDS_Face.hxx>
-#include <TopExp_Explorer.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
 #include <BRepGProp.hxx>
 #include <GProp_GProps.hxx>
@@ -28,23 +27,6 @@
 
 namespace Rongine {
 
-    // --- 内部辅助：根据索引找到 Face ---
-    static TopoDS_Face GetFaceByIndex(const TopoDS_Shape& shape, int index)
-    {
-        int current = 0;
-        TopExp_Explorer explorer(shape, TopAbs_FACE);
-        while (explorer.More())
-        {
-            if (current == index)
-            {
-                return TopoDS::Face(explorer.Current());
-            }
-            current++;
-            explorer.Next();
-        }
-        return TopoDS_Face(); // 返回空面
-    }
-
     // --- 内部辅助：计算面的中心法线 ---
     static gp_Vec GetFaceNormal(const TopoDS_Face& face)
     {
@@ -77,14 +59,12 @@ namespace Rongine {
         return gp_Vec(0, 1, 0); // 兜底
     }
 
-    void* CADFeature::ExtrudeFace(void* shapeHandle, int faceIndex, float height)
+    void* CADFeature::ExtrudeFace(const TopologyIndex* topology, int faceIndex, float height)
     {
-        if (!shapeHandle || faceIndex < 0) return nullptr;
-
-        TopoDS_Shape* mainShape = (TopoDS_Shape*)shapeHandle;
+        if (!topology || faceIndex < 0) return nullptr;
 
         // 1. 找到对应的面
-        TopoDS_Face face = GetFaceByIndex(*mainShape, faceIndex);
+        TopoDS_Face face = topology->GetFace(faceIndex);
         if (face.IsNull())
         {
             RONG_CORE_ERROR("Extrude: Face ID {0} not found!", faceIndex);
@@ -115,12 +95,11 @@ namespace Rongine {
 
         return nullptr;
     }
-    glm::mat4 CADFeature::GetFaceTransform(void* shapeHandle, int faceIndex)
+    glm::mat4 CADFeature::GetFaceTransform(const TopologyIndex* topology, int faceIndex)
     {
-        if (!shapeHandle || faceIndex < 0) return glm::mat4(1.0f);
+        if (!topology || faceIndex < 0) return glm::mat4(1.0f);
 
-        TopoDS_Shape* mainShape = (TopoDS_Shape*)shapeHandle;
-        TopoDS_Face face = GetFaceByIndex(*mainShape, faceIndex);
+        TopoDS_Face face = topology->GetFace(faceIndex);
         if (face.IsNull()) return glm::mat4(1.0f);
 
         // 1. 获取中心点和法线
@@ -164,32 +143,15 @@ namespace Rongine {
         return translation * rotation;
     }
 
-    void* CADFeature::MakeFilletShape(void* shapeHandle, int edgeID, float radius)
+    void* CADFeature::MakeFilletShape(const TopologyIndex* topology, int edgeID, float radius)
     {
-        if (!shapeHandle) return nullptr;
-        TopoDS_Shape* shape = (TopoDS_Shape*)shapeHandle;
+        if (!topology || !topology->IsValidEdge(edgeID)) return nullptr;
 
         // 1. 初始化倒角工具
-        BRepFilletAPI_MakeFillet filletMaker(*shape);
-
-        // 2. 找到对应的边
-        // 注意：这里的遍历顺序必须和 Mesher 生成 ID 的顺序完全一致
-        int currentID = 0;
-        bool found = false;
-        TopExp_Explorer explorer(*shape, TopAbs_EDGE);
-        for (; explorer.More(); explorer.Next())
-        {
-            if (currentID == edgeID)
-            {
-                const TopoDS_Edge& edge = TopoDS::Edge(explorer.Current());
-                filletMaker.Add(radius, edge);
-                found = true;
-                break;
-            }
-            currentID++;
-        }
+        BRepFilletAPI_MakeFillet filletMaker(topology->GetShape());
 
-        if (!found) return nullptr;
+        // 2. 找到对应的边 (和 CADMesher::BuildEdgeData 用同一张索引表，编号一致)
+        filletMaker.Add(radius, topology->GetEdge(edgeID));
 
         // 3. 构建
         try {
@@ -205,32 +167,14 @@ namespace Rongine {
         return nullptr;
     }
 
-    glm::mat4 CADFeature::GetEdgeTransform(void* shapeHandle, int edgeID)
+    glm::mat4 CADFeature::GetEdgeTransform(const TopologyIndex* topology, int edgeID)
     {
-        if (!shapeHandle) return glm::mat4(1.0f);
-
-        TopoDS_Shape* shape = (TopoDS_Shape*)shapeHandle;
-        TopoDS_Edge targetEdge;
-        bool found = false;
-
-        // 1. 遍历寻找对应 ID 的边
-        int currentID = 0;
-        TopExp_Explorer explorer(*shape, TopAbs_EDGE);
-        for (; explorer.More(); explorer.Next())
-        {
-            if (currentID == edgeID)
-            {
-                targetEdge = TopoDS::Edge(explorer.Current());
-                found = true;
-                break;
-            }
-            currentID++;
-        }
-
-        if (!found)
+        // 1. 按 ID 查找对应的边 (与 CADMesher::BuildEdgeData 的编号一致)
+        if (!topology || !topology->IsValidEdge(edgeID))
         {
             return glm::mat4(1.0f);
         }
+        TopoDS_Edge targetEdge = topology->GetEdge(edgeID);
 
         // 2. 计算边的质心 
         GProp_GProps linearProps;
@@ -241,10 +185,11 @@ namespace Rongine {
         return glm::translate(glm::mat4(1.0f), glm::vec3((float)center.X(), (float)center.Y(), (float)center.Z()));
     }
 
-    bool CADFeature::GetPlanarFaceCoordinateSystem(const TopoDS_Shape& shape, int faceID, gp_Ax3& outAx3, glm::mat4& outMatrix)
+    bool CADFeature::GetPlanarFaceCoordinateSystem(const TopologyIndex* topology, int faceID, gp_Ax3& outAx3, glm::mat4& outMatrix)
     {
         // 1. 获取面
-        TopoDS_Face face = TopoDS::Face(CADFeature::GetSubShape(shape, TopAbs_FACE, faceID));
+        if (!topology) return false;
+        TopoDS_Face face = topology->GetFace(faceID);
         if (face.IsNull()) return false;
 
         // 2. 检查底层几何是否为平面
@@ -324,21 +269,4 @@ namespace Rongine {
 
         return nullptr;
     }
-
-
-    TopoDS_Shape CADFeature::GetSubShape(const TopoDS_Shape& shape, TopAbs_ShapeEnum type, int index)
-    {
-        TopExp_Explorer explorer(shape, type);
-        int current = 0;
-        while (explorer.More())
-        {
-            if (current == index)
-            {
-                return explorer.Current();
-            }
-            explorer.Next();
-            current++;
-        }
-        return TopoDS_Shape(); // 返回空形状
-    }
 }
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include "Rongpch.h"
 #include "CADMesher.h"
+#include "MeshJobSystem.h"
+#include "CADImporter.h"
+#include "Rongine/Scene/SceneSerializer.h"
 
 #include "Rongine/Renderer/Renderer3D.h" // 获取 CubeVertex 定义
 #include "Rongine/Renderer/Buffer.h"
+#include "Rongine/Renderer/VertexCompression.h"
+#include "Rongine/Renderer/MeshBuffer.h"
 
 // --- OCCT 算法头文件 (只在 cpp 中包含，加快编译) ---
 #include <TopoDS.hxx>
@@ -14,322 +19,852 @@
 #include <TColgp_Array1OfPnt.hxx>
 #include <Poly_Array1OfTriangle.hxx>
 #include <TopoDS_Edge.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <TColStd_Array1OfInteger.hxx>
 #include <BRepAdaptor_Curve.hxx>
 #include <GCPnts_TangentialDeflection.hxx>
 #include <BRepFilletAPI_MakeFillet.hxx>
 #include <BRepTools.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Geom_Surface.hxx>
+#include <GeomLProp_SLProps.hxx>
+#include <Precision.hxx>
+#include <BRep_Builder.hxx>
+#include <IMeshTools_Parameters.hxx>
+
+#include <chrono>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <thread>
 
 namespace Rongine {
 
-    Ref<VertexArray> CADMesher::CreateMeshFromShape(const TopoDS_Shape& shape, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection)
+    // 三角网格缓存：同一个面 (TShape + Location + Orientation) 在同一精度下的离散化结果
+    // 倒角/拉伸/撤销之后没被修改的面共享原来的 TShape，直接复用之前的 Poly_Triangulation 和提取好的顶点
+    struct FaceCacheEntry
     {
-        // 0. 清空传入的容器，确保数据干净
-        outVertices.clear();
-        outIndices.clear(); 
+        TopoDS_Face Face; // 持有 TShape 的引用，保证指针作为 key 期间不会被释放复用
+        float Deflection = 0.0f;
+        Handle(Poly_Triangulation) Triangulation;
+        std::vector<CubeVertex> Vertices; // FaceID 在复制时重新填写
+        std::vector<uint32_t> Indices;    // 面内局部索引 (已按 Orientation 调整绕序)
+        uint64_t LastUsed = 0;
+    };
+
+    // 缓存上限 (三角形数)，超过后按最近使用时间淘汰
+    static const uint64_t s_MeshCacheBudget = 2000000;
+
+    // Mutex 只在查找和写入时持有，离散化/提取期间不锁 (后台网格任务运行时主线程照常读统计)
+    // 条目写入后除 LastUsed 外不再修改，构建期间持有 Ref，被其它线程淘汰也不会失效
+    struct MeshCacheData
+    {
+        std::mutex Mutex;
+        std::unordered_map<const void*, std::vector<Ref<FaceCacheEntry>>> Entries; // key: TShape 指针
+        uint64_t Generation = 0;
+        uint64_t CachedTriangles = 0;
 
-        // 1. 离散化 (Meshing)
-        BRepMesh_IncrementalMesh mesher(shape, deflection);
+        std::mutex StatsMutex; // 统计单独加锁，每帧读取也不会等待缓存
+        CADMesher::MeshCacheStats Stats;
+    };
 
-        uint32_t indexOffset = 0;
-        int faceID = 0;
+    static MeshCacheData s_MeshCache;
 
-        // 2. 遍历所有的面 (Face)
-        TopExp_Explorer explorer(shape, TopAbs_FACE);
-        while (explorer.More())
+    static Ref<FaceCacheEntry> FindCacheEntry(const TopoDS_Face& face, float deflection)
+    {
+        auto it = s_MeshCache.Entries.find(face.TShape().get());
+        if (it == s_MeshCache.Entries.end()) return nullptr;
+
+        for (const auto& entry : it->second)
         {
-            const TopoDS_Face& face = TopoDS::Face(explorer.Current());
-            TopLoc_Location location;
+            if (entry->Deflection == deflection && entry->Face.Orientation() == face.Orientation() &&
+                entry->Face.Location().IsEqual(face.Location()))
+                return entry;
+        }
+        return nullptr;
+    }
+
+    // 面上现有的三角网格是否就是缓存里同一精度的结果 (同一 TShape 的另一个 Location 已经命中过)
+    static bool IsCachedTriangulation(const TopoDS_Face& face, float deflection, const Handle(Poly_Triangulation)& triangulation)
+    {
+        auto it = s_MeshCache.Entries.find(face.TShape().get());
+        if (it == s_MeshCache.Entries.end()) return false;
+
+        for (const auto& entry : it->second)
+            if (entry->Deflection == deflection && entry->Triangulation == triangulation) return true;
+        return false;
+    }
+
+    static void TrimMeshCache(uint64_t keepGeneration)
+    {
+        if (s_MeshCache.CachedTriangles <= s_MeshCacheBudget) return;
 
-            // 获取三角网格数据
-            Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, location);
+        // 按最近使用时间从旧到新淘汰，本次 (及之后开始的) 构建用到的不淘汰
+        std::vector<std::pair<uint64_t, const void*>> order;
+        for (const auto& [key, entries] : s_MeshCache.Entries)
+            for (const auto& entry : entries)
+                order.push_back({ entry->LastUsed, key });
+        std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
-            if (!triangulation.IsNull())
+        for (const auto& [lastUsed, key] : order)
+        {
+            if (s_MeshCache.CachedTriangles <= s_MeshCacheBudget || lastUsed >= keepGeneration) break;
+
+            auto& entries = s_MeshCache.Entries[key];
+            for (auto it = entries.begin(); it != entries.end(); ++it)
             {
-                // ========================================================
-                // 获取面的方向
-                // 如果是 REVERSED，说明几何法线与逻辑法线相反，需要翻转顶点顺序
-                // ========================================================
-                bool isReversed = (face.Orientation() == TopAbs_REVERSED);
+                if ((*it)->LastUsed != lastUsed) continue;
+                s_MeshCache.CachedTriangles -= (*it)->Indices.size() / 3;
+                entries.erase(it);
+                break;
+            }
+            if (entries.empty()) s_MeshCache.Entries.erase(key);
+        }
+    }
 
-                gp_Trsf trsf = location.Transformation();
+    // 每个面在输出缓冲中的位置 (两遍提取的第一遍算出)
+    struct FaceMeshRange
+    {
+        TopoDS_Face Face;
+        Handle(Poly_Triangulation) Triangulation;
+        TopLoc_Location Location;
+        const FaceCacheEntry* Cached = nullptr; // 命中缓存时直接复制
+        int FaceID = 0;
+        uint32_t VertexOffset = 0;
+        uint32_t IndexOffset = 0;
+    };
+
+    static void CopyCachedFaceMesh(const FaceMeshRange& range, CubeVertex* outVertices, uint32_t* outIndices)
+    {
+        const FaceCacheEntry& entry = *range.Cached;
 
-                int nodeCount = triangulation->NbNodes();
-                int triangleCount = triangulation->NbTriangles();
+        CubeVertex* vertex = outVertices + range.VertexOffset;
+        for (const CubeVertex& v : entry.Vertices)
+        {
+            *vertex = v;
+            vertex->FaceID = range.FaceID;
+            vertex++;
+        }
 
-                // 记录当前面的顶点偏移量
-                uint32_t currentFaceOffset = indexOffset;
+        uint32_t* index = outIndices + range.IndexOffset;
+        for (uint32_t i : entry.Indices)
+            *index++ = i + range.VertexOffset;
+    }
 
-                // --- A. 提取顶点 ---
-                for (int i = 1; i <= nodeCount; i++)
-                {
-                    gp_Pnt p = triangulation->Node(i).Transformed(trsf);
-
-                    CubeVertex v;
-                    v.Position = { (float)p.X(), (float)p.Y(), (float)p.Z() };
-                    v.Normal = { 0.0f, 1.0f, 0.0f }; // 简单默认法线
-                    v.Color = { 0.8f, 0.8f, 0.8f, 1.0f };
-                    v.TexCoord = { 0.0f, 0.0f };
-                    v.TexIndex = 0.0f;
-                    v.TilingFactor = 1.0f;
-                    v.FaceID = faceID;
-
-                    outVertices.push_back(v);
-                }
+    // 把一个面的三角网格写入预先分配好的缓冲区 (各个面写入的区间互不重叠，可以并发)
+    static void FillFaceMesh(const FaceMeshRange& range, CubeVertex* outVertices, uint32_t* outIndices)
+    {
+        const Handle(Poly_Triangulation)& triangulation = range.Triangulation;
+
+        // ========================================================
+        // 获取面的方向
+        // 如果是 REVERSED，说明几何法线与逻辑法线相反，需要翻转顶点顺序
+        // ========================================================
+        bool isReversed = (range.Face.Orientation() == TopAbs_REVERSED);
+
+        gp_Trsf trsf = range.Location.Transformation();
+
+        int nodeCount = triangulation->NbNodes();
+        int triangleCount = triangulation->NbTriangles();
+
+        // 法线来源：优先用三角网格自带的法线，否则在节点的 UV 处求曲面法线
+        // 两者都是曲面的自然方向，REVERSED 面需要取反
+        bool hasNormals = triangulation->HasNormals();
+        bool hasUV = triangulation->HasUVNodes();
+
+        TopLoc_Location surfaceLocation;
+        Handle(Geom_Surface) surface;
+        if (!hasNormals && hasUV)
+            surface = BRep_Tool::Surface(range.Face, surfaceLocation);
+        GeomLProp_SLProps props(1, Precision::Confusion());
+        if (!surface.IsNull())
+            props.SetSurface(surface);
+        gp_Trsf surfaceTrsf = surfaceLocation.Transformation();
+
+        // 纹理坐标：节点 UV 按本面的 UV 范围归一化到 [0, 1]
+        double uMin = 0.0, vMin = 0.0, uScale = 0.0, vScale = 0.0;
+        if (hasUV)
+        {
+            double uMax = -1e300, vMax = -1e300;
+            uMin = vMin = 1e300;
+            for (int i = 1; i <= nodeCount; i++)
+            {
+                gp_Pnt2d uv = triangulation->UVNode(i);
+                uMin = std::min(uMin, uv.X()); uMax = std::max(uMax, uv.X());
+                vMin = std::min(vMin, uv.Y()); vMax = std::max(vMax, uv.Y());
+            }
+            uScale = uMax - uMin > 1e-12 ? 1.0 / (uMax - uMin) : 0.0;
+            vScale = vMax - vMin > 1e-12 ? 1.0 / (vMax - vMin) : 0.0;
+        }
+
+        // 曲面退化点 (如球的极点) 上法线没有定义，之后用相邻三角形的法线补上
+        bool needsTriangleNormals = false;
+
+        // --- A. 提取顶点 ---
+        CubeVertex* vertex = outVertices + range.VertexOffset;
+        for (int i = 1; i <= nodeCount; i++, vertex++)
+        {
+            gp_Pnt p = triangulation->Node(i).Transformed(trsf);
 
-                // --- B. 提取三角形索引 ---
-                for (int i = 1; i <= triangleCount; i++)
+            glm::vec3 normal(0.0f);
+            if (hasNormals)
+            {
+                gp_Dir n = triangulation->Normal(i).Transformed(trsf);
+                normal = { (float)n.X(), (float)n.Y(), (float)n.Z() };
+            }
+            else if (!surface.IsNull())
+            {
+                gp_Pnt2d uv = triangulation->UVNode(i);
+                props.SetParameters(uv.X(), uv.Y());
+                if (props.IsNormalDefined())
                 {
-                    const Poly_Triangle& tri = triangulation->Triangle(i);
-
-                    int n1, n2, n3;
-                    tri.Get(n1, n2, n3);
-
-                    // OCCT 的索引是从 1 开始的，我们需要减 1 变成从 0 开始
-                    uint32_t idx1 = currentFaceOffset + (n1 - 1);
-                    uint32_t idx2 = currentFaceOffset + (n2 - 1);
-                    uint32_t idx3 = currentFaceOffset + (n3 - 1);
-
-                    // ========================================================
-                    // 根据 Orientation 调整顶点写入顺序
-                    // ========================================================
-                    if (isReversed)
-                    {
-                        // 如果是反向面，交换 2 和 3 的顺序 (1-3-2)
-                        // 存入 outIndices
-                        outIndices.push_back(idx1);
-                        outIndices.push_back(idx3);
-                        outIndices.push_back(idx2);
-                    }
-                    else
-                    {
-                        // 正常顺序 (1-2-3)
-                        outIndices.push_back(idx1);
-                        outIndices.push_back(idx2);
-                        outIndices.push_back(idx3);
-                    }
+                    gp_Dir n = props.Normal().Transformed(surfaceTrsf);
+                    normal = { (float)n.X(), (float)n.Y(), (float)n.Z() };
                 }
-
-                indexOffset += nodeCount;
             }
-            explorer.Next();
-            faceID++;
-        }
 
-        // 3. 创建 OpenGL 资源
-        if (outVertices.empty()) return nullptr;
+            if (normal == glm::vec3(0.0f))
+                needsTriangleNormals = true;
+            else if (isReversed)
+                normal = -normal;
 
-        Ref<VertexArray> va = VertexArray::create();
+            vertex->Position = { (float)p.X(), (float)p.Y(), (float)p.Z() };
+            vertex->Normal = normal;
+            vertex->Color = { 0.8f, 0.8f, 0.8f, 1.0f };
+            if (hasUV)
+            {
+                gp_Pnt2d uv = triangulation->UVNode(i);
+                vertex->TexCoord = { (float)((uv.X() - uMin) * uScale), (float)((uv.Y() - vMin) * vScale) };
+            }
+            else
+            {
+                vertex->TexCoord = { 0.0f, 0.0f };
+            }
+            vertex->TexIndex = 0.0f;
+            vertex->TilingFactor = 1.0f;
+            vertex->FaceID = range.FaceID;
+        }
 
-        Ref<VertexBuffer> vb = VertexBuffer::create((float*)outVertices.data(), (uint32_t)(outVertices.size() * sizeof(CubeVertex)));
-
-        vb->setLayout({
-            { ShaderDataType::Float3, "a_Position" },
-            { ShaderDataType::Float3, "a_Normal" },
-            { ShaderDataType::Float4, "a_Color" },
-            { ShaderDataType::Float2, "a_TexCoord" },
-            { ShaderDataType::Float,  "a_TexIndex" },
-            { ShaderDataType::Float,  "a_TilingFactor" },
-            { ShaderDataType::Int,    "a_FaceID" }
-            });
-        va->addVertexBuffer(vb);
+        // --- B. 提取三角形索引 ---
+        uint32_t* index = outIndices + range.IndexOffset;
+        for (int i = 1; i <= triangleCount; i++, index += 3)
+        {
+            const Poly_Triangle& tri = triangulation->Triangle(i);
+
+            int n1, n2, n3;
+            tri.Get(n1, n2, n3);
+
+            // OCCT 的索引是从 1 开始的，我们需要减 1 变成从 0 开始
+            uint32_t idx1 = range.VertexOffset + (n1 - 1);
+            uint32_t idx2 = range.VertexOffset + (n2 - 1);
+            uint32_t idx3 = range.VertexOffset + (n3 - 1);
+
+            // ========================================================
+            // 根据 Orientation 调整顶点写入顺序
+            // ========================================================
+            index[0] = idx1;
+            index[1] = isReversed ? idx3 : idx2; // 如果是反向面，交换 2 和 3 的顺序 (1-3-2)
+            index[2] = isReversed ? idx2 : idx3;
+        }
 
-        // 使用 outIndices 创建索引缓冲
-        Ref<IndexBuffer> ib = IndexBuffer::create(outIndices.data(), (uint32_t)outIndices.size());
-        va->setIndexBuffer(ib);
+        // --- C. 没有法线的顶点：累加相邻三角形的面积加权法线 (绕序已按 Orientation 调整，不需要再取反)
+        if (needsTriangleNormals)
+        {
+            CubeVertex* vertices = outVertices + range.VertexOffset;
+            std::vector<glm::vec3> accumulated(nodeCount, glm::vec3(0.0f));
+            const uint32_t* faceIndices = outIndices + range.IndexOffset;
+            for (int t = 0; t < triangleCount; t++)
+            {
+                uint32_t a = faceIndices[t * 3] - range.VertexOffset;
+                uint32_t b = faceIndices[t * 3 + 1] - range.VertexOffset;
+                uint32_t c = faceIndices[t * 3 + 2] - range.VertexOffset;
+                glm::vec3 n = glm::cross(vertices[b].Position - vertices[a].Position, vertices[c].Position - vertices[a].Position);
+                accumulated[a] += n; accumulated[b] += n; accumulated[c] += n;
+            }
+            for (int v = 0; v < nodeCount; v++)
+            {
+                if (vertices[v].Normal != glm::vec3(0.0f)) continue;
+                float len = glm::length(accumulated[v]);
+                vertices[v].Normal = len > 0.0f ? accumulated[v] / len : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        }
+    }
 
-        return va;
+    void CADMesher::BuildMeshData(const TopoDS_Shape& shape, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection, int threadCount, bool useCache,
+        const Message_ProgressRange& progress)
+    {
+        BuildMeshData(TopologyIndex(shape), outVertices, outIndices, deflection, threadCount, useCache, progress);
     }
 
-    Ref<VertexArray> CADMesher::CreateEdgeMeshFromShape(const TopoDS_Shape& shape, std::vector<LineVertex>& outLines, float deflection)
+    void CADMesher::BuildMeshData(const TopologyIndex& topology, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection, int threadCount, bool useCache,
+        const Message_ProgressRange& progress)
     {
-        outLines.clear();
-        int edgeID = 0; // 给每条边编个号，方便以后拾取
+        const TopoDS_Shape& shape = topology.GetShape();
 
-        // 1. 遍历所有的边 (Edge)
-        TopExp_Explorer explorer(shape, TopAbs_EDGE);
-        while (explorer.More())
+        // 0. 清空传入的容器，确保数据干净
+        outVertices.clear();
+        outIndices.clear();
+
+        if (threadCount <= 0)
+            threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+
+        // 1. 先查缓存
+        //    命中的面把缓存的三角网格挂回 BRep (保证相邻新面的边界离散化与之一致)
+        //    没命中但带有三角网格的面 (其它精度或外部生成)，去掉三角网格让 BRepMesh 按当前精度重新离散
+        //    面按拓扑索引表编号 (建模操作后延续旧 ID)，被多个壳共享的面只离散/提取一次
+        std::vector<TopoDS_Face> faces;
+        std::vector<Ref<FaceCacheEntry>> cached;
+        const TopTools_IndexedMapOfShape& faceMap = topology.GetFaceMap();
+        faces.reserve(faceMap.Extent());
+        for (int i = 1; i <= faceMap.Extent(); i++)
+            faces.push_back(TopoDS::Face(faceMap(i)));
+        cached.resize(faces.size(), nullptr);
+
+        uint32_t hits = 0;
+        uint64_t generation = 0;
+        if (useCache)
         {
-            const TopoDS_Edge& edge = TopoDS::Edge(explorer.Current());
+            std::lock_guard<std::mutex> lock(s_MeshCache.Mutex);
+            generation = ++s_MeshCache.Generation;
 
-            //entity.GetComponent<MeshComponent>().m_IDToEdgeMap[edgeID] = edge;
+            BRep_Builder builder;
+            for (size_t i = 0; i < faces.size(); i++)
+            {
+                const TopoDS_Face& face = faces[i];
+                TopLoc_Location location;
+                Handle(Poly_Triangulation) current = BRep_Tool::Triangulation(face, location);
 
-            // 2. 将边离散化为线段
-            // BRepAdaptor_Curve 用于获取边的几何属性
-            BRepAdaptor_Curve curveAdaptor(edge);
+                cached[i] = FindCacheEntry(face, deflection);
+                if (cached[i])
+                {
+                    if (current != cached[i]->Triangulation)
+                        builder.UpdateFace(face, cached[i]->Triangulation);
+                    cached[i]->LastUsed = generation;
+                    hits++;
+                }
+                else if (!current.IsNull() && !IsCachedTriangulation(face, deflection, current))
+                {
+                    builder.UpdateFace(face, Handle(Poly_Triangulation)());
+                }
+            }
+        }
 
-            // GCPnts_TangentialDeflection: 基于切向偏差的离散化算法
-            // deflection: 线性偏差 (控制光滑度)
-            // angularDeflection: 角度偏差 (控制转角处的精度)，这里给 0.1弧度 (约5.7度)
-            GCPnts_TangentialDeflection discretizer;
-            discretizer.Initialize(curveAdaptor, deflection, 0.1);
+        // 2. 离散化 (Meshing)，只处理没有三角网格的面；多线程时让 OCCT 并行处理各个面
+        if (hits < faces.size())
+        {
+            IMeshTools_Parameters params;
+            params.Deflection = deflection;
+            params.Angle = 0.5;
+            params.Relative = Standard_False;
+            params.InParallel = threadCount > 1;
+            BRepMesh_IncrementalMesh mesher(shape, params, progress);
+        }
 
-            int nPoints = discretizer.NbPoints();
+        // 离散化途中被取消 (例如后台任务已过期)：已经生成的三角网格留在面上，下次构建时会被重新离散
+        if (progress.UserBreak()) return;
 
-            // 3. 构建线段 (GL_LINES 模式：点1-点2, 点2-点3...)
-            // 也就是每两个点构成一条独立的线段
-            if (nPoints > 1)
+        // 3. 第一遍：按遍历顺序统计每个面的顶点/三角形数量并求前缀和
+        //    FaceID = 拓扑索引表中的下标 - 1 (没有三角网格的面也占一个编号)
+        std::vector<FaceMeshRange> ranges;
+        uint32_t vertexCount = 0, indexCount = 0;
+        for (int faceID = 0; faceID < (int)faces.size(); faceID++)
+        {
+            FaceMeshRange range;
+            range.Face = faces[faceID];
+            range.FaceID = faceID;
+            range.VertexOffset = vertexCount;
+            range.IndexOffset = indexCount;
+
+            if (cached[faceID])
+            {
+                range.Cached = cached[faceID].get();
+                vertexCount += (uint32_t)range.Cached->Vertices.size();
+                indexCount += (uint32_t)range.Cached->Indices.size();
+            }
+            else
             {
-                for (int i = 1; i < nPoints; i++)
+                // 获取三角网格数据
+                range.Triangulation = BRep_Tool::Triangulation(range.Face, range.Location);
+                if (range.Triangulation.IsNull()) continue;
+
+                vertexCount += (uint32_t)range.Triangulation->NbNodes();
+                indexCount += (uint32_t)range.Triangulation->NbTriangles() * 3;
+            }
+            ranges.push_back(range);
+        }
+
+        outVertices.resize(vertexCount);
+        outIndices.resize(indexCount);
+
+        // 4. 第二遍：各个面并发写入预先分配好的缓冲区，结果与串行完全相同
+        //    按三角形数量把面切成 threadCount 段，每段一个任务 (同时运行的任务数不超过 threadCount)
+        if (!ranges.empty())
+        {
+            std::vector<size_t> chunkBegin;
+            for (size_t i = 0; i < ranges.size(); i++)
+            {
+                uint64_t chunk = (uint64_t)ranges[i].IndexOffset * threadCount / std::max(indexCount, 1u);
+                while (chunkBegin.size() <= chunk) chunkBegin.push_back(i);
+            }
+            chunkBegin.push_back(ranges.size());
+
+            std::vector<int> chunks((int)chunkBegin.size() - 1);
+            std::iota(chunks.begin(), chunks.end(), 0);
+
+            auto fillChunk = [&](int c) {
+                for (size_t i = chunkBegin[c]; i < chunkBegin[c + 1]; i++)
                 {
-                    gp_Pnt p1 = discretizer.Value(i);
-                    gp_Pnt p2 = discretizer.Value(i + 1);
-
-                    // 存入第一个点
-                    LineVertex v1;
-                    v1.Position = { (float)p1.X(), (float)p1.Y(), (float)p1.Z() };
-                    v1.EntityID = edgeID; // 存入边ID
-                    outLines.push_back(v1);
-
-                    // 存入第二个点
-                    LineVertex v2;
-                    v2.Position = { (float)p2.X(), (float)p2.Y(), (float)p2.Z() };
-                    v2.EntityID = edgeID; // 存入边ID
-                    outLines.push_back(v2);
+                    if (ranges[i].Cached) CopyCachedFaceMesh(ranges[i], outVertices.data(), outIndices.data());
+                    else FillFaceMesh(ranges[i], outVertices.data(), outIndices.data());
                 }
+            };
+
+            if (chunks.size() > 1)
+                std::for_each(std::execution::par, chunks.begin(), chunks.end(), fillChunk);
+            else
+                std::for_each(chunks.begin(), chunks.end(), fillChunk);
+        }
+
+        if (!useCache) return;
+
+        // 5. 新离散的面写入缓存 (条目在锁外准备好，锁内只做插入)
+        std::vector<Ref<FaceCacheEntry>> added;
+        for (const auto& range : ranges)
+        {
+            if (range.Cached) continue;
+
+            Ref<FaceCacheEntry> entry = CreateRef<FaceCacheEntry>();
+            entry->Face = range.Face;
+            entry->Deflection = deflection;
+            entry->Triangulation = range.Triangulation;
+            entry->LastUsed = generation;
+            entry->Vertices.assign(outVertices.begin() + range.VertexOffset,
+                outVertices.begin() + range.VertexOffset + range.Triangulation->NbNodes());
+            entry->Indices.resize(range.Triangulation->NbTriangles() * 3);
+            for (size_t i = 0; i < entry->Indices.size(); i++)
+                entry->Indices[i] = outIndices[range.IndexOffset + i] - range.VertexOffset;
+            added.push_back(std::move(entry));
+        }
+        uint32_t misses = (uint32_t)added.size();
+
+        uint64_t cachedTriangles = 0;
+        uint32_t entryCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(s_MeshCache.Mutex);
+            for (auto& entry : added)
+            {
+                // 其它线程在这期间已经写入同一个面：保留先写入的
+                if (FindCacheEntry(entry->Face, deflection)) continue;
+                s_MeshCache.CachedTriangles += entry->Indices.size() / 3;
+                s_MeshCache.Entries[entry->Face.TShape().get()].push_back(std::move(entry));
             }
+            TrimMeshCache(generation);
+
+            cachedTriangles = s_MeshCache.CachedTriangles;
+            for (const auto& [key, entries] : s_MeshCache.Entries)
+                entryCount += (uint32_t)entries.size();
+        }
+
+        std::lock_guard<std::mutex> lock(s_MeshCache.StatsMutex);
+        MeshCacheStats& stats = s_MeshCache.Stats;
+        stats.Hits += hits;
+        stats.Misses += misses;
+        stats.LastHits = hits;
+        stats.LastMisses = misses;
+        stats.CachedTriangles = cachedTriangles;
+        stats.Entries = entryCount;
+    }
+
+    CADMesher::MeshCacheStats CADMesher::GetMeshCacheStats()
+    {
+        std::lock_guard<std::mutex> lock(s_MeshCache.StatsMutex);
+        return s_MeshCache.Stats;
+    }
 
-            explorer.Next();
-            edgeID++;
+    void CADMesher::ClearMeshCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_MeshCache.Mutex);
+            s_MeshCache.Entries.clear();
+            s_MeshCache.CachedTriangles = 0;
         }
+        std::lock_guard<std::mutex> lock(s_MeshCache.StatsMutex);
+        s_MeshCache.Stats = MeshCacheStats();
+    }
+
+    Ref<VertexArray> CADMesher::CreateMeshFromShape(const TopoDS_Shape& shape, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection)
+    {
+        return CreateMeshFromShape(TopologyIndex(shape), outVertices, outIndices, deflection);
+    }
+
+    Ref<VertexArray> CADMesher::CreateMeshFromShape(const TopologyIndex& topology, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection)
+    {
+        // 1. 离散化并提取顶点/索引 (CPU)
+        BuildMeshData(topology, outVertices, outIndices, deflection);
+
+        // 2. 创建 OpenGL 资源
+        return CreateMeshVertexArray(outVertices, outIndices);
+    }
 
-        if (outLines.empty()) return nullptr;
+    Ref<VertexArray> CADMesher::CreateMeshVertexArray(const std::vector<CubeVertex>& vertices, const std::vector<uint32_t>& indices)
+    {
+        if (vertices.empty()) return nullptr;
 
-        // 4. 创建 OpenGL 资源
         Ref<VertexArray> va = VertexArray::create();
-        Ref<VertexBuffer> vb = VertexBuffer::create((float*)outLines.data(), (uint32_t)(outLines.size() * sizeof(LineVertex)));
 
-        // 布局必须匹配 Shader (pos: vec3, entityID: int)
-        vb->setLayout({
-            { ShaderDataType::Float3, "a_Position" },
-            { ShaderDataType::Int,    "a_EntityID" }
-            });
+        // GPU 上只放紧凑格式 (60 -> 16 字节/顶点)，CPU 端的 LocalVertices 仍是全精度 (拾取/光追/BVH 用)
+        std::vector<CADVertex> compact;
+        glm::vec3 offset, scale;
+        CompressCADVertices(vertices, compact, offset, scale);
 
+        Ref<VertexBuffer> vb = VertexBuffer::create((float*)compact.data(), (uint32_t)(compact.size() * sizeof(CADVertex)));
+
+        vb->setLayout(MeshBuffer::getVertexLayout());
         va->addVertexBuffer(vb);
+        va->setPositionDequantization(offset, scale);
+
+        // 顶点数少于 65536 时用 16 位索引
+        Ref<IndexBuffer> ib;
+        if (vertices.size() < 65536)
+        {
+            std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+            ib = IndexBuffer::create(shortIndices.data(), (uint32_t)shortIndices.size());
+        }
+        else
+        {
+            ib = IndexBuffer::create((uint32_t*)indices.data(), (uint32_t)indices.size());
+        }
+        va->setIndexBuffer(ib);
 
-        // 线框渲染通常不需要 IndexBuffer，直接 drawArrays 即可
         return va;
     }
 
-    // 带 Entity 版本的重载 (负责建立映射)
-    Ref<VertexArray> CADMesher::CreateEdgeMeshFromShape(Entity entity, const TopoDS_Shape& shape, std::vector<LineVertex>& outLines, float deflection)
+    Ref<VertexArray> CADMesher::UpdateMeshVertexArray(MeshComponent& mesh, ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices)
     {
-        outLines.clear();
-        auto& mesh = entity.GetComponent<MeshComponent>();
+        // 复制出来的组件和原实体共用同一个 MeshBuffer，第一次更新时分开
+        if (!mesh.GPUBuffer || mesh.GPUBuffer.use_count() > 1)
+            mesh.GPUBuffer = CreateRef<MeshBuffer>();
 
-        // 1. 确保 Map 是空的
-        mesh.m_IDToEdgeMap.clear();
+        Ref<VertexArray> va = mesh.GPUBuffer->update(vertices, indices);
 
-        int edgeID = 0;
-        TopExp_Explorer explorer(shape, TopAbs_EDGE);
-        while (explorer.More())
-        {
-            const TopoDS_Edge& edge = TopoDS::Edge(explorer.Current());
+        const auto& stats = mesh.GPUBuffer->getLastStats();
+        RONG_CORE_TRACE("Mesh Upload: {0}/{1} Bytes ({2} Writes), Faces Kept {3}, Rewritten {4}, Moved {5}, Freed {6}{7}",
+            stats.BytesUploaded, stats.BytesFull, stats.WriteCalls, stats.FacesKept, stats.FacesRewritten, stats.FacesMoved,
+            stats.FacesFreed, stats.Reallocations > 0 ? ", Reallocated" : "");
+        return va;
+    }
 
-            // 2. [关键] 记录 ID -> Edge 映射
-            mesh.m_IDToEdgeMap[edgeID] = edge;
+    // 性能测试会 Clean/重新离散，在独立的拓扑副本上进行 (共享几何，不带网格)
+    // 不动实体的形状：后台网格任务可能正在往同一批 TShape 上挂三角网格
+    static TopoDS_Shape CopyForBenchmark(const TopoDS_Shape& shape)
+    {
+        BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+        return copier.Shape();
+    }
 
-            BRepAdaptor_Curve curveAdaptor(edge);
-            GCPnts_TangentialDeflection discretizer;
-            discretizer.Initialize(curveAdaptor, deflection, 0.1);
+    void CADMesher::BenchmarkMeshing(const TopoDS_Shape& source, float deflection)
+    {
+        if (source.IsNull()) return;
+        TopoDS_Shape shape = CopyForBenchmark(source);
 
-            int nPoints = discretizer.NbPoints();
-            if (nPoints > 1)
+        using Clock = std::chrono::high_resolution_clock;
+        auto elapsedMs = [](Clock::time_point a, Clock::time_point b) { return std::chrono::duration<float, std::milli>(b - a).count(); };
+
+        // 1. 离散化：串行与并行 BRepMesh (每次先清掉已有的三角网格)
+        BRepTools::Clean(shape);
+        auto m0 = Clock::now();
+        BRepMesh_IncrementalMesh(shape, deflection, Standard_False, 0.5, Standard_False);
+        auto m1 = Clock::now();
+        BRepTools::Clean(shape);
+        BRepMesh_IncrementalMesh(shape, deflection, Standard_False, 0.5, Standard_True);
+        auto m2 = Clock::now();
+
+        // 2. 提取：三角网格已经存在 (BRepMesh 直接跳过)，只测量两遍提取的耗时
+        //    单线程结果作为基准，其它线程数的输出必须逐字节相同
+        auto measureExtract = [&](int threadCount, std::vector<CubeVertex>& vertices, std::vector<uint32_t>& indices) {
+            float best = 1e30f;
+            for (int run = 0; run < 3; run++)
             {
-                for (int i = 1; i < nPoints; i++)
-                {
-                    gp_Pnt p1 = discretizer.Value(i);
-                    gp_Pnt p2 = discretizer.Value(i + 1);
+                auto t0 = Clock::now();
+                BuildMeshData(shape, vertices, indices, deflection, threadCount, false);
+                best = std::min(best, elapsedMs(t0, Clock::now()));
+            }
+            return best;
+        };
 
-                    outLines.push_back({ {(float)p1.X(), (float)p1.Y(), (float)p1.Z()}, edgeID });
-                    outLines.push_back({ {(float)p2.X(), (float)p2.Y(), (float)p2.Z()}, edgeID });
+        std::vector<CubeVertex> refVertices, vertices;
+        std::vector<uint32_t> refIndices, indices;
+        float serialMs = measureExtract(1, refVertices, refIndices);
+
+        int faceCount = 0;
+        for (TopExp_Explorer explorer(shape, TopAbs_FACE); explorer.More(); explorer.Next()) faceCount++;
+
+        RONG_CORE_INFO("Meshing Benchmark: {0} Faces, {1} Vertices, {2} Triangles; BRepMesh Serial {3}ms, Parallel {4}ms (x{5:.2f})",
+            faceCount, refVertices.size(), refIndices.size() / 3, elapsedMs(m0, m1), elapsedMs(m1, m2),
+            elapsedMs(m0, m1) / std::max(elapsedMs(m1, m2), 1e-3f));
+        RONG_CORE_INFO("Meshing Benchmark [Extract x1 Thread]: {0}ms", serialMs);
+
+        // 线程数: 2, 4, 8 ... 以及全部核心
+        int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> threadCounts;
+        for (int t = 2; t < maxThreads; t *= 2) threadCounts.push_back(t);
+        if (maxThreads > 1) threadCounts.push_back(maxThreads);
+
+        for (int threadCount : threadCounts)
+        {
+            float ms = measureExtract(threadCount, vertices, indices);
+            bool identical = vertices.size() == refVertices.size() && indices.size() == refIndices.size() &&
+                std::memcmp(vertices.data(), refVertices.data(), vertices.size() * sizeof(CubeVertex)) == 0 &&
+                std::memcmp(indices.data(), refIndices.data(), indices.size() * sizeof(uint32_t)) == 0;
+
+            RONG_CORE_INFO("Meshing Benchmark [Extract x{0} Threads]: {1}ms, Speedup x{2:.2f}, Identical: {3}",
+                threadCount, ms, serialMs / std::max(ms, 1e-3f), identical);
+            if (!identical)
+                RONG_CORE_ERROR("Meshing Benchmark: parallel extraction with {0} threads differs from the serial output!", threadCount);
+        }
+    }
+
+    void CADMesher::BenchmarkFilletRebuild(const TopoDS_Shape& source, float deflection, float radius)
+    {
+        if (source.IsNull()) return;
+        TopoDS_Shape shape = CopyForBenchmark(source);
+
+        // 1. 对第一条能倒角的边做倒角，得到 "只改了几个面" 的新形状 (按倒角历史延续面的编号)
+        TopologyIndex topology(shape);
+        TopoDS_Shape filleted;
+        Handle(BRepTools_History) history;
+        for (TopExp_Explorer explorer(shape, TopAbs_EDGE); explorer.More() && filleted.IsNull(); explorer.Next())
+        {
+            try
+            {
+                BRepFilletAPI_MakeFillet filletMaker(shape);
+                filletMaker.Add(radius, TopoDS::Edge(explorer.Current()));
+                filletMaker.Build();
+                if (filletMaker.IsDone())
+                {
+                    filleted = filletMaker.Shape();
+                    history = TopologyIndex::MakeHistory(shape, filletMaker);
                 }
             }
-            explorer.Next();
-            edgeID++;
+            catch (Standard_Failure&) {}
+        }
+        if (filleted.IsNull())
+        {
+            RONG_CORE_WARN("Fillet Rebuild Benchmark: no edge accepts radius {0}", radius);
+            return;
         }
 
-        if (outLines.empty()) return nullptr;
+        using Clock = std::chrono::high_resolution_clock;
+        std::vector<CubeVertex> vertices;
+        std::vector<uint32_t> indices;
+
+        // 2. 之前的做法：Clean 后整体重新离散
+        BRepTools::Clean(filleted);
+        auto t0 = Clock::now();
+        BuildMeshData(filleted, vertices, indices, deflection, 0, false);
+        auto t1 = Clock::now();
+
+        // 3. 缓存：原形状先离散一次 (倒角前的状态)，倒角后只有被修改的面需要重新离散
+        TopologyIndex filletedTopology(filleted, topology, history);
+        std::vector<CubeVertex> oldVertices;
+        std::vector<uint32_t> oldIndices;
+        BRepTools::Clean(filleted);
+        BuildMeshData(topology, oldVertices, oldIndices, deflection);
+        auto t2 = Clock::now();
+        BuildMeshData(filletedTopology, vertices, indices, deflection);
+        auto t3 = Clock::now();
+
+        // 4. 显存：倒角前的网格先整体上传，倒角后的网格只上传变化的面
+        MeshBuffer buffer;
+        buffer.update(oldVertices, oldIndices);
+        auto u0 = Clock::now();
+        buffer.update(vertices, indices);
+        auto u1 = Clock::now();
+        MeshBuffer::UpdateStats upload = buffer.getLastStats();
+
+        auto stats = GetMeshCacheStats();
+
+        // 5. 撤销：命令按值保存倒角前的形状 (共享 TShape)，恢复后所有面都应该命中缓存
+        std::vector<CubeVertex> undoVertices;
+        std::vector<uint32_t> undoIndices;
+        auto t4 = Clock::now();
+        BuildMeshData(topology, undoVertices, undoIndices, deflection);
+        auto t5 = Clock::now();
+        auto undoStats = GetMeshCacheStats();
+
+        int faceCount = 0;
+        for (TopExp_Explorer explorer(filleted, TopAbs_FACE); explorer.More(); explorer.Next()) faceCount++;
+
+        float fullMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+        float cachedMs = std::chrono::duration<float, std::milli>(t3 - t2).count();
+        RONG_CORE_INFO("Fillet Rebuild Benchmark: {0} Faces, Full Remesh {1}ms, Cached {2}ms (x{3:.2f}), {4}/{5} Faces Reused",
+            faceCount, fullMs, cachedMs, fullMs / std::max(cachedMs, 1e-3f), stats.LastHits, stats.LastHits + stats.LastMisses);
+        RONG_CORE_INFO("Fillet Rebuild Benchmark [Undo]: {0}ms, {1}/{2} Faces Reused, Output Identical: {3}",
+            std::chrono::duration<float, std::milli>(t5 - t4).count(), undoStats.LastHits, undoStats.LastHits + undoStats.LastMisses,
+            undoVertices.size() == oldVertices.size() && undoIndices == oldIndices);
+        RONG_CORE_INFO("Fillet Rebuild Benchmark [Upload]: {0} / {1} Bytes ({2:.1f}%), {3} Writes, Faces Kept {4}, Rewritten {5}, Moved {6}, Freed {7}, Reallocated: {8}, {9}ms",
+            upload.BytesUploaded, upload.BytesFull, 100.0 * (double)upload.BytesUploaded / (double)std::max<uint64_t>(upload.BytesFull, 1),
+            upload.WriteCalls, upload.FacesKept, upload.FacesRewritten, upload.FacesMoved, upload.FacesFreed, upload.Reallocations > 0,
+            std::chrono::duration<float, std::milli>(u1 - u0).count());
+    }
 
-        Ref<VertexArray> va = VertexArray::create();
-        Ref<VertexBuffer> vb = VertexBuffer::create((float*)outLines.data(), (uint32_t)(outLines.size() * sizeof(LineVertex)));
-        vb->setLayout({
-            { ShaderDataType::Float3, "a_Position" },
-            { ShaderDataType::Int,    "a_EntityID" }
-            });
-        va->addVertexBuffer(vb);
-        return va;
+    void CADMesher::ReportMeshMemory(const std::string& filepath, float deflection)
+    {
+        std::string extension = std::filesystem::path(filepath).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+        if (extension == ".stp" || extension == ".step")
+        {
+            TopoDS_Shape shape = CADImporter::ImportSTEP(filepath);
+            if (shape.IsNull())
+            {
+                RONG_CORE_WARN("Mesh Memory: failed to import {0}", filepath);
+                return;
+            }
+
+            std::vector<CubeVertex> vertices;
+            std::vector<uint32_t> indices;
+            BuildMeshData(shape, vertices, indices, deflection, 0, false);
+            MeasureMeshMemory(vertices, indices).Log(filepath.c_str());
+        }
+        else if (extension == ".rong")
+        {
+            // 在临时场景里加载，后台网格任务全部完成后再统计
+            Ref<Scene> scene = CreateRef<Scene>();
+            SceneSerializer serializer(scene);
+            if (!serializer.Deserialize(filepath))
+            {
+                RONG_CORE_WARN("Mesh Memory: failed to load {0}", filepath);
+                return;
+            }
+            MeshJobSystem::WaitAll();
+            MeshJobSystem::Update(scene.get());
+            ReportSceneMeshMemory(scene.get(), filepath.c_str());
+        }
+        else
+        {
+            RONG_CORE_WARN("Mesh Memory: unsupported file {0}", filepath);
+        }
     }
 
-    //传入引用
-    Ref<VertexArray> CADMesher::CreateEdgeMeshFromShape(
-        const TopoDS_Shape& shape,
-        std::vector<LineVertex>& outLines,
-        std::map<int, TopoDS_Edge>& outEdgeMap, // <--- 接收 Map
+    void CADMesher::ReportSceneMeshMemory(Scene* scene, const char* name)
+    {
+        if (!scene) return;
+
+        MeshMemoryReport total;
+        auto view = scene->getRegistry().view<MeshComponent>();
+        for (auto entityHandle : view)
+        {
+            const auto& mesh = view.get<MeshComponent>(entityHandle);
+            if (mesh.LocalVertices.empty() || mesh.LocalIndices.empty()) continue;
+            total.Add(MeasureMeshMemory(mesh.LocalVertices, mesh.LocalIndices));
+        }
+
+        if (total.Triangles == 0)
+        {
+            RONG_CORE_WARN("Mesh Memory [{0}]: no meshes", name);
+            return;
+        }
+        total.Log(name);
+    }
+
+    void CADMesher::BuildEdgeData(const TopologyIndex& topology, std::vector<LineVertex>& outLines, std::vector<uint32_t>& outIndices,
         float deflection)
     {
         outLines.clear();
-        outEdgeMap.clear(); // 1. 务必先清空，防止残留旧数据
+        outIndices.clear();
 
-        int edgeID = 0; // 这里的 ID 必须从 0 开始，和 Shader/Pixel 读取逻辑一致
+        // 1. 索引表里每条边只出现一次 (TopExp_Explorer 会在每个相邻面上各访问一次共享边)
+        //    EdgeID = 在索引表中的下标 - 1 (从 0 开始，和 Shader/Pixel 读取逻辑一致)
+        const TopTools_IndexedMapOfShape& edgeMap = topology.GetEdgeMap();
+        const int edgeCount = edgeMap.Extent();
 
-        // 2. 遍历所有边
-        TopExp_Explorer explorer(shape, TopAbs_EDGE);
-        while (explorer.More())
-        {
-            const TopoDS_Edge& edge = TopoDS::Edge(explorer.Current());
+        // 2. 各条边并发离散 (只读形状)
+        //    面已经离散过时直接取边在三角网格上的折线：不用重新采样，并且和面片的接缝完全重合
+        std::vector<std::vector<glm::vec3>> polylines(edgeCount);
+        std::vector<int> edgeIndices(edgeCount);
+        std::iota(edgeIndices.begin(), edgeIndices.end(), 0);
 
-            // 3. 【核心】建立映射关系：ID -> Edge
-            outEdgeMap[edgeID] = edge;
+        std::for_each(std::execution::par, edgeIndices.begin(), edgeIndices.end(), [&](int i) {
+            const TopoDS_Edge& edge = TopoDS::Edge(edgeMap(i + 1));
+            if (BRep_Tool::Degenerated(edge)) return;
 
-            // --- 下面是原本的离散化逻辑 ---
+            auto& points = polylines[i];
+
+            Handle(Poly_PolygonOnTriangulation) polygon;
+            Handle(Poly_Triangulation) triangulation;
+            TopLoc_Location location;
+            BRep_Tool::PolygonOnTriangulation(edge, polygon, triangulation, location);
+            if (!polygon.IsNull() && !triangulation.IsNull())
+            {
+                const TColStd_Array1OfInteger& nodes = polygon->Nodes();
+                const gp_Trsf& trsf = location.Transformation();
+                points.reserve(nodes.Length());
+                for (int n = nodes.Lower(); n <= nodes.Upper(); n++)
+                {
+                    gp_Pnt p = triangulation->Node(nodes(n)).Transformed(trsf);
+                    points.push_back({ (float)p.X(), (float)p.Y(), (float)p.Z() });
+                }
+                return;
+            }
+
+            // 没有三角网格 (曲线/草图)：按切向偏差离散
+            // angularDeflection: 0.1 弧度 (约 5.7 度)
             BRepAdaptor_Curve curveAdaptor(edge);
             GCPnts_TangentialDeflection discretizer;
             discretizer.Initialize(curveAdaptor, deflection, 0.1);
-
-            int nPoints = discretizer.NbPoints();
-            if (nPoints > 1)
+            points.reserve(discretizer.NbPoints());
+            for (int n = 1; n <= discretizer.NbPoints(); n++)
             {
-                for (int i = 1; i < nPoints; i++)
-                {
-                    gp_Pnt p1 = discretizer.Value(i);
-                    gp_Pnt p2 = discretizer.Value(i + 1);
+                gp_Pnt p = discretizer.Value(n);
+                points.push_back({ (float)p.X(), (float)p.Y(), (float)p.Z() });
+            }
+        });
 
-                    // 写入顶点数据，注意这里写入了 edgeID
-                    LineVertex v1, v2;
-                    v1.Position = { (float)p1.X(), (float)p1.Y(), (float)p1.Z() };
-                    v1.EntityID = edgeID;
+        // 3. 按 EdgeID 顺序拼成线带：同一条边的相邻线段共享顶点，边与边之间插入重启索引
+        size_t totalPoints = 0;
+        for (const auto& points : polylines) totalPoints += points.size();
+        outLines.reserve(totalPoints);
+        outIndices.reserve(totalPoints + edgeCount);
 
-                    v2.Position = { (float)p2.X(), (float)p2.Y(), (float)p2.Z() };
-                    v2.EntityID = edgeID;
+        for (int i = 0; i < edgeCount; i++)
+        {
+            const auto& points = polylines[i];
+            if (points.size() < 2) continue;
 
-                    outLines.push_back(v1);
-                    outLines.push_back(v2);
-                }
+            if (!outIndices.empty()) outIndices.push_back(LineStripRestartIndex);
+            for (const auto& p : points)
+            {
+                outIndices.push_back((uint32_t)outLines.size());
+                outLines.push_back({ p, i });
             }
-            // -----------------------------
-
-            explorer.Next();
-            edgeID++; // ID 自增
         }
+    }
 
-        if (outLines.empty()) return nullptr;
+    void CADMesher::RebuildEdges(MeshComponent& mesh, CADGeometryComponent& cad, float deflection)
+    {
+        const TopologyIndex* topology = TopologyIndex::Get(cad);
+        if (!topology)
+        {
+            mesh.ClearEdges();
+            return;
+        }
 
-        // 创建 VA/VB ...
-        Ref<VertexArray> va = VertexArray::create();
-        Ref<VertexBuffer> vb = VertexBuffer::create((float*)outLines.data(), (uint32_t)(outLines.size() * sizeof(LineVertex)));
-        vb->setLayout({
-            { ShaderDataType::Float3, "a_Position" },
-            { ShaderDataType::Int,    "a_EntityID" }
-            });
-        va->addVertexBuffer(vb);
-        return va;
+        std::vector<LineVertex> lines;
+        std::vector<uint32_t> indices;
+        BuildEdgeData(*topology, lines, indices, deflection);
+        mesh.SetEdges(std::move(lines), std::move(indices));
     }
 
-    void CADMesher::ApplyFillet(Entity entity, int edgeID, float radius)
+    TopologyRemap CADMesher::ApplyFillet(Entity entity, int edgeID, float radius)
     {
         // 1. 基础组件检查
         if (!entity.HasComponent<CADGeometryComponent>() || !entity.HasComponent<MeshComponent>())
-            return;
+            return {};
 
         auto& cad = entity.GetComponent<CADGeometryComponent>();
         auto& mesh = entity.GetComponent<MeshComponent>();
@@ -337,53 +872,32 @@ namespace Rongine {
         TopoDS_Shape* currentShape = static_cast<TopoDS_Shape*>(cad.ShapeHandle);
         if (!currentShape || currentShape->IsNull()) {
             RONG_CORE_ERROR("ApplyFillet: Invalid Shape Handle.");
-            return;
+            return {};
         }
 
         // 2. 参数检查
         if (edgeID < 0) {
             RONG_CORE_WARN("ApplyFillet: Invalid Edge ID (-1).");
-            return;
+            return {};
         }
         if (radius <= 0.001f) {
             RONG_CORE_WARN("ApplyFillet: Radius is too small or negative.");
-            return;
-        }
-
-        // 3. 从 Map 中查找边
-        if (mesh.m_IDToEdgeMap.find(edgeID) == mesh.m_IDToEdgeMap.end())
-        {
-            RONG_CORE_WARN("ApplyFillet: Edge ID {0} not found in map! (Map size: {1})", edgeID, mesh.m_IDToEdgeMap.size());
-            return;
-        }
-
-        // 获取 Map 中记录的边 (这可能是一个过期的拓扑引用)
-        TopoDS_Edge targetEdge = mesh.m_IDToEdgeMap[edgeID];
-
-        // =========================================================================================
-        // 安全性检查：验证这条边是否真的属于当前的 Shape
-        // 防止因为 Map 数据未及时更新，或者拓扑结构改变(如连续倒角)导致的野指针崩溃
-        // =========================================================================================
-        bool isEdgeValid = false;
-        TopExp_Explorer checkExp(*currentShape, TopAbs_EDGE);
-        while (checkExp.More())
-        {
-            // IsSame 检查底层的 TShape 指针是否一致
-            if (checkExp.Current().IsSame(targetEdge))
-            {
-                isEdgeValid = true;
-                break;
-            }
-            checkExp.Next();
+            return {};
         }
 
-        if (!isEdgeValid)
+        // 3. 从拓扑索引表中取边
+        // TopologyIndex::Get 保证索引表和当前形状是同一个版本 (形状被替换过会重建)，
+        // 所以取到的边一定属于当前拓扑，不会拿到连续倒角前的过期边
+        const TopologyIndex* topology = TopologyIndex::Get(cad);
+        if (!topology->IsValidEdge(edgeID))
         {
-            RONG_CORE_ERROR("CRITICAL: Safety Check Failed! Edge {0} does not belong to current shape topology.", edgeID);
+            RONG_CORE_WARN("ApplyFillet: Edge ID {0} out of range! (Edge count: {1})", edgeID, topology->GetEdgeCount());
             RONG_CORE_WARN("Please re-select the edge.");
-            return; // 强制返回，避免崩溃
+            return {};
         }
 
+        TopoDS_Edge targetEdge = topology->GetEdge(edgeID);
+
         // 4. 执行倒角操作
         try
         {
@@ -401,7 +915,7 @@ namespace Rongine {
                 // B. 检查结果是否有效 (防止生成空形状)
                 if (newShape.IsNull()) {
                     RONG_CORE_ERROR("Fillet result is null.");
-                    return;
+                    return {};
                 }
 
                 // C. 更新 CAD 组件数据
@@ -409,10 +923,16 @@ namespace Rongine {
                 // delete currentShape; 
                 *currentShape = newShape; // 或者直接覆盖内容
 
-                // D. 调用重建函数刷新渲染 (这会清空 Map 并重新生成 ID)
+                // D. 按倒角的修改历史延续面/边 ID：没被波及的面 ID 不变，网格缓存按 TShape 直接复用
+                TopologyRemap remap = TopologyIndex::Transfer(cad, TopologyIndex::MakeHistory(topology->GetShape(), filletMaker));
+
+                // E. 调用重建函数刷新渲染
                 RebuildMesh(entity);
 
                 RONG_CORE_INFO("Success: Fillet applied to Edge {0} with Radius {1}", edgeID, radius);
+                RONG_CORE_INFO("Topology Remap: {0} Faces Kept, {1} Modified, {2} Deleted, {3} Generated",
+                    remap.KeptFaces, remap.ModifiedFaces, remap.DeletedFaces, remap.GeneratedFaces);
+                return remap;
             }
             else
             {
@@ -432,6 +952,7 @@ namespace Rongine {
         {
             RONG_CORE_ERROR("Unknown Crash occurred during Fillet operation.");
         }
+        return {};
     }
 
 
@@ -448,36 +969,43 @@ namespace Rongine {
         // 获取最新的几何形状
         TopoDS_Shape* shapePtr = static_cast<TopoDS_Shape*>(cad.ShapeHandle);
         if (!shapePtr || shapePtr->IsNull()) return;
-        const TopoDS_Shape& shape = *shapePtr;
 
-        BRepTools::Clean(shape);
+        // 拓扑索引表：建模操作已经通过 TopologyIndex::Transfer 延续了旧 ID 时直接用，否则按当前形状新建
+        const TopologyIndex* topology = TopologyIndex::Get(cad);
+
+        // 后台还有这个实体的网格任务：作废并等它退出，避免两个线程同时离散同一个形状
+        MeshJobSystem::Cancel(entity);
+        mesh.MeshPending = false;
+
+        // 不再 BRepTools::Clean 整个形状：没被修改的面由三角网格缓存直接复用
+        auto startTime = std::chrono::high_resolution_clock::now();
 
         // 3. 清理 Mesh 组件的旧数据
-        mesh.m_IDToEdgeMap.clear();
-        mesh.LocalLines.clear();
-        mesh.LocalVertices.clear();
-        mesh.LocalIndices.clear();
+        mesh.SetGeometry({}, {});
 
         // 4. 尝试生成面片网格 (Face Mesh)
         std::vector<CubeVertex> newVertices;
         std::vector<uint32_t> newIndices;
 
-        // 使用组件里存的精度参数
-        Ref<VertexArray> faceVA = CreateMeshFromShape(shape, newVertices, newIndices, cad.LinearDeflection);
+        // 使用组件里存的精度参数；显存只更新内容变化的面
+        BuildMeshData(*topology, newVertices, newIndices, cad.LinearDeflection);
+        Ref<VertexArray> faceVA = UpdateMeshVertexArray(mesh, newVertices, newIndices);
 
         // 更新 VA 和 CPU 数据
         // 如果 faceVA 是空的 (nullptr)，说明这个物体没有面 (是纯线框)，mesh.VA 也会变成 nullptr
         // 如果 faceVA 有数据 (实体)，mesh.VA 就会被赋值
         mesh.VA = faceVA;
-        mesh.LocalVertices = newVertices;
-        mesh.LocalIndices = newIndices;
+        mesh.SetGeometry(std::move(newVertices), std::move(newIndices));
 
-        // 5. 重新生成边框网格 (Edge Mesh) 并重建 m_IDToEdgeMap
+        // 5. 重新生成边框线 (拓扑索引表随形状版本自动重建)
         // 无论是实体还是曲线，这一步都会生成线条
-        mesh.EdgeVA = CreateEdgeMeshFromShape(entity, shape, mesh.LocalLines, cad.LinearDeflection);
+        RebuildEdges(mesh, cad, cad.LinearDeflection);
 
-        RONG_CORE_INFO("Rebuild Complete. Faces: {0}, Edges: {1}",
-            (mesh.VA ? "Yes" : "No"), mesh.m_IDToEdgeMap.size());
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        auto cacheStats = GetMeshCacheStats();
+        RONG_CORE_INFO("Rebuild Complete. Faces: {0}, Edges: {1}, Mesh Cache {2}/{3} Faces Reused, {4}ms",
+            (mesh.VA ? "Yes" : "No"), topology->GetEdgeCount(),
+            cacheStats.LastHits, cacheStats.LastHits + cacheStats.LastMisses, ms);
     }
 
 
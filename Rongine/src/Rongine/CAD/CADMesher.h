@@ -7,7 +7,9 @@
 
 // 引入 TopoDS_Shape 定义，方便外部调用
 #include <TopoDS_Shape.hxx>
+#include <Message_ProgressRange.hxx>
 #include "Rongine/Scene/Entity.h"
+#include "TopologyIndex.h"
 
 class TopoDS_Shape;
 
@@ -19,12 +21,61 @@ namespace Rongine {
 		// 输入：OCCT 形状
 		// 输出：一个可以在 OpenGL 里画出来的 VertexArray
 		static Ref<VertexArray> CreateMeshFromShape(const TopoDS_Shape& shape, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection = 0.1f);
+		// FaceID 按拓扑索引表编号 (组件上的表在建模操作后会延续旧 ID)
+		static Ref<VertexArray> CreateMeshFromShape(const TopologyIndex& topology, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection = 0.1f);
 
-		static Ref<VertexArray> CreateEdgeMeshFromShape(const TopoDS_Shape& shape, std::vector<LineVertex>& outLines, float deflection = 0.1f);
-		static Ref<VertexArray> CreateEdgeMeshFromShape(Entity entity, const TopoDS_Shape& shape, std::vector<LineVertex>& outLines, float deflection);
-		static Ref<VertexArray> CreateEdgeMeshFromShape(const TopoDS_Shape& shape,std::vector<LineVertex>& outLines,std::map<int, TopoDS_Edge>& outEdgeMap,float deflection);
+		// 只做离散化和顶点/索引提取，不创建 GL 资源
+		// 两遍提取：先统计每个面的顶点/三角形数量并求前缀和，再各个面并发写入预分配的缓冲区
+		// threadCount: 0 = 全部核心，1 = 串行；输出与线程数无关 (逐字节相同)
+		// useCache: 按面的 TShape + 精度缓存三角网格和提取结果，没被修改的面直接复用
+		// progress: 传给 BRepMesh，UserBreak() 为真时中途退出并返回空结果 (后台任务取消)
+		static void BuildMeshData(const TopoDS_Shape& shape, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection = 0.1f, int threadCount = 0, bool useCache = true,
+			const Message_ProgressRange& progress = Message_ProgressRange());
+		static void BuildMeshData(const TopologyIndex& topology, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices, float deflection = 0.1f, int threadCount = 0, bool useCache = true,
+			const Message_ProgressRange& progress = Message_ProgressRange());
+		// 边的离散化 (CPU)，EdgeID 取自拓扑索引表
+		// 输出为带索引的线带：每条边一段折线 (相邻线段共享顶点)，边之间用 LineStripRestartIndex 断开
+		// 面已经离散过时直接复用边在三角网格上的折线，否则按 deflection 采样
+		static void BuildEdgeData(const TopologyIndex& topology, std::vector<LineVertex>& outLines, std::vector<uint32_t>& outIndices,
+			float deflection = 0.1f);
+		// 按组件当前形状 BuildEdgeData 并写入 MeshComponent (LocalLines/LocalLineIndices)，GL 资源由场景线缓冲统一管理
+		// 没有形状时清空边框线
+		static void RebuildEdges(MeshComponent& mesh, CADGeometryComponent& cad, float deflection = 0.1f);
 
-		static void ApplyFillet(Entity entity, int edgeID, float radius);
+		// 用 CPU 数据创建 GL 资源 (只能在主线程调用)
+		static Ref<VertexArray> CreateMeshVertexArray(const std::vector<CubeVertex>& vertices, const std::vector<uint32_t>& indices);
+		// 更新实体自己的网格显存 (MeshComponent::GPUBuffer)：只上传内容变化的面，返回新的 VA (主线程)
+		static Ref<VertexArray> UpdateMeshVertexArray(MeshComponent& mesh, ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices);
+
+		// 三角网格缓存统计
+		struct MeshCacheStats
+		{
+			uint64_t Hits = 0;         // 累计复用的面数
+			uint64_t Misses = 0;       // 累计重新离散的面数
+			uint32_t LastHits = 0;     // 最近一次构建
+			uint32_t LastMisses = 0;
+			uint32_t Entries = 0;
+			uint64_t CachedTriangles = 0;
+
+			float GetHitRate() const { return Hits + Misses > 0 ? (float)Hits / (float)(Hits + Misses) : 0.0f; }
+		};
+		static MeshCacheStats GetMeshCacheStats();
+		static void ClearMeshCache();
+
+		// 性能测试：串行/并行 BRepMesh 耗时，以及不同线程数下提取的加速比 (并校验输出一致)
+		// 两个性能测试都在形状的拓扑副本上运行，不修改传入的形状
+		static void BenchmarkMeshing(const TopoDS_Shape& shape, float deflection = 0.1f);
+
+		// 性能测试：单条边倒角后重建网格，整体重新离散 vs 三角网格缓存，以及显存整体上传 vs 只上传变化的面
+		static void BenchmarkFilletRebuild(const TopoDS_Shape& shape, float deflection = 0.1f, float radius = 0.1f);
+
+		// 网格显存占用报告 (字节/三角形，结果输出到日志)：原始格式 vs 紧凑顶点 + 16 位索引，光追上传焊接前后
+		// filepath 支持 .stp/.step (按 deflection 离散) 和 .rong (在临时场景中加载)
+		static void ReportMeshMemory(const std::string& filepath, float deflection = 0.1f);
+		static void ReportSceneMeshMemory(Scene* scene, const char* name);
+
+		// 返回操作前后的 ID 对应关系 (失败时为空)，调用方据此更新选择
+		static TopologyRemap ApplyFillet(Entity entity, int edgeID, float radius);
 
 		static void RebuildMesh(Entity entity);
 
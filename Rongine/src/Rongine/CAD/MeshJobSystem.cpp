@@ -0,0 +1,426 @@
+#include "Rongpch.h"
+#include "MeshJobSystem.h"
+#include "CADMesher.h"
+#include "CADImporter.h"
+#include "Rongine/Core/Log.h"
+
+#include <Message_ProgressIndicator.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace Rongine {
+
+    // 取消标志通过 OCCT 的进度接口传给 BRepMesh，离散化途中轮询 UserBreak() 提前退出
+    class MeshJobProgress : public Message_ProgressIndicator
+    {
+    public:
+        MeshJobProgress(const std::shared_ptr<std::atomic<bool>>& cancelled) : m_Cancelled(cancelled) {}
+
+        Standard_Boolean UserBreak() override { return m_Cancelled->load(); }
+        void Show(const Message_ProgressScope&, const Standard_Boolean) override {}
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_Cancelled;
+    };
+
+    struct MeshJob
+    {
+        uint64_t ID = 0;
+        Scene* TargetScene = nullptr;
+        entt::entity Handle = entt::null;
+        TopoDS_Shape Shape; // LOD0: 与组件共享 TShape (会写入三角网格，主线程读写前先 Cancel/WaitAll)；粗 LOD: 独立的拓扑副本
+        Ref<TopologyIndex> Topology; // Shape 的拓扑索引表 (保持组件的 FaceID/EdgeID 编号)，为空时在工作线程按形状新建
+        float Deflection = 0.1f;
+        int Level = 0;
+        std::weak_ptr<VertexArray> Source; // 粗 LOD 是给哪个 LOD0 网格生成的
+        std::shared_ptr<std::atomic<bool>> Cancelled;
+    };
+
+    struct MeshJobResult
+    {
+        uint64_t ID = 0;
+        Scene* TargetScene = nullptr;
+        entt::entity Handle = entt::null;
+        int Level = 0;
+        std::weak_ptr<VertexArray> Source;
+
+        std::vector<CubeVertex> Vertices;
+        std::vector<uint32_t> Indices;
+        std::vector<LineVertex> Lines;
+        std::vector<uint32_t> LineIndices;
+        Ref<TopologyIndex> Topology; // LOD0：在工作线程构建，形状没被替换的话直接装到组件上
+        AABB BoundingBox;
+        float Milliseconds = 0.0f;
+    };
+
+    using MeshEntityKey = std::pair<Scene*, entt::entity>;
+    using MeshJobKey = std::tuple<Scene*, entt::entity, int>; // 同一实体每个 LOD 各有一个最新任务
+
+    struct MeshJobSystemData
+    {
+        std::thread Worker;
+        bool Running = false;
+
+        std::mutex Mutex;
+        std::condition_variable JobAvailable;
+        std::condition_variable JobFinished;
+
+        std::deque<MeshJob> Queue;
+        std::vector<MeshJobResult> Completed;
+
+        // 每个实体最新的任务，不在表里或 ID 对不上的结果一律丢弃
+        std::map<MeshJobKey, MeshJob> Pending;
+        uint64_t ActiveID = 0; // 工作线程正在处理的任务
+        MeshEntityKey ActiveKey = { nullptr, entt::null };
+
+        uint64_t NextID = 1;
+
+        // 没调用 Shutdown 就退出 (例如没有界面的离线渲染)：先停下工作线程，否则 std::thread 析构时会 terminate
+        ~MeshJobSystemData()
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Running = false;
+            }
+            JobAvailable.notify_all();
+            if (Worker.joinable())
+                Worker.join();
+        }
+    };
+
+    static MeshJobSystemData s_Data;
+
+    static void WorkerLoop()
+    {
+        while (true)
+        {
+            MeshJob job;
+            {
+                std::unique_lock<std::mutex> lock(s_Data.Mutex);
+                s_Data.JobAvailable.wait(lock, [] { return !s_Data.Running || !s_Data.Queue.empty(); });
+                if (!s_Data.Running) break;
+
+                job = std::move(s_Data.Queue.front());
+                s_Data.Queue.pop_front();
+                s_Data.ActiveID = job.ID;
+                s_Data.ActiveKey = { job.TargetScene, job.Handle };
+            }
+
+            MeshJobResult result;
+            if (!job.Cancelled->load())
+            {
+                auto startTime = std::chrono::high_resolution_clock::now();
+
+                // 粗 LOD 在副本上离散，不进面缓存，也不替换组件形状上 LOD0 的三角网格
+                Handle(MeshJobProgress) progress = new MeshJobProgress(job.Cancelled);
+                if (!job.Topology)
+                    job.Topology = CreateRef<TopologyIndex>(job.Shape);
+                CADMesher::BuildMeshData(*job.Topology, result.Vertices, result.Indices, job.Deflection, 0, job.Level == 0, progress->Start());
+
+                if (job.Level == 0 && !job.Cancelled->load())
+                {
+                    result.Topology = job.Topology;
+                    CADMesher::BuildEdgeData(*result.Topology, result.Lines, result.LineIndices, job.Deflection);
+                    // 三角网格已经生成，包围盒按网格计算更贴合
+                    result.BoundingBox = CADImporter::CalculateAABB(job.Shape);
+                }
+
+                result.ID = job.ID;
+                result.TargetScene = job.TargetScene;
+                result.Handle = job.Handle;
+                result.Level = job.Level;
+                result.Source = job.Source;
+                result.Milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(s_Data.Mutex);
+                if (!job.Cancelled->load())
+                    s_Data.Completed.push_back(std::move(result));
+                s_Data.ActiveID = 0;
+                s_Data.ActiveKey = { nullptr, entt::null };
+            }
+            s_Data.JobFinished.notify_all();
+        }
+    }
+
+    // 占位：包围盒的 12 条棱 (底面、顶面各一个闭合线带，加 4 条竖棱)
+    static void SetPlaceholderBox(MeshComponent& mesh, const AABB& box)
+    {
+        const glm::vec3& a = box.Min;
+        const glm::vec3& b = box.Max;
+        glm::vec3 corners[8] = {
+            { a.x, a.y, a.z }, { b.x, a.y, a.z }, { b.x, b.y, a.z }, { a.x, b.y, a.z },
+            { a.x, a.y, b.z }, { b.x, a.y, b.z }, { b.x, b.y, b.z }, { a.x, b.y, b.z },
+        };
+        const uint32_t R = LineStripRestartIndex;
+        std::vector<uint32_t> indices = {
+            0, 1, 2, 3, 0, R,
+            4, 5, 6, 7, 4, R,
+            0, 4, R, 1, 5, R, 2, 6, R, 3, 7,
+        };
+
+        std::vector<LineVertex> lines;
+        lines.reserve(8);
+        for (const auto& corner : corners)
+            lines.push_back({ corner, -1 }); // -1: 不对应任何边，拾取时忽略
+
+        mesh.SetEdges(std::move(lines), std::move(indices));
+    }
+
+    // 调用方持有锁；level < 0 时取消该实体的所有 LOD
+    static void CancelLocked(const MeshEntityKey& key, int level)
+    {
+        for (auto it = s_Data.Pending.begin(); it != s_Data.Pending.end();)
+        {
+            const auto& [scene, handle, jobLevel] = it->first;
+            if (scene != key.first || handle != key.second || (level >= 0 && jobLevel != level))
+            {
+                ++it;
+                continue;
+            }
+
+            it->second.Cancelled->store(true);
+            uint64_t id = it->second.ID;
+            it = s_Data.Pending.erase(it);
+
+            s_Data.Queue.erase(std::remove_if(s_Data.Queue.begin(), s_Data.Queue.end(),
+                [id](const MeshJob& job) { return job.ID == id; }), s_Data.Queue.end());
+        }
+    }
+
+    static uint64_t EnqueueJob(MeshJob& job, int cancelLevel)
+    {
+        uint64_t id;
+        {
+            std::lock_guard<std::mutex> lock(s_Data.Mutex);
+            CancelLocked({ job.TargetScene, job.Handle }, cancelLevel);
+
+            id = job.ID = s_Data.NextID++;
+            s_Data.Pending[{ job.TargetScene, job.Handle, job.Level }] = job;
+            s_Data.Queue.push_back(std::move(job));
+        }
+        s_Data.JobAvailable.notify_one();
+        return id;
+    }
+
+    void MeshJobSystem::Init()
+    {
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        if (s_Data.Running) return;
+
+        s_Data.Running = true;
+        s_Data.Worker = std::thread(WorkerLoop);
+    }
+
+    void MeshJobSystem::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_Data.Mutex);
+            if (!s_Data.Running) return;
+
+            for (auto& [key, job] : s_Data.Pending)
+                job.Cancelled->store(true);
+            s_Data.Pending.clear();
+            s_Data.Queue.clear();
+            s_Data.Completed.clear();
+            s_Data.Running = false;
+        }
+        s_Data.JobAvailable.notify_all();
+        if (s_Data.Worker.joinable())
+            s_Data.Worker.join();
+    }
+
+    uint64_t MeshJobSystem::Submit(Entity entity, const TopoDS_Shape& shape, float deflection)
+    {
+        if (!entity || shape.IsNull()) return 0;
+
+        Init(); // 懒启动 (离线渲染等没有 EditorLayer 的路径)
+
+        auto& mesh = entity.GetOrAddComponent<MeshComponent>();
+        mesh.MeshPending = true;
+
+        // 还没有任何网格：先用包围盒线框占位，旧网格则保留到新结果完成
+        if (!mesh.VA && !mesh.HasEdges())
+        {
+            mesh.BoundingBox = CADImporter::CalculateAABB(shape);
+            SetPlaceholderBox(mesh, mesh.BoundingBox);
+        }
+
+        MeshJob job;
+        job.TargetScene = entity.getScene();
+        job.Handle = (entt::entity)entity;
+        job.Shape = shape;
+        job.Deflection = deflection;
+        job.Cancelled = std::make_shared<std::atomic<bool>>(false);
+
+        // 组件上已有这个形状的索引表 (可能延续过建模操作前的 ID) 时沿用，保证网格里的 FaceID 和选择一致
+        if (entity.HasComponent<CADGeometryComponent>())
+        {
+            auto& cad = entity.GetComponent<CADGeometryComponent>();
+            if (cad.Topology && cad.Topology->IsBuiltFrom(shape))
+                job.Topology = cad.Topology;
+        }
+
+        // 同一实体的旧任务 (包括粗 LOD) 全部作废；单工作线程，不会同时离散同一个形状
+        return EnqueueJob(job, -1);
+    }
+
+    uint64_t MeshJobSystem::SubmitLOD(Entity entity, const TopoDS_Shape& shape, float deflection, int level)
+    {
+        if (!entity || shape.IsNull() || level <= 0 || !entity.HasComponent<MeshComponent>()) return 0;
+
+        auto& mesh = entity.GetComponent<MeshComponent>();
+        if (!mesh.VA) return 0;
+
+        Init();
+
+        MeshJob job;
+        job.TargetScene = entity.getScene();
+        job.Handle = (entt::entity)entity;
+        // 在主线程复制拓扑 (共享几何曲面，不带三角网格)：工作线程离散副本时不会和主线程争用原形状的三角网格
+        BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+        job.Shape = copier.Shape();
+        job.Deflection = deflection;
+
+        // 粗网格的 FaceID 要和 LOD0 一致：组件的索引表按复制历史搬到副本上
+        if (entity.HasComponent<CADGeometryComponent>())
+        {
+            auto& cad = entity.GetComponent<CADGeometryComponent>();
+            if (cad.Topology && cad.Topology->IsBuiltFrom(shape))
+                job.Topology = CreateRef<TopologyIndex>(job.Shape, *cad.Topology, TopologyIndex::MakeHistory(shape, copier));
+        }
+        job.Level = level;
+        job.Source = mesh.VA;
+        job.Cancelled = std::make_shared<std::atomic<bool>>(false);
+
+        return EnqueueJob(job, level);
+    }
+
+    void MeshJobSystem::Cancel(Entity entity)
+    {
+        if (!entity) return;
+
+        MeshEntityKey key = { entity.getScene(), (entt::entity)entity };
+        std::unique_lock<std::mutex> lock(s_Data.Mutex);
+        CancelLocked(key, -1);
+
+        // 等工作线程退出这个实体的任务，之后主线程才能安全地重新离散同一个形状
+        s_Data.JobFinished.wait(lock, [&] { return s_Data.ActiveKey != key; });
+
+        s_Data.Completed.erase(std::remove_if(s_Data.Completed.begin(), s_Data.Completed.end(),
+            [&](const MeshJobResult& result) { return result.TargetScene == key.first && result.Handle == key.second; }), s_Data.Completed.end());
+    }
+
+    void MeshJobSystem::CancelAll()
+    {
+        std::unique_lock<std::mutex> lock(s_Data.Mutex);
+        for (auto& [key, job] : s_Data.Pending)
+            job.Cancelled->store(true);
+        s_Data.Pending.clear();
+        s_Data.Queue.clear();
+        s_Data.Completed.clear();
+
+        s_Data.JobFinished.wait(lock, [] { return s_Data.ActiveID == 0; });
+    }
+
+    uint32_t MeshJobSystem::Update(Scene* scene)
+    {
+        std::vector<MeshJobResult> completed;
+        {
+            std::lock_guard<std::mutex> lock(s_Data.Mutex);
+            if (s_Data.Completed.empty()) return 0;
+
+            // 只取当前场景且仍是最新的结果，其他场景的留给它们自己的 Update
+            std::vector<MeshJobResult> others;
+            for (auto& result : s_Data.Completed)
+            {
+                auto it = s_Data.Pending.find({ result.TargetScene, result.Handle, result.Level });
+                if (it == s_Data.Pending.end() || it->second.ID != result.ID) continue;
+                if (result.TargetScene != scene)
+                {
+                    others.push_back(std::move(result));
+                    continue;
+                }
+
+                s_Data.Pending.erase(it);
+                completed.push_back(std::move(result));
+            }
+            s_Data.Completed = std::move(others);
+        }
+
+        uint32_t swapped = 0;
+        for (auto& result : completed)
+        {
+            if (!scene->getRegistry().valid(result.Handle)) continue;
+
+            Entity entity(result.Handle, scene);
+            if (!entity.HasComponent<MeshComponent>()) continue;
+
+            auto& mesh = entity.GetComponent<MeshComponent>();
+
+            // 粗 LOD：只有生成它的 LOD0 网格还在用时才装上，VA 被替换过就丢弃
+            if (result.Level > 0)
+            {
+                if (result.Source.expired() || result.Source.lock() != mesh.VA || result.Level > (int)mesh.CoarseLODs.size())
+                    continue;
+
+                auto& lod = mesh.CoarseLODs[result.Level - 1];
+                lod.VA = CADMesher::CreateMeshVertexArray(result.Vertices, result.Indices);
+                lod.TriangleCount = (uint32_t)(result.Indices.size() / 3);
+
+                RONG_CORE_TRACE("Mesh LOD{0} Ready: Entity {1}, {2} -> {3} Triangles, {4}ms", result.Level, (uint32_t)result.Handle,
+                    mesh.LocalIndices.size() / 3, lod.TriangleCount, result.Milliseconds);
+                continue;
+            }
+
+            mesh.VA = CADMesher::UpdateMeshVertexArray(mesh, result.Vertices, result.Indices);
+            mesh.SetGeometry(std::move(result.Vertices), std::move(result.Indices));
+            mesh.SetEdges(std::move(result.Lines), std::move(result.LineIndices));
+            mesh.BoundingBox = result.BoundingBox;
+            mesh.MeshPending = false;
+            swapped++;
+
+            if (result.Topology && entity.HasComponent<CADGeometryComponent>())
+            {
+                auto& cad = entity.GetComponent<CADGeometryComponent>();
+                TopoDS_Shape* shape = static_cast<TopoDS_Shape*>(cad.ShapeHandle);
+                if (shape && result.Topology->IsBuiltFrom(*shape))
+                    cad.Topology = result.Topology;
+            }
+
+            RONG_CORE_INFO("Background Mesh Ready: Entity {0}, {1} Triangles, {2} Edges, {3}ms",
+                (uint32_t)result.Handle, mesh.LocalIndices.size() / 3, result.Topology ? result.Topology->GetEdgeCount() : 0, result.Milliseconds);
+        }
+        return swapped;
+    }
+
+    void MeshJobSystem::WaitAll()
+    {
+        std::unique_lock<std::mutex> lock(s_Data.Mutex);
+        s_Data.JobFinished.wait(lock, [] { return s_Data.Queue.empty() && s_Data.ActiveID == 0; });
+    }
+
+    bool MeshJobSystem::IsPending(Entity entity)
+    {
+        if (!entity) return false;
+
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        return s_Data.Pending.find({ entity.getScene(), (entt::entity)entity, 0 }) != s_Data.Pending.end();
+    }
+
+    uint32_t MeshJobSystem::GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        return (uint32_t)s_Data.Pending.size();
+    }
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Rongine/Scene/Entity.h"
+
+#include <TopoDS_Shape.hxx>
+#include <cstdint>
+
+namespace Rongine {
+
+    // 后台网格任务：离散化 + 顶点/边提取放在工作线程，GL 资源在主线程的 Update 中创建
+    // 提交后实体先显示包围盒线框占位，网格完成后替换；同一实体的新任务或编辑会让旧任务作废
+    class MeshJobSystem
+    {
+    public:
+        static void Init();
+        static void Shutdown();
+
+        // 提交一个网格任务，返回任务 ID (形状为空时返回 0)
+        // 实体还没有任何网格时先装上包围盒线框占位 (MeshComponent::MeshPending = true)
+        static uint64_t Submit(Entity entity, const TopoDS_Shape& shape, float deflection);
+
+        // 提交粗 LOD (level >= 1) 的网格任务，结果装进 MeshComponent::CoarseLODs[level - 1]
+        // 只对当前的 VA 有效：完成前 VA 被替换 (重建/编辑) 的话结果会被丢弃
+        static uint64_t SubmitLOD(Entity entity, const TopoDS_Shape& shape, float deflection, int level);
+
+        // 取消实体的任务；如果工作线程正在处理它，等到离散化中途退出为止
+        // (三角网格挂在共享的 TShape 上，主线程接着同步重建同一个形状之前必须让出)
+        static void Cancel(Entity entity);
+        static void CancelAll();
+
+        // 主线程每帧调用：把完成的结果装进 MeshComponent，返回本次替换的实体数
+        static uint32_t Update(Scene* scene);
+
+        // 阻塞到队列清空 (离线渲染/测试用)，之后仍需调用 Update 才会创建 GL 资源
+        static void WaitAll();
+
+        static bool IsPending(Entity entity); // 只看 LOD0
+        static uint32_t GetPendingCount();
+    };
+
+}
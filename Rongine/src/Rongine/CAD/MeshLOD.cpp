@@ -0,0 +1,115 @@
+#include "Rongpch.h"
+#include "MeshLOD.h"
+#include "MeshJobSystem.h"
+#include "Rongine/Scene/Components.h"
+
+#include <TopoDS_Shape.hxx>
+
+#include <cmath>
+
+namespace Rongine {
+
+    static MeshLODStats s_Stats;
+
+    Ref<VertexArray> MeshLOD::Select(Entity entity, const glm::mat4& transform, const PerspectiveCamera& camera,
+        float viewportHeight, const MeshLODSettings& settings)
+    {
+        auto& mesh = entity.GetComponent<MeshComponent>();
+        uint32_t fullTriangles = (uint32_t)(mesh.LocalIndices.size() / 3);
+
+        s_Stats.Entities++;
+        s_Stats.FullTriangles += fullTriangles;
+
+        auto useFull = [&]() {
+            s_Stats.DrawnTriangles += fullTriangles;
+            s_Stats.LevelCounts[0]++;
+            return mesh.VA;
+        };
+
+        // 只有 CAD 实体才能按更大的弦高重新离散
+        if (!settings.Enabled || !mesh.VA || mesh.MeshPending || !entity.HasComponent<CADGeometryComponent>())
+            return useFull();
+
+        auto& cad = entity.GetComponent<CADGeometryComponent>();
+        const TopoDS_Shape* shape = static_cast<const TopoDS_Shape*>(cad.ShapeHandle);
+        if (!shape || shape->IsNull())
+            return useFull();
+
+        int levelCount = std::min(std::max(settings.LevelCount, 1), MeshLODSettings::MaxLevels);
+
+        // 1. LOD0 被替换 (重建/编辑/后台任务完成) 或级数变了：之前的粗网格全部作废
+        if (mesh.LODSource.lock() != mesh.VA || (int)mesh.CoarseLODs.size() != levelCount - 1)
+        {
+            mesh.CoarseLODs.assign(levelCount - 1, MeshComponent::LODLevel());
+            mesh.LODSource = mesh.VA;
+            mesh.CurrentLOD = 0;
+        }
+        for (int level = 1; level < levelCount; level++)
+            mesh.CoarseLODs[level - 1].Deflection = cad.LinearDeflection * std::pow(settings.DeflectionRatio, (float)level);
+
+        // 2. 包围球投影：球面上离相机最近的点处，一个世界单位对应多少像素
+        //    (投影矩阵 [1][1] = 1 / tan(fov / 2))
+        glm::vec3 scale = { glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) };
+        float maxScale = std::max(scale.x, std::max(scale.y, scale.z));
+        glm::vec3 center = glm::vec3(transform * glm::vec4(mesh.BoundingBox.GetCenter(), 1.0f));
+        float radius = glm::length(mesh.BoundingBox.GetSize()) * 0.5f * maxScale;
+        float distance = glm::length(center - camera.getPosition()) - radius;
+
+        // 相机在包围球内部：离得太近，直接用 LOD0
+        if (distance <= 1e-4f)
+        {
+            mesh.CurrentLOD = 0;
+            return useFull();
+        }
+
+        float pixelsPerUnit = camera.getProjectionMatrix()[1][1] * viewportHeight * 0.5f / distance;
+        auto pixelError = [&](int level) {
+            float deflection = level == 0 ? cad.LinearDeflection : mesh.CoarseLODs[level - 1].Deflection;
+            return deflection * maxScale * pixelsPerUnit;
+        };
+
+        // 3. 误差不超过阈值的最粗一级
+        int desired = 0;
+        while (desired + 1 < levelCount && pixelError(desired + 1) <= settings.MaxPixelError)
+            desired++;
+
+        // 4. 滞后：变精细立即切换 (当前级的误差已经超过阈值)，变粗要留出余量
+        int current = std::min(mesh.CurrentLOD, levelCount - 1);
+        while (desired > current && pixelError(desired) > settings.MaxPixelError * settings.Hysteresis)
+            desired--;
+        mesh.CurrentLOD = desired;
+
+        // 5. 需要的粗网格还没生成：提交后台任务，先画已有的更精细一级
+        int level = mesh.CurrentLOD;
+        if (level > 0)
+        {
+            auto& lod = mesh.CoarseLODs[level - 1];
+            if (!lod.VA && !lod.Requested)
+            {
+                lod.Requested = MeshJobSystem::SubmitLOD(entity, *shape, lod.Deflection, level) != 0;
+                s_Stats.Requested++;
+            }
+        }
+        while (level > 0 && !mesh.CoarseLODs[level - 1].VA)
+            level--;
+
+        if (level == 0)
+            return useFull();
+
+        const auto& lod = mesh.CoarseLODs[level - 1];
+        s_Stats.DrawnTriangles += lod.TriangleCount;
+        s_Stats.LevelCounts[level]++;
+        return lod.VA;
+    }
+
+    void MeshLOD::ResetStats()
+    {
+        s_Stats = MeshLODStats();
+    }
+
+    const MeshLODStats& MeshLOD::GetStats()
+    {
+        return s_Stats;
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Rongine/Scene/Entity.h"
+#include "Rongine/Renderer/PerspectiveCamera.h"
+#include "Rongine/Renderer/VertexArray.h"
+
+#include <glm/glm.hpp>
+
+namespace Rongine {
+
+    struct MeshLODSettings
+    {
+        bool Enabled = true;
+        int LevelCount = 4;            // 含 LOD0，最多 MaxLevels
+        float DeflectionRatio = 4.0f;  // 相邻两级的弦高倍数
+        float MaxPixelError = 1.0f;    // 允许的屏幕空间弦高误差 (像素)
+        float Hysteresis = 0.7f;       // 变粗时误差要低于 MaxPixelError * Hysteresis，避免在阈值附近来回跳
+
+        static const int MaxLevels = 8;
+    };
+
+    // 每帧统计 (GeometryPass 开始时清零)
+    struct MeshLODStats
+    {
+        uint32_t Entities = 0;
+        uint64_t DrawnTriangles = 0;
+        uint64_t FullTriangles = 0;    // 全部用 LOD0 时的三角形数
+        uint32_t LevelCounts[MeshLODSettings::MaxLevels] = {};
+        uint32_t Requested = 0;        // 本帧新提交的粗 LOD 任务
+    };
+
+    // 按投影到屏幕上的大小为 CAD 实体选择 LOD
+    // 物体离相机越远，一个世界单位对应的像素越少，弦高误差投影后低于阈值的最粗一级就够用
+    // 选中的粗网格还没生成时提交后台任务，并先画已有的更精细一级
+    class MeshLOD
+    {
+    public:
+        static Ref<VertexArray> Select(Entity entity, const glm::mat4& transform, const PerspectiveCamera& camera,
+            float viewportHeight, const MeshLODSettings& settings);
+
+        static void ResetStats();
+        static const MeshLODStats& GetStats();
+    };
+
+}
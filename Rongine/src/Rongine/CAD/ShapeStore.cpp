@@ -0,0 +1,420 @@
+#include "Rongpch.h"
+#include "ShapeStore.h"
+#include "Rongine/Core/Log.h"
+
+#include <BinTools.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <Standard_Version.hxx>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdio>
+
+namespace Rongine {
+
+    struct ShapeRecord
+    {
+        TopoDS_Shape Shape; // 持有 TShape 的引用，保证指针作为 key 期间不会被释放复用
+        std::string Path;
+        uint64_t LastUsed = 0;
+    };
+
+    struct ShapeStoreData
+    {
+        std::mutex Mutex;
+        std::unordered_map<const void*, std::vector<ShapeRecord>> Records; // key: TShape 指针
+        uint64_t Generation = 1; // 每次 CommitSave 加一
+        ShapeStore::Stats Stats;
+    };
+
+    static ShapeStoreData s_Store;
+
+    static const char* BlobExtension = ".bbrep";
+
+    static uint64_t HashBytes(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static std::string ToHex(uint64_t value)
+    {
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)value);
+        return buffer;
+    }
+
+    // 不带三角网格写出：同一个形状离散前后内容一样，哈希才稳定
+    static void WriteBinary(const TopoDS_Shape& shape, std::ostream& stream)
+    {
+#if OCC_VERSION_HEX >= 0x070600
+        BinTools::Write(shape, stream, Standard_False, Standard_False, BinTools_FormatVersion_CURRENT);
+#else
+        // 旧版 BinTools 总是写三角网格：复制拓扑 (共享几何，不带网格) 再写
+        BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+        BinTools::Write(copier.Shape(), stream);
+#endif
+    }
+
+    static ShapeRecord* FindRecord(const TopoDS_Shape& shape)
+    {
+        auto it = s_Store.Records.find(shape.TShape().get());
+        if (it == s_Store.Records.end()) return nullptr;
+        for (auto& record : it->second)
+            if (record.Shape.IsEqual(shape)) return &record;
+        return nullptr;
+    }
+
+    static void AddRecord(const TopoDS_Shape& shape, const std::string& filepath)
+    {
+        if (ShapeRecord* record = FindRecord(shape))
+        {
+            record->Path = filepath;
+            record->LastUsed = s_Store.Generation;
+            return;
+        }
+        s_Store.Records[shape.TShape().get()].push_back({ shape, filepath, s_Store.Generation });
+    }
+
+    static std::string GetRefsDirectory()
+    {
+        return ShapeStore::GetDirectory() + "/refs";
+    }
+
+    // 引用清单按场景绝对路径哈希命名，另存为时各有一份
+    static std::string GetRefsPath(const std::string& scenePath, std::string& outAbsolute)
+    {
+        std::error_code error;
+        outAbsolute = std::filesystem::absolute(scenePath, error).generic_string();
+        return GetRefsDirectory() + "/" + ToHex(HashBytes(outAbsolute.data(), outAbsolute.size())) + ".refs";
+    }
+
+    // 读清单里的文件名 (第一行是场景路径)；文件存在但读不出来时返回 false
+    static bool ReadRefs(const std::filesystem::path& refsPath, std::unordered_set<std::string>& outNames)
+    {
+        std::ifstream in(refsPath);
+        if (!in) return false;
+
+        std::string line;
+        std::getline(in, line);
+        while (std::getline(in, line))
+            if (!line.empty()) outNames.insert(line);
+        return !in.bad();
+    }
+
+    // 已有文件的内容是否就是 bytes (文件名相同只说明哈希和长度相同)
+    static bool SameContent(const std::string& filepath, const std::string& bytes)
+    {
+        std::ifstream in(filepath, std::ios::binary);
+        if (!in) return false;
+        std::string existing((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return existing == bytes;
+    }
+
+    // 候选文件中其它清单都没有提到的移进隔离区 (ownRefs 是刚更新过的清单，跳过)
+    // 没有清单的场景 (编辑器外复制的) 也可能还在用，所以不直接删除
+    static uint32_t QuarantineUnreferenced(std::unordered_set<std::string> candidates, const std::string& ownRefs)
+    {
+        if (candidates.empty()) return 0;
+
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(GetRefsDirectory(), error))
+        {
+            if (!entry.is_regular_file() || entry.path().extension() != ".refs") continue;
+            if (entry.path().filename() == std::filesystem::path(ownRefs).filename()) continue;
+
+            std::unordered_set<std::string> names;
+            if (!ReadRefs(entry.path(), names))
+            {
+                // 有清单读不出来就不移动，否则可能移走别的场景还在用的文件
+                RONG_CORE_WARN("BRep store references unreadable, skipping collection: {0}", entry.path().string());
+                return 0;
+            }
+            for (const auto& name : names)
+                candidates.erase(name);
+            if (candidates.empty()) return 0;
+        }
+        if (error)
+        {
+            RONG_CORE_WARN("BRep store references not listed, skipping collection: {0}", error.message());
+            return 0;
+        }
+
+        std::filesystem::create_directories(ShapeStore::GetQuarantineDirectory(), error);
+
+        uint32_t moved = 0;
+        for (const auto& name : candidates)
+        {
+            std::filesystem::rename(ShapeStore::GetDirectory() + "/" + name, ShapeStore::GetQuarantineDirectory() + "/" + name, error);
+            if (!error) moved++;
+        }
+
+        // 记住的形状指向被移走的文件时，下次保存会发现文件不在，Put 按内容把它移回来
+        std::lock_guard<std::mutex> lock(s_Store.Mutex);
+        s_Store.Stats.Quarantined += moved;
+        return moved;
+    }
+
+    const std::string& ShapeStore::GetDirectory()
+    {
+        static const std::string directory = "assets/cache/brep";
+        return directory;
+    }
+
+    const std::string& ShapeStore::GetQuarantineDirectory()
+    {
+        static const std::string directory = GetDirectory() + "/unreferenced";
+        return directory;
+    }
+
+    std::string ShapeStore::Put(const TopoDS_Shape& shape)
+    {
+        if (shape.IsNull()) return std::string();
+
+        std::lock_guard<std::mutex> lock(s_Store.Mutex);
+
+        // 1. 形状没变 (同一个 TShape) 且文件还在：不序列化、不写
+        if (ShapeRecord* record = FindRecord(shape))
+        {
+            if (std::filesystem::exists(record->Path))
+            {
+                record->LastUsed = s_Store.Generation;
+                s_Store.Stats.Unchanged++;
+                return record->Path;
+            }
+        }
+
+        // 2. 序列化到内存，按内容 (哈希 + 长度) 命名
+        std::ostringstream stream(std::ios::binary);
+        WriteBinary(shape, stream);
+        std::string bytes = stream.str();
+        if (bytes.empty())
+        {
+            RONG_CORE_ERROR("Failed to serialize shape for the BRep store");
+            return std::string();
+        }
+
+        // 3. 同样内容的文件已经存在 (其它实体共用/改回原样) 就不写，在隔离区里就移回来
+        //    同名文件内容不同 (哈希碰撞) 时加序号，不能把别的形状当成这一个
+        std::string stem = GetDirectory() + "/" + ToHex(HashBytes(bytes.data(), bytes.size())) + "-" + std::to_string(bytes.size());
+        std::string filepath;
+        bool found = false;
+        for (uint32_t n = 0; filepath.empty(); n++)
+        {
+            std::string candidate = stem + (n > 0 ? "-" + std::to_string(n) : std::string()) + BlobExtension;
+            std::string name = std::filesystem::path(candidate).filename().string();
+            std::string quarantined = GetQuarantineDirectory() + "/" + name;
+
+            if (std::filesystem::exists(candidate))
+            {
+                if (!SameContent(candidate, bytes)) continue;
+                found = true;
+            }
+            else if (std::filesystem::exists(quarantined))
+            {
+                if (!SameContent(quarantined, bytes)) continue;
+                std::error_code error;
+                std::filesystem::rename(quarantined, candidate, error);
+                found = !error;
+            }
+            filepath = candidate;
+        }
+
+        if (found)
+        {
+            s_Store.Stats.Shared++;
+        }
+        else
+        {
+            std::filesystem::create_directories(GetDirectory());
+
+            // 先写临时文件再改名，写到一半的文件不会被当成完整内容
+            std::string tempPath = filepath + ".tmp";
+            {
+                std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                out.write(bytes.data(), (std::streamsize)bytes.size());
+                if (!out)
+                {
+                    RONG_CORE_ERROR("Failed to write BRep file: {0}", filepath);
+                    return std::string();
+                }
+            }
+            std::error_code error;
+            std::filesystem::rename(tempPath, filepath, error);
+            if (error)
+            {
+                RONG_CORE_ERROR("Failed to write BRep file: {0} ({1})", filepath, error.message());
+                std::filesystem::remove(tempPath, error);
+                return std::string();
+            }
+
+            s_Store.Stats.Written++;
+            s_Store.Stats.BytesWritten += bytes.size();
+        }
+
+        AddRecord(shape, filepath);
+        return filepath;
+    }
+
+    bool ShapeStore::Parse(const std::string& filepath, const std::string& bytes, TopoDS_Shape& outShape)
+    {
+        outShape.Nullify();
+        std::istringstream stream(bytes);
+
+        if (std::filesystem::path(filepath).extension() == ".brep")
+        {
+            BRep_Builder builder;
+            BRepTools::Read(outShape, stream, builder);
+        }
+        else
+        {
+            BinTools::Read(outShape, stream);
+        }
+        return !outShape.IsNull();
+    }
+
+    void ShapeStore::Remember(const TopoDS_Shape& shape, const std::string& filepath)
+    {
+        if (shape.IsNull() || !IsStorePath(filepath)) return;
+
+        std::lock_guard<std::mutex> lock(s_Store.Mutex);
+        AddRecord(shape, filepath);
+    }
+
+    bool ShapeStore::IsStorePath(const std::string& filepath)
+    {
+        std::filesystem::path path(filepath);
+        return path.extension() == BlobExtension && path.parent_path().generic_string() == GetDirectory();
+    }
+
+    bool ShapeStore::Restore(const std::string& filepath)
+    {
+        std::error_code error;
+        if (std::filesystem::exists(filepath, error)) return true;
+        if (!IsStorePath(filepath)) return false;
+
+        // 加载可能在工作线程并行进行，和 Put 一样在锁里移动文件
+        std::lock_guard<std::mutex> lock(s_Store.Mutex);
+        if (std::filesystem::exists(filepath, error)) return true;
+
+        std::string quarantined = GetQuarantineDirectory() + "/" + std::filesystem::path(filepath).filename().string();
+        if (!std::filesystem::exists(quarantined, error)) return false;
+
+        std::filesystem::rename(quarantined, filepath, error);
+        if (error)
+        {
+            RONG_CORE_ERROR("Failed to restore BRep file from quarantine: {0} ({1})", filepath, error.message());
+            return false;
+        }
+        RONG_CORE_INFO("BRep file restored from quarantine: {0}", filepath);
+        return true;
+    }
+
+    void ShapeStore::CommitSave(const std::string& scenePath, const std::vector<std::string>& blobPaths)
+    {
+        // 这次保存没用到的形状记录 (已关闭的场景、被替换的形状) 不再持有
+        {
+            std::lock_guard<std::mutex> lock(s_Store.Mutex);
+            for (auto it = s_Store.Records.begin(); it != s_Store.Records.end();)
+            {
+                auto& records = it->second;
+                records.erase(std::remove_if(records.begin(), records.end(),
+                    [](const ShapeRecord& record) { return record.LastUsed < s_Store.Generation; }), records.end());
+                it = records.empty() ? s_Store.Records.erase(it) : std::next(it);
+            }
+            s_Store.Generation++;
+        }
+
+        UpdateReferences(scenePath, blobPaths);
+    }
+
+    void ShapeStore::UpdateReferences(const std::string& scenePath, const std::vector<std::string>& blobPaths)
+    {
+        std::string absolute;
+        std::string refsPath = GetRefsPath(scenePath, absolute);
+
+        std::unordered_set<std::string> current;
+        for (const auto& blob : blobPaths)
+            if (IsStorePath(blob)) current.insert(std::filesystem::path(blob).filename().string());
+
+        // 1. 上一次保存的清单：只有其中不再引用的文件才移进隔离区
+        std::error_code error;
+        std::unordered_set<std::string> previous;
+        if (std::filesystem::exists(refsPath, error) && !ReadRefs(refsPath, previous))
+        {
+            RONG_CORE_ERROR("Failed to read BRep store references: {0}", refsPath);
+            return;
+        }
+
+        // 2. 写新的清单：第一行是场景的绝对路径，之后每行一个文件名 (先写临时文件再改名)
+        std::filesystem::create_directories(GetRefsDirectory(), error);
+        std::string tempPath = refsPath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::trunc);
+            out << absolute << "\n";
+            for (const auto& name : current)
+                out << name << "\n";
+            if (!out)
+            {
+                // 清单不完整时不能移动，否则可能移走这个场景还在用的文件
+                RONG_CORE_ERROR("Failed to write BRep store references: {0}", refsPath);
+                return;
+            }
+        }
+        std::filesystem::rename(tempPath, refsPath, error);
+        if (error)
+        {
+            RONG_CORE_ERROR("Failed to write BRep store references: {0} ({1})", refsPath, error.message());
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+
+        // 3. 不再引用的文件移进隔离区
+        for (const auto& name : current)
+            previous.erase(name);
+        QuarantineUnreferenced(std::move(previous), refsPath);
+    }
+
+    void ShapeStore::ReleaseScene(const std::string& scenePath)
+    {
+        std::string absolute;
+        std::string refsPath = GetRefsPath(scenePath, absolute);
+
+        std::error_code error;
+        std::unordered_set<std::string> previous;
+        if (!std::filesystem::exists(refsPath, error)) return;
+        if (!ReadRefs(refsPath, previous))
+        {
+            RONG_CORE_ERROR("Failed to read BRep store references: {0}", refsPath);
+            return;
+        }
+
+        std::filesystem::remove(refsPath, error);
+        QuarantineUnreferenced(std::move(previous), refsPath);
+    }
+
+    const ShapeStore::Stats& ShapeStore::GetStats()
+    {
+        return s_Store.Stats;
+    }
+
+    void ShapeStore::ResetStats()
+    {
+        std::lock_guard<std::mutex> lock(s_Store.Mutex);
+        s_Store.Stats = Stats();
+    }
+
+}
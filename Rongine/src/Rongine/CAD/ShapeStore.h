@@ -0,0 +1,61 @@
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Rongine {
+
+    // 按内容寻址的 BRep 仓库 (assets/cache/brep)：文件名是形状二进制 BRep (BinTools) 的哈希
+    //   - 内容相同的形状 (多个实体、撤销回原样) 共用一个文件，已存在就不再写
+    //   - 记住每个形状 (TShape + Location + Orientation) 对应的文件，没改过的形状保存时不再序列化
+    //   - 文件名由 64 位哈希和长度决定，已存在的同名文件要逐字节比较，碰撞时换一个序号
+    //   - 每个场景保存时写一份引用清单 (refs/)，这个场景上次引用、这次不再引用、且其它清单都没有提到的文件
+    //     只移进隔离区 (unreferenced/)，不自动删除：编辑器外复制的场景 (备份、版本库里的旧版本) 没有自己的清单，
+    //     加载时发现文件在隔离区就移回来，需要腾磁盘时手动清空隔离区
+    // 旧版按实体 ID 保存的 ASCII 文件 (assets/cache/<id>.brep) 仍可读取，不参与隔离
+    class ShapeStore
+    {
+    public:
+        struct Stats
+        {
+            uint32_t Written = 0;   // 新内容，写入文件
+            uint32_t Unchanged = 0; // 形状没变，直接用记住的文件
+            uint32_t Shared = 0;    // 序列化后发现同样内容的文件已存在 (包括从隔离区移回的)
+            uint64_t BytesWritten = 0;
+            uint32_t Quarantined = 0; // 不再被引用、移进隔离区的文件数
+        };
+
+        static const std::string& GetDirectory();
+        static const std::string& GetQuarantineDirectory();
+
+        // 存入形状，返回文件路径 (失败返回空)
+        static std::string Put(const TopoDS_Shape& shape);
+
+        // 按扩展名解析文件内容：.brep 为旧的 ASCII 格式，其余为二进制
+        static bool Parse(const std::string& filepath, const std::string& bytes, TopoDS_Shape& outShape);
+
+        // 从仓库加载的形状记下来源，下次保存时不用重新序列化 (可以在工作线程调用)
+        static void Remember(const TopoDS_Shape& shape, const std::string& filepath);
+
+        static bool IsStorePath(const std::string& filepath);
+
+        // 加载前调用：仓库文件已被移进隔离区时移回原处，返回文件是否可用
+        static bool Restore(const std::string& filepath);
+
+        // 场景保存完成后调用：丢掉本次保存没用到的形状记录，再更新场景的引用清单
+        static void CommitSave(const std::string& scenePath, const std::vector<std::string>& blobPaths);
+
+        // 只更新引用清单 (场景格式转换等不经过 Put 的写入)，这个场景不再引用的文件移进隔离区
+        static void UpdateReferences(const std::string& scenePath, const std::vector<std::string>& blobPaths);
+
+        // 场景文件被删除：去掉它的引用清单，只有它引用的文件移进隔离区
+        static void ReleaseScene(const std::string& scenePath);
+
+        static const Stats& GetStats();
+        static void ResetStats();
+    };
+
+}
@@ -0,0 +1,157 @@
+#include "Rongpch.h"
+#include "TopologyIndex.h"
+
+#include "Rongine/Scene/Components.h"
+
+#include <TopoDS.hxx>
+#include <TopExp.hxx>
+#include <TopTools_ListIteratorOfListOfShape.hxx>
+
+#include <numeric>
+
+namespace Rongine {
+
+    // 按旧编号延续一类子形状的编号，返回被修改的个数
+    static uint32_t CarryShapes(const TopoDS_Shape& shape, TopAbs_ShapeEnum type, const TopTools_IndexedMapOfShape& previous,
+        const Handle(BRepTools_History)& history, TopTools_IndexedMapOfShape& outMap, std::vector<int>& outRemap)
+    {
+        TopTools_IndexedMapOfShape current;
+        TopExp::MapShapes(shape, type, current);
+
+        uint32_t modified = 0;
+        outRemap.assign(previous.Extent(), -1);
+
+        // 1. 旧子形状按旧 ID 顺序放在前面
+        for (int i = 1; i <= previous.Extent(); i++)
+        {
+            const TopoDS_Shape& old = previous(i);
+
+            // 没变：新形状里还是同一个子形状 (取新形状里的朝向)
+            int index = current.FindIndex(old);
+            if (index == 0 && !history.IsNull() && history->IsSupportedType(old))
+            {
+                // 被修改 (裁剪/分割)：取第一个还没被占用的像
+                for (TopTools_ListIteratorOfListOfShape it(history->Modified(old)); it.More(); it.Next())
+                {
+                    int candidate = current.FindIndex(it.Value());
+                    if (candidate != 0 && !outMap.Contains(it.Value()))
+                    {
+                        index = candidate;
+                        modified++;
+                        break;
+                    }
+                }
+            }
+
+            if (index == 0 || outMap.Contains(current(index))) continue; // 被删除
+            outRemap[i - 1] = outMap.Add(current(index)) - 1;
+        }
+
+        // 2. 新生成的子形状按遍历顺序排在后面 (已经加入的 Add 会直接跳过)
+        for (int i = 1; i <= current.Extent(); i++)
+            outMap.Add(current(i));
+
+        return modified;
+    }
+
+    TopologyIndex::TopologyIndex(const TopoDS_Shape& shape)
+        : m_Shape(shape)
+    {
+        if (shape.IsNull()) return;
+
+        // MapShapes 按 TopExp_Explorer 的遍历顺序编号，共享的子形状只记第一次出现
+        TopExp::MapShapes(shape, TopAbs_FACE, m_Faces);
+        TopExp::MapShapes(shape, TopAbs_EDGE, m_Edges);
+        TopExp::MapShapes(shape, TopAbs_VERTEX, m_Vertices);
+    }
+
+    TopologyIndex::TopologyIndex(const TopoDS_Shape& shape, const TopologyIndex& previous, const Handle(BRepTools_History)& history,
+        TopologyRemap* outRemap)
+        : m_Shape(shape)
+    {
+        if (shape.IsNull()) return;
+
+        TopologyRemap remap;
+        uint32_t modifiedFaces = CarryShapes(shape, TopAbs_FACE, previous.m_Faces, history, m_Faces, remap.Faces);
+        CarryShapes(shape, TopAbs_EDGE, previous.m_Edges, history, m_Edges, remap.Edges);
+        CarryShapes(shape, TopAbs_VERTEX, previous.m_Vertices, history, m_Vertices, remap.Vertices);
+
+        if (!outRemap) return;
+
+        uint32_t survived = 0;
+        for (int id : remap.Faces)
+            if (id >= 0) survived++;
+        remap.ModifiedFaces = modifiedFaces;
+        remap.KeptFaces = survived - modifiedFaces;
+        remap.DeletedFaces = (uint32_t)remap.Faces.size() - survived;
+        remap.GeneratedFaces = (uint32_t)m_Faces.Extent() - survived;
+        *outRemap = std::move(remap);
+    }
+
+    const TopologyIndex* TopologyIndex::Get(CADGeometryComponent& cad)
+    {
+        TopoDS_Shape* shape = static_cast<TopoDS_Shape*>(cad.ShapeHandle);
+        if (!shape || shape->IsNull())
+        {
+            cad.Topology.reset();
+            return nullptr;
+        }
+
+        if (!cad.Topology || !cad.Topology->IsBuiltFrom(*shape))
+            cad.Topology = CreateRef<TopologyIndex>(*shape);
+
+        return cad.Topology.get();
+    }
+
+    TopologyRemap TopologyIndex::Transfer(CADGeometryComponent& cad, const Handle(BRepTools_History)& history)
+    {
+        TopologyRemap remap;
+        TopoDS_Shape* shape = static_cast<TopoDS_Shape*>(cad.ShapeHandle);
+        if (!shape || shape->IsNull())
+        {
+            cad.Topology.reset();
+            return remap;
+        }
+
+        if (!cad.Topology)
+        {
+            Get(cad);
+            return remap;
+        }
+
+        // 形状没变：编号原样对应
+        if (cad.Topology->IsBuiltFrom(*shape))
+        {
+            const TopologyIndex& topology = *cad.Topology;
+            remap.Faces.resize(topology.GetFaceCount());
+            remap.Edges.resize(topology.GetEdgeCount());
+            remap.Vertices.resize(topology.GetVertexCount());
+            std::iota(remap.Faces.begin(), remap.Faces.end(), 0);
+            std::iota(remap.Edges.begin(), remap.Edges.end(), 0);
+            std::iota(remap.Vertices.begin(), remap.Vertices.end(), 0);
+            remap.KeptFaces = (uint32_t)topology.GetFaceCount();
+            return remap;
+        }
+
+        cad.Topology = CreateRef<TopologyIndex>(*shape, *cad.Topology, history, &remap);
+        return remap;
+    }
+
+    TopoDS_Face TopologyIndex::GetFace(int id) const
+    {
+        if (!IsValidFace(id)) return TopoDS_Face();
+        return TopoDS::Face(m_Faces(id + 1));
+    }
+
+    TopoDS_Edge TopologyIndex::GetEdge(int id) const
+    {
+        if (!IsValidEdge(id)) return TopoDS_Edge();
+        return TopoDS::Edge(m_Edges(id + 1));
+    }
+
+    TopoDS_Vertex TopologyIndex::GetVertex(int id) const
+    {
+        if (!IsValidVertex(id)) return TopoDS_Vertex();
+        return TopoDS::Vertex(m_Vertices(id + 1));
+    }
+}
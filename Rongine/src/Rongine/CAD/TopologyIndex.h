@@ -0,0 +1,103 @@
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <BRepTools_History.hxx>
+#include <TopTools_ListOfShape.hxx>
+
+#include <vector>
+#include <cstdint>
+
+namespace Rongine {
+
+    struct CADGeometryComponent;
+
+    // 一次建模操作前后的 ID 对应关系：下标是旧 ID，值是新 ID (-1 = 被删除)
+    struct TopologyRemap
+    {
+        std::vector<int> Faces;
+        std::vector<int> Edges;
+        std::vector<int> Vertices;
+
+        // 统计 (只算面)：原样保留 / 被修改但仍有对应 / 被删除 / 新生成
+        uint32_t KeptFaces = 0;
+        uint32_t ModifiedFaces = 0;
+        uint32_t DeletedFaces = 0;
+        uint32_t GeneratedFaces = 0;
+
+        int MapFace(int id) const { return id >= 0 && id < (int)Faces.size() ? Faces[id] : -1; }
+        int MapEdge(int id) const { return id >= 0 && id < (int)Edges.size() ? Edges[id] : -1; }
+        int MapVertex(int id) const { return id >= 0 && id < (int)Vertices.size() ? Vertices[id] : -1; }
+    };
+
+    // 形状的拓扑索引表：面/边/顶点各一张 TopTools_IndexedMapOfShape (每个子形状只出现一次)
+    // ID = 在表中的下标 - 1，和网格里的 FaceID、线缓冲里的 EdgeID、拾取纹理读出的值一致
+    // 按 ID 取子形状是数组访问，按子形状反查 ID 是哈希查找，都是 O(1)
+    // 每个形状版本只构建一次，挂在 CADGeometryComponent::Topology 上；构建后只读，可以跨线程共享
+    //
+    // 建模操作 (倒角/拉伸/布尔/复制) 之后按操作历史延续编号：
+    // 旧的面/边按旧 ID 的顺序排在前面 (没变的取同一个子形状，被修改的取 Modified 的第一个像)，被删除的让出位置，
+    // 新生成的排在最后。没有删除时旧 ID 全部不变，其余情况由 TopologyRemap 给出旧 ID -> 新 ID
+    class TopologyIndex
+    {
+    public:
+        TopologyIndex() = default;
+        explicit TopologyIndex(const TopoDS_Shape& shape);
+        // 按 previous 的编号和 history (previous 的形状 -> shape) 延续 ID，outRemap 可为空
+        TopologyIndex(const TopoDS_Shape& shape, const TopologyIndex& previous, const Handle(BRepTools_History)& history,
+            TopologyRemap* outRemap = nullptr);
+
+        // 组件当前形状的索引表，形状被替换过 (TShape/位置/朝向任一不同) 就重新构建
+        // 没有形状时返回 nullptr
+        static const TopologyIndex* Get(CADGeometryComponent& cad);
+
+        // 组件的形状已经换成操作结果之后调用：按操作历史从旧索引表延续编号并装到组件上
+        // (旧索引表必须在替换形状之前通过 Get 构建过，否则没有可延续的编号，返回空的 Remap)
+        static TopologyRemap Transfer(CADGeometryComponent& cad, const Handle(BRepTools_History)& history);
+
+        // 收集建模算法 (BRepFilletAPI/BRepPrimAPI/BRepBuilderAPI_Copy 等) 从 argument 到结果的修改历史
+        // BRepAlgoAPI 的布尔运算直接用 History()
+        template<typename TAlgo>
+        static Handle(BRepTools_History) MakeHistory(const TopoDS_Shape& argument, TAlgo& algo)
+        {
+            TopTools_ListOfShape arguments;
+            arguments.Append(argument);
+            return new BRepTools_History(arguments, algo);
+        }
+
+        // 是否就是按这个形状构建的 (只比较句柄，O(1))
+        bool IsBuiltFrom(const TopoDS_Shape& shape) const { return !m_Shape.IsNull() && m_Shape.IsEqual(shape); }
+        const TopoDS_Shape& GetShape() const { return m_Shape; }
+
+        int GetFaceCount() const { return m_Faces.Extent(); }
+        int GetEdgeCount() const { return m_Edges.Extent(); }
+        int GetVertexCount() const { return m_Vertices.Extent(); }
+
+        bool IsValidFace(int id) const { return id >= 0 && id < m_Faces.Extent(); }
+        bool IsValidEdge(int id) const { return id >= 0 && id < m_Edges.Extent(); }
+        bool IsValidVertex(int id) const { return id >= 0 && id < m_Vertices.Extent(); }
+
+        // ID 越界时返回空形状
+        TopoDS_Face GetFace(int id) const;
+        TopoDS_Edge GetEdge(int id) const;
+        TopoDS_Vertex GetVertex(int id) const;
+
+        // 反查 ID (按 IsSame 比较，忽略朝向)，不属于这个形状时返回 -1
+        int FindFace(const TopoDS_Shape& face) const { return m_Faces.FindIndex(face) - 1; }
+        int FindEdge(const TopoDS_Shape& edge) const { return m_Edges.FindIndex(edge) - 1; }
+        int FindVertex(const TopoDS_Shape& vertex) const { return m_Vertices.FindIndex(vertex) - 1; }
+
+        const TopTools_IndexedMapOfShape& GetFaceMap() const { return m_Faces; }
+        const TopTools_IndexedMapOfShape& GetEdgeMap() const { return m_Edges; }
+        const TopTools_IndexedMapOfShape& GetVertexMap() const { return m_Vertices; }
+
+    private:
+        TopoDS_Shape m_Shape;
+        TopTools_IndexedMapOfShape m_Faces;
+        TopTools_IndexedMapOfShape m_Edges;
+        TopTools_IndexedMapOfShape m_Vertices;
+    };
+}
@@ -2,7 +2,6 @@
 #include "CADModifyCommand.h"
 #include "Rongine/Scene/Components.h"
 #include "Rongine/CAD/CADMesher.h" 
-#include <BRepBuilderAPI_Copy.hxx> 
 
 namespace Rongine {
 
@@ -22,7 +21,8 @@ namespace Rongine {
 			auto& cad = entity.GetComponent<CADGeometryComponent>();
 			if (cad.ShapeHandle)
 			{
-				m_OldShape = DeepCopyShape((TopoDS_Shape*)cad.ShapeHandle);
+				TopologyIndex::Get(cad);
+				m_OldShape = SnapshotShape((TopoDS_Shape*)cad.ShapeHandle, cad.Topology, m_OldTopology);
 			}
 		}
 	}
@@ -43,7 +43,8 @@ namespace Rongine {
 			auto& cad = entity.GetComponent<CADGeometryComponent>();
 			if (cad.ShapeHandle)
 			{
-				m_NewShape = DeepCopyShape((TopoDS_Shape*)cad.ShapeHandle);
+				TopologyIndex::Get(cad);
+				m_NewShape = SnapshotShape((TopoDS_Shape*)cad.ShapeHandle, cad.Topology, m_NewTopology);
 			}
 		}
 	}
@@ -53,7 +54,7 @@ namespace Rongine {
 		// Redo: 应用新形状
 		if (m_NewShape)
 		{
-			ApplyShape(m_NewShape);
+			ApplyShape(m_NewShape, m_NewTopology);
 			return true;
 		}
 		return false;
@@ -64,11 +65,11 @@ namespace Rongine {
 		// Undo: 恢复旧形状
 		if (m_OldShape)
 		{
-			ApplyShape(m_OldShape);
+			ApplyShape(m_OldShape, m_OldTopology);
 		}
 	}
 
-	void CADModifyCommand::ApplyShape(TopoDS_Shape* sourceShape)
+	void CADModifyCommand::ApplyShape(TopoDS_Shape* sourceShape, const Ref<TopologyIndex>& sourceTopology)
 	{
 		Entity entity = GetEntity(); // <--- 动态获取
 		if (!entity) return;
@@ -80,19 +81,24 @@ namespace Rongine {
 		//  释放当前实体持有的 Shape 内存 (如果是 new 出来的)
 		if (cad.ShapeHandle) delete (TopoDS_Shape*)cad.ShapeHandle; 
 
-		// 将备份的数据 深拷贝 一份给实体
-		cad.ShapeHandle = DeepCopyShape(sourceShape);
+		// 实体拿到备份形状的一份句柄 (共享 TShape，不复制几何)
+		cad.ShapeHandle = SnapshotShape(sourceShape, sourceTopology, cad.Topology);
 
 		// 网格重建
 		CADMesher::RebuildMesh(entity);
 	}
 
-	TopoDS_Shape* CADModifyCommand::DeepCopyShape(const TopoDS_Shape* shape)
+	TopoDS_Shape* CADModifyCommand::SnapshotShape(const TopoDS_Shape* shape, const Ref<TopologyIndex>& topology, Ref<TopologyIndex>& outTopology)
 	{
+		outTopology.reset();
 		if (!shape) return nullptr;
-		BRepBuilderAPI_Copy copier(*shape);
-		// 返回一个新的堆内存对象
-		return new TopoDS_Shape(copier.Shape());
+
+		// 索引表建好后不再修改，同一个形状可以直接共享
+		if (topology && topology->IsBuiltFrom(*shape))
+			outTopology = topology;
+
+		// 返回一个新的堆内存对象 (句柄复制)
+		return new TopoDS_Shape(*shape);
 	}
 
 	Entity CADModifyCommand::GetEntity()
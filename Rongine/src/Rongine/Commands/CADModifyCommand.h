@@ -2,6 +2,7 @@
 #include "Command.h"
 #include "Rongine/Scene/Entity.h"
 #include <TopoDS_Shape.hxx>
+#include "Rongine/CAD/TopologyIndex.h"
 
 namespace Rongine {
 
@@ -23,9 +24,10 @@ namespace Rongine {
 
 	private:
 		// 辅助函数：应用形状并重建网格
-		void ApplyShape(TopoDS_Shape* sourceShape);
-		// 辅助函数：深拷贝 Shape
-		TopoDS_Shape* DeepCopyShape(const TopoDS_Shape* shape);
+		void ApplyShape(TopoDS_Shape* sourceShape, const Ref<TopologyIndex>& sourceTopology);
+		// 辅助函数：按值备份 Shape (OCCT 形状是不可变的句柄，备份和实体共享 TShape)
+		// 撤销/重做后没被修改的面仍是原来的 TShape，三角网格缓存直接命中；拓扑索引表也原样共享，面/边 ID 和操作前一致
+		TopoDS_Shape* SnapshotShape(const TopoDS_Shape* shape, const Ref<TopologyIndex>& topology, Ref<TopologyIndex>& outTopology);
 
 		// 辅助函数：获取当前有效的实体
 		Entity GetEntity();
@@ -35,5 +37,7 @@ namespace Rongine {
 		uint64_t m_EntityUUID = 0;
 		TopoDS_Shape* m_OldShape = nullptr; // 堆内存中的备份
 		TopoDS_Shape* m_NewShape = nullptr; // 堆内存中的备份
+		Ref<TopologyIndex> m_OldTopology;   // 备份形状的拓扑索引表
+		Ref<TopologyIndex> m_NewTopology;
 	};
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "DeleteCommand.h"
 #include "Rongine/Scene/Scene.h"
 #include "Rongine/CAD/CADMesher.h"
+#include "Rongine/CAD/MeshJobSystem.h"
 #include <TopoDS_Shape.hxx>
 #include <BRepBuilderAPI_Copy.hxx>
 
@@ -30,6 +31,8 @@ namespace Rongine {
 			//  ShapeHandleֹɾʵָʧЧ
 			if (m_Backup.CAD.ShapeHandle)
 			{
+				// ̨ͬһ״д˳ٸ (Undo ʱ)
+				MeshJobSystem::Cancel(entity);
 				BRepBuilderAPI_Copy copier(*(TopoDS_Shape*)m_Backup.CAD.ShapeHandle);
 				m_Backup.CAD.ShapeHandle = new TopoDS_Shape(copier.Shape());
 			}
@@ -3,6 +3,9 @@
 #ifdef RONG_PLATFORM_WINDOWS
 
 #include "Log.h"
+#include "Rongine/Renderer/MeshBuffer.h"
+#include "Rongine/Scene/SceneSerializer.h"
+#include <cstring>
 
 extern Rongine::Application* Rongine::createApplication();
 
@@ -12,6 +15,17 @@ inline int main(int argc, char* argv[])
 	Rongine::Log::init();
 	RONG_CORE_INFO("  init sucess!  ");
 
+	// --headless-test：不创建 Application (没有窗口和 GL 上下文)，跑完自检直接退出，失败时返回 1
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--headless-test") != 0) continue;
+
+		bool passed = Rongine::MeshBuffer::SelfTest();
+		passed = Rongine::SceneSerializer::TestHeadlessLoad(500) && passed;
+		RONG_CORE_INFO("Headless Tests: {0}", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	}
+
 	auto app = Rongine::createApplication();
 	app->run();
 	delete app;
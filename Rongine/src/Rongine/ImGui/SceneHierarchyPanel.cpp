@@ -6,6 +6,7 @@
 #include "Rongine/CAD/CADModeler.h"
 #include "Rongine/CAD/CADMesher.h"
 #include "Rongine/CAD/CADImporter.h"
+#include "Rongine/CAD/MeshJobSystem.h"
 #include "Rongine/Commands/Command.h" 
 #include "Rongine/Commands/CADModifyCommand.h" 
 #include <glm/gtc/type_ptr.hpp>
@@ -41,6 +42,10 @@ namespace Rongine {
 		auto& cadComp = entity.GetComponent<CADGeometryComponent>();
 		auto& meshComp = entity.GetComponent<MeshComponent>();
 
+		// 后台还没完成的网格任务作废，否则旧形状的结果会覆盖这里同步生成的网格
+		MeshJobSystem::Cancel(entity);
+		meshComp.MeshPending = false;
+
 		const float MIN_SIZE = 0.001f;
 		// 1. 清理旧的 Shape (防止内存泄漏)
 		if (cadComp.ShapeHandle)
@@ -99,15 +104,11 @@ namespace Rongine {
 			{
 				// 4. 更新 MeshComponent
 				meshComp.VA = newVA;
-				meshComp.LocalVertices = newVertices; // 更新 CPU 顶点，保证 Gizmo 吸附正确
-				meshComp.LocalIndices = newIndices;
+				meshComp.SetGeometry(std::move(newVertices), std::move(newIndices)); // 更新 CPU 顶点，保证 Gizmo 吸附正确
 				meshComp.BoundingBox = CADImporter::CalculateAABB(*occShape); // 更新包围盒，保证 F 键聚焦正确
 
 				// ==================== 生成边框线 ====================
-				std::vector<LineVertex> lineVerts;
-				auto edgeVA = CADMesher::CreateEdgeMeshFromShape(*occShape, lineVerts, cadComp.LinearDeflection);
-				meshComp.EdgeVA = edgeVA;
-				meshComp.LocalLines = lineVerts;
+				CADMesher::RebuildEdges(meshComp, cadComp, cadComp.LinearDeflection);
 				// ===========================================================
 			}
 		}
@@ -122,6 +123,10 @@ namespace Rongine {
 		auto& cadComp = entity.GetComponent<CADGeometryComponent>();
 		auto& meshComp = entity.GetComponent<MeshComponent>();
 
+		// 先等后台任务退出，再清理同一个形状上的三角网格
+		MeshJobSystem::Cancel(entity);
+		meshComp.MeshPending = false;
+
 		if (cadComp.ShapeHandle)
 		{
 			TopoDS_Shape* occShape = (TopoDS_Shape*)cadComp.ShapeHandle;
@@ -135,23 +140,13 @@ namespace Rongine {
 			if (newVA)
 			{
 				meshComp.VA = newVA;
-				meshComp.LocalVertices = newVertices;
-				meshComp.LocalIndices = newIndices;
+				meshComp.SetGeometry(std::move(newVertices), std::move(newIndices));
 				// 更新AABB
 				meshComp.BoundingBox = CADImporter::CalculateAABB(*occShape);
 
 				// ==================== 生成边框线 ====================
-				std::vector<LineVertex> lineVerts;
 				// 传入 cadComp.LinearDeflection
-				meshComp.m_IDToEdgeMap.clear();
-				auto edgeVA = CADMesher::CreateEdgeMeshFromShape(
-					*occShape,
-					lineVerts,
-					meshComp.m_IDToEdgeMap, 
-					cadComp.LinearDeflection
-				);
-				meshComp.EdgeVA = edgeVA;
-				meshComp.LocalLines = lineVerts;
+				CADMesher::RebuildEdges(meshComp, cadComp, cadComp.LinearDeflection);
 				// ===========================================================
 			}
 		}
@@ -173,13 +168,10 @@ namespace Rongine {
 			TopoDS_Shape* shape = (TopoDS_Shape*)cad.ShapeHandle;
 			BRepTools::Clean(*shape);
 
-			std::vector<LineVertex> lines;
-			mesh.m_IDToEdgeMap.clear();
-			mesh.EdgeVA = CADMesher::CreateEdgeMeshFromShape(*shape, lines, mesh.m_IDToEdgeMap, cad.LinearDeflection);
-			mesh.LocalLines = lines;
+			CADMesher::RebuildEdges(mesh, cad, cad.LinearDeflection);
 			// 注意：Spline 没有面，所以 mesh.VA 设为 nullptr
 			mesh.VA = nullptr;
-			mesh.LocalVertices.clear();
+			mesh.SetGeometry({}, {});
 		}
 	}
 
@@ -573,14 +565,14 @@ namespace Rongine {
 						auto* cmd = new CADModifyCommand(entity);
 
 						// B. 执行操作
-						CADMesher::ApplyFillet(entity, m_selectedEdge, s_CurrentFilletRadius);
+						TopologyRemap remap = CADMesher::ApplyFillet(entity, m_selectedEdge, s_CurrentFilletRadius);
 
 						// C. 备份新状态并提交
 						cmd->CaptureNewState();
 						CommandHistory::Push(cmd);
 
-						// D. 强制取消选择 (防止拓扑变动导致崩溃)
-						m_selectedEdge = -1;
+						// D. 按操作历史更新选择 (倒角的边本身被删除，会变成 -1)
+						m_selectedEdge = remap.MapEdge(m_selectedEdge);
 					}
 					ImGui::PopStyleColor();
 
@@ -597,7 +589,11 @@ namespace Rongine {
 			{
 				auto& mesh = entity.GetComponent<MeshComponent>();
 				ImGui::Text("Vertices: %zu", mesh.LocalVertices.size());
-				ImGui::Text("Edges Mapped: %zu", mesh.m_IDToEdgeMap.size());
+				if (entity.HasComponent<CADGeometryComponent>())
+				{
+					if (const TopologyIndex* topology = TopologyIndex::Get(entity.GetComponent<CADGeometryComponent>()))
+						ImGui::Text("Topology: %d Faces, %d Edges, %d Vertices", topology->GetFaceCount(), topology->GetEdgeCount(), topology->GetVertexCount());
+				}
 			}
 		}
 
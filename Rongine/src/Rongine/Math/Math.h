@@ -6,6 +6,41 @@ namespace Rongine::Math {
         const glm::vec3& planeOrigin, const glm::vec3& planeNormal,
         glm::vec3& outIntersection);
 
+    // --- 光线求交 (CPU 端 BVH / 八叉树遍历共用，放在头文件中便于内联) ---
+
+    // Möller–Trumbore 三角形求交，与 Shader 中的 HitTriangle 一致，未击中返回 -1
+    inline float RayTriangleIntersection(const glm::vec3& rayOrigin, const glm::vec3& rayDir,
+        const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+    {
+        const float epsilon = 1e-6f;
+        glm::vec3 edge1 = v1 - v0;
+        glm::vec3 edge2 = v2 - v0;
+        glm::vec3 h = glm::cross(rayDir, edge2);
+        float a = glm::dot(edge1, h);
+        if (a > -epsilon && a < epsilon) return -1.0f;
+        float f = 1.0f / a;
+        glm::vec3 s = rayOrigin - v0;
+        float u = f * glm::dot(s, h);
+        if (u < 0.0f || u > 1.0f) return -1.0f;
+        glm::vec3 q = glm::cross(s, edge1);
+        float v = f * glm::dot(rayDir, q);
+        if (v < 0.0f || u + v > 1.0f) return -1.0f;
+        float t = f * glm::dot(edge2, q);
+        return (t > epsilon) ? t : -1.0f;
+    }
+
+    // slab 包围盒测试，与 Shader 中的 IntersectAABB 一致 (只接受比 closestT 更近的盒子)
+    inline bool RayAABBIntersection(const glm::vec3& rayOrigin, const glm::vec3& invDir,
+        const glm::vec3& boxMin, const glm::vec3& boxMax, float closestT)
+    {
+        glm::vec3 t0 = (boxMin - rayOrigin) * invDir;
+        glm::vec3 t1 = (boxMax - rayOrigin) * invDir;
+        glm::vec3 tSmall = glm::min(t0, t1);
+        glm::vec3 tBig = glm::max(t0, t1);
+        float tMin = glm::max(tSmall.x, glm::max(tSmall.y, tSmall.z));
+        float tMax = glm::min(tBig.x, glm::min(tBig.y, tBig.z));
+        return (tMin <= tMax) && (tMax > 0.0f) && (tMin < closestT);
+    }
 }
 
 
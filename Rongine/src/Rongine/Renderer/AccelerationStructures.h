@@ -1,30 +1,49 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <vector>
+#include <cstdint>
 
 namespace Rongine {
 
     enum class AccelType {
         None = 0,
         BVH = 1,
-        Octree = 2
+        Octree = 2,
+        TwoLevel = 3 // 每个 Mesh 一棵局部 BLAS + 实例层 TLAS
     };
 
-    // --- BVH 节点 (32 bytes) ---
-    //struct GPUBVHNode {
-    //    glm::vec3 AABBMin;
-    //    float LeftChildIndex; // < 0 表示叶子节点
-    //    glm::vec3 AABBMax;
-    //    float RightChildIndex; // 叶子节点时存储 TriangleCount
-    //};
+    // BVH 构建质量 (切分策略)
+    enum class BVHBuildQuality {
+        Midpoint = 0, // 最长轴空间中点 (构建最快)
+        SAH = 1,      // 分桶表面积启发式 (遍历更快)
+        LBVH = 2      // Morton 码线性 BVH (交互式重建，见 LBVHBuilder)
+    };
 
+    // --- BVH 节点 (32 bytes) ---
+    // 格式版本 2：子节点/三角形偏移用 uint32 存储
+    // (版本 1 用 float 存 -(start + 1)，超过 2^24 个三角形会丢失精度，遍历时还要做浮点转整数)
+    // 内部节点：LeftFirst = 左子节点索引，RightOrCount = 右子节点索引
+    // 叶子节点：LeftFirst = 第一个三角形在索引表中的位置，RightOrCount = LeafFlag | 三角形数量
     struct GPUBVHNode {
+        static constexpr uint32_t FormatVersion = 2;
+        static constexpr uint32_t LeafFlag = 0x80000000u;
+
         float MinX, MinY, MinZ; // 12 bytes
-        float LeftChildIndex;   // 4 bytes
+        uint32_t LeftFirst;     // 4 bytes
 
         float MaxX, MaxY, MaxZ; // 12 bytes
-        float RightChildIndex;  // 4 bytes
+        uint32_t RightOrCount;  // 4 bytes
+
+        bool IsLeaf() const { return (RightOrCount & LeafFlag) != 0; }
+        uint32_t GetLeftChild() const { return LeftFirst; }
+        uint32_t GetRightChild() const { return RightOrCount; }
+        uint32_t GetFirstPrim() const { return LeftFirst; }
+        uint32_t GetPrimCount() const { return RightOrCount & ~LeafFlag; }
+
+        void SetLeaf(uint32_t firstPrim, uint32_t count) { LeftFirst = firstPrim; RightOrCount = LeafFlag | count; }
+        void SetChildren(uint32_t left, uint32_t right) { LeftFirst = left; RightOrCount = right; }
     };
+    static_assert(sizeof(GPUBVHNode) == 32, "GPUBVHNode must match the std430 layout in the shaders");
 
     // --- 八叉树节点 (通常比较大，简化版) ---
     // 线性八叉树 (Linear Octree) 结构
@@ -37,6 +56,22 @@ namespace Rongine {
         float _pad[2]; // 填充至 16 字节对齐
     };
 
+    // --- 两层加速结构的实例 (80 bytes) ---
+    // TLAS 叶子指向实例，实例再指向自己的 BLAS 根节点
+    struct GPUInstance {
+        glm::mat4 InverseTransform; // 世界 -> 局部，用于把光线变换到 BLAS 空间
+        uint32_t BLASRootIndex;     // BLAS 根节点在拼接后节点数组中的位置
+        uint32_t TriangleOffset;    // 该实例第一个三角形的全局 ID
+        uint32_t TriangleCount;
+        uint32_t _pad;
+    };
+
+    // CPU 端射线查询统计 (用于对比不同加速结构的遍历代价)
+    struct RayQueryStats {
+        uint64_t NodesVisited = 0;
+        uint64_t TrianglesTested = 0;
+    };
+
     struct BVHTriangle {
         glm::vec3 V0, V1, V2;
         glm::vec3 Centroid;
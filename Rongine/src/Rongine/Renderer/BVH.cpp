@@ -1,10 +1,68 @@
 #include "Rongpch.h"
 #include "BVH.h"
+#include "LBVH.h"
 #include "Rongine/Core/Log.h"
+#include "Rongine/Math/Math.h"
+
+#include <chrono>
+#include <execution> // C++17 并行算法
+#include <numeric>
+#include <thread>
 
 namespace Rongine {
 
-    BVHBuilder::BVHBuilder(const std::vector<BVHTriangle>& triangles)
+    // SAH 参数
+    static const int   s_SAHBinCount = 12;      // 每个轴的分桶数
+    static const int   s_SAHMaxLeafSize = 8;    // SAH 认为不值得再切时，允许的最大叶子三角形数
+    static const float s_SAHTraversalCost = 1.0f;
+    static const float s_SAHIntersectCost = 1.0f;
+
+    // Refit 参数
+    static const uint32_t s_RefitMergeGap = 16; // 两段脏区间相隔不超过该节点数时合并上传 (少一次 glBufferSubData 更划算)
+
+    // 并行构建参数
+    static const int s_ParallelMinTriangles = 8192;      // 三角形太少时线程调度开销大于收益，直接串行
+    static const int s_ParallelPassMinTriangles = 65536; // 节点超过该规模时，包围盒/分桶统计才并行
+    static const int s_MinTaskTriangles = 1024;          // 单个子树任务的最小规模
+    static const int s_BinChunkSize = 16384;             // 并行分桶时每个分块的三角形数
+
+    static AABB GetTriangleBounds(const BVHTriangle& tri)
+    {
+        AABB box;
+        box.Grow(tri.V0);
+        box.Grow(tri.V1);
+        box.Grow(tri.V2);
+        return box;
+    }
+
+    static AABB MergeBounds(AABB a, const AABB& b)
+    {
+        a.Grow(b);
+        return a;
+    }
+
+    struct SAHBin {
+        AABB Bounds;
+        int Count = 0;
+    };
+
+    // 三个轴的分桶统计
+    struct SAHBinSet {
+        SAHBin Bins[3][s_SAHBinCount];
+
+        void Merge(const SAHBinSet& other)
+        {
+            for (int axis = 0; axis < 3; axis++)
+                for (int b = 0; b < s_SAHBinCount; b++)
+                {
+                    Bins[axis][b].Bounds.Grow(other.Bins[axis][b].Bounds);
+                    Bins[axis][b].Count += other.Bins[axis][b].Count;
+                }
+        }
+    };
+
+    BVHBuilder::BVHBuilder(const std::vector<BVHTriangle>& triangles, BVHBuildQuality quality, bool parallel)
+        : m_Quality(quality), m_Parallel(parallel)
     {
         m_BuildTriangles = triangles;
         m_Nodes.reserve(triangles.size() * 2);
@@ -12,14 +70,22 @@ namespace Rongine {
 
         // 1. 创建根节点 (Index 0)
         GPUBVHNode root;
-        root.LeftChildIndex = 0;
-        root.RightChildIndex = 0;
+        root.SetLeaf(0, 0);
         root.MinX = 0.0f; root.MinY = 0.0f; root.MinZ = 0.0f;
         root.MaxX = 0.0f; root.MaxY = 0.0f; root.MaxZ = 0.0f;
         m_Nodes.push_back(root);
 
-        // 2. 开始递归构建
-        SplitBVHNode(0, 0, (int)m_BuildTriangles.size(), 0);
+        // 2. 开始构建
+        if (m_Parallel && (int)m_BuildTriangles.size() >= s_ParallelMinTriangles)
+        {
+            BuildParallel();
+        }
+        else
+        {
+            BuildContext ctx;
+            ctx.Nodes = &m_Nodes;
+            SplitBVHNode(ctx, 0, 0, (int)m_BuildTriangles.size(), 0);
+        }
 
         // 3. 生成最终索引表
         // 因为构建过程中 m_BuildTriangles 被 std::partition 重排了
@@ -28,57 +94,119 @@ namespace Rongine {
             m_SortedIndices.push_back(tri.Index);
         }
 
-        RONG_CORE_INFO("BVH Built Successfully: {0} Triangles -> {1} Nodes", triangles.size(), m_Nodes.size());
+        RONG_CORE_INFO("BVH Built Successfully ({0}{1}): {2} Triangles -> {3} Nodes",
+            QualityToString(m_Quality), m_Parallel ? ", Parallel" : "", triangles.size(), m_Nodes.size());
+    }
+
+    const char* BVHBuilder::QualityToString(BVHBuildQuality quality)
+    {
+        switch (quality)
+        {
+        case BVHBuildQuality::Midpoint: return "Midpoint";
+        case BVHBuildQuality::SAH:      return "SAH";
+        case BVHBuildQuality::LBVH:     return "LBVH";
+        }
+        return "Unknown";
     }
 
-    void BVHBuilder::UpdateNodeBounds(int nodeIndex, int start, int end)
+    void BVHBuilder::UpdateNodeBounds(GPUBVHNode& node, int start, int end, bool parallel)
     {
         glm::vec3 min(1e30f);
         glm::vec3 max(-1e30f);
 
-        for (int i = start; i < end; i++) {
-            const auto& tri = m_BuildTriangles[i];
+        if (parallel)
+        {
+            // min/max 满足结合律，并行归约的结果与串行完全一致
+            AABB box = std::transform_reduce(std::execution::par,
+                m_BuildTriangles.begin() + start, m_BuildTriangles.begin() + end,
+                AABB(), MergeBounds, GetTriangleBounds);
+            min = box.Min;
+            max = box.Max;
+        }
+        else
+        {
+            for (int i = start; i < end; i++) {
+                const auto& tri = m_BuildTriangles[i];
 
-            min = glm::min(min, tri.V0);
-            min = glm::min(min, tri.V1);
-            min = glm::min(min, tri.V2);
+                min = glm::min(min, tri.V0);
+                min = glm::min(min, tri.V1);
+                min = glm::min(min, tri.V2);
 
-            max = glm::max(max, tri.V0);
-            max = glm::max(max, tri.V1);
-            max = glm::max(max, tri.V2);
+                max = glm::max(max, tri.V0);
+                max = glm::max(max, tri.V1);
+                max = glm::max(max, tri.V2);
+            }
         }
 
-        m_Nodes[nodeIndex].MinX = min.x;
-        m_Nodes[nodeIndex].MinY = min.y;
-        m_Nodes[nodeIndex].MinZ = min.z;
+        node.MinX = min.x;
+        node.MinY = min.y;
+        node.MinZ = min.z;
 
-        m_Nodes[nodeIndex].MaxX = max.x;
-        m_Nodes[nodeIndex].MaxY = max.y;
-        m_Nodes[nodeIndex].MaxZ = max.z;
+        node.MaxX = max.x;
+        node.MaxY = max.y;
+        node.MaxZ = max.z;
     }
 
-    void BVHBuilder::SplitBVHNode(int nodeIndex, int start, int end, int depth)
+    void BVHBuilder::SplitBVHNode(BuildContext& ctx, int nodeIndex, int start, int end, int depth)
     {
+        std::vector<GPUBVHNode>& nodes = *ctx.Nodes;
         int count = end - start;
 
+        // 0. 并行构建时，规模足够小的子树延迟到线程池里独立构建
+        if (ctx.DeferredTasks && count <= ctx.TaskSize && count > 4 && depth <= 32)
+        {
+            ctx.DeferredTasks->push_back({ nodeIndex, start, end, depth, {} });
+            return;
+        }
+
+        bool parallelPasses = ctx.ParallelPasses && count >= s_ParallelPassMinTriangles;
+
         // 1. 先计算当前节点的包围盒
-        UpdateNodeBounds(nodeIndex, start, end);
-        GPUBVHNode& node = m_Nodes[nodeIndex]; // 获取引用
+        UpdateNodeBounds(nodes[nodeIndex], start, end, parallelPasses);
+        GPUBVHNode& node = nodes[nodeIndex]; // 获取引用
 
         // 2. 终止条件：如果是叶子节点 (三角形很少，或者深度太深)
         if (count <= 4 || depth > 32)
         {
             // === 标记为叶子节点 ===
-            // 你的注释：LeftChildIndex < 0 表示叶子
-            // 我们存储 -(Start + 1) 以避免 0 的歧义
-            node.LeftChildIndex = -(float)(start + 1);
+            // 叶子存储三角形在索引表中的起始位置，数量与叶子标记打包在一起
+            node.SetLeaf((uint32_t)start, (uint32_t)count);
+            return;
+        }
+
+        // 3. 按构建质量选择切分策略
+        int mid = (m_Quality == BVHBuildQuality::SAH)
+            ? PartitionSAH(node, start, end, parallelPasses)
+            : PartitionMidpoint(node, start, end);
 
-            // 你的注释：叶子节点时存储 TriangleCount
-            node.RightChildIndex = (float)count;
+        // SAH 判定不切分更划算
+        if (mid < 0)
+        {
+            node.SetLeaf((uint32_t)start, (uint32_t)count);
             return;
         }
 
-        // 3. 寻找最长轴用于切割
+        // 4. 创建子节点
+        // 注意：nodes.push_back 可能会导致 vector 扩容，从而使上面的 `node` 引用失效！
+        // 所以这里我们要先记录索引，push 之后再重新获取 node 的访问权
+        int leftChildIdx = (int)nodes.size();
+        nodes.push_back(GPUBVHNode()); // Left
+        nodes.push_back(GPUBVHNode()); // Right
+        int rightChildIdx = leftChildIdx + 1;
+
+        // 重新获取当前节点 (防止扩容引用失效)
+        nodes[nodeIndex].SetChildren((uint32_t)leftChildIdx, (uint32_t)rightChildIdx);
+
+        // 5. 递归构建子节点
+        SplitBVHNode(ctx, leftChildIdx, start, mid, depth + 1);
+        SplitBVHNode(ctx, rightChildIdx, mid, end, depth + 1);
+    }
+
+    int BVHBuilder::PartitionMidpoint(const GPUBVHNode& node, int start, int end)
+    {
+        int count = end - start;
+
+        // 1. 寻找最长轴用于切割
         glm::vec3 boxMin(node.MinX, node.MinY, node.MinZ);
         glm::vec3 boxMax(node.MaxX, node.MaxY, node.MaxZ);
 
@@ -88,19 +216,16 @@ namespace Rongine {
         if (extent.z > extent[axis]) axis = 2;
 
         float splitPos = (boxMin[axis] + boxMax[axis]) * 0.5f; // 中点分割
-        // 或者使用质心包围盒的中点 (更稳健)：
-        // float splitPos = 0.0f; ... (略，先用简单的空间中点)
 
-        // 4. 执行划分 (Partition)
+        // 2. 执行划分 (Partition)
         // 将三角形数组分为两部分：左边 < splitPos，右边 >= splitPos
-        int mid = start;
         auto it = std::partition(m_BuildTriangles.begin() + start, m_BuildTriangles.begin() + end,
             [axis, splitPos](const BVHTriangle& tri) {
                 return tri.Centroid[axis] < splitPos;
             });
-        mid = (int)(it - m_BuildTriangles.begin());
+        int mid = (int)(it - m_BuildTriangles.begin());
 
-        // 5. 兜底策略：如果切分失败 (比如所有三角形重心都在一边)，强制对半切
+        // 3. 兜底策略：如果切分失败 (比如所有三角形重心都在一边)，强制对半切
         if (mid == start || mid == end) {
             mid = start + (count / 2);
             std::nth_element(m_BuildTriangles.begin() + start,
@@ -111,20 +236,508 @@ namespace Rongine {
                 });
         }
 
-        // 6. 创建子节点
-        // 注意：m_Nodes.push_back 可能会导致 vector 扩容，从而使上面的 `node` 引用失效！
-        // 所以这里我们要先记录索引，push 之后再重新获取 node 的访问权
-        int leftChildIdx = (int)m_Nodes.size();
-        m_Nodes.push_back(GPUBVHNode()); // Left
-        m_Nodes.push_back(GPUBVHNode()); // Right
-        int rightChildIdx = leftChildIdx + 1;
+        return mid;
+    }
 
-        // 重新获取当前节点 (防止扩容引用失效)
-        m_Nodes[nodeIndex].LeftChildIndex = (float)leftChildIdx;
-        m_Nodes[nodeIndex].RightChildIndex = (float)rightChildIdx;
+    int BVHBuilder::PartitionSAH(const GPUBVHNode& node, int start, int end, bool parallel)
+    {
+        int count = end - start;
+
+        // 1. 计算质心包围盒 (分桶基于质心，而不是三角形包围盒)
+        AABB centroidBounds;
+        if (parallel)
+        {
+            centroidBounds = std::transform_reduce(std::execution::par,
+                m_BuildTriangles.begin() + start, m_BuildTriangles.begin() + end,
+                AABB(), MergeBounds, [](const BVHTriangle& tri) { return AABB(tri.Centroid, tri.Centroid); });
+        }
+        else
+        {
+            for (int i = start; i < end; i++)
+                centroidBounds.Grow(m_BuildTriangles[i].Centroid);
+        }
+
+        glm::vec3 cMin = centroidBounds.Min;
+        glm::vec3 cExtent = centroidBounds.GetSize();
+
+        float parentArea = AABB({ node.MinX, node.MinY, node.MinZ }, { node.MaxX, node.MaxY, node.MaxZ }).Area();
+
+        glm::vec3 scale(0.0f);
+        for (int axis = 0; axis < 3; axis++)
+            if (cExtent[axis] > 1e-6f) scale[axis] = (float)s_SAHBinCount / cExtent[axis];
+
+        // 2. 三个轴同时分桶 (质心在某个轴上重合时该轴 scale 为 0，跳过)
+        auto binRange = [&](int from, int to, SAHBinSet& out) {
+            for (int i = from; i < to; i++)
+            {
+                const auto& tri = m_BuildTriangles[i];
+                AABB triBox = GetTriangleBounds(tri);
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    if (scale[axis] == 0.0f) continue;
+                    int b = std::min(s_SAHBinCount - 1, (int)((tri.Centroid[axis] - cMin[axis]) * scale[axis]));
+                    out.Bins[axis][b].Count++;
+                    out.Bins[axis][b].Bounds.Grow(triBox);
+                }
+            }
+        };
+
+        SAHBinSet binSet;
+        if (parallel)
+        {
+            // 分块统计后按顺序合并，计数与 min/max 合并顺序无关，结果与串行一致
+            int chunkCount = (count + s_BinChunkSize - 1) / s_BinChunkSize;
+            std::vector<SAHBinSet> partial(chunkCount);
+            std::vector<int> chunks(chunkCount);
+            std::iota(chunks.begin(), chunks.end(), 0);
+
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](int c) {
+                int from = start + c * s_BinChunkSize;
+                int to = std::min(end, from + s_BinChunkSize);
+                binRange(from, to, partial[c]);
+            });
+
+            for (const auto& p : partial)
+                binSet.Merge(p);
+        }
+        else
+        {
+            binRange(start, end, binSet);
+        }
+
+        // 3. 找代价最小的切分面
+        float bestCost = 1e30f;
+        int bestAxis = -1;
+        int bestSplit = -1; // 桶 [0, bestSplit] 归左边
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (scale[axis] == 0.0f) continue; // 质心在这个轴上重合，切不开
+
+            const SAHBin* bins = binSet.Bins[axis];
+
+            // 从右往左扫一遍，记录右侧的累积面积和数量
+            float rightArea[s_SAHBinCount - 1];
+            int rightCount[s_SAHBinCount - 1];
+            AABB rightBox;
+            int rightSum = 0;
+            for (int i = s_SAHBinCount - 1; i > 0; i--)
+            {
+                rightBox.Grow(bins[i].Bounds);
+                rightSum += bins[i].Count;
+                rightArea[i - 1] = rightBox.Area();
+                rightCount[i - 1] = rightSum;
+            }
+
+            // 从左往右扫，计算每个切分面的代价
+            AABB leftBox;
+            int leftSum = 0;
+            for (int i = 0; i < s_SAHBinCount - 1; i++)
+            {
+                leftBox.Grow(bins[i].Bounds);
+                leftSum += bins[i].Count;
+                if (leftSum == 0 || rightCount[i] == 0) continue;
+
+                float cost = leftBox.Area() * leftSum + rightArea[i] * rightCount[i];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        // 4. 所有质心重合 (退化情况)：小节点直接做叶子，大节点对半切
+        if (bestAxis < 0)
+        {
+            if (count <= s_SAHMaxLeafSize) return -1;
+            return PartitionMidpoint(node, start, end);
+        }
+
+        // 5. 与不切分 (直接做叶子) 的代价比较
+        float splitCost = s_SAHTraversalCost + s_SAHIntersectCost * bestCost / std::max(parentArea, 1e-12f);
+        float leafCost = s_SAHIntersectCost * count;
+        if (splitCost >= leafCost && count <= s_SAHMaxLeafSize)
+            return -1;
+
+        // 6. 按最佳桶划分
+        float axisScale = scale[bestAxis];
+        float minAxis = cMin[bestAxis];
+        auto it = std::partition(m_BuildTriangles.begin() + start, m_BuildTriangles.begin() + end,
+            [=](const BVHTriangle& tri) {
+                int b = std::min(s_SAHBinCount - 1, (int)((tri.Centroid[bestAxis] - minAxis) * axisScale));
+                return b <= bestSplit;
+            });
+        int mid = (int)(it - m_BuildTriangles.begin());
+
+        if (mid == start || mid == end)
+            return PartitionMidpoint(node, start, end);
+
+        return mid;
+    }
+
+    void BVHBuilder::BuildParallel()
+    {
+        int triCount = (int)m_BuildTriangles.size();
+        int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+
+        // 1. 串行切出上层结构 (大节点内部的统计是并行的)，小子树收集成任务
+        // 每个线程平均分到 4 个任务左右，负载更均衡
+        std::vector<SubtreeTask> tasks;
+        BuildContext topCtx;
+        topCtx.Nodes = &m_Nodes;
+        topCtx.DeferredTasks = &tasks;
+        topCtx.TaskSize = std::max(s_MinTaskTriangles, triCount / (threadCount * 4));
+        topCtx.ParallelPasses = true;
+        SplitBVHNode(topCtx, 0, 0, triCount, 0);
+
+        // 2. 子树并行构建
+        // 每个任务只读写自己 [Start, End) 范围内的三角形，节点写到自己的局部数组里，互不干扰
+        std::for_each(std::execution::par, tasks.begin(), tasks.end(), [this](SubtreeTask& task) {
+            task.LocalNodes.reserve((task.End - task.Start) * 2);
+            task.LocalNodes.push_back(GPUBVHNode());
+
+            BuildContext localCtx;
+            localCtx.Nodes = &task.LocalNodes;
+            SplitBVHNode(localCtx, 0, task.Start, task.End, task.Depth);
+        });
+
+        // 3. 拼接：局部根节点写回占位节点，其余节点追加到全局数组并修正子节点索引
+        // 叶子节点存的是全局三角形偏移，不需要修正
+        for (auto& task : tasks)
+        {
+            uint32_t offset = (uint32_t)m_Nodes.size() - 1;
+            for (size_t i = 0; i < task.LocalNodes.size(); i++)
+            {
+                GPUBVHNode node = task.LocalNodes[i];
+                if (!node.IsLeaf())
+                    node.SetChildren(node.GetLeftChild() + offset, node.GetRightChild() + offset);
+
+                if (i == 0) m_Nodes[task.NodeIndex] = node;
+                else m_Nodes.push_back(node);
+            }
+        }
+
+        // 4. 统一编号顺序，保证与串行构建结果逐字节一致
+        ReorderToSerialLayout();
+    }
+
+    void BVHBuilder::ReorderToSerialLayout()
+    {
+        // 串行构建的分配顺序：先给当前节点分配一对子节点，再完整构建左子树，最后构建右子树
+        std::vector<GPUBVHNode> ordered;
+        ordered.reserve(m_Nodes.size());
+        ordered.push_back(m_Nodes[0]);
+
+        std::vector<std::pair<int, int>> stack; // (旧索引, 新索引)
+        stack.push_back({ 0, 0 });
+        while (!stack.empty())
+        {
+            auto [oldIdx, newIdx] = stack.back();
+            stack.pop_back();
+
+            const GPUBVHNode& node = m_Nodes[oldIdx];
+            if (node.IsLeaf()) continue;
+
+            int oldLeft = (int)node.GetLeftChild();
+            int oldRight = (int)node.GetRightChild();
+
+            int newLeft = (int)ordered.size();
+            ordered.push_back(m_Nodes[oldLeft]);
+            ordered.push_back(m_Nodes[oldRight]);
+            ordered[newIdx].SetChildren((uint32_t)newLeft, (uint32_t)(newLeft + 1));
+
+            // 先压右再压左，保证左子树先被完整处理
+            stack.push_back({ oldRight, newLeft + 1 });
+            stack.push_back({ oldLeft, newLeft });
+        }
+
+        m_Nodes = std::move(ordered);
+    }
+
+    float BVHBuilder::ComputeSAHCost(const std::vector<GPUBVHNode>& nodes)
+    {
+        if (nodes.empty()) return 0.0f;
+
+        auto nodeArea = [](const GPUBVHNode& n) {
+            return AABB({ n.MinX, n.MinY, n.MinZ }, { n.MaxX, n.MaxY, n.MaxZ }).Area();
+        };
+
+        float rootArea = nodeArea(nodes[0]);
+        if (rootArea <= 0.0f) return 0.0f;
+
+        // 非递归遍历：内部节点累加遍历代价，叶子累加求交代价
+        float cost = 0.0f;
+        std::vector<int> stack;
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            int idx = stack.back();
+            stack.pop_back();
+
+            const GPUBVHNode& node = nodes[idx];
+            float relArea = nodeArea(node) / rootArea;
+
+            if (node.IsLeaf())
+            {
+                cost += s_SAHIntersectCost * node.GetPrimCount() * relArea;
+            }
+            else
+            {
+                cost += s_SAHTraversalCost * relArea;
+                stack.push_back((int)node.GetLeftChild());
+                stack.push_back((int)node.GetRightChild());
+            }
+        }
+        return cost;
+    }
+
+    bool BVHBuilder::IsIdentical(const BVHBuilder& a, const BVHBuilder& b)
+    {
+        const auto& nodesA = a.GetNodes();
+        const auto& nodesB = b.GetNodes();
+        if (nodesA.size() != nodesB.size() || a.GetSortedIndices() != b.GetSortedIndices())
+            return false;
+
+        return memcmp(nodesA.data(), nodesB.data(), nodesA.size() * sizeof(GPUBVHNode)) == 0;
+    }
+
+    bool BVHBuilder::Refit(std::vector<GPUBVHNode>& nodes, const std::vector<uint32_t>& indices, const std::vector<BVHTriangle>& triangles,
+        std::vector<std::pair<uint32_t, uint32_t>>* dirtyRanges)
+    {
+        if (dirtyRanges) dirtyRanges->clear();
+        if (nodes.empty()) return true;
+
+        auto sameBounds = [](const GPUBVHNode& a, const GPUBVHNode& b) {
+            return a.MinX == b.MinX && a.MinY == b.MinY && a.MinZ == b.MinZ &&
+                a.MaxX == b.MaxX && a.MaxY == b.MaxY && a.MaxZ == b.MaxZ;
+        };
+
+        // 子节点索引总是大于父节点，逆序遍历即可保证先处理孩子
+        for (int64_t i = (int64_t)nodes.size() - 1; i >= 0; i--)
+        {
+            GPUBVHNode& node = nodes[i];
+            AABB box;
+
+            if (node.IsLeaf())
+            {
+                uint32_t first = node.GetFirstPrim();
+                uint32_t last = first + node.GetPrimCount();
+                if (last > indices.size()) return false;
+
+                for (uint32_t k = first; k < last; k++)
+                {
+                    const BVHTriangle& tri = triangles[indices[k]];
+                    box.Grow(tri.V0);
+                    box.Grow(tri.V1);
+                    box.Grow(tri.V2);
+                }
+            }
+            else
+            {
+                uint32_t left = node.GetLeftChild();
+                uint32_t right = node.GetRightChild();
+                if (left <= (uint64_t)i || right <= (uint64_t)i || left >= nodes.size() || right >= nodes.size())
+                    return false;
+
+                const GPUBVHNode& l = nodes[left];
+                const GPUBVHNode& r = nodes[right];
+                box.Grow(AABB({ l.MinX, l.MinY, l.MinZ }, { l.MaxX, l.MaxY, l.MaxZ }));
+                box.Grow(AABB({ r.MinX, r.MinY, r.MinZ }, { r.MaxX, r.MaxY, r.MaxZ }));
+            }
+
+            GPUBVHNode updated = node;
+            updated.MinX = box.Min.x; updated.MinY = box.Min.y; updated.MinZ = box.Min.z;
+            updated.MaxX = box.Max.x; updated.MaxY = box.Max.y; updated.MaxZ = box.Max.z;
+            if (sameBounds(node, updated)) continue;
+            node = updated;
+
+            if (!dirtyRanges) continue;
+
+            // 逆序遍历，脏区间向低地址扩展
+            uint32_t idx = (uint32_t)i;
+            if (!dirtyRanges->empty() && dirtyRanges->back().first <= idx + 1 + s_RefitMergeGap)
+            {
+                auto& range = dirtyRanges->back();
+                range.second += range.first - idx;
+                range.first = idx;
+            }
+            else
+            {
+                dirtyRanges->push_back({ idx, 1 });
+            }
+        }
+
+        if (dirtyRanges) std::reverse(dirtyRanges->begin(), dirtyRanges->end());
+        return true;
+    }
+
+    bool BVHBuilder::Intersect(const std::vector<GPUBVHNode>& nodes, const std::vector<uint32_t>& indices, const std::vector<BVHTriangle>& triangles,
+        const glm::vec3& origin, const glm::vec3& dir, float& outT, uint32_t& outTriangle, RayQueryStats* stats)
+    {
+        outT = 1e30f;
+        bool hit = false;
+        if (nodes.empty()) return false;
+
+        glm::vec3 invDir = 1.0f / dir;
+
+        int stack[64];
+        int stackPtr = 0;
+        stack[stackPtr++] = 0;
+
+        while (stackPtr > 0)
+        {
+            const GPUBVHNode& node = nodes[stack[--stackPtr]];
+            if (stats) stats->NodesVisited++;
+
+            if (!Math::RayAABBIntersection(origin, invDir, glm::vec3(node.MinX, node.MinY, node.MinZ),
+                glm::vec3(node.MaxX, node.MaxY, node.MaxZ), outT))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                uint32_t start = node.GetFirstPrim();
+                uint32_t count = node.GetPrimCount();
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const BVHTriangle& tri = triangles[indices[start + i]];
+                    if (stats) stats->TrianglesTested++;
+
+                    float t = Math::RayTriangleIntersection(origin, dir, tri.V0, tri.V1, tri.V2);
+                    if (t > 0.0f && t < outT)
+                    {
+                        outT = t;
+                        outTriangle = tri.Index;
+                        hit = true;
+                    }
+                }
+            }
+            else
+            {
+                stack[stackPtr++] = (int)node.GetLeftChild();
+                stack[stackPtr++] = (int)node.GetRightChild();
+            }
+        }
+        return hit;
+    }
+
+    bool BVHBuilder::Validate(const std::vector<GPUBVHNode>& nodes, const std::vector<uint32_t>& indices, size_t triangleCount)
+    {
+        if (nodes.empty())
+        {
+            if (triangleCount == 0) return true;
+            RONG_CORE_ERROR("BVH Validate: no nodes for {0} triangles", triangleCount);
+            return false;
+        }
+
+        std::vector<uint8_t> nodeVisited(nodes.size(), 0);
+        std::vector<uint32_t> triangleRefs(triangleCount, 0);
+
+        std::vector<uint32_t> stack;
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            uint32_t idx = stack.back();
+            stack.pop_back();
+
+            if (nodeVisited[idx])
+            {
+                RONG_CORE_ERROR("BVH Validate: node {0} is reachable more than once", idx);
+                return false;
+            }
+            nodeVisited[idx] = 1;
+
+            const GPUBVHNode& node = nodes[idx];
+            if (node.IsLeaf())
+            {
+                uint64_t first = node.GetFirstPrim();
+                uint64_t count = node.GetPrimCount();
+                if (first + count > indices.size())
+                {
+                    RONG_CORE_ERROR("BVH Validate: leaf {0} references [{1}, {2}) beyond index table size {3}",
+                        idx, first, first + count, indices.size());
+                    return false;
+                }
+                for (uint64_t i = first; i < first + count; i++)
+                {
+                    uint32_t triIndex = indices[i];
+                    if (triIndex >= triangleCount)
+                    {
+                        RONG_CORE_ERROR("BVH Validate: leaf {0} references invalid triangle {1}", idx, triIndex);
+                        return false;
+                    }
+                    triangleRefs[triIndex]++;
+                }
+                continue;
+            }
+
+            uint32_t left = node.GetLeftChild();
+            uint32_t right = node.GetRightChild();
+            if (left >= nodes.size() || right >= nodes.size())
+            {
+                RONG_CORE_ERROR("BVH Validate: node {0} has out-of-range children ({1}, {2})", idx, left, right);
+                return false;
+            }
+            stack.push_back(left);
+            stack.push_back(right);
+        }
+
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            if (triangleRefs[i] != 1)
+            {
+                RONG_CORE_ERROR("BVH Validate: triangle {0} is referenced {1} times (expected 1)", i, triangleRefs[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void BVHBuilder::Benchmark(const std::vector<BVHTriangle>& triangles)
+    {
+        if (triangles.empty())
+        {
+            RONG_CORE_WARN("BVH Benchmark: no triangles in scene");
+            return;
+        }
+
+        auto timeBuild = [&](BVHBuildQuality mode, bool parallel, float& outMs) {
+            auto start = std::chrono::high_resolution_clock::now();
+            BVHBuilder builder(triangles, mode, parallel);
+            auto end = std::chrono::high_resolution_clock::now();
+            outMs = std::chrono::duration<float, std::milli>(end - start).count();
+            return builder;
+        };
+
+        const BVHBuildQuality modes[] = { BVHBuildQuality::Midpoint, BVHBuildQuality::SAH };
+        for (BVHBuildQuality mode : modes)
+        {
+            float serialMs = 0.0f, parallelMs = 0.0f;
+            BVHBuilder serial = timeBuild(mode, false, serialMs);
+            BVHBuilder parallel = timeBuild(mode, true, parallelMs);
+
+            RONG_CORE_INFO("BVH Benchmark [{0}]: {1} Triangles, {2} Nodes, Build {3}ms, SAH Cost {4}",
+                QualityToString(mode), triangles.size(), serial.GetNodes().size(), serialMs, serial.ComputeSAHCost());
+            RONG_CORE_INFO("BVH Benchmark [{0}, Parallel x{1}]: Build {2}ms, Speedup {3}x, Output {4}",
+                QualityToString(mode), std::thread::hardware_concurrency(), parallelMs,
+                parallelMs > 0.0f ? serialMs / parallelMs : 0.0f,
+                IsIdentical(serial, parallel) ? "Identical" : "MISMATCH");
+
+            if (Validate(serial.GetNodes(), serial.GetSortedIndices(), triangles.size()))
+                RONG_CORE_INFO("BVH Benchmark [{0}]: Validate OK (node format v{1})", QualityToString(mode), GPUBVHNode::FormatVersion);
+        }
+
+        // 线性 BVH：构建最快，树质量最差
+        auto start = std::chrono::high_resolution_clock::now();
+        LBVHBuilder lbvh(triangles);
+        auto end = std::chrono::high_resolution_clock::now();
+        float lbvhMs = std::chrono::duration<float, std::milli>(end - start).count();
+
+        RONG_CORE_INFO("BVH Benchmark [LBVH]: {0} Triangles, {1} Nodes, Build {2}ms, SAH Cost {3}",
+            triangles.size(), lbvh.GetNodes().size(), lbvhMs, ComputeSAHCost(lbvh.GetNodes()));
 
-        // 7. 递归构建子节点
-        SplitBVHNode(leftChildIdx, start, mid, depth + 1);
-        SplitBVHNode(rightChildIdx, mid, end, depth + 1);
+        if (Validate(lbvh.GetNodes(), lbvh.GetSortedIndices(), triangles.size()))
+            RONG_CORE_INFO("BVH Benchmark [LBVH]: Validate OK (node format v{0})", GPUBVHNode::FormatVersion);
     }
-}
\ No newline at end of file
+}
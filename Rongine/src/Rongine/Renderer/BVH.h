@@ -1,31 +1,93 @@
 #pragma once
 #include "Rongine/Renderer/AccelerationStructures.h"
-#include "Rongine/Renderer/RenderTypes.h" 
+#include "Rongine/Renderer/RenderTypes.h"
 
 #include <vector>
 #include <glm/glm.hpp>
 
 namespace Rongine {
+    // 自顶向下 BVH 构建器，支持 Midpoint / SAH 两种切分策略
+    // (BVHBuildQuality::LBVH 由 LBVHBuilder 负责)
     class BVHBuilder {
     public:
-        BVHBuilder(const std::vector<BVHTriangle>& triangles);
+        // parallel = true 时：上层节点的包围盒/分桶统计并行计算，下层子树分发到线程池独立构建
+        // 无论串行还是并行，输出的节点数组和索引表完全一致
+        BVHBuilder(const std::vector<BVHTriangle>& triangles, BVHBuildQuality quality = BVHBuildQuality::Midpoint, bool parallel = false);
 
-        // 获取构建好的节点数组 
+        // 获取构建好的节点数组
         const std::vector<GPUBVHNode>& GetNodes() const { return m_Nodes; }
 
         // 获取重排后的索引映射
         const std::vector<uint32_t>& GetSortedIndices() const { return m_SortedIndices; }
 
+        BVHBuildQuality GetQuality() const { return m_Quality; }
+
+        // 计算整棵树的 SAH 代价 (相对根节点表面积归一化，越小遍历越快)
+        float ComputeSAHCost() const { return ComputeSAHCost(m_Nodes); }
+        static float ComputeSAHCost(const std::vector<GPUBVHNode>& nodes);
+
+        // 比较两个构建结果是否逐字节一致 (用于校验并行构建与串行构建)
+        static bool IsIdentical(const BVHBuilder& a, const BVHBuilder& b);
+
+        // 保持树结构，按新的三角形位置自底向上重算包围盒 (拓扑不变、只有顶点移动时使用)
+        // 要求子节点索引大于父节点 (BVHBuilder / LBVHBuilder 的输出都满足)，否则返回 false
+        // dirtyRanges 输出包围盒有变化的节点区间 (first, count)，相距很近的区间会合并成一段
+        static bool Refit(std::vector<GPUBVHNode>& nodes, const std::vector<uint32_t>& indices, const std::vector<BVHTriangle>& triangles,
+            std::vector<std::pair<uint32_t, uint32_t>>* dirtyRanges = nullptr);
+
+        // CPU 端求交 (与 Shader 中 TraverseBVH 一致)，返回最近交点和三角形原始 ID
+        // indices 中存的是三角形原始 ID，要求 triangles[i].Index == i (CollectWorldTriangles 的输出满足这一点)
+        static bool Intersect(const std::vector<GPUBVHNode>& nodes, const std::vector<uint32_t>& indices, const std::vector<BVHTriangle>& triangles,
+            const glm::vec3& origin, const glm::vec3& dir, float& outT, uint32_t& outTriangle, RayQueryStats* stats = nullptr);
+
+        // CPU 端遍历整棵树做结构校验：子节点/叶子范围不越界、每个节点只被访问一次、
+        // 每个三角形 (0 ~ triangleCount-1) 恰好被一个叶子引用一次。失败时打印第一个错误
+        static bool Validate(const std::vector<GPUBVHNode>& nodes, const std::vector<uint32_t>& indices, size_t triangleCount);
+
+        // 性能测试：对同一组三角形分别用各种策略构建，打印构建耗时与 SAH 代价
+        static void Benchmark(const std::vector<BVHTriangle>& triangles);
+
+        static const char* QualityToString(BVHBuildQuality quality);
+
     private:
+        // 延迟到线程池构建的子树
+        struct SubtreeTask {
+            int NodeIndex;
+            int Start, End;
+            int Depth;
+            std::vector<GPUBVHNode> LocalNodes;
+        };
+
+        // 一次递归构建的上下文：节点写到哪里、是否把子树延迟成任务
+        struct BuildContext {
+            std::vector<GPUBVHNode>* Nodes = nullptr;
+            std::vector<SubtreeTask>* DeferredTasks = nullptr; // 为空表示一路递归到底
+            int TaskSize = 0;                                   // 三角形数不超过该值的子树变成任务
+            bool ParallelPasses = false;                        // 包围盒/分桶是否并行统计
+        };
+
         // 递归构建函数
-        void SplitBVHNode(int nodeIndex, int start, int end, int depth);
+        void SplitBVHNode(BuildContext& ctx, int nodeIndex, int start, int end, int depth);
 
         // 更新节点的 AABB 包围盒
-        void UpdateNodeBounds(int nodeIndex, int start, int end);
+        void UpdateNodeBounds(GPUBVHNode& node, int start, int end, bool parallel);
+
+        // 切分策略：返回切分位置 mid，返回 -1 表示应当作为叶子
+        int PartitionMidpoint(const GPUBVHNode& node, int start, int end);
+        int PartitionSAH(const GPUBVHNode& node, int start, int end, bool parallel);
+
+        // 并行构建：先串行切出上层，再并行构建子树，最后拼接
+        void BuildParallel();
+
+        // 把节点重新编号为串行递归的分配顺序，保证与串行构建结果一致
+        void ReorderToSerialLayout();
 
         std::vector<GPUBVHNode> m_Nodes;           // 最终输出给 GPU 的节点
         std::vector<BVHTriangle> m_BuildTriangles; // 构建时的临时三角形数据
         std::vector<uint32_t> m_SortedIndices;     // 最终输出的索引
+
+        BVHBuildQuality m_Quality = BVHBuildQuality::Midpoint;
+        bool m_Parallel = false;
     };
 
-}
\ No newline at end of file
+}
@@ -61,7 +61,39 @@ namespace Rongine {
 		return nullptr;
 	}
 
+	Ref<IndexBuffer> IndexBuffer::create(uint32_t capacity, uint32_t indexSize)
+	{
+		switch (Renderer::getAPI())
+		{
+		case RendererAPI::API::None: {
+			RONG_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		}
+		case RendererAPI::API::OpenGL: {
+			return CreateRef<OpenGLIndexBuffer>(capacity, indexSize);
+		}
+		}
+		RONG_CORE_ASSERT(false, "UnKnown RendererAPI!");
+		return nullptr;
+	}
+
 	Ref<IndexBuffer> IndexBuffer::create(uint32_t* indices, uint32_t count)
+	{
+		switch (Renderer::getAPI())
+		{
+		case RendererAPI::API::None: {
+			RONG_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+			return nullptr;
+		}
+		case RendererAPI::API::OpenGL: {
+			return CreateRef<OpenGLIndexBuffer>(indices, count);
+		}
+		}
+		RONG_CORE_ASSERT(false, "UnKnown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<IndexBuffer> IndexBuffer::create(uint16_t* indices, uint32_t count)
 	{
 		switch (Renderer::getAPI())
 		{
@@ -5,7 +5,8 @@ namespace Rongine {
 
 	enum class ShaderDataType
 	{
-		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+		Short2, UShort4 // 16 位整数，normalized 时在 Shader 中读作 [-1,1] / [0,1] 的浮点
 	};
 
 	static uint32_t shaderDateTypeSize(ShaderDataType type)
@@ -23,6 +24,8 @@ namespace Rongine {
 		case ShaderDataType::Int3:   return 4 * 3;
 		case ShaderDataType::Int4:   return 4 * 4;
 		case ShaderDataType::Bool:   return 1;
+		case ShaderDataType::Short2: return 2 * 2;
+		case ShaderDataType::UShort4: return 2 * 4;
 		}
 
 		RONG_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -61,6 +64,8 @@ namespace Rongine {
 			case ShaderDataType::Int3:    return 3;
 			case ShaderDataType::Int4:    return 4;
 			case ShaderDataType::Bool:    return 1;
+			case ShaderDataType::Short2:  return 2;
+			case ShaderDataType::UShort4: return 4;
 			}
 
 			RONG_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -112,7 +117,8 @@ namespace Rongine {
 		virtual void bind()const =0;
 		virtual void unbind()const =0;
 
-		virtual void setData(const void* data,uint32_t size) = 0;
+		// offset: 写入位置 (字节)，只更新 [offset, offset + size)，不重新分配显存
+		virtual void setData(const void* data,uint32_t size, uint32_t offset = 0) = 0;
 		virtual const BufferLayout& getLayout() const =0;
 		virtual void setLayout(const BufferLayout& layout) = 0;
 
@@ -131,9 +137,17 @@ namespace Rongine {
 		virtual void unbind()const = 0;
 
 		virtual inline uint32_t getCount() const = 0;
+		virtual uint32_t getIndexSize() const = 0; // 每个索引的字节数 (2 或 4)
+		virtual uint32_t getCapacity() const = 0;  // 分配的索引个数 (>= getCount)
+
+		// 部分更新 (offset/size 以字节计)，绘制数量单独由 setCount 指定 (不能超过容量)
+		virtual void setData(const void* data, uint32_t size, uint32_t offset) = 0;
+		virtual void setCount(uint32_t count) = 0;
 
 		static Ref<IndexBuffer> create(uint32_t count);
+		static Ref<IndexBuffer> create(uint32_t capacity, uint32_t indexSize); // 预留容量，内容之后用 setData 写入
 		static Ref<IndexBuffer> create(uint32_t* indices, uint32_t count);
+		static Ref<IndexBuffer> create(uint16_t* indices, uint32_t count); // 顶点数少于 65536 的网格
 	};
 }
 
@@ -0,0 +1,216 @@
+#include "Rongpch.h"
+#include "LBVH.h"
+#include "Rongine/Core/Log.h"
+
+#include <execution> // C++17 并行算法
+#include <numeric>
+
+namespace Rongine {
+
+    static const int s_RadixBits = 8;
+    static const int s_RadixBuckets = 1 << s_RadixBits;
+    static const int s_RadixPasses = 4;          // 30 位 Morton 码，4 趟覆盖
+    static const int s_RadixChunkSize = 65536;   // 每个并行分块的元素数
+
+    // 把 10 位整数的每一位之间插入两个 0
+    static uint32_t ExpandBits(uint32_t v)
+    {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+
+    uint32_t LBVHBuilder::MortonCode3D(const glm::vec3& normalized)
+    {
+        uint32_t x = (uint32_t)std::min(std::max(normalized.x * 1024.0f, 0.0f), 1023.0f);
+        uint32_t y = (uint32_t)std::min(std::max(normalized.y * 1024.0f, 0.0f), 1023.0f);
+        uint32_t z = (uint32_t)std::min(std::max(normalized.z * 1024.0f, 0.0f), 1023.0f);
+        return (ExpandBits(x) << 2) | (ExpandBits(y) << 1) | ExpandBits(z);
+    }
+
+    LBVHBuilder::LBVHBuilder(const std::vector<BVHTriangle>& triangles)
+        : m_Triangles(triangles)
+    {
+        int triCount = (int)triangles.size();
+        if (triCount == 0) return;
+
+        // 1. 质心包围盒 (用于把质心归一化到 [0,1])
+        AABB centroidBounds = std::transform_reduce(std::execution::par,
+            triangles.begin(), triangles.end(), AABB(),
+            [](AABB a, const AABB& b) { a.Grow(b); return a; },
+            [](const BVHTriangle& tri) { return AABB(tri.Centroid, tri.Centroid); });
+
+        glm::vec3 extent = centroidBounds.GetSize();
+        glm::vec3 invExtent(
+            extent.x > 1e-6f ? 1.0f / extent.x : 0.0f,
+            extent.y > 1e-6f ? 1.0f / extent.y : 0.0f,
+            extent.z > 1e-6f ? 1.0f / extent.z : 0.0f);
+
+        // 2. 并行计算 Morton 码
+        m_MortonCodes.resize(triCount);
+        std::transform(std::execution::par, triangles.begin(), triangles.end(), m_MortonCodes.begin(),
+            [&](const BVHTriangle& tri) {
+                glm::vec3 p = tri.Centroid - centroidBounds.Min;
+                return MortonCode3D(glm::vec3(p.x * invExtent.x, p.y * invExtent.y, p.z * invExtent.z));
+            });
+
+        m_Order.resize(triCount);
+        std::iota(m_Order.begin(), m_Order.end(), 0u);
+
+        // 3. 按 Morton 码排序
+        RadixSort();
+
+        // 4. 自顶向下生成层级 (子节点成对分配，与 BVHBuilder 布局一致)
+        m_Nodes.reserve(triCount);
+        m_Nodes.push_back(GPUBVHNode());
+        EmitNode(0, 0, triCount, 0);
+
+        // 5. 生成最终索引表
+        m_SortedIndices.resize(triCount);
+        for (int i = 0; i < triCount; i++)
+            m_SortedIndices[i] = triangles[m_Order[i]].Index;
+
+        RONG_CORE_INFO("LBVH Built Successfully: {0} Triangles -> {1} Nodes", triCount, m_Nodes.size());
+    }
+
+    void LBVHBuilder::RadixSort()
+    {
+        int count = (int)m_MortonCodes.size();
+        int chunkCount = (count + s_RadixChunkSize - 1) / s_RadixChunkSize;
+
+        std::vector<uint32_t> tmpCodes(count);
+        std::vector<uint32_t> tmpOrder(count);
+
+        std::vector<int> chunks(chunkCount);
+        std::iota(chunks.begin(), chunks.end(), 0);
+
+        // 每个分块一份直方图 / 写入偏移
+        std::vector<uint32_t> histograms((size_t)chunkCount * s_RadixBuckets);
+
+        for (int pass = 0; pass < s_RadixPasses; pass++)
+        {
+            int shift = pass * s_RadixBits;
+
+            // 1. 各分块并行统计直方图
+            std::fill(histograms.begin(), histograms.end(), 0u);
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](int c) {
+                uint32_t* hist = &histograms[(size_t)c * s_RadixBuckets];
+                int from = c * s_RadixChunkSize;
+                int to = std::min(count, from + s_RadixChunkSize);
+                for (int i = from; i < to; i++)
+                    hist[(m_MortonCodes[i] >> shift) & (s_RadixBuckets - 1)]++;
+            });
+
+            // 2. 前缀和：桶优先、分块其次，保证排序稳定
+            uint32_t sum = 0;
+            for (int b = 0; b < s_RadixBuckets; b++)
+            {
+                for (int c = 0; c < chunkCount; c++)
+                {
+                    uint32_t& h = histograms[(size_t)c * s_RadixBuckets + b];
+                    uint32_t n = h;
+                    h = sum;
+                    sum += n;
+                }
+            }
+
+            // 3. 各分块并行分散到自己的写入区间
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](int c) {
+                uint32_t* offsets = &histograms[(size_t)c * s_RadixBuckets];
+                int from = c * s_RadixChunkSize;
+                int to = std::min(count, from + s_RadixChunkSize);
+                for (int i = from; i < to; i++)
+                {
+                    uint32_t dst = offsets[(m_MortonCodes[i] >> shift) & (s_RadixBuckets - 1)]++;
+                    tmpCodes[dst] = m_MortonCodes[i];
+                    tmpOrder[dst] = m_Order[i];
+                }
+            });
+
+            m_MortonCodes.swap(tmpCodes);
+            m_Order.swap(tmpOrder);
+        }
+    }
+
+    int LBVHBuilder::FindSplit(int start, int end) const
+    {
+        uint32_t first = m_MortonCodes[start];
+        uint32_t last = m_MortonCodes[end - 1];
+
+        // Morton 码完全相同：对半切
+        if (first == last)
+            return (start + end) / 2;
+
+        // 最高不同位
+        int commonPrefix = 0;
+        uint32_t diff = first ^ last;
+        while ((diff & 0x80000000u) == 0) { diff <<= 1; commonPrefix++; }
+
+        // 二分查找：最后一个与 first 共享超过 commonPrefix 位前缀的元素
+        int split = start;
+        int step = end - 1 - start;
+        do
+        {
+            step = (step + 1) >> 1;
+            int newSplit = split + step;
+            if (newSplit < end - 1)
+            {
+                uint32_t splitDiff = first ^ m_MortonCodes[newSplit];
+                int splitPrefix = 32;
+                if (splitDiff != 0)
+                {
+                    splitPrefix = 0;
+                    while ((splitDiff & 0x80000000u) == 0) { splitDiff <<= 1; splitPrefix++; }
+                }
+                if (splitPrefix > commonPrefix)
+                    split = newSplit;
+            }
+        } while (step > 1);
+
+        return split + 1;
+    }
+
+    AABB LBVHBuilder::EmitNode(int nodeIndex, int start, int end, int depth)
+    {
+        int count = end - start;
+
+        // 1. 叶子：与 BVHBuilder 相同的终止条件和编码
+        if (count <= 4 || depth > 32)
+        {
+            AABB box;
+            for (int i = start; i < end; i++)
+            {
+                const auto& tri = m_Triangles[m_Order[i]];
+                box.Grow(tri.V0);
+                box.Grow(tri.V1);
+                box.Grow(tri.V2);
+            }
+
+            GPUBVHNode& node = m_Nodes[nodeIndex];
+            node.MinX = box.Min.x; node.MinY = box.Min.y; node.MinZ = box.Min.z;
+            node.MaxX = box.Max.x; node.MaxY = box.Max.y; node.MaxZ = box.Max.z;
+            node.SetLeaf((uint32_t)start, (uint32_t)count);
+            return box;
+        }
+
+        // 2. 按 Morton 码最高不同位切分
+        int mid = FindSplit(start, end);
+
+        // 3. 子节点成对分配 (push_back 可能扩容，之后再通过下标访问)
+        int leftChildIdx = (int)m_Nodes.size();
+        m_Nodes.push_back(GPUBVHNode());
+        m_Nodes.push_back(GPUBVHNode());
+
+        AABB box = EmitNode(leftChildIdx, start, mid, depth + 1);
+        box.Grow(EmitNode(leftChildIdx + 1, mid, end, depth + 1));
+
+        // 4. 内部节点包围盒 = 两个子节点的并集
+        GPUBVHNode& node = m_Nodes[nodeIndex];
+        node.MinX = box.Min.x; node.MinY = box.Min.y; node.MinZ = box.Min.z;
+        node.MaxX = box.Max.x; node.MaxY = box.Max.y; node.MaxZ = box.Max.z;
+        node.SetChildren((uint32_t)leftChildIdx, (uint32_t)(leftChildIdx + 1));
+        return box;
+    }
+}
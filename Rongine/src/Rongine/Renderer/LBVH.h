@@ -0,0 +1,42 @@
+#pragma once
+#include "Rongine/Renderer/AccelerationStructures.h"
+#include "Rongine/Renderer/RenderTypes.h"
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Rongine {
+
+    // 线性 BVH (Linear BVH)：按 Morton 码排序三角形后直接按位切分层级
+    // 构建速度远快于 SAH，树的质量略差，适合拖拽 Gizmo 时的交互式重建
+    // 输出与 BVHBuilder 相同的 GPUBVHNode 布局和索引表
+    class LBVHBuilder {
+    public:
+        LBVHBuilder(const std::vector<BVHTriangle>& triangles);
+
+        const std::vector<GPUBVHNode>& GetNodes() const { return m_Nodes; }
+        const std::vector<uint32_t>& GetSortedIndices() const { return m_SortedIndices; }
+
+        // 把 [0,1] 范围内的坐标编码成 30 位 Morton 码 (每轴 10 位)
+        static uint32_t MortonCode3D(const glm::vec3& normalized);
+
+    private:
+        // 并行基数排序 (LSD，每趟 8 位)，按 Morton 码稳定排序 m_Order
+        void RadixSort();
+
+        // 按 Morton 码最高不同位递归切分，返回节点包围盒
+        AABB EmitNode(int nodeIndex, int start, int end, int depth);
+
+        // 在 [start, end) 中找 Morton 码最高不同位发生变化的位置
+        int FindSplit(int start, int end) const;
+
+        const std::vector<BVHTriangle>& m_Triangles;
+
+        std::vector<uint32_t> m_MortonCodes; // 排序后的 Morton 码
+        std::vector<uint32_t> m_Order;       // 排序后的三角形下标 (指向 m_Triangles)
+
+        std::vector<GPUBVHNode> m_Nodes;
+        std::vector<uint32_t> m_SortedIndices;
+    };
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "Rongine/Core/Core.h"
+#include "Rongine/Utils/MappedFile.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace Rongine {
+
+	// 只读的连续数组视图 (不持有数据)，std::vector 和 MeshArray 都可以直接传进来
+	template<typename T>
+	class ArrayView
+	{
+	public:
+		ArrayView() = default;
+		ArrayView(const T* data, size_t size) : m_data(data), m_size(size) {}
+		ArrayView(const std::vector<T>& values) : m_data(values.data()), m_size(values.size()) {}
+
+		const T* data() const { return m_data; }
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		const T& operator[](size_t i) const { return m_data[i]; }
+		const T* begin() const { return m_data; }
+		const T* end() const { return m_data + m_size; }
+
+	private:
+		const T* m_data = nullptr;
+		size_t m_size = 0;
+	};
+
+	// MeshComponent 的 CPU 网格数组：要么自己持有 std::vector，要么只读引用映射文件里的一段 (零拷贝)
+	// 引用映射时同时持有 MappedFile，组件还在映射就不会被释放；复制组件只复制指针
+	// 没有提供逐元素修改，整体替换 (赋值一个 vector) 或 clear
+	template<typename T>
+	class MeshArray
+	{
+	public:
+		MeshArray() = default;
+		MeshArray(std::vector<T> values) : m_owned(std::move(values)) {}
+		MeshArray(const T* data, size_t size, const Ref<MappedFile>& source)
+			: m_mapped(data), m_mappedSize(size), m_source(source) {}
+
+		const T* data() const { return m_source ? m_mapped : m_owned.data(); }
+		size_t size() const { return m_source ? m_mappedSize : m_owned.size(); }
+		bool empty() const { return size() == 0; }
+		const T& operator[](size_t i) const { return data()[i]; }
+		const T* begin() const { return data(); }
+		const T* end() const { return data() + size(); }
+
+		operator ArrayView<T>() const { return ArrayView<T>(data(), size()); }
+
+		void clear() { *this = MeshArray(); }
+
+		// 引用映射时返回映射文件，否则为空
+		const Ref<MappedFile>& getSource() const { return m_source; }
+
+		// 把映射里的数据复制成自己持有 (映射文件要被覆盖前调用)
+		void detach()
+		{
+			if (!m_source) return;
+			m_owned.assign(m_mapped, m_mapped + m_mappedSize);
+			m_mapped = nullptr;
+			m_mappedSize = 0;
+			m_source.reset();
+		}
+
+	private:
+		std::vector<T> m_owned;
+		const T* m_mapped = nullptr;
+		size_t m_mappedSize = 0;
+		Ref<MappedFile> m_source;
+	};
+}
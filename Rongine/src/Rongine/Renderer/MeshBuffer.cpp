@@ -0,0 +1,561 @@
+#include "Rongpch.h"
+#include "MeshBuffer.h"
+#include "VertexCompression.h"
+#include "Rongine/Core/Log.h"
+
+#include <climits>
+#include <cstring>
+
+namespace Rongine {
+
+	static MeshBuffer::UpdateStats s_TotalStats;
+
+	// 一个面在 BuildMeshData 输出中的顶点段和索引段
+	struct FaceRun
+	{
+		int FaceID = 0;
+		uint32_t FirstVertex = 0;
+		uint32_t VertexCount = 0;
+		uint32_t FirstIndex = 0;
+		uint32_t IndexCount = 0;
+		uint64_t Hash = 0;
+	};
+
+	// 面的顶点或三角形不连续时 (非 CADMesher 生成的网格) 整个网格当作一个面
+	static constexpr int WholeMeshFaceID = INT_MIN;
+
+	static bool SplitFaceRuns(ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices, std::vector<FaceRun>& outRuns)
+	{
+		std::unordered_map<int, uint32_t> runOfFace;
+		for (uint32_t v = 0; v < (uint32_t)vertices.size(); v++)
+		{
+			int faceID = vertices[v].FaceID;
+			if (outRuns.empty() || outRuns.back().FaceID != faceID)
+			{
+				if (!runOfFace.emplace(faceID, (uint32_t)outRuns.size()).second) return false; // 同一个面的顶点不连续
+				FaceRun run;
+				run.FaceID = faceID;
+				run.FirstVertex = v;
+				outRuns.push_back(run);
+			}
+			outRuns.back().VertexCount++;
+		}
+
+		for (uint32_t i = 0; i + 2 < (uint32_t)indices.size(); i += 3)
+		{
+			if (indices[i] >= vertices.size()) return false;
+			FaceRun& run = outRuns[runOfFace[vertices[indices[i]].FaceID]];
+
+			if (run.IndexCount == 0) run.FirstIndex = i;
+			else if (run.FirstIndex + run.IndexCount != i) return false; // 同一个面的三角形不连续
+
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				uint32_t index = indices[i + k];
+				if (index < run.FirstVertex || index >= run.FirstVertex + run.VertexCount) return false; // 三角形跨面
+			}
+			run.IndexCount += 3;
+		}
+		return true;
+	}
+
+	// FNV-1a
+	static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// 重新分配的容量和索引宽度 (BytesFull 按同样的规则估算整体上传)
+	static uint32_t VertexCapacityFor(uint32_t vertexCount) { return std::max(vertexCount + vertexCount / 2, 256u); }
+	static uint32_t IndexCapacityFor(uint32_t indexCount) { return std::max(indexCount + indexCount / 2, 768u); }
+	static uint32_t IndexSizeFor(uint32_t vertexCapacity) { return vertexCapacity <= 65536 ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+	// 面的内容 = 紧凑顶点 + 面内局部索引，和它在缓冲里的位置无关
+	static uint64_t HashFaceRun(const std::vector<CADVertex>& compact, ArrayView<uint32_t> indices, const FaceRun& run)
+	{
+		uint64_t hash = HashBytes(compact.data() + run.FirstVertex, run.VertexCount * sizeof(CADVertex));
+		for (uint32_t i = 0; i < run.IndexCount; i++)
+		{
+			uint32_t local = indices[run.FirstIndex + i] - run.FirstVertex;
+			hash = HashBytes(&local, sizeof(local), hash);
+		}
+		return hash;
+	}
+
+	// 新包围盒还在原来的量化范围内时沿用原参数 (否则所有顶点的量化值都会变，只能整体上传)
+	// 范围缩小到一半以下时重新量化，避免精度一直损失下去
+	static bool FitsQuantization(const AABB& bounds, const glm::vec3& offset, const glm::vec3& scale)
+	{
+		glm::vec3 extent = scale * 65535.0f;
+		glm::vec3 tolerance = extent * 1e-6f + 1e-7f;
+		if (glm::any(glm::lessThan(bounds.Min, offset - tolerance))) return false;
+		if (glm::any(glm::greaterThan(bounds.Max, offset + extent + tolerance))) return false;
+
+		glm::vec3 size = bounds.GetSize();
+		float largest = std::max(extent.x, std::max(extent.y, extent.z));
+		return std::max(size.x, std::max(size.y, size.z)) * 2.0f >= largest;
+	}
+
+	void MeshBuffer::UpdateStats::add(const UpdateStats& other)
+	{
+		BytesUploaded += other.BytesUploaded;
+		BytesFull += other.BytesFull;
+		WriteCalls += other.WriteCalls;
+		FacesKept += other.FacesKept;
+		FacesRewritten += other.FacesRewritten;
+		FacesMoved += other.FacesMoved;
+		FacesFreed += other.FacesFreed;
+		Reallocations += other.Reallocations;
+	}
+
+	const MeshBuffer::UpdateStats& MeshBuffer::getTotalStats()
+	{
+		return s_TotalStats;
+	}
+
+	void MeshBuffer::resetTotalStats()
+	{
+		s_TotalStats = UpdateStats();
+	}
+
+	BufferLayout MeshBuffer::getVertexLayout()
+	{
+		return {
+			{ ShaderDataType::UShort4, "a_Position", true },
+			{ ShaderDataType::Short2,  "a_Normal",   true },
+			{ ShaderDataType::Int,     "a_FaceID" }
+		};
+	}
+
+	void MeshBuffer::release()
+	{
+		m_vertexBuffer.reset();
+		m_indexBuffer.reset();
+		m_vertexCapacity = m_indexCapacity = 0;
+		m_vertexEnd = m_indexEnd = 0;
+		m_slots.clear();
+	}
+
+	Ref<VertexArray> MeshBuffer::update(ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices)
+	{
+		m_lastStats = UpdateStats();
+
+		if (vertices.empty() || indices.empty())
+		{
+			release();
+			return nullptr;
+		}
+
+		// 1. 按面切分
+		std::vector<FaceRun> runs;
+		if (!SplitFaceRuns(vertices, indices, runs))
+		{
+			runs.assign(1, FaceRun{ WholeMeshFaceID, 0, (uint32_t)vertices.size(), 0, (uint32_t)indices.size(), 0 });
+		}
+
+		// 2. 量化：能沿用原参数时，没变的面量化结果逐字节相同
+		AABB bounds;
+		for (const auto& v : vertices)
+			bounds.Grow(v.Position);
+
+		bool reallocate = !m_vertexBuffer || !FitsQuantization(bounds, m_dequantOffset, m_dequantScale);
+		if (reallocate)
+		{
+			m_dequantOffset = bounds.Min;
+			m_dequantScale = bounds.GetSize() / 65535.0f;
+		}
+
+		std::vector<CADVertex> compact;
+		QuantizeCADVertices(vertices, m_dequantOffset, m_dequantScale, compact);
+		for (auto& run : runs)
+			run.Hash = HashFaceRun(compact, indices, run);
+
+		m_lastStats.BytesFull = compact.size() * sizeof(CADVertex) + indices.size() * IndexSizeFor(VertexCapacityFor((uint32_t)vertices.size()));
+
+		// 3. 规划每个面的位置
+		std::unordered_map<int, FaceSlot> slots;
+		if (!reallocate)
+		{
+			enum class Action { Keep, Rewrite, Append };
+			std::vector<Action> actions(runs.size());
+
+			uint32_t vertexEnd = m_vertexEnd, indexEnd = m_indexEnd;
+			uint64_t liveVertices = 0, liveIndices = 0;
+			for (size_t r = 0; r < runs.size(); r++)
+			{
+				const FaceRun& run = runs[r];
+				FaceSlot slot;
+				auto it = m_slots.find(run.FaceID);
+				if (it != m_slots.end() && it->second.Hash == run.Hash)
+				{
+					slot = it->second;
+					actions[r] = Action::Keep;
+				}
+				else if (it != m_slots.end() && run.VertexCount <= it->second.VertexCapacity && run.IndexCount <= it->second.IndexCapacity)
+				{
+					slot = it->second;
+					actions[r] = Action::Rewrite;
+				}
+				else
+				{
+					slot.VertexOffset = vertexEnd;
+					slot.VertexCapacity = run.VertexCount;
+					slot.IndexOffset = indexEnd;
+					slot.IndexCapacity = run.IndexCount;
+					vertexEnd += run.VertexCount;
+					indexEnd += run.IndexCount;
+					actions[r] = Action::Append;
+				}
+				slot.Hash = run.Hash;
+				liveVertices += slot.VertexCapacity;
+				liveIndices += slot.IndexCapacity;
+				slots[run.FaceID] = slot;
+			}
+
+			// 余量用完 / 16 位索引放不下 / 空洞超过一半：重新分配
+			reallocate = vertexEnd > m_vertexCapacity || indexEnd > m_indexCapacity ||
+				(m_indexSize == sizeof(uint16_t) && vertexEnd > 65536) ||
+				vertexEnd > liveVertices * 2 || indexEnd > liveIndices * 2;
+
+			if (!reallocate)
+			{
+				// 4. 只写变化的面
+				for (size_t r = 0; r < runs.size(); r++)
+				{
+					const FaceRun& run = runs[r];
+					const FaceSlot& slot = slots[run.FaceID];
+					if (actions[r] == Action::Keep)
+					{
+						m_lastStats.FacesKept++;
+						continue;
+					}
+
+					writeVertices(compact.data() + run.FirstVertex, run.VertexCount, slot.VertexOffset);
+					writeIndices(indices.data() + run.FirstIndex, run.IndexCount, slot.IndexCapacity,
+						(int32_t)slot.VertexOffset - (int32_t)run.FirstVertex, slot.IndexOffset);
+					if (actions[r] == Action::Rewrite) m_lastStats.FacesRewritten++;
+					else m_lastStats.FacesMoved++;
+				}
+
+				// 5. 删除或搬走的面：索引段清零，绘制时都是退化三角形
+				for (const auto& [faceID, oldSlot] : m_slots)
+				{
+					auto it = slots.find(faceID);
+					if (it != slots.end() && it->second.IndexOffset == oldSlot.IndexOffset) continue;
+					if (oldSlot.IndexCapacity > 0)
+						writeIndices(nullptr, 0, oldSlot.IndexCapacity, 0, oldSlot.IndexOffset);
+					m_lastStats.FacesFreed++;
+				}
+
+				m_vertexEnd = vertexEnd;
+				m_indexEnd = indexEnd;
+			}
+		}
+
+		if (reallocate)
+		{
+			// 重新分配：按输入顺序紧密排列，末尾留一半余量给之后变大的面
+			uint32_t vertexCount = (uint32_t)vertices.size();
+			uint32_t indexCount = (uint32_t)indices.size();
+			m_vertexCapacity = VertexCapacityFor(vertexCount);
+			m_indexCapacity = IndexCapacityFor(indexCount);
+			m_indexSize = IndexSizeFor(m_vertexCapacity);
+
+			m_vertexBuffer = createVertexBuffer(m_vertexCapacity * (uint32_t)sizeof(CADVertex));
+			m_vertexBuffer->setLayout(getVertexLayout());
+			m_indexBuffer = createIndexBuffer(m_indexCapacity, m_indexSize);
+
+			writeVertices(compact.data(), vertexCount, 0);
+			writeIndices(indices.data(), indexCount, indexCount, 0, 0);
+
+			slots.clear();
+			for (const auto& run : runs)
+				slots[run.FaceID] = FaceSlot{ run.FirstVertex, run.VertexCount, run.FirstIndex, run.IndexCount, run.Hash };
+
+			m_vertexEnd = vertexCount;
+			m_indexEnd = indexCount;
+			m_lastStats.Reallocations++;
+		}
+
+		m_slots = std::move(slots);
+		m_indexBuffer->setCount(m_indexEnd);
+		s_TotalStats.add(m_lastStats);
+
+		// 新的 VA 对象，缓冲共享
+		Ref<VertexArray> va = createVertexArray();
+		va->addVertexBuffer(m_vertexBuffer);
+		va->setIndexBuffer(m_indexBuffer);
+		va->setPositionDequantization(m_dequantOffset, m_dequantScale);
+		return va;
+	}
+
+	Ref<VertexBuffer> MeshBuffer::createVertexBuffer(uint32_t size)
+	{
+		return VertexBuffer::create(size);
+	}
+
+	Ref<IndexBuffer> MeshBuffer::createIndexBuffer(uint32_t capacity, uint32_t indexSize)
+	{
+		return IndexBuffer::create(capacity, indexSize);
+	}
+
+	Ref<VertexArray> MeshBuffer::createVertexArray()
+	{
+		return VertexArray::create();
+	}
+
+	void MeshBuffer::writeVertices(const CADVertex* data, uint32_t count, uint32_t offset)
+	{
+		if (count == 0) return;
+
+		uint32_t size = count * (uint32_t)sizeof(CADVertex);
+		uint32_t byteOffset = offset * (uint32_t)sizeof(CADVertex);
+		m_vertexBuffer->setData(data, size, byteOffset);
+
+		m_lastStats.BytesUploaded += size;
+		m_lastStats.WriteCalls++;
+	}
+
+	void MeshBuffer::writeIndices(const uint32_t* indices, uint32_t count, uint32_t capacity, int32_t rebase, uint32_t offset)
+	{
+		if (capacity == 0) return;
+
+		uint32_t byteOffset = offset * m_indexSize;
+		if (m_indexSize == sizeof(uint32_t) && rebase == 0 && count == capacity)
+		{
+			// 不需要转换，直接从调用方的数组 (可能是映射文件) 上传
+			uint32_t size = count * (uint32_t)sizeof(uint32_t);
+			m_indexBuffer->setData(indices, size, byteOffset);
+
+			m_lastStats.BytesUploaded += size;
+			m_lastStats.WriteCalls++;
+			return;
+		}
+
+		// count 之后到 capacity 的部分填 0 (退化三角形)
+		uint32_t size = capacity * m_indexSize;
+		m_scratch.assign(size, 0);
+		if (m_indexSize == sizeof(uint16_t))
+		{
+			uint16_t* dst = reinterpret_cast<uint16_t*>(m_scratch.data());
+			for (uint32_t i = 0; i < count; i++)
+				dst[i] = (uint16_t)((int64_t)indices[i] + rebase);
+		}
+		else
+		{
+			uint32_t* dst = reinterpret_cast<uint32_t*>(m_scratch.data());
+			for (uint32_t i = 0; i < count; i++)
+				dst[i] = (uint32_t)((int64_t)indices[i] + rebase);
+		}
+
+		m_indexBuffer->setData(m_scratch.data(), size, byteOffset);
+
+		m_lastStats.BytesUploaded += size;
+		m_lastStats.WriteCalls++;
+	}
+
+	// =============================================================
+	// 自检
+	// =============================================================
+
+	// 一次 setData 的目标和字节范围
+	struct RecordedWrite
+	{
+		bool IndexBuffer = false;
+		uint32_t Offset = 0;
+		uint32_t Size = 0;
+
+		bool operator==(const RecordedWrite& other) const { return IndexBuffer == other.IndexBuffer && Offset == other.Offset && Size == other.Size; }
+	};
+
+	// 只在内存里保存内容并记录写入的缓冲 (不需要 GL 上下文)
+	class RecordingVertexBuffer : public VertexBuffer
+	{
+	public:
+		RecordingVertexBuffer(uint32_t size, std::vector<RecordedWrite>& writes) : Data(size, 0), m_writes(writes) {}
+
+		void bind() const override {}
+		void unbind() const override {}
+		void setData(const void* data, uint32_t size, uint32_t offset) override
+		{
+			if ((uint64_t)offset + size > Data.size()) { Overflow = true; return; }
+			std::memcpy(Data.data() + offset, data, size);
+			m_writes.push_back({ false, offset, size });
+		}
+		const BufferLayout& getLayout() const override { return m_layout; }
+		void setLayout(const BufferLayout& layout) override { m_layout = layout; }
+		uint32_t getSize() const override { return (uint32_t)Data.size(); }
+
+		std::vector<uint8_t> Data;
+		bool Overflow = false;
+
+	private:
+		BufferLayout m_layout;
+		std::vector<RecordedWrite>& m_writes;
+	};
+
+	class RecordingIndexBuffer : public IndexBuffer
+	{
+	public:
+		RecordingIndexBuffer(uint32_t capacity, uint32_t indexSize, std::vector<RecordedWrite>& writes)
+			: Data((size_t)capacity * indexSize, 0), m_capacity(capacity), m_indexSize(indexSize), m_writes(writes) {}
+
+		void bind() const override {}
+		void unbind() const override {}
+		uint32_t getCount() const override { return m_count; }
+		uint32_t getIndexSize() const override { return m_indexSize; }
+		uint32_t getCapacity() const override { return m_capacity; }
+		void setData(const void* data, uint32_t size, uint32_t offset) override
+		{
+			if ((uint64_t)offset + size > Data.size()) { Overflow = true; return; }
+			std::memcpy(Data.data() + offset, data, size);
+			m_writes.push_back({ true, offset, size });
+		}
+		void setCount(uint32_t count) override { m_count = count; }
+
+		std::vector<uint8_t> Data;
+		bool Overflow = false;
+
+	private:
+		uint32_t m_capacity = 0;
+		uint32_t m_indexSize = 0;
+		uint32_t m_count = 0;
+		std::vector<RecordedWrite>& m_writes;
+	};
+
+	class RecordingVertexArray : public VertexArray
+	{
+	public:
+		void bind() const override {}
+		void unbind() const override {}
+		void addVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override { m_vertexBuffers.push_back(vertexBuffer); }
+		void setIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override { m_indexBuffer = indexBuffer; }
+		const std::vector<Ref<VertexBuffer>>& getVertexBuffers() const override { return m_vertexBuffers; }
+		const Ref<IndexBuffer>& getIndexBuffer() const override { return m_indexBuffer; }
+
+	private:
+		std::vector<Ref<VertexBuffer>> m_vertexBuffers;
+		Ref<IndexBuffer> m_indexBuffer;
+	};
+
+	class RecordingMeshBuffer : public MeshBuffer
+	{
+	public:
+		std::vector<RecordedWrite> Writes;
+		Ref<RecordingVertexBuffer> Vertices;
+		Ref<RecordingIndexBuffer> Indices;
+
+	protected:
+		Ref<VertexBuffer> createVertexBuffer(uint32_t size) override
+		{
+			Vertices = CreateRef<RecordingVertexBuffer>(size, Writes);
+			return Vertices;
+		}
+		Ref<IndexBuffer> createIndexBuffer(uint32_t capacity, uint32_t indexSize) override
+		{
+			Indices = CreateRef<RecordingIndexBuffer>(capacity, indexSize, Writes);
+			return Indices;
+		}
+		Ref<VertexArray> createVertexArray() override
+		{
+			return CreateRef<RecordingVertexArray>();
+		}
+	};
+
+	// 和 BuildMeshData 输出相同的布局：每个面一个四边形 (4 个顶点、2 个三角形)，排成 256 列的网格
+	static void MakeSelfTestMesh(uint32_t faceCount, std::vector<CubeVertex>& outVertices, std::vector<uint32_t>& outIndices)
+	{
+		static const glm::vec2 corners[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+		outVertices.clear();
+		outIndices.clear();
+		for (uint32_t face = 0; face < faceCount; face++)
+		{
+			glm::vec3 origin((float)(face % 256), (float)(face / 256), (float)(face % 7) * 0.25f);
+			uint32_t first = (uint32_t)outVertices.size();
+			for (const auto& corner : corners)
+			{
+				CubeVertex v{};
+				v.Position = origin + glm::vec3(corner, 0.0f);
+				v.Normal = { 0.0f, 0.0f, 1.0f };
+				v.Color = { 1.0f, 1.0f, 1.0f, 1.0f };
+				v.FaceID = (int)face;
+				outVertices.push_back(v);
+			}
+			for (uint32_t index : { 0u, 1u, 2u, 0u, 2u, 3u })
+				outIndices.push_back(first + index);
+		}
+	}
+
+	bool MeshBuffer::SelfTest()
+	{
+		// 自检的写入不计入编辑器显示的累计统计
+		UpdateStats savedTotals = s_TotalStats;
+		bool passed = true;
+
+		// 256 个面 (1024 个顶点，16 位索引) 和 20000 个面 (80000 个顶点，32 位索引)
+		for (uint32_t faceCount : { 256u, 20000u })
+		{
+			auto check = [&](bool condition, const char* what) {
+				if (condition) return;
+				RONG_CORE_ERROR("MeshBuffer Self-Test ({0} Faces): {1}", faceCount, what);
+				passed = false;
+			};
+
+			std::vector<CubeVertex> vertices;
+			std::vector<uint32_t> indices;
+			MakeSelfTestMesh(faceCount, vertices, indices);
+
+			// 1. 第一次上传：重新分配并整体写入
+			RecordingMeshBuffer buffer;
+			check(buffer.update(vertices, indices) != nullptr, "first update returned no vertex array");
+			check(buffer.getLastStats().Reallocations == 1, "first update did not allocate");
+			if (!buffer.Vertices || !buffer.Indices) { passed = false; continue; }
+			uint32_t indexSize = buffer.Indices->getIndexSize();
+			check(indexSize == IndexSizeFor(VertexCapacityFor((uint32_t)vertices.size())), "unexpected index size");
+
+			// 2. 网格完全没变：一个字节都不写
+			buffer.Writes.clear();
+			buffer.update(vertices, indices);
+			check(buffer.Writes.empty(), "unchanged rebuild wrote to the buffers");
+			check(buffer.getLastStats().BytesUploaded == 0, "unchanged rebuild reported uploaded bytes");
+			check(buffer.getLastStats().FacesKept == faceCount, "unchanged rebuild did not keep every face");
+
+			// 3. 只改一个面 (在原包围盒内收缩，量化参数不变)：只写这个面的顶点段和索引段
+			uint32_t face = faceCount / 2;
+			glm::vec3 center(0.0f);
+			for (uint32_t v = face * 4; v < face * 4 + 4; v++) center += vertices[v].Position * 0.25f;
+			for (uint32_t v = face * 4; v < face * 4 + 4; v++) vertices[v].Position = glm::mix(vertices[v].Position, center, 0.5f);
+
+			buffer.Writes.clear();
+			buffer.update(vertices, indices);
+			std::vector<RecordedWrite> expected = {
+				{ false, face * 4 * (uint32_t)sizeof(CADVertex), 4 * (uint32_t)sizeof(CADVertex) },
+				{ true, face * 6 * indexSize, 6 * indexSize } };
+			check(buffer.Writes == expected, "single-face rebuild did not write exactly that face's slot");
+			check(buffer.getLastStats().BytesUploaded == 4 * sizeof(CADVertex) + 6 * indexSize, "single-face rebuild reported wrong byte count");
+			check(buffer.getLastStats().Reallocations == 0 && buffer.getLastStats().FacesRewritten == 1, "single-face rebuild did not rewrite in place");
+			check(!buffer.Vertices->Overflow && !buffer.Indices->Overflow, "write outside the buffer");
+
+			// 4. 局部更新后的内容和整体上传的结果逐字节相同
+			RecordingMeshBuffer fresh;
+			fresh.update(vertices, indices);
+			size_t vertexBytes = vertices.size() * sizeof(CADVertex);
+			size_t indexBytes = indices.size() * indexSize;
+			check(fresh.Vertices && fresh.Indices &&
+				std::memcmp(buffer.Vertices->Data.data(), fresh.Vertices->Data.data(), vertexBytes) == 0 &&
+				std::memcmp(buffer.Indices->Data.data(), fresh.Indices->Data.data(), indexBytes) == 0,
+				"partially updated buffers differ from a full upload");
+		}
+
+		s_TotalStats = savedTotals;
+		if (passed) RONG_CORE_INFO("MeshBuffer Self-Test: passed");
+		return passed;
+	}
+}
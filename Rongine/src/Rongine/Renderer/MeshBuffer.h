@@ -0,0 +1,99 @@
+#pragma once
+#include "Rongine/Core/Core.h"
+#include "Rongine/Renderer/VertexArray.h"
+#include "Rongine/Renderer/RenderTypes.h"
+#include "Rongine/Renderer/MeshArray.h"
+
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace Rongine {
+
+	// 单个实体的 CAD 网格显存：顶点/索引缓冲按面 (FaceID) 分段，末尾留有余量
+	// 局部编辑 (倒角/拉伸/撤销) 之后提交整份新网格，只把内容变化的面写进显存：
+	//   - 内容没变的面 (紧凑顶点 + 面内局部索引都相同) 不上传
+	//   - 变化的面放得下就原地覆盖，放不下就追加到末尾；删除/搬走的面把索引段清零 (退化三角形)
+	//   - 余量用完、空洞超过一半或需要 32 位索引时，按 1.5 倍重新分配并整体上传
+	// 每次 update 返回一个新的 VertexArray 对象 (共享同一对缓冲)，按 VA 判断网格版本的 LOD 缓存照常失效
+	class MeshBuffer
+	{
+	public:
+		struct UpdateStats
+		{
+			uint64_t BytesUploaded = 0;  // 实际写入显存的字节数
+			uint64_t BytesFull = 0;      // 整份重新上传需要的字节数 (对照)
+			uint32_t WriteCalls = 0;
+			uint32_t FacesKept = 0;      // 内容没变，不上传
+			uint32_t FacesRewritten = 0; // 原地覆盖
+			uint32_t FacesMoved = 0;     // 追加到末尾
+			uint32_t FacesFreed = 0;     // 面被删除或搬走，索引段清零
+			uint32_t Reallocations = 0;
+
+			void add(const UpdateStats& other);
+		};
+
+		MeshBuffer() = default;
+		virtual ~MeshBuffer() = default;
+		MeshBuffer(const MeshBuffer&) = delete;
+		MeshBuffer& operator=(const MeshBuffer&) = delete;
+
+		// vertices/indices 是 CADMesher::BuildMeshData 的输出 (同一个面的顶点和三角形连续存放)
+		// 可以直接指向映射的网格缓存文件：32 位索引整段写入时不经过中转缓冲
+		// 没有面的网格返回 nullptr 并释放显存
+		Ref<VertexArray> update(ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices);
+		void release();
+
+		const UpdateStats& getLastStats() const { return m_lastStats; }
+		uint32_t getVertexCapacity() const { return m_vertexCapacity; }
+		uint32_t getIndexCapacity() const { return m_indexCapacity; }
+		uint64_t getAllocatedBytes() const { return (uint64_t)m_vertexCapacity * sizeof(CADVertex) + (uint64_t)m_indexCapacity * m_indexSize; }
+
+		// 所有实体累计
+		static const UpdateStats& getTotalStats();
+		static void resetTotalStats();
+
+		// CADVertex 的顶点布局 (CADMesh.glsl)
+		static BufferLayout getVertexLayout();
+
+		// 自检：用只记录写入的缓冲代替 GL 缓冲 (不需要窗口)，检查没变的网格不写任何字节、
+		// 只改一个面时只写这个面的顶点段和索引段、局部更新后的内容和整体上传相同 (16 位和 32 位索引各一次)
+		static bool SelfTest();
+
+	protected:
+		// 创建显存对象，自检时替换
+		virtual Ref<VertexBuffer> createVertexBuffer(uint32_t size);
+		virtual Ref<IndexBuffer> createIndexBuffer(uint32_t capacity, uint32_t indexSize);
+		virtual Ref<VertexArray> createVertexArray();
+
+	private:
+		struct FaceSlot
+		{
+			uint32_t VertexOffset = 0;
+			uint32_t VertexCapacity = 0;
+			uint32_t IndexOffset = 0;
+			uint32_t IndexCapacity = 0;
+			uint64_t Hash = 0;
+		};
+
+		void writeVertices(const CADVertex* data, uint32_t count, uint32_t offset);
+		void writeIndices(const uint32_t* indices, uint32_t count, uint32_t capacity, int32_t rebase, uint32_t offset);
+
+	private:
+		Ref<VertexBuffer> m_vertexBuffer;
+		Ref<IndexBuffer> m_indexBuffer;
+		uint32_t m_vertexCapacity = 0;
+		uint32_t m_indexCapacity = 0;
+		uint32_t m_indexSize = sizeof(uint32_t);
+		uint32_t m_vertexEnd = 0; // 已分配段的末尾，之后是余量
+		uint32_t m_indexEnd = 0;  // 同时也是绘制的索引数量
+
+		glm::vec3 m_dequantOffset = glm::vec3(0.0f);
+		glm::vec3 m_dequantScale = glm::vec3(0.0f);
+
+		std::unordered_map<int, FaceSlot> m_slots;
+
+		UpdateStats m_lastStats;
+		std::vector<uint8_t> m_scratch;
+	};
+}
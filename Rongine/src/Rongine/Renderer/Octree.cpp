@@ -0,0 +1,255 @@
+#include "Rongpch.h"
+#include "Octree.h"
+#include "BVH.h"
+#include "Rongine/Core/Log.h"
+#include "Rongine/Math/Math.h"
+
+#include <chrono>
+#include <numeric>
+#include <random>
+
+namespace Rongine {
+
+    OctreeBuilder::OctreeBuilder(const std::vector<BVHTriangle>& triangles, const OctreeSettings& settings)
+        : m_Settings(settings)
+    {
+        m_Settings.MaxDepth = std::min(std::max(m_Settings.MaxDepth, 0), MaxSupportedDepth);
+        m_Settings.MaxLeafSize = std::max(m_Settings.MaxLeafSize, 1);
+
+        if (triangles.empty()) return;
+
+        // 1. 预先计算每个三角形的包围盒，以及整个场景的包围盒
+        AABB sceneBounds;
+        m_TriangleBounds.resize(triangles.size());
+        for (size_t i = 0; i < triangles.size(); i++)
+        {
+            const auto& tri = triangles[i];
+            AABB& box = m_TriangleBounds[i];
+            box.Grow(tri.V0);
+            box.Grow(tri.V1);
+            box.Grow(tri.V2);
+            sceneBounds.Grow(box);
+        }
+
+        // 2. 根节点取包住场景的立方体 (略微放大，避免边界上的三角形被漏掉)
+        glm::vec3 size = sceneBounds.GetSize();
+        float halfSize = std::max(size.x, std::max(size.y, size.z)) * 0.5f * 1.001f + 1e-4f;
+
+        std::vector<uint32_t> all(triangles.size());
+        std::iota(all.begin(), all.end(), 0u);
+
+        m_Nodes.reserve(triangles.size() / m_Settings.MaxLeafSize + 1);
+        m_Nodes.push_back(GPUOctreeNode());
+        BuildNode(0, sceneBounds.GetCenter(), halfSize, all, 0);
+
+        // 3. 把输入下标换成原始三角形 ID (与 BVH 的 SortedIndices 含义相同)
+        m_TriangleIndices.resize(m_InputIndices.size());
+        for (size_t i = 0; i < m_InputIndices.size(); i++)
+            m_TriangleIndices[i] = triangles[m_InputIndices[i]].Index;
+
+        RONG_CORE_INFO("Octree Built Successfully: {0} Triangles -> {1} Nodes, {2} Leaf References",
+            triangles.size(), m_Nodes.size(), m_TriangleIndices.size());
+    }
+
+    void OctreeBuilder::BuildNode(int nodeIndex, const glm::vec3& center, float halfSize, std::vector<uint32_t>& triangleList, int depth)
+    {
+        {
+            GPUOctreeNode& node = m_Nodes[nodeIndex];
+            node.Center = center;
+            node.Size = halfSize;
+            for (int i = 0; i < 8; i++) node.Children[i] = -1.0f;
+            node.TriangleStartIndex = 0.0f;
+            node.TriangleCount = 0.0f;
+            node._pad[0] = 0.0f; node._pad[1] = 0.0f;
+        }
+
+        auto makeLeaf = [&]() {
+            GPUOctreeNode& node = m_Nodes[nodeIndex];
+            node.TriangleStartIndex = (float)m_InputIndices.size();
+            node.TriangleCount = (float)triangleList.size();
+            m_InputIndices.insert(m_InputIndices.end(), triangleList.begin(), triangleList.end());
+        };
+
+        // 1. 终止条件
+        if ((int)triangleList.size() <= m_Settings.MaxLeafSize || depth >= m_Settings.MaxDepth)
+        {
+            makeLeaf();
+            return;
+        }
+
+        // 2. 按重叠关系把三角形分发到 8 个子立方体
+        float childHalf = halfSize * 0.5f;
+        std::vector<uint32_t> childLists[8];
+        glm::vec3 childCenters[8];
+        bool progress = false;
+
+        for (int c = 0; c < 8; c++)
+        {
+            childCenters[c] = center + glm::vec3(
+                (c & 1) ? childHalf : -childHalf,
+                (c & 2) ? childHalf : -childHalf,
+                (c & 4) ? childHalf : -childHalf);
+
+            glm::vec3 boxMin = childCenters[c] - glm::vec3(childHalf);
+            glm::vec3 boxMax = childCenters[c] + glm::vec3(childHalf);
+
+            for (uint32_t triIndex : triangleList)
+            {
+                const AABB& box = m_TriangleBounds[triIndex];
+                if (box.Max.x < boxMin.x || box.Min.x > boxMax.x ||
+                    box.Max.y < boxMin.y || box.Min.y > boxMax.y ||
+                    box.Max.z < boxMin.z || box.Min.z > boxMax.z)
+                    continue;
+                childLists[c].push_back(triIndex);
+            }
+
+            if (childLists[c].size() < triangleList.size())
+                progress = true;
+        }
+
+        // 3. 细分没有任何效果 (例如大三角形覆盖了所有子节点)，直接做叶子
+        if (!progress)
+        {
+            makeLeaf();
+            return;
+        }
+
+        // 父节点的列表已经分发完毕，提前释放内存
+        std::vector<uint32_t>().swap(triangleList);
+
+        // 4. 递归构建非空子节点 (push_back 可能扩容，之后用下标访问)
+        for (int c = 0; c < 8; c++)
+        {
+            if (childLists[c].empty()) continue;
+
+            int childIndex = (int)m_Nodes.size();
+            m_Nodes.push_back(GPUOctreeNode());
+            m_Nodes[nodeIndex].Children[c] = (float)childIndex;
+
+            BuildNode(childIndex, childCenters[c], childHalf, childLists[c], depth + 1);
+        }
+    }
+
+    bool OctreeBuilder::Intersect(const std::vector<BVHTriangle>& triangles, const glm::vec3& origin, const glm::vec3& dir,
+        float& outT, uint32_t& outTriangle, QueryStats* stats) const
+    {
+        outT = 1e30f;
+        bool hit = false;
+        if (m_Nodes.empty()) return false;
+
+        glm::vec3 invDir = 1.0f / dir;
+
+        int stack[64];
+        int stackPtr = 0;
+        stack[stackPtr++] = 0;
+
+        while (stackPtr > 0)
+        {
+            const GPUOctreeNode& node = m_Nodes[stack[--stackPtr]];
+            if (stats) stats->NodesVisited++;
+
+            glm::vec3 boxMin = node.Center - glm::vec3(node.Size);
+            glm::vec3 boxMax = node.Center + glm::vec3(node.Size);
+            if (!Math::RayAABBIntersection(origin, invDir, boxMin, boxMax, outT)) continue;
+
+            if (node.TriangleCount > 0.0f)
+            {
+                int start = (int)node.TriangleStartIndex;
+                int count = (int)node.TriangleCount;
+                for (int i = 0; i < count; i++)
+                {
+                    const BVHTriangle& tri = triangles[m_InputIndices[start + i]];
+                    if (stats) stats->TrianglesTested++;
+
+                    float t = Math::RayTriangleIntersection(origin, dir, tri.V0, tri.V1, tri.V2);
+                    if (t > 0.0f && t < outT)
+                    {
+                        outT = t;
+                        outTriangle = tri.Index;
+                        hit = true;
+                    }
+                }
+            }
+            else
+            {
+                for (int c = 0; c < 8; c++)
+                    if (node.Children[c] >= 0.0f) stack[stackPtr++] = (int)node.Children[c];
+            }
+        }
+        return hit;
+    }
+
+    void OctreeBuilder::Benchmark(const std::vector<BVHTriangle>& triangles, const OctreeSettings& settings, int rayCount)
+    {
+        if (triangles.empty())
+        {
+            RONG_CORE_WARN("Octree Benchmark: no triangles in scene");
+            return;
+        }
+
+        // 1. 构建耗时
+        auto t0 = std::chrono::high_resolution_clock::now();
+        OctreeBuilder octree(triangles, settings);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        BVHBuilder bvh(triangles, BVHBuildQuality::SAH);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        float octreeBuildMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+        float bvhBuildMs = std::chrono::duration<float, std::milli>(t2 - t1).count();
+
+        // 2. 生成同一组随机射线 (固定种子)：起点在场景包围盒内，方向均匀随机
+        AABB sceneBounds;
+        for (const auto& tri : triangles)
+        {
+            sceneBounds.Grow(tri.V0);
+            sceneBounds.Grow(tri.V1);
+            sceneBounds.Grow(tri.V2);
+        }
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<glm::vec3> origins(rayCount), dirs(rayCount);
+        glm::vec3 size = sceneBounds.GetSize();
+        for (int r = 0; r < rayCount; r++)
+        {
+            origins[r] = sceneBounds.Min + glm::vec3(unit(rng) * size.x, unit(rng) * size.y, unit(rng) * size.z);
+            dirs[r] = glm::normalize(glm::vec3(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f) + glm::vec3(1e-4f));
+        }
+
+        // 3. 射线查询代价
+        QueryStats octreeStats, bvhStats;
+        int mismatches = 0;
+
+        auto q0 = std::chrono::high_resolution_clock::now();
+        std::vector<float> octreeT(rayCount);
+        for (int r = 0; r < rayCount; r++)
+        {
+            uint32_t triIndex;
+            if (!octree.Intersect(triangles, origins[r], dirs[r], octreeT[r], triIndex, &octreeStats))
+                octreeT[r] = -1.0f;
+        }
+        auto q1 = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < rayCount; r++)
+        {
+            float t;
+            uint32_t triIndex;
+            if (!BVHBuilder::Intersect(bvh.GetNodes(), bvh.GetSortedIndices(), triangles, origins[r], dirs[r], t, triIndex, &bvhStats))
+                t = -1.0f;
+            if (std::abs(t - octreeT[r]) > 1e-3f * std::max(1.0f, std::abs(t))) mismatches++;
+        }
+        auto q2 = std::chrono::high_resolution_clock::now();
+
+        float octreeQueryMs = std::chrono::duration<float, std::milli>(q1 - q0).count();
+        float bvhQueryMs = std::chrono::duration<float, std::milli>(q2 - q1).count();
+
+        RONG_CORE_INFO("Octree Benchmark [Octree d{0}/l{1}]: Build {2}ms, {3} Nodes, {4} Rays in {5}ms, {6:.1f} Nodes/Ray, {7:.1f} Tris/Ray",
+            octree.m_Settings.MaxDepth, octree.m_Settings.MaxLeafSize, octreeBuildMs, octree.GetNodes().size(), rayCount, octreeQueryMs,
+            (double)octreeStats.NodesVisited / rayCount, (double)octreeStats.TrianglesTested / rayCount);
+        RONG_CORE_INFO("Octree Benchmark [BVH SAH]: Build {0}ms, {1} Nodes, {2} Rays in {3}ms, {4:.1f} Nodes/Ray, {5:.1f} Tris/Ray",
+            bvhBuildMs, bvh.GetNodes().size(), rayCount, bvhQueryMs,
+            (double)bvhStats.NodesVisited / rayCount, (double)bvhStats.TrianglesTested / rayCount);
+
+        if (mismatches > 0)
+            RONG_CORE_WARN("Octree Benchmark: {0} / {1} rays disagree with the BVH", mismatches, rayCount);
+    }
+}
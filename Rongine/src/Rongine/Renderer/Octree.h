@@ -0,0 +1,48 @@
+#pragma once
+#include "Rongine/Renderer/AccelerationStructures.h"
+#include "Rongine/Renderer/RenderTypes.h"
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Rongine {
+
+    struct OctreeSettings {
+        int MaxDepth = 6;    // 最大深度 (Shader 栈大小限制，最多 8)
+        int MaxLeafSize = 8; // 三角形数不超过该值时停止细分
+    };
+
+    // 线性八叉树构建器
+    // 根节点是包住所有三角形的立方体，三角形按包围盒与子立方体的重叠关系分发 (跨越边界的三角形会进入多个叶子)
+    // 输出 GPUOctreeNode 数组 (Binding 7) 和叶子引用的三角形索引表 (与 BVH 一样通过 Binding 8 间接寻址)
+    class OctreeBuilder {
+    public:
+        static const int MaxSupportedDepth = 8;
+
+        OctreeBuilder(const std::vector<BVHTriangle>& triangles, const OctreeSettings& settings = OctreeSettings());
+
+        const std::vector<GPUOctreeNode>& GetNodes() const { return m_Nodes; }
+        const std::vector<uint32_t>& GetTriangleIndices() const { return m_TriangleIndices; }
+
+        // 求交统计 (用于和 BVH 对比查询代价)
+        using QueryStats = RayQueryStats;
+
+        // CPU 端求交 (与 Shader 中 TraverseOctree 一致)，返回最近交点和三角形原始 ID
+        bool Intersect(const std::vector<BVHTriangle>& triangles, const glm::vec3& origin, const glm::vec3& dir,
+            float& outT, uint32_t& outTriangle, QueryStats* stats = nullptr) const;
+
+        // 性能测试：同一组三角形上对比八叉树与 BVH 的构建耗时和射线查询代价
+        static void Benchmark(const std::vector<BVHTriangle>& triangles, const OctreeSettings& settings, int rayCount = 4096);
+
+    private:
+        void BuildNode(int nodeIndex, const glm::vec3& center, float halfSize, std::vector<uint32_t>& triangleList, int depth);
+
+        std::vector<AABB> m_TriangleBounds;
+        OctreeSettings m_Settings;
+
+        std::vector<GPUOctreeNode> m_Nodes;
+        std::vector<uint32_t> m_TriangleIndices; // 叶子引用的三角形原始 ID (上传给 GPU)
+        std::vector<uint32_t> m_InputIndices;    // 同上，但为输入数组中的下标 (CPU 求交用)
+    };
+
+}
@@ -50,6 +50,11 @@ namespace Rongine {
 			s_rendererAPI->drawArrays(vertexArray, vertexCount);
 		}
 
+		inline static void drawLineStrips(const Ref<VertexArray>& vertexArray, const uint32_t* firstIndices, const uint32_t* counts, uint32_t drawCount)
+		{
+			s_rendererAPI->drawLineStrips(vertexArray, firstIndices, counts, drawCount);
+		}
+
 		inline static void setDepthTest(bool enabled)
 		{
 			s_rendererAPI->setDepthTest(enabled);
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 
 namespace Rongine {
 
@@ -14,12 +15,39 @@ namespace Rongine {
 		int FaceID;
 	};
 
+	// CAD 网格的紧凑顶点 (16 字节)
+	// CAD 面片的颜色、纹理槽和平铺系数都是常量，不逐顶点存储；位置按网格包围盒量化，法线八面体编码
+	struct CADVertex
+	{
+		uint16_t Position[4]; // xyz: 包围盒内的 unorm16 坐标, w: 填充 (4 字节对齐)
+		int16_t Normal[2];    // 八面体编码的 snorm16 法线
+		int FaceID;
+	};
+
 	struct BatchLineVertex
 	{
 		glm::vec3 Position;
 		glm::vec4 Color;
 	};
 
+	// 场景线缓冲的顶点：所有实体的边框线打包在一起，Slot 指向该实体在 Binding 11 中的区间数据
+	struct SceneEdgeVertex
+	{
+		glm::vec3 Position;
+		int EdgeID;
+		int Slot;
+	};
+
+	// Binding 11：每个实体一条 (std430)
+	struct GPUEdgeRange
+	{
+		glm::mat4 Transform;
+		glm::vec4 Color;
+		int EntityID;
+		int SelectedEdgeID;
+		int _pad[2];
+	};
+
 	//SSBO
 	struct GPUVertex
 	{
@@ -4,7 +4,10 @@
 #include "Rongine/Scene/Entity.h" 
 #include "Rongine/Scene/Components.h"
 #include "Rongine/Renderer/BVH.h"
+#include "Rongine/Renderer/LBVH.h"
+#include "Rongine/Renderer/WideBVH.h"
 #include "Rongine/Renderer/UniformBuffer.h"
+#include "Rongine/Renderer/VertexCompression.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <array>
@@ -62,6 +65,8 @@ namespace Rongine {
 		s_Data.TextureShader->bind();
 		s_Data.TextureShader->setIntArray("u_Textures", samplers, s_Data.MaxTextureSlots);
 
+		s_Data.CADMeshShader = Shader::create("assets/shaders/CADMesh.glsl");
+
 		s_Data.LineShader = Shader::create("assets/shaders/Line.glsl");
 
 		s_Data.TextureSlots[0] = s_Data.WhiteTexture;
@@ -188,6 +193,11 @@ namespace Rongine {
 		s_Data.TextureShader->setMat4("u_Model", glm::mat4(1.0f));
 		s_Data.TextureShader->setInt("u_EntityID", -1);
 
+		s_Data.CADMeshShader->bind();
+		s_Data.CADMeshShader->setMat4("u_ViewProjection", s_Data.ViewProjection);
+		s_Data.CADMeshShader->setFloat3("u_ViewPos", camera.getPosition());
+		s_Data.TextureShader->bind();
+
 		s_Data.CubeIndexCount = 0;
 		s_Data.CubeVertexBufferPtr = s_Data.CubeVertexBufferBase;
 		s_Data.TextureSlotIndex = 1;
@@ -395,41 +405,58 @@ namespace Rongine {
 	// ===========================================
 	//  Mesh Rendering
 	// ===========================================
-	void Renderer3D::drawModel(const Ref<VertexArray>& va, const glm::mat4& transform,int entityID, const MaterialComponent* material)
+	// 按顶点格式选择 Shader：量化顶点 (CADMesher 输出) 走 CADMesh.glsl，其余走 Texture.glsl
+	static const Ref<Shader>& bindMeshShader(const Ref<VertexArray>& va, const glm::mat4& transform, int entityID)
 	{
-		// 1. 如果批处理里有方块没画，先画掉 (flush 会使用 Identity Model 矩阵)
-		//flush();
-
-		s_Data.TextureShader->bind();
+		const Ref<Shader>& shader = va->isPositionQuantized() ? s_Data.CADMeshShader : s_Data.TextureShader;
+		shader->bind();
 
-		// 2. 分别设置矩阵
 		// u_Model: 物体的变换 (Shader 用它算 v_Position 和 v_Normal)
-		s_Data.TextureShader->setMat4("u_Model", transform);
+		shader->setMat4("u_Model", transform);
 
 		// u_ViewProjection: 相机的 VP (保持 beginScene 设的值，不需要乘 transform)
-		s_Data.TextureShader->setMat4("u_ViewProjection", s_Data.ViewProjection);
+		shader->setMat4("u_ViewProjection", s_Data.ViewProjection);
+
+		if (va->isPositionQuantized())
+		{
+			shader->setFloat3("u_DequantOffset", va->getDequantizationOffset());
+			shader->setFloat3("u_DequantScale", va->getDequantizationScale());
+		}
+		else
+		{
+			s_Data.WhiteTexture->bind(0);
+		}
+
+		shader->setInt("u_EntityID", entityID);
 
-		s_Data.WhiteTexture->bind(0);
+		shader->setInt("u_SelectedEntityID", s_Data.SelectedEntityID);
+		shader->setInt("u_SelectedFaceID", s_Data.SelectedFaceID);
 
-		s_Data.TextureShader->setInt("u_EntityID", entityID);
+		shader->setInt("u_HoveredEntityID", s_Data.HoveredEntityID);
+		shader->setInt("u_HoveredFaceID", s_Data.HoveredFaceID);
 
-		s_Data.TextureShader->setInt("u_SelectedEntityID", s_Data.SelectedEntityID);
-		s_Data.TextureShader->setInt("u_SelectedFaceID", s_Data.SelectedFaceID);
+		return shader;
+	}
 
-		s_Data.TextureShader->setInt("u_HoveredEntityID", s_Data.HoveredEntityID);
-		s_Data.TextureShader->setInt("u_HoveredFaceID", s_Data.HoveredFaceID);
+	void Renderer3D::drawModel(const Ref<VertexArray>& va, const glm::mat4& transform,int entityID, const MaterialComponent* material)
+	{
+		// 1. 如果批处理里有方块没画，先画掉 (flush 会使用 Identity Model 矩阵)
+		//flush();
+
+		// 2. 绑定 Shader 并设置矩阵、选中/悬停状态
+		const Ref<Shader>& shader = bindMeshShader(va, transform, entityID);
 
 		if (material)
 		{
-			s_Data.TextureShader->setFloat3("u_Albedo", material->Albedo);
-			s_Data.TextureShader->setFloat("u_Roughness", material->Roughness);
-			s_Data.TextureShader->setFloat("u_Metallic", material->Metallic);
+			shader->setFloat3("u_Albedo", material->Albedo);
+			shader->setFloat("u_Roughness", material->Roughness);
+			shader->setFloat("u_Metallic", material->Metallic);
 		}
 		else
 		{
-			s_Data.TextureShader->setFloat3("u_Albedo", glm::vec3(1.0f));
-			s_Data.TextureShader->setFloat("u_Roughness", 0.5f);
-			s_Data.TextureShader->setFloat("u_Metallic", 0.0f);
+			shader->setFloat3("u_Albedo", glm::vec3(1.0f));
+			shader->setFloat("u_Roughness", 0.5f);
+			shader->setFloat("u_Metallic", 0.0f);
 		}
 
 		va->bind();
@@ -442,37 +469,25 @@ namespace Rongine {
 
 		// 4. 画完后，恢复 u_Model 为单位矩阵
 		// 否则之后如果再调用 drawCube，方块会飞到错误的地方
+		s_Data.TextureShader->bind();
 		s_Data.TextureShader->setMat4("u_Model", glm::mat4(1.0f));
 	}
 
 	void Renderer3D::drawModel(Entity& en, const glm::mat4& transform,int entityID)
 	{
-		s_Data.TextureShader->bind();
-
-		s_Data.TextureShader->setMat4("u_Model", transform);
-		s_Data.TextureShader->setMat4("u_ViewProjection", s_Data.ViewProjection);
+		Ref<VertexArray> va = en.GetComponent<MeshComponent>().VA;
 
-		s_Data.WhiteTexture->bind(0);
+		const Ref<Shader>& shader = bindMeshShader(va, transform, entityID);
 
 		if (en.HasComponent<MaterialComponent>())
 		{
 			const auto& mat = en.GetComponent<MaterialComponent>();
 
-			s_Data.TextureShader->setFloat3("u_Albedo", mat.Albedo);
-			s_Data.TextureShader->setFloat("u_Roughness", mat.Roughness);
-			s_Data.TextureShader->setFloat("u_Metallic", mat.Metallic);
+			shader->setFloat3("u_Albedo", mat.Albedo);
+			shader->setFloat("u_Roughness", mat.Roughness);
+			shader->setFloat("u_Metallic", mat.Metallic);
 		}
 
-		s_Data.TextureShader->setInt("u_EntityID", entityID);
-
-		s_Data.TextureShader->setInt("u_SelectedEntityID", s_Data.SelectedEntityID);
-		s_Data.TextureShader->setInt("u_SelectedFaceID", s_Data.SelectedFaceID);
-
-		s_Data.TextureShader->setInt("u_HoveredEntityID", s_Data.HoveredEntityID);
-		s_Data.TextureShader->setInt("u_HoveredFaceID", s_Data.HoveredFaceID);
-
-
-		Ref<VertexArray> va = en.GetComponent<MeshComponent>().VA;
 		va->bind();
 
 		// 3. 显式传递 Index Count！
@@ -482,40 +497,163 @@ namespace Rongine {
 		s_Data.Stats.DrawCalls++;
 
 		//清理显存
+		shader->setFloat3("u_Albedo", glm::vec3(1.0f));
+		shader->setFloat("u_Roughness", 0.5f);
+		shader->setFloat("u_Metallic", 0.0f);
+
+		s_Data.TextureShader->bind();
 		s_Data.TextureShader->setMat4("u_Model", glm::mat4(1.0f));
+	}
 
-		s_Data.TextureShader->setFloat3("u_Albedo", glm::vec3(1.0f));
-		s_Data.TextureShader->setFloat("u_Roughness", 0.5f);
-		s_Data.TextureShader->setFloat("u_Metallic", 0.0f);
+	// 把场景里所有实体的边框线重新打包进一个 VB/IB
+	static void rebuildEdgeBuffer(Scene* scene)
+	{
+		s_Data.EdgeRanges.clear();
+		s_Data.EdgeScene = scene;
+
+		std::vector<SceneEdgeVertex> vertices;
+		std::vector<uint32_t> indices;
+
+		auto view = scene->getRegistry().view<MeshComponent>();
+		for (auto entityHandle : view)
+		{
+			const auto& mesh = view.get<MeshComponent>(entityHandle);
+			if (!mesh.HasEdges()) continue;
+
+			Renderer3DData::EdgeRange range;
+			range.Revision = mesh.EdgeRevision;
+			range.Slot = (uint32_t)s_Data.EdgeRanges.size();
+			range.FirstIndex = (uint32_t)indices.size();
+
+			uint32_t baseVertex = (uint32_t)vertices.size();
+			for (const auto& v : mesh.LocalLines)
+				vertices.push_back({ v.Position, v.EntityID, (int)range.Slot });
+			for (uint32_t index : mesh.LocalLineIndices)
+				indices.push_back(index == LineStripRestartIndex ? LineStripRestartIndex : index + baseVertex);
+			// 每个实体末尾补一个重启索引，和下一个实体的线带断开
+			indices.push_back(LineStripRestartIndex);
+
+			range.IndexCount = (uint32_t)indices.size() - range.FirstIndex;
+			s_Data.EdgeRanges[entityHandle] = range;
+		}
+
+		s_Data.EdgeRangeData.assign(s_Data.EdgeRanges.size(), GPUEdgeRange());
+		s_Data.EdgeSlotFirstIndex.assign(s_Data.EdgeRanges.size(), 0);
+		s_Data.EdgeSlotIndexCount.assign(s_Data.EdgeRanges.size(), 0);
+		for (const auto& [entityHandle, range] : s_Data.EdgeRanges)
+		{
+			s_Data.EdgeSlotFirstIndex[range.Slot] = range.FirstIndex;
+			s_Data.EdgeSlotIndexCount[range.Slot] = range.IndexCount;
+		}
+
+		s_Data.EdgeVA = nullptr;
+		if (!vertices.empty())
+		{
+			s_Data.EdgeVA = VertexArray::create();
+			Ref<VertexBuffer> vb = VertexBuffer::create((float*)vertices.data(), (uint32_t)(vertices.size() * sizeof(SceneEdgeVertex)));
+			vb->setLayout({
+				{ ShaderDataType::Float3, "a_Position" },
+				{ ShaderDataType::Int,    "a_EdgeID" },
+				{ ShaderDataType::Int,    "a_Slot" }
+				});
+			s_Data.EdgeVA->addVertexBuffer(vb);
+			s_Data.EdgeVA->setIndexBuffer(IndexBuffer::create(indices.data(), (uint32_t)indices.size()));
+		}
+
+		s_Data.EdgeStats.Entities = (uint32_t)s_Data.EdgeRanges.size();
+		s_Data.EdgeStats.Vertices = (uint32_t)vertices.size();
+		s_Data.EdgeStats.Indices = (uint32_t)indices.size();
+		s_Data.EdgeStats.Rebuilds++;
 	}
 
-	void Renderer3D::drawEdges(const Ref<VertexArray>& va, const glm::mat4& transform, const glm::vec4& color, int entityID, int selectedEdgeID)
+	void Renderer3D::beginEdges(Scene* scene)
 	{
-		if (!va) return;
+		s_Data.EdgeSubmittedSlots.clear();
+		if (!scene) return;
 
-		// 绑定线框 Shader
-		s_Data.LineShader->bind();
+		// 场景换了、实体增删或某个实体的边变了 (EdgeRevision 不同) 就重新打包
+		bool dirty = scene != s_Data.EdgeScene;
+		uint32_t edgeEntities = 0;
 
-		s_Data.LineShader->setMat4("u_ViewProjection", s_Data.ViewProjection);
-		s_Data.LineShader->setMat4("u_Transform", transform);
-		s_Data.LineShader->setFloat4("u_Color", color);
+		auto view = scene->getRegistry().view<MeshComponent>();
+		for (auto entityHandle : view)
+		{
+			const auto& mesh = view.get<MeshComponent>(entityHandle);
+			if (!mesh.HasEdges()) continue;
+			edgeEntities++;
+
+			if (dirty) continue;
+			auto it = s_Data.EdgeRanges.find(entityHandle);
+			dirty = it == s_Data.EdgeRanges.end() || it->second.Revision != mesh.EdgeRevision;
+		}
+		dirty = dirty || edgeEntities != s_Data.EdgeRanges.size();
+
+		if (dirty)
+			rebuildEdgeBuffer(scene);
+	}
+
+	void Renderer3D::submitEdges(entt::entity entity, const glm::mat4& transform, const glm::vec4& color, int selectedEdgeID)
+	{
+		auto it = s_Data.EdgeRanges.find(entity);
+		if (it == s_Data.EdgeRanges.end()) return;
+
+		GPUEdgeRange& range = s_Data.EdgeRangeData[it->second.Slot];
+		range.Transform = transform;
+		range.Color = color;
+		range.EntityID = (int)entity;
+		range.SelectedEdgeID = selectedEdgeID;
+
+		s_Data.EdgeSubmittedSlots.push_back(it->second.Slot);
+	}
+
+	void Renderer3D::endEdges()
+	{
+		auto& slots = s_Data.EdgeSubmittedSlots;
+		s_Data.EdgeStats.SubmittedRanges = (uint32_t)slots.size();
+		s_Data.EdgeStats.DrawRanges = 0;
+		if (slots.empty() || !s_Data.EdgeVA) return;
+
+		// 1. 按缓冲中的顺序合并相邻实体 (每个区间末尾都有重启索引，可以直接拼接)
+		std::sort(slots.begin(), slots.end());
+		slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
 
-		s_Data.LineShader->setInt("u_EntityID", entityID);
-		s_Data.LineShader->setInt("u_SelectedEdgeID", selectedEdgeID);
+		std::vector<uint32_t> firsts, counts;
+		for (uint32_t slot : slots)
+		{
+			uint32_t first = s_Data.EdgeSlotFirstIndex[slot];
+			uint32_t count = s_Data.EdgeSlotIndexCount[slot];
+			if (!firsts.empty() && firsts.back() + counts.back() == first)
+				counts.back() += count;
+			else
+			{
+				firsts.push_back(first);
+				counts.push_back(count);
+			}
+		}
 
+		// 2. 每个实体的变换、颜色和 ID 通过 Binding 11 传给 Shader
+		uint32_t rangeSize = (uint32_t)(s_Data.EdgeRangeData.size() * sizeof(GPUEdgeRange));
+		if (!s_Data.EdgeRangeSSBO) s_Data.EdgeRangeSSBO = ShaderStorageBuffer::create(rangeSize, ShaderStorageBufferUsage::DynamicDraw);
+		else if (s_Data.EdgeRangeSSBO->getSize() < rangeSize) s_Data.EdgeRangeSSBO->resize(rangeSize);
+		s_Data.EdgeRangeSSBO->setData(s_Data.EdgeRangeData.data(), rangeSize);
+		s_Data.EdgeRangeSSBO->bind(11);
+
+		// 3. 一次 MultiDraw
+		s_Data.LineShader->bind();
+		s_Data.LineShader->setMat4("u_ViewProjection", s_Data.ViewProjection);
 		s_Data.LineShader->setInt("u_HoveredEntityID", s_Data.HoveredEntityID);
 		s_Data.LineShader->setInt("u_HoveredEdgeID", s_Data.HoveredEdgeID);
 
-		va->bind();
+		s_Data.EdgeVA->bind();
+		RenderCommand::drawLineStrips(s_Data.EdgeVA, firsts.data(), counts.data(), (uint32_t)firsts.size());
 
-		// 绘制线条
-		// 获取第一个 VertexBuffer
-		auto& vb = va->getVertexBuffers()[0];
+		s_Data.EdgeStats.DrawRanges = (uint32_t)firsts.size();
+		s_Data.Stats.DrawCalls++;
+	}
 
-		// 通过 Size / Stride 计算顶点数量
-		// count = 总字节数 / 单个顶点的步长
-		uint32_t vertexCount = vb->getSize() / vb->getLayout().getStride();
-		RenderCommand::drawLines(va, vertexCount);
+	Renderer3D::EdgeBufferStats Renderer3D::getEdgeBufferStats()
+	{
+		return s_Data.EdgeStats;
 	}
 
 
@@ -532,14 +670,32 @@ namespace Rongine {
 
 	void Renderer3D::UploadSceneDataToGPU(Scene* scene)
 	{
+		auto view = scene->getRegistry().view<TransformComponent, MeshComponent>();
+
+		// 两层结构在 BLAS 里用局部光线求交，顶点按局部空间上传，变换只体现在实例数据里
+		// 网格都没变 (只改了变换或材质) 时不用重新上传顶点和三角形
+		bool localSpace = s_Data.CurrentAccelType == AccelType::TwoLevel;
+		std::vector<std::pair<uint32_t, uint64_t>> geometry;
+		for (auto entityHandle : view)
+		{
+			auto& mesh = view.get<MeshComponent>(entityHandle);
+			if (!mesh.LocalVertices.empty() && !mesh.LocalIndices.empty())
+				geometry.emplace_back((uint32_t)entityHandle, mesh.GeometryRevision);
+		}
+		bool reuseGeometry = localSpace && s_Data.RTUploadedLocal && s_Data.VerticesSSBO &&
+			s_Data.RTUploadedWelded == s_Data.RTVertexWelding && geometry == s_Data.RTUploadedGeometry;
+
 		// 1. 清空所有 Host 缓存
-		s_Data.HostVertices.clear();
-		s_Data.HostTriangles.clear();
+		if (!reuseGeometry)
+		{
+			s_Data.HostVertices.clear();
+			s_Data.HostTriangles.clear();
+			s_Data.RTUpload = Renderer3D::RTUploadStats();
+			for (auto& [key, entry] : s_Data.WeldCache) entry.Used = false;
+		}
 		s_Data.HostMaterials.clear();
 		s_Data.HostSpectralCurves.clear(); // [新增] 清空光谱数据
 
-		auto view = scene->getRegistry().view<TransformComponent, MeshComponent>();
-
 		for (auto entityHandle : view)
 		{
 			auto [tc, mesh] = view.get<TransformComponent, MeshComponent>(entityHandle);
@@ -606,14 +762,33 @@ namespace Rongine {
 			s_Data.HostMaterials.push_back(gpuMat);			
 			// ============================================================
 
-			glm::mat4 transform = tc.GetTransform();
+			// 三角形的 MaterialID 只取决于实例顺序，沿用上次上传的三角形即可
+			if (reuseGeometry)
+				continue;
+
+			// 两层结构的变换在 Shader 里作用到光线上，顶点保持局部坐标
+			glm::mat4 transform = localSpace ? glm::mat4(1.0f) : tc.GetTransform();
 			glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(transform)));
 
 			uint32_t vertexOffset = (uint32_t)s_Data.HostVertices.size();
 
-			// --- 转换并合并顶点 ---
-			for (const auto& v : mesh.LocalVertices)
+			// --- 焊接 (可选)：每个面单独离散，面与面交界处的顶点重复存储 ---
+			const Renderer3DData::WeldCacheEntry* weld = nullptr;
+			if (s_Data.RTVertexWelding && mesh.VA)
 			{
+				auto it = s_Data.WeldCache.find(mesh.GeometryRevision);
+				if (it == s_Data.WeldCache.end())
+				{
+					it = s_Data.WeldCache.emplace(mesh.GeometryRevision, Renderer3DData::WeldCacheEntry()).first;
+					WeldVertices(mesh.LocalVertices, it->second.Remap, it->second.Unique);
+				}
+				auto& entry = it->second;
+				entry.Used = true;
+				weld = &entry;
+			}
+
+			// --- 转换并合并顶点 ---
+			auto pushVertex = [&](const CubeVertex& v) {
 				GPUVertex gpuV;
 				gpuV.Position = glm::vec3(transform * glm::vec4(v.Position, 1.0f));
 				gpuV.Normal = glm::normalize(normalMatrix * v.Normal);
@@ -621,42 +796,76 @@ namespace Rongine {
 				gpuV._pad1 = 0.0f; gpuV._pad2 = 0.0f; gpuV._pad3 = { 0.0f, 0.0f };
 
 				s_Data.HostVertices.push_back(gpuV);
+			};
+			if (weld)
+			{
+				for (uint32_t src : weld->Unique)
+					pushVertex(mesh.LocalVertices[src]);
+			}
+			else
+			{
+				for (const auto& v : mesh.LocalVertices)
+					pushVertex(v);
 			}
 
-			// --- 合并索引 ---
+			// --- 合并索引 (三角形顺序不变，只重映射顶点下标) ---
+			auto mapIndex = [&](uint32_t index) { return (weld ? weld->Remap[index] : index) + vertexOffset; };
 			for (size_t i = 0; i < mesh.LocalIndices.size(); i += 3)
 			{
 				if (i + 2 >= mesh.LocalIndices.size()) break;
 
 				TriangleData tri;
-				tri.v0 = mesh.LocalIndices[i + 0] + vertexOffset;
-				tri.v1 = mesh.LocalIndices[i + 1] + vertexOffset;
-				tri.v2 = mesh.LocalIndices[i + 2] + vertexOffset;
+				tri.v0 = mapIndex(mesh.LocalIndices[i + 0]);
+				tri.v1 = mapIndex(mesh.LocalIndices[i + 1]);
+				tri.v2 = mapIndex(mesh.LocalIndices[i + 2]);
 				tri.MaterialID = currentMatIndex;
 
 				s_Data.HostTriangles.push_back(tri);
 			}
+
+			s_Data.RTUpload.SourceVertices += (uint32_t)mesh.LocalVertices.size();
 		}
 
 		// ==================== 上传 SSBO 数据 ====================
 
-		if (s_Data.HostVertices.empty()) return;
+		if (!reuseGeometry)
+		{
+			// 丢掉已经不存在的网格的焊接结果
+			for (auto it = s_Data.WeldCache.begin(); it != s_Data.WeldCache.end();)
+			{
+				if (it->second.Used) ++it;
+				else it = s_Data.WeldCache.erase(it);
+			}
 
-		size_t vertSize = s_Data.HostVertices.size() * sizeof(GPUVertex);
-		size_t triSize = s_Data.HostTriangles.size() * sizeof(TriangleData);
-		size_t matSize = s_Data.HostMaterials.size() * sizeof(GPUMaterial);
+			s_Data.RTUploadedGeometry = std::move(geometry);
+			s_Data.RTUploadedLocal = localSpace;
+			s_Data.RTUploadedWelded = s_Data.RTVertexWelding;
 
-		// 1. Vertices SSBO
-		if (!s_Data.VerticesSSBO) s_Data.VerticesSSBO = ShaderStorageBuffer::create((uint32_t)vertSize, ShaderStorageBufferUsage::DynamicDraw);
-		else s_Data.VerticesSSBO->resize((uint32_t)vertSize);
-		s_Data.VerticesSSBO->bind(1);
-		s_Data.VerticesSSBO->setData(s_Data.HostVertices.data(), (uint32_t)vertSize);
+			if (s_Data.HostVertices.empty()) return;
 
-		// 2. Triangles SSBO
-		if (!s_Data.TrianglesSSBO) s_Data.TrianglesSSBO = ShaderStorageBuffer::create((uint32_t)triSize, ShaderStorageBufferUsage::DynamicDraw);
-		else s_Data.TrianglesSSBO->resize((uint32_t)triSize);
-		s_Data.TrianglesSSBO->bind(2);
-		s_Data.TrianglesSSBO->setData(s_Data.HostTriangles.data(), (uint32_t)triSize);
+			size_t vertSize = s_Data.HostVertices.size() * sizeof(GPUVertex);
+			size_t triSize = s_Data.HostTriangles.size() * sizeof(TriangleData);
+
+			s_Data.RTUpload.Triangles = (uint32_t)s_Data.HostTriangles.size();
+			s_Data.RTUpload.UploadedVertices = (uint32_t)s_Data.HostVertices.size();
+			s_Data.RTUpload.UploadedBytes = (uint32_t)(vertSize + triSize);
+
+			// 1. Vertices SSBO
+			if (!s_Data.VerticesSSBO) s_Data.VerticesSSBO = ShaderStorageBuffer::create((uint32_t)vertSize, ShaderStorageBufferUsage::DynamicDraw);
+			else s_Data.VerticesSSBO->resize((uint32_t)vertSize);
+			s_Data.VerticesSSBO->bind(1);
+			s_Data.VerticesSSBO->setData(s_Data.HostVertices.data(), (uint32_t)vertSize);
+
+			// 2. Triangles SSBO
+			if (!s_Data.TrianglesSSBO) s_Data.TrianglesSSBO = ShaderStorageBuffer::create((uint32_t)triSize, ShaderStorageBufferUsage::DynamicDraw);
+			else s_Data.TrianglesSSBO->resize((uint32_t)triSize);
+			s_Data.TrianglesSSBO->bind(2);
+			s_Data.TrianglesSSBO->setData(s_Data.HostTriangles.data(), (uint32_t)triSize);
+		}
+
+		if (s_Data.HostMaterials.empty()) return;
+
+		size_t matSize = s_Data.HostMaterials.size() * sizeof(GPUMaterial);
 
 		// 3. Materials SSBO
 		if (!s_Data.MaterialsSSBO) s_Data.MaterialsSSBO = ShaderStorageBuffer::create((uint32_t)matSize, ShaderStorageBufferUsage::DynamicDraw);
@@ -725,6 +934,33 @@ namespace Rongine {
 		if (s_Data.MaterialsSSBO) s_Data.MaterialsSSBO->bind(3);
 		if (s_Data.SpectralCurvesSSBO) s_Data.SpectralCurvesSSBO->bind(5);
 
+		// 加速结构：只有在数据已经构建好时才让 Shader 走 BVH，否则回退暴力求交
+		int accelType = (int)AccelType::None;
+		if (s_Data.CurrentAccelType == AccelType::BVH && s_Data.BVHStorageBuffer && s_Data.IndexMapBuffer && s_Data.BVHNodeCount > 0)
+		{
+			s_Data.BVHStorageBuffer->bind(6);
+			s_Data.IndexMapBuffer->bind(8);
+			accelType = (int)AccelType::BVH;
+		}
+		else if (s_Data.CurrentAccelType == AccelType::Octree && s_Data.OctreeStorageBuffer && s_Data.OctreeIndexBuffer && !s_Data.OctreeNodes.empty())
+		{
+			// 八叉树的叶子同样通过 8 号绑定点间接寻址
+			s_Data.OctreeStorageBuffer->bind(7);
+			s_Data.OctreeIndexBuffer->bind(8);
+			accelType = (int)AccelType::Octree;
+		}
+		else if (s_Data.CurrentAccelType == AccelType::TwoLevel && s_Data.BLASStorageBuffer && s_Data.BLASIndexBuffer &&
+			s_Data.TLASStorageBuffer && s_Data.InstanceStorageBuffer && !s_Data.SceneTwoLevelBVH.GetTLASNodes().empty())
+		{
+			// 两层结构复用 6/8 号绑定点存放拼接后的 BLAS
+			s_Data.BLASStorageBuffer->bind(6);
+			s_Data.BLASIndexBuffer->bind(8);
+			s_Data.TLASStorageBuffer->bind(9);
+			s_Data.InstanceStorageBuffer->bind(10);
+			accelType = (int)AccelType::TwoLevel;
+		}
+		shader->setInt("u_AccelType", accelType);
+
 		// 5. 发射计算
 		uint32_t width = outputTexture->getWidth();
 		uint32_t height = outputTexture->getHeight();
@@ -768,20 +1004,11 @@ namespace Rongine {
 		s_Data.FrameIndex = 1;
 	}
 
-	void Renderer3D::BuildAccelerationStructures(Scene* scene)
+	// 收集场景中所有三角形 (世界坐标)
+	// 注意：这里的遍历顺序必须与 UploadSceneDataToGPU 中上传 Triangles 的顺序严格一致！
+	// 否则索引就会错乱，BVH 会指向错误的三角形。
+	static void CollectWorldTriangles(Scene* scene, std::vector<BVHTriangle>& worldTriangles)
 	{
-		// 1. 如果当前没有启用 BVH，直接返回，节省性能
-		if (s_Data.CurrentAccelType != AccelType::BVH)
-			return;
-
-		// 计时开始 (用于性能分析)
-		auto start = std::chrono::high_resolution_clock::now();
-
-		// 2. 收集场景中所有的三角形
-		// 注意：这里的遍历顺序必须与 UploadSceneDataToGPU 中上传 Triangles 的顺序严格一致！
-		// 否则索引就会错乱，BVH 会指向错误的三角形。
-
-		std::vector<BVHTriangle> worldTriangles;
 		uint32_t globalTriIndex = 0; // 这是三角形在 GPU Triangles Buffer (Binding 2) 中的原始索引
 
 		// 获取所有带 Mesh 和 Transform 的实体
@@ -826,47 +1053,319 @@ namespace Rongine {
 				worldTriangles.push_back(tri);
 			}
 		}
+	}
 
-		// 如果没有三角形，就不构建了
-		if (worldTriangles.empty()) return;
+	void Renderer3D::BuildAccelerationStructures(Scene* scene)
+	{
+		BuildAccelerationStructures(scene, s_Data.BVHQuality);
+	}
 
-		// 3. 执行 BVH 构建 (CPU高计算量操作)
-		BVHBuilder builder(worldTriangles);
+	// 上传到 SSBO，容量不够时重新创建
+	static void UploadStorageBuffer(Ref<ShaderStorageBuffer>& buffer, const void* data, uint32_t size, uint32_t binding)
+	{
+		if (size == 0) return;
 
-		// 4. 获取构建结果
-		const auto& nodes = builder.GetNodes();
-		const auto& sortedIndices = builder.GetSortedIndices();
+		if (!buffer || buffer->getSize() < size)
+		{
+			buffer = ShaderStorageBuffer::create(size, ShaderStorageBufferUsage::StaticDraw);
+			buffer->bind(binding);
+		}
+		buffer->setData(data, size);
+	}
 
-		s_Data.BVHNodeCount = (uint32_t)nodes.size();
+	// 两层加速结构：BLAS 只在网格变化时重建/上传，TLAS 与实例数据每次都更新
+	// 拖拽时传入的临时质量 (LBVH) 在这里不需要：纯变换改动本来就只重建 TLAS
+	static void BuildTwoLevelAccelerationStructure(Scene* scene)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
 
-		// 5. 上传节点数据 (Binding 6)
-		uint32_t nodeBufferSize = (uint32_t)nodes.size() * sizeof(GPUBVHNode);
+		auto stats = s_Data.SceneTwoLevelBVH.Build(scene, s_Data.BVHQuality, s_Data.BVHParallelBuild);
 
-		if (!s_Data.BVHStorageBuffer || s_Data.BVHStorageBuffer->getSize() < nodeBufferSize)
+		if (stats.BLASLayoutChanged)
 		{
-			s_Data.BVHStorageBuffer = ShaderStorageBuffer::create(nodeBufferSize, ShaderStorageBufferUsage::StaticDraw);
-			s_Data.BVHStorageBuffer->bind(6);
+			const auto& blasNodes = s_Data.SceneTwoLevelBVH.GetBLASNodes();
+			const auto& blasIndices = s_Data.SceneTwoLevelBVH.GetBLASIndices();
+			UploadStorageBuffer(s_Data.BLASStorageBuffer, blasNodes.data(), (uint32_t)(blasNodes.size() * sizeof(GPUBVHNode)), 6);
+			UploadStorageBuffer(s_Data.BLASIndexBuffer, blasIndices.data(), (uint32_t)(blasIndices.size() * sizeof(uint32_t)), 8);
 		}
-		s_Data.BVHStorageBuffer->setData(nodes.data(), nodeBufferSize);
 
-		// 6. 上传索引映射表 (Binding 8)
-		// Shader 遍历到叶子节点时，拿到的是 sortedIndices 里的索引，
-		// 需要通过 sortedIndices[i] 查找到原始的 TriangleID
-		uint32_t indexBufferSize = (uint32_t)sortedIndices.size() * sizeof(uint32_t);
+		const auto& tlasNodes = s_Data.SceneTwoLevelBVH.GetTLASNodes();
+		const auto& instances = s_Data.SceneTwoLevelBVH.GetInstances();
+		UploadStorageBuffer(s_Data.TLASStorageBuffer, tlasNodes.data(), (uint32_t)(tlasNodes.size() * sizeof(GPUBVHNode)), 9);
+		UploadStorageBuffer(s_Data.InstanceStorageBuffer, instances.data(), (uint32_t)(instances.size() * sizeof(GPUInstance)), 10);
+
+		s_Data.BVHNodeCount = (uint32_t)(tlasNodes.size() + s_Data.SceneTwoLevelBVH.GetBLASNodes().size());
+
+		auto end = std::chrono::high_resolution_clock::now();
+		float duration = std::chrono::duration<float, std::milli>(end - start).count();
+		s_Data.BVHBuildTimeMs = duration;
+		RONG_CORE_INFO("Two-Level BVH Rebuilt: {0} Instances, {1} BLAS Rebuilt, TLAS {2} Nodes in {3}ms",
+			stats.InstanceCount, stats.BLASRebuilt, tlasNodes.size(), duration);
+	}
 
-		if (!s_Data.IndexMapBuffer || s_Data.IndexMapBuffer->getSize() < indexBufferSize)
+	static void BuildOctreeAccelerationStructure(Scene* scene)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		std::vector<BVHTriangle> worldTriangles;
+		CollectWorldTriangles(scene, worldTriangles);
+
+		if (worldTriangles.empty())
 		{
-			s_Data.IndexMapBuffer = ShaderStorageBuffer::create(indexBufferSize, ShaderStorageBufferUsage::StaticDraw);
-			s_Data.IndexMapBuffer->bind(8);
+			s_Data.OctreeNodes.clear();
+			s_Data.OctreeTriangleIndices.clear();
+			return;
+		}
+
+		OctreeBuilder builder(worldTriangles, s_Data.OctreeConfig);
+		s_Data.OctreeNodes = builder.GetNodes();
+		s_Data.OctreeTriangleIndices = builder.GetTriangleIndices();
+
+		const auto& nodes = s_Data.OctreeNodes;
+		const auto& indices = s_Data.OctreeTriangleIndices;
+		UploadStorageBuffer(s_Data.OctreeStorageBuffer, nodes.data(), (uint32_t)(nodes.size() * sizeof(GPUOctreeNode)), 7);
+		UploadStorageBuffer(s_Data.OctreeIndexBuffer, indices.data(), (uint32_t)(indices.size() * sizeof(uint32_t)), 8);
+
+		auto end = std::chrono::high_resolution_clock::now();
+		float duration = std::chrono::duration<float, std::milli>(end - start).count();
+		s_Data.BVHBuildTimeMs = duration;
+		RONG_CORE_INFO("Octree Rebuilt: {0} Triangles, {1} Nodes, {2} Leaf References in {3}ms",
+			worldTriangles.size(), nodes.size(), indices.size(), duration);
+	}
+
+	// Refit 后 SAH 代价超过完整构建时的这个倍数，就认为树已经退化，改为完整重建
+	static const float s_BVHRefitMaxSAHGrowth = 1.5f;
+
+	// 拓扑不变时只更新包围盒，并只上传变化的节点区间。返回 false 表示需要完整重建
+	static bool RefitBVH(const std::vector<BVHTriangle>& worldTriangles, BVHBuildQuality quality)
+	{
+		if (!s_Data.BVHRefitEnabled || s_Data.BVHForceRebuild)
+			return false;
+
+		// 1. 三角形数量必须一致 (叶子引用的是三角形 ID)
+		if (s_Data.BVHNodes.empty() || !s_Data.BVHStorageBuffer || s_Data.BVHBuildSAHCost <= 0.0f ||
+			s_Data.SortedTriangleIndices.size() != worldTriangles.size())
+			return false;
+
+		// 2. 树结构的质量要满足请求 (拖拽时请求 LBVH，任何已有的树都可以沿用)
+		if (quality != BVHBuildQuality::LBVH && quality != s_Data.BVHBuiltQuality)
+			return false;
+
+		std::vector<std::pair<uint32_t, uint32_t>> dirtyRanges;
+		if (!BVHBuilder::Refit(s_Data.BVHNodes, s_Data.SortedTriangleIndices, worldTriangles, &dirtyRanges))
+			return false;
+
+		// 3. 质量检查：包围盒重叠太多时 SAH 代价会明显上升
+		float growth = BVHBuilder::ComputeSAHCost(s_Data.BVHNodes) / s_Data.BVHBuildSAHCost;
+		if (growth > s_BVHRefitMaxSAHGrowth)
+		{
+			RONG_CORE_INFO("BVH Refit rejected: SAH cost grew {0}x, rebuilding", growth);
+			return false;
+		}
+
+		// 4. 只上传脏区间 (Binding 6 的 SSBO 保持不变，索引表也不需要重新上传)
+		uint32_t uploadedBytes = 0;
+		for (const auto& [first, count] : dirtyRanges)
+		{
+			uint32_t size = count * (uint32_t)sizeof(GPUBVHNode);
+			s_Data.BVHStorageBuffer->setData(&s_Data.BVHNodes[first], size, first * (uint32_t)sizeof(GPUBVHNode));
+			uploadedBytes += size;
+		}
+
+		s_Data.BVHUpdate.Refitted = true;
+		s_Data.BVHUpdate.SAHGrowth = growth;
+		s_Data.BVHUpdate.UploadedBytes = uploadedBytes;
+		s_Data.BVHUpdate.UploadRanges = (uint32_t)dirtyRanges.size();
+		return true;
+	}
+
+	void Renderer3D::BuildAccelerationStructures(Scene* scene, BVHBuildQuality quality)
+	{
+		if (s_Data.CurrentAccelType == AccelType::TwoLevel)
+		{
+			BuildTwoLevelAccelerationStructure(scene);
+			return;
+		}
+
+		if (s_Data.CurrentAccelType == AccelType::Octree)
+		{
+			BuildOctreeAccelerationStructure(scene);
+			return;
 		}
-		s_Data.IndexMapBuffer->setData(sortedIndices.data(), indexBufferSize);
+
+		// 1. 如果当前没有启用 BVH，直接返回，节省性能
+		if (s_Data.CurrentAccelType != AccelType::BVH)
+			return;
+
+		// 计时开始 (用于性能分析)
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// 2. 收集场景中所有的三角形
+		std::vector<BVHTriangle> worldTriangles;
+		CollectWorldTriangles(scene, worldTriangles);
+
+		// 如果没有三角形，就不构建了 (同时让 Shader 回退到暴力求交，避免访问旧节点)
+		if (worldTriangles.empty())
+		{
+			s_Data.BVHNodeCount = 0;
+			return;
+		}
+
+		// 3. 拓扑没变时优先 Refit
+		if (RefitBVH(worldTriangles, quality))
+		{
+			auto end = std::chrono::high_resolution_clock::now();
+			float duration = std::chrono::duration<float, std::milli>(end - start).count();
+			s_Data.BVHBuildTimeMs = duration;
+			RONG_CORE_INFO("BVH Refitted: {0} Triangles, {1} Dirty Ranges ({2} Bytes), SAH x{3} in {4}ms",
+				worldTriangles.size(), s_Data.BVHUpdate.UploadRanges, s_Data.BVHUpdate.UploadedBytes, s_Data.BVHUpdate.SAHGrowth, duration);
+			return;
+		}
+
+		// 4. 执行 BVH 构建 (CPU高计算量操作)，结果缓存到 CPU 端
+		if (quality == BVHBuildQuality::LBVH)
+		{
+			LBVHBuilder builder(worldTriangles);
+			s_Data.BVHNodes = builder.GetNodes();
+			s_Data.SortedTriangleIndices = builder.GetSortedIndices();
+		}
+		else
+		{
+			BVHBuilder builder(worldTriangles, quality, s_Data.BVHParallelBuild);
+			s_Data.BVHNodes = builder.GetNodes();
+			s_Data.SortedTriangleIndices = builder.GetSortedIndices();
+		}
+
+		// 5. 获取构建结果
+		const auto& nodes = s_Data.BVHNodes;
+		const auto& sortedIndices = s_Data.SortedTriangleIndices;
+
+		s_Data.BVHNodeCount = (uint32_t)nodes.size();
+		s_Data.BVHBuiltQuality = quality;
+		s_Data.BVHBuildSAHCost = BVHBuilder::ComputeSAHCost(nodes);
+		s_Data.BVHForceRebuild = false;
+
+#ifdef RONG_DEBUG
+		// 调试构建下校验每个三角形都能被恰好访问一次
+		BVHBuilder::Validate(nodes, sortedIndices, worldTriangles.size());
+#endif
+
+		// 6. 上传节点数据 (Binding 6)
+		UploadStorageBuffer(s_Data.BVHStorageBuffer, nodes.data(), (uint32_t)(nodes.size() * sizeof(GPUBVHNode)), 6);
+
+		s_Data.BVHUpdate.Refitted = false;
+		s_Data.BVHUpdate.SAHGrowth = 1.0f;
+		s_Data.BVHUpdate.UploadedBytes = (uint32_t)(nodes.size() * sizeof(GPUBVHNode));
+		s_Data.BVHUpdate.UploadRanges = 1;
+
+		// 7. 上传索引映射表 (Binding 8)
+		// Shader 遍历到叶子节点时，拿到的是 sortedIndices 里的索引，
+		// 需要通过 sortedIndices[i] 查找到原始的 TriangleID
+		UploadStorageBuffer(s_Data.IndexMapBuffer, sortedIndices.data(), (uint32_t)(sortedIndices.size() * sizeof(uint32_t)), 8);
 
 		// 性能统计日志
 		auto end = std::chrono::high_resolution_clock::now();
 		float duration = std::chrono::duration<float, std::milli>(end - start).count();
+		s_Data.BVHBuildTimeMs = duration;
 		RONG_CORE_INFO("BVH Rebuilt: {0} Triangles, {1} Nodes in {2}ms", worldTriangles.size(), nodes.size(), duration);
 	}
 
+	void Renderer3D::BenchmarkAccelerationStructures(Scene* scene)
+	{
+		std::vector<BVHTriangle> worldTriangles;
+		CollectWorldTriangles(scene, worldTriangles);
+
+		BVHBuilder::Benchmark(worldTriangles);
+
+		// 两层结构：首次构建 (所有 BLAS) 与纯变换改动 (只重建 TLAS) 的耗时对比，并用 CPU 求交校验
+		TwoLevelBVH twoLevel;
+		auto t0 = std::chrono::high_resolution_clock::now();
+		auto fullStats = twoLevel.Build(scene, s_Data.BVHQuality, s_Data.BVHParallelBuild);
+		auto t1 = std::chrono::high_resolution_clock::now();
+		twoLevel.Build(scene, s_Data.BVHQuality, s_Data.BVHParallelBuild);
+		auto t2 = std::chrono::high_resolution_clock::now();
+
+		RONG_CORE_INFO("BVH Benchmark [Two-Level]: {0} Instances, Full Build {1}ms, TLAS-Only Rebuild {2}ms",
+			fullStats.InstanceCount,
+			std::chrono::duration<float, std::milli>(t1 - t0).count(),
+			std::chrono::duration<float, std::milli>(t2 - t1).count());
+
+		twoLevel.Validate(worldTriangles, 256);
+
+		// 八叉树与 BVH 的构建耗时和射线查询代价对比
+		OctreeBuilder::Benchmark(worldTriangles, s_Data.OctreeConfig);
+
+		// CPU 射线查询吞吐量：二叉 BVH 标量遍历 vs BVH4 / BVH8 SIMD 遍历
+		BenchmarkRayQueries(worldTriangles);
+	}
+
+	void Renderer3D::setBVHBuildQuality(BVHBuildQuality quality)
+	{
+		s_Data.BVHQuality = quality;
+		s_Data.BVHForceRebuild = true;
+	}
+
+	BVHBuildQuality Renderer3D::getBVHBuildQuality()
+	{
+		return s_Data.BVHQuality;
+	}
+
+	void Renderer3D::setBVHParallelBuild(bool enable)
+	{
+		s_Data.BVHParallelBuild = enable;
+		s_Data.BVHForceRebuild = true;
+	}
+
+	bool Renderer3D::isBVHParallelBuild()
+	{
+		return s_Data.BVHParallelBuild;
+	}
+
+	void Renderer3D::setBVHRefitEnabled(bool enable)
+	{
+		s_Data.BVHRefitEnabled = enable;
+	}
+
+	bool Renderer3D::isBVHRefitEnabled()
+	{
+		return s_Data.BVHRefitEnabled;
+	}
+
+	Renderer3D::BVHUpdateStats Renderer3D::getBVHUpdateStats()
+	{
+		return s_Data.BVHUpdate;
+	}
+
+	void Renderer3D::setRTVertexWelding(bool enable)
+	{
+		s_Data.RTVertexWelding = enable;
+	}
+
+	bool Renderer3D::isRTVertexWelding()
+	{
+		return s_Data.RTVertexWelding;
+	}
+
+	Renderer3D::RTUploadStats Renderer3D::getRTUploadStats()
+	{
+		return s_Data.RTUpload;
+	}
+
+	float Renderer3D::getBVHBuildTime()
+	{
+		return s_Data.BVHBuildTimeMs;
+	}
+
+	void Renderer3D::setOctreeSettings(const OctreeSettings& settings)
+	{
+		s_Data.OctreeConfig = settings;
+	}
+
+	OctreeSettings Renderer3D::getOctreeSettings()
+	{
+		return s_Data.OctreeConfig;
+	}
+
 	void Renderer3D::setAccelType(const AccelType& acceltype)
 	{
 		s_Data.CurrentAccelType = acceltype;
@@ -13,6 +13,8 @@
 #include "Rongine/Renderer/ComputeShader.h"
 #include "Rongine/Renderer/Framebuffer.h"
 #include "Rongine/Renderer/AccelerationStructures.h"
+#include "Rongine/Renderer/TwoLevelBVH.h"
+#include "Rongine/Renderer/Octree.h"
 
 #include <glm/glm.hpp>
 
@@ -55,7 +57,23 @@ namespace Rongine {
 
 		static void drawModel(const Ref<VertexArray>& va, const glm::mat4& transform = glm::mat4(1.0f),int entityID=-1, const MaterialComponent* material=nullptr);
 		static void drawModel(Entity& en, const glm::mat4& transform = glm::mat4(1.0f), int entityID = -1);
-		static void drawEdges(const Ref<VertexArray>& va, const glm::mat4& transform, const glm::vec4& color, int entityID, int selectedEdgeID = -1);
+
+		// 边框线：所有实体的线带打包在一个场景线缓冲里 (只有某个实体的 EdgeRevision 变了才重新打包)
+		// beginEdges 同步缓冲，submitEdges 登记本帧要画的实体，endEdges 合并相邻区间后一次 MultiDraw
+		static void beginEdges(Scene* scene);
+		static void submitEdges(entt::entity entity, const glm::mat4& transform, const glm::vec4& color, int selectedEdgeID = -1);
+		static void endEdges();
+
+		struct EdgeBufferStats
+		{
+			uint32_t Entities = 0;      // 缓冲中登记的实体数
+			uint32_t Vertices = 0;
+			uint32_t Indices = 0;       // 含重启索引
+			uint32_t Rebuilds = 0;      // 累计重新打包次数
+			uint32_t SubmittedRanges = 0; // 最近一帧提交的实体数
+			uint32_t DrawRanges = 0;    // 合并后的 MultiDraw 区间数
+		};
+		static EdgeBufferStats getEdgeBufferStats();
 
 
 
@@ -77,10 +95,47 @@ namespace Rongine {
 		static void ResizeComputeOutput(uint32_t width, uint32_t height);
 
 		static void BuildAccelerationStructures(Scene* scene);
+		// 指定构建质量 (例如拖拽时临时使用 LBVH 快速重建)
+		static void BuildAccelerationStructures(Scene* scene, BVHBuildQuality quality);
+		// 对当前场景跑一遍各构建策略的性能对比，以及 CPU 射线查询吞吐量 (结果输出到日志)
+		static void BenchmarkAccelerationStructures(Scene* scene);
 
 		static void setAccelType(const AccelType& acceltype);
 		static AccelType getAccelType();
 
+		static void setBVHBuildQuality(BVHBuildQuality quality);
+		static BVHBuildQuality getBVHBuildQuality();
+		static void setBVHParallelBuild(bool enable);
+		static bool isBVHParallelBuild();
+		static float getBVHBuildTime();
+
+		// 拓扑不变 (只有顶点/变换变化) 时只 Refit 包围盒，SAH 代价恶化过多再完整重建
+		struct BVHUpdateStats
+		{
+			bool Refitted = false;      // 最近一次更新是否为 Refit
+			float SAHGrowth = 1.0f;     // Refit 后的 SAH 代价 / 上次完整构建时的 SAH 代价
+			uint32_t UploadedBytes = 0; // 上传到 Binding 6 的字节数
+			uint32_t UploadRanges = 0;  // 上传调用次数 (Refit 时为脏区间数量)
+		};
+		static void setBVHRefitEnabled(bool enable);
+		static bool isBVHRefitEnabled();
+		static BVHUpdateStats getBVHUpdateStats();
+
+		static void setOctreeSettings(const OctreeSettings& settings);
+		static OctreeSettings getOctreeSettings();
+
+		// 光追上传前跨面焊接顶点 (只合并位置重合且法线一致的顶点，三角形顺序不变，加速结构不受影响)
+		struct RTUploadStats
+		{
+			uint32_t Triangles = 0;
+			uint32_t SourceVertices = 0;   // 网格原始顶点数
+			uint32_t UploadedVertices = 0; // 实际上传的顶点数 (焊接后)
+			uint32_t UploadedBytes = 0;    // Binding 1 + Binding 2 的字节数
+		};
+		static void setRTVertexWelding(bool enable);
+		static bool isRTVertexWelding();
+		static RTUploadStats getRTUploadStats();
+
 		static int getBVHNodeCount();
 		static int getOctreeNodeCount();
 
@@ -112,6 +167,7 @@ namespace Rongine {
 		Ref<VertexArray> CubeVA;
 		Ref<VertexBuffer> CubeVB;
 		Ref<Shader> TextureShader;
+		Ref<Shader> CADMeshShader; // 紧凑顶点格式 (CADVertex)
 		Ref<Shader> LineShader;
 		Ref<Texture2D> WhiteTexture;
 
@@ -119,6 +175,24 @@ namespace Rongine {
 		Ref<VertexBuffer> BatchLineVB;
 		Ref<Shader> BatchLineShader;
 
+		// 场景线缓冲
+		struct EdgeRange
+		{
+			uint64_t Revision = 0;
+			uint32_t Slot = 0;
+			uint32_t FirstIndex = 0;
+			uint32_t IndexCount = 0; // 含末尾的重启索引，相邻区间可以直接合并
+		};
+		Scene* EdgeScene = nullptr;
+		std::unordered_map<entt::entity, EdgeRange> EdgeRanges;
+		Ref<VertexArray> EdgeVA;
+		Ref<ShaderStorageBuffer> EdgeRangeSSBO; // Binding 11
+		std::vector<GPUEdgeRange> EdgeRangeData;
+		std::vector<uint32_t> EdgeSubmittedSlots;
+		std::vector<uint32_t> EdgeSlotFirstIndex;
+		std::vector<uint32_t> EdgeSlotIndexCount;
+		Renderer3D::EdgeBufferStats EdgeStats;
+
 		uint32_t CubeIndexCount = 0;
 		CubeVertex* CubeVertexBufferBase = nullptr;
 		CubeVertex* CubeVertexBufferPtr = nullptr;
@@ -157,6 +231,22 @@ namespace Rongine {
 		std::vector<TriangleData> HostTriangles;
 		std::vector<GPUMaterial> HostMaterials;
 
+		// 焊接结果按网格版本号缓存 (MeshComponent::GeometryRevision，全局唯一)
+		struct WeldCacheEntry
+		{
+			std::vector<uint32_t> Remap;
+			std::vector<uint32_t> Unique;
+			bool Used = false;
+		};
+		std::unordered_map<uint64_t, WeldCacheEntry> WeldCache;
+		bool RTVertexWelding = true;
+		Renderer3D::RTUploadStats RTUpload;
+
+		// 两层结构上传的是局部空间顶点：实例顺序、网格版本号和焊接开关都没变时 Binding 1/2 沿用上次上传的数据
+		std::vector<std::pair<uint32_t, uint64_t>> RTUploadedGeometry; // (实体句柄, GeometryRevision)
+		bool RTUploadedLocal = false;
+		bool RTUploadedWelded = false;
+
 		Ref<Texture2D> ComputeOutputTexture; // 画布
 		Ref<Texture2D> AccumulationTexture;  // 累加 
 		Ref<ComputeShader> RaytracingShader; // 画笔
@@ -184,7 +274,28 @@ namespace Rongine {
 		Ref<ShaderStorageBuffer> BVHStorageBuffer;    // Binding 6
 		Ref<ShaderStorageBuffer> OctreeStorageBuffer; // Binding 7
 		Ref<ShaderStorageBuffer> IndexMapBuffer;      // Binding 8 (用于间接寻址)
+		Ref<ShaderStorageBuffer> OctreeIndexBuffer;   // Binding 8 (八叉树叶子 -> 三角形 ID)
+
+		OctreeSettings OctreeConfig;
+		std::vector<uint32_t> OctreeTriangleIndices;
+
+		// 两层加速结构 (BLAS 缓存在 SceneTwoLevelBVH 内部)
+		TwoLevelBVH SceneTwoLevelBVH;
+		Ref<ShaderStorageBuffer> BLASStorageBuffer;     // Binding 6 (拼接后的 BLAS 节点)
+		Ref<ShaderStorageBuffer> BLASIndexBuffer;       // Binding 8 (BLAS 叶子 -> 全局三角形 ID)
+		Ref<ShaderStorageBuffer> TLASStorageBuffer;     // Binding 9
+		Ref<ShaderStorageBuffer> InstanceStorageBuffer; // Binding 10
 
 		uint32_t BVHNodeCount = 0;
+		BVHBuildQuality BVHQuality = BVHBuildQuality::SAH;
+		bool BVHParallelBuild = true; // 多线程构建 (结果与单线程一致)
+		float BVHBuildTimeMs = 0.0f;
+
+		// Refit 状态
+		bool BVHRefitEnabled = true;
+		bool BVHForceRebuild = false; // 构建参数变了，下一次必须完整重建
+		BVHBuildQuality BVHBuiltQuality = BVHBuildQuality::SAH; // 当前树结构的构建质量
+		float BVHBuildSAHCost = 0.0f; // 上次完整构建时的 SAH 代价
+		Renderer3D::BVHUpdateStats BVHUpdate;
 	};
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ namespace Rongine {
 		// 现代渲染命令
 		virtual void drawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount) = 0;
 		virtual void drawArrays(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		// 一次画多段带索引的线带 (图元重启索引为 32 位最大值)，firstIndices/counts 以索引个数计
+		virtual void drawLineStrips(const Ref<VertexArray>& vertexArray, const uint32_t* firstIndices, const uint32_t* counts, uint32_t drawCount) = 0;
 
 		// GPU 状态管理
 		virtual void setDepthTest(bool enabled) = 0;
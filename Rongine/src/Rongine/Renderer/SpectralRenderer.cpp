@@ -1,9 +1,14 @@
 ﻿#include "Rongpch.h"
 #include "SpectralRenderer.h"
 #include "Rongine/Scene/Entity.h"
+#include "Rongine/Core/Log.h"
+#include "Rongine/Scene/SceneSerializer.h"
+#include <glm/gtc/constants.hpp>
 #include <random>
 #include <execution>// C++17 并行算法
 #include <numeric>// for std::iota
+#include <chrono>
+#include <fstream>
 
 
 namespace Rongine {
@@ -18,6 +23,47 @@ namespace Rongine {
 		return (a << 24) | (b << 16) | (g << 8) | r;
 	}
 
+	// ==================== 与 Raytrace.glsl 保持一致的采样工具 ====================
+	static const float s_RayOffset = 0.001f;
+
+	static uint32_t InitSeed(uint32_t x, uint32_t y, uint32_t frame)
+	{
+		return y * 1920u + x + frame * 719393u;
+	}
+
+	static float RandomFloat(uint32_t& seed)
+	{
+		seed = seed * 747796405u + 2891336453u;
+		uint32_t result = ((seed >> ((seed >> 28) + 4u)) ^ seed) * 277803737u;
+		result = (result >> 22) ^ result;
+		return (float)result / 4294967295.0f;
+	}
+
+	static glm::vec3 SampleCosineHemisphere(const glm::vec3& N, uint32_t& seed)
+	{
+		float r1 = RandomFloat(seed);
+		float r2 = RandomFloat(seed);
+		float r = std::sqrt(r1);
+		float theta = 2.0f * glm::pi<float>() * r2;
+		float x = r * std::cos(theta);
+		float y = r * std::sin(theta);
+		float z = std::sqrt(std::max(0.0f, 1.0f - r1));
+		glm::vec3 up = std::abs(N.z) < 0.999f ? glm::vec3(0, 0, 1) : glm::vec3(1, 0, 0);
+		glm::vec3 tangent = glm::normalize(glm::cross(up, N));
+		glm::vec3 bitangent = glm::cross(N, tangent);
+		return glm::normalize(tangent * x + bitangent * y + N * z);
+	}
+
+	static float FresnelSchlick(float cosTheta, float F0)
+	{
+		return F0 + (1.0f - F0) * std::pow(1.0f - cosTheta, 5.0f);
+	}
+
+	static float Luminance(const glm::vec3& c)
+	{
+		return glm::dot(c, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+	}
+
 	SpectralRenderer::SpectralRenderer()
 	{
 	}
@@ -29,54 +75,163 @@ namespace Rongine {
 		m_Width = width;
 		m_Height = height;
 
-		// 重新分配内存
+		// 重新分配内存 (GPU 纹理在 Render 中按需创建，Headless 模式不需要 GL 上下文)
 		m_ImageData.resize(m_Width * m_Height);
+		m_AccumulationData.resize(m_Width * m_Height);
+		m_TileStats.resize(((m_Width + TileSize - 1) / TileSize) * ((m_Height + TileSize - 1) / TileSize));
+		ResetAccumulation();
+	}
+
+	void SpectralRenderer::ResetAccumulation()
+	{
+		m_FrameIndex = 0;
+		std::fill(m_AccumulationData.begin(), m_AccumulationData.end(), glm::vec4(0.0f));
+		std::fill(m_TileStats.begin(), m_TileStats.end(), TileStats());
+	}
+
+	uint32_t SpectralRenderer::GetConvergedTileCount() const
+	{
+		return (uint32_t)std::count_if(m_TileStats.begin(), m_TileStats.end(), [](const TileStats& t) { return t.Converged; });
+	}
+
+	void SpectralRenderer::Render(Scene& scene, const PerspectiveCamera& camera)
+	{
+		if (m_Width == 0 || m_Height == 0) return;
+
+		RenderFrame(scene, camera);
 
 		// 创建或重建 GPU 纹理
-		if (m_FinalTexture) m_FinalTexture.reset(); // 释放旧的
-		m_FinalTexture = Texture2D::create(m_Width, m_Height);
+		if (!m_FinalTexture || m_FinalTexture->getWidth() != m_Width || m_FinalTexture->getHeight() != m_Height)
+			m_FinalTexture = Texture2D::create(m_Width, m_Height);
+
+		// 把 CPU 数据上传到 GPU
+		m_FinalTexture->setData(m_ImageData.data(), m_ImageData.size() * sizeof(uint32_t));
 	}
 
-	void SpectralRenderer::Render( Scene& scene, const PerspectiveCamera& camera)
+	void SpectralRenderer::RenderFrame(Scene& scene, const PerspectiveCamera& camera)
 	{
 		if (m_Width == 0 || m_Height == 0) return;
 
-		// 创建一个行索引的集合: 0, 1, 2, ..., height-1
-		std::vector<uint32_t> verticalIter(m_Height);
-		std::iota(verticalIter.begin(), verticalIter.end(), 0);
+		bool sceneChanged = UpdateSceneCache(scene);
+
+		// 相机矩阵每帧只求逆一次
+		bool cameraChanged = camera.getViewProjectionMatrix() != m_LastViewProjection;
+		m_LastViewProjection = camera.getViewProjectionMatrix();
+		m_InverseProjection = camera.getInverseProjectionMatrix();
+		m_InverseView = camera.getInverseViewMatrix();
+		m_CameraPosition = camera.getPosition();
+
+		if (sceneChanged || cameraChanged)
+			ResetAccumulation();
+		m_FrameIndex++;
+
+		// 按 Tile 而不是按行划分任务：同一块像素的射线方向相近，BVH 节点在缓存里复用率更高
+		uint32_t tilesX = (m_Width + TileSize - 1) / TileSize;
+		std::vector<uint32_t> tileIter(m_TileStats.size());
+		std::iota(tileIter.begin(), tileIter.end(), 0);
 
 		// 使用 std::execution::par 让所有 CPU 核心一起跑
-		std::for_each(std::execution::par, verticalIter.begin(), verticalIter.end(),
-			[this, &camera,&scene](uint32_t y)
+		std::for_each(std::execution::par, tileIter.begin(), tileIter.end(),
+			[this, tilesX](uint32_t tile)
 			{
-				for (uint32_t x = 0; x < m_Width; x++)
-				{
-					glm::vec4 color = PerPixel(x, y, m_Width, m_Height, camera,scene);
-
-					// 写入 Buffer
-					m_ImageData[x + y * m_Width] = ConvertToRGBA(color);
-				}
+				RenderTile(tile, tilesX);
 			});
+	}
 
-		// 把 CPU 数据上传到 GPU
-		m_FinalTexture->setData(m_ImageData.data(), m_ImageData.size() * sizeof(uint32_t));
+	void SpectralRenderer::RenderTile(uint32_t tile, uint32_t tilesX)
+	{
+		uint32_t x0 = (tile % tilesX) * TileSize;
+		uint32_t y0 = (tile / tilesX) * TileSize;
+		uint32_t x1 = std::min(x0 + TileSize, m_Width);
+		uint32_t y1 = std::min(y0 + TileSize, m_Height);
+
+		if (m_Mode == RenderMode::Preview)
+		{
+			for (uint32_t y = y0; y < y1; y++)
+				for (uint32_t x = x0; x < x1; x++)
+					m_ImageData[x + y * m_Width] = ConvertToRGBA(PerPixel(x, y));
+			return;
+		}
+
+		// 已收敛的 Tile 不再采样，保留上一帧的结果
+		TileStats& stats = m_TileStats[tile];
+		if (stats.Converged) return;
+		stats.SampleCount++;
+
+		for (uint32_t y = y0; y < y1; y++)
+		{
+			for (uint32_t x = x0; x < x1; x++)
+			{
+				uint32_t seed = InitSeed(x, y, m_FrameIndex);
+				glm::vec3 radiance = PathTracePixel(x, y, seed);
+
+				glm::vec4& accum = m_AccumulationData[x + y * m_Width];
+				float luminance = Luminance(radiance);
+				accum += glm::vec4(radiance, luminance * luminance);
+
+				// 与 Raytrace.glsl 相同的 Tone Mapping
+				glm::vec3 avgColor = glm::vec3(accum) / (float)stats.SampleCount;
+				avgColor = avgColor / (avgColor + glm::vec3(1.0f));
+				avgColor = glm::pow(avgColor, glm::vec3(1.0f / 2.2f));
+
+				m_ImageData[x + y * m_Width] = ConvertToRGBA(glm::vec4(avgColor, 1.0f));
+			}
+		}
+
+		UpdateTileStats(tile, tilesX);
 	}
 
-	// 计算像素
-	glm::vec4 SpectralRenderer::PerPixel(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const PerspectiveCamera& camera, Scene& scene)
+	void SpectralRenderer::UpdateTileStats(uint32_t tile, uint32_t tilesX)
+	{
+		uint32_t x0 = (tile % tilesX) * TileSize;
+		uint32_t y0 = (tile / tilesX) * TileSize;
+		uint32_t x1 = std::min(x0 + TileSize, m_Width);
+		uint32_t y1 = std::min(y0 + TileSize, m_Height);
+
+		TileStats& stats = m_TileStats[tile];
+		float n = (float)stats.SampleCount;
+
+		// 每个像素: 均值的标准误差 = sqrt(Var / n)
+		double sumMean = 0.0, sumError = 0.0;
+		for (uint32_t y = y0; y < y1; y++)
+		{
+			for (uint32_t x = x0; x < x1; x++)
+			{
+				const glm::vec4& accum = m_AccumulationData[x + y * m_Width];
+				float mean = Luminance(glm::vec3(accum)) / n;
+				float variance = std::max(accum.a / n - mean * mean, 0.0f);
+				sumMean += mean;
+				sumError += std::sqrt(variance / n);
+			}
+		}
+
+		stats.MeanLuminance = (float)(sumMean / ((x1 - x0) * (y1 - y0)));
+		stats.RelativeError = (float)(sumError / std::max(sumMean, 1e-6));
+		stats.Converged = m_Settings.ConvergenceThreshold > 0.0f && stats.SampleCount >= m_Settings.MinTileSamples &&
+			stats.RelativeError < m_Settings.ConvergenceThreshold;
+	}
+
+	SpectralRenderer::Ray SpectralRenderer::GenerateRay(float x, float y) const
 	{
 		Ray ray;
-		ray.Origin = camera.getPosition();
+		ray.Origin = m_CameraPosition;
 
-		glm::vec2 coord = { (float)x / (float)width, (float)y / (float)height };
+		glm::vec2 coord = { x / (float)m_Width, y / (float)m_Height };
 		coord = coord * 2.0f - 1.0f;
 
-		glm::vec4 target = camera.getInverseProjectionMatrix() * glm::vec4(coord.x, coord.y, 1.0f, 1.0f);
-		glm::vec3 rayDir = glm::vec3(camera.getInverseViewMatrix() * glm::vec4(glm::normalize(glm::vec3(target) / target.w), 0));
+		glm::vec4 target = m_InverseProjection * glm::vec4(coord.x, coord.y, 1.0f, 1.0f);
+		glm::vec3 rayDir = glm::vec3(m_InverseView * glm::vec4(glm::normalize(glm::vec3(target) / target.w), 0));
 
 		ray.Direction = glm::normalize(rayDir);
+		return ray;
+	}
 
-		HitPayload payload = TraceRay(ray, scene);
+	// 计算像素
+	glm::vec4 SpectralRenderer::PerPixel(uint32_t x, uint32_t y)
+	{
+		Ray ray = GenerateRay((float)x, (float)y);
+
+		HitPayload payload = TraceRay(ray);
 
 		if (payload.HitDistance < 0.0f)
 		{
@@ -93,7 +248,7 @@ namespace Rongine {
 
 		// 2. 准备向量
 		glm::vec3 normal = glm::normalize(payload.WorldNormal);
-		glm::vec3 viewDir = glm::normalize(camera.getPosition() - payload.WorldPosition);
+		glm::vec3 viewDir = glm::normalize(m_CameraPosition - payload.WorldPosition);
 
 		// --- A. 漫反射 (Diffuse) ---
 		// 塑料和金属都有漫反射，但金属的漫反射通常很弱（甚至为0，全黑）
@@ -144,119 +299,334 @@ namespace Rongine {
 		return glm::vec4(finalColor, 1.0f);
 	}
 
-	// Möller–Trumbore ray-triangle intersection algorithm
-	bool SpectralRenderer::RayTriangleIntersect(const Ray& ray,
-		const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
-		float& t, glm::vec3& normal)
+	glm::vec3 SpectralRenderer::PathTracePixel(uint32_t x, uint32_t y, uint32_t& seed) const
 	{
-		const float EPSILON = 0.0000001f;
-		glm::vec3 edge1 = v1 - v0;
-		glm::vec3 edge2 = v2 - v0;
-		glm::vec3 h = glm::cross(ray.Direction, edge2);
-		float a = glm::dot(edge1, h);
+		// 像素内随机抖动 (与 GPU 相同)
+		float jitterX = RandomFloat(seed) - 0.5f;
+		float jitterY = RandomFloat(seed) - 0.5f;
+		Ray ray = GenerateRay((float)x + 0.5f + jitterX, (float)y + 0.5f + jitterY);
+
+		glm::vec3 throughput(1.0f);
+		glm::vec3 radiance(0.0f);
+
+		for (int bounce = 0; bounce < m_Settings.MaxBounces; bounce++)
+		{
+			HitPayload payload = TraceRay(ray);
 
-		if (a > -EPSILON && a < EPSILON) return false; // 光线平行于三角形
+			if (payload.HitDistance < 0.0f)
+			{
+				// 简单的天空光 (RGB)
+				float t = 0.5f * (ray.Direction.y + 1.0f);
+				glm::vec3 skyColor = glm::mix(glm::vec3(0.5f, 0.7f, 1.0f), glm::vec3(1.0f), t);
+				radiance += skyColor * throughput;
+				break;
+			}
 
-		float f = 1.0f / a;
-		glm::vec3 s = ray.Origin - v0;
-		float u = f * glm::dot(s, h);
-		if (u < 0.0f || u > 1.0f) return false;
+			bool frontFace = glm::dot(ray.Direction, payload.WorldNormal) < 0.0f;
+			glm::vec3 normal = frontFace ? payload.WorldNormal : -payload.WorldNormal;
+			glm::vec3 hitPos = payload.WorldPosition;
 
-		glm::vec3 q = glm::cross(s, edge1);
-		float v = f * glm::dot(ray.Direction, q);
-		if (v < 0.0f || u + v > 1.0f) return false;
+			// --- RGB 材质逻辑 (与 Raytrace.glsl 一致) ---
+			glm::vec3 albedo = payload.Albedo;
+			float roughness = payload.Roughness;
+			float metallic = payload.Metallic;
+			if (payload.MaterialType == 1) metallic = 1.0f;      // Conductor
+			else if (payload.MaterialType == 2) metallic = 0.0f; // Dielectric
 
-		float currentT = f * glm::dot(edge2, q);
-		if (currentT > EPSILON) // 只有 t > 0 才算击中（前方）
-		{
-			t = currentT;
-			// 简单的面法线 (Flat Shading)
-			// 如果要光滑着色，需要用 u,v 插值顶点法线
-			normal = glm::normalize(glm::cross(edge1, edge2));
-			return true;
+			if (payload.MaterialType == 2)
+			{
+				// 玻璃: 按 Fresnel 在反射和折射之间随机选择
+				float ior = 1.5f;
+				float cosTheta = glm::dot(-ray.Direction, normal);
+				float fresnel = FresnelSchlick(std::abs(cosTheta), 0.04f);
+
+				glm::vec3 refractDir = glm::refract(ray.Direction, normal, frontFace ? (1.0f / ior) : ior);
+				if (RandomFloat(seed) < fresnel || glm::length(refractDir) == 0.0f)
+				{
+					ray.Origin = hitPos + normal * s_RayOffset;
+					ray.Direction = glm::reflect(ray.Direction, normal);
+				}
+				else
+				{
+					ray.Origin = hitPos - normal * s_RayOffset;
+					ray.Direction = glm::normalize(refractDir);
+					throughput *= albedo; // 玻璃体色
+				}
+			}
+			else if (RandomFloat(seed) < metallic)
+			{
+				// 金属反射
+				ray.Origin = hitPos + normal * s_RayOffset;
+				glm::vec3 reflected = glm::reflect(ray.Direction, normal);
+				if (roughness > 0.0f) reflected = glm::normalize(reflected + SampleCosineHemisphere(normal, seed) * roughness);
+				ray.Direction = reflected;
+				throughput *= albedo; // 金属带颜色
+			}
+			else
+			{
+				// 漫反射
+				ray.Origin = hitPos + normal * s_RayOffset;
+				ray.Direction = SampleCosineHemisphere(normal, seed);
+				throughput *= albedo;
+			}
+
+			// 俄罗斯轮盘赌
+			float p = std::max(throughput.r, std::max(throughput.g, throughput.b));
+			if (bounce > 3)
+			{
+				if (RandomFloat(seed) > p) break;
+				throughput /= p;
+			}
 		}
-		return false;
+
+		return radiance;
 	}
 
-	SpectralRenderer::HitPayload SpectralRenderer::TraceRay(const Ray& ray, Scene& scene)
+	bool SpectralRenderer::UpdateSceneCache(Scene& scene)
 	{
-		HitPayload payload;
-		payload.HitDistance = std::numeric_limits<float>::max(); // 初始化为无穷远
-
-		// 1. 获取场景中所有带 MeshComponent 的物体
+		// 1. 收集当前帧的实例状态
+		std::vector<InstanceEntry> instances;
 		auto view = scene.getAllEntitiesWith<TransformComponent, MeshComponent>();
-
-		// 2. 遍历所有物体 (Brute Force，以后用 BVH 加速)
 		for (auto entityHandle : view)
 		{
 			auto [tc, mesh] = view.get<TransformComponent, MeshComponent>(entityHandle);
 
 			// 跳过没有顶点数据的
-			if (mesh.LocalVertices.empty()) continue;
-
-			// 获取模型矩阵 (Model Matrix)
-			glm::mat4 transform = tc.GetTransform();
+			if (mesh.LocalVertices.empty() || mesh.LocalIndices.empty()) continue;
 
-			// 提取法线矩阵 (用于变换法线，防止非均匀缩放导致法线错误)
-			glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+			InstanceEntry entry;
+			entry.Entity = entityHandle;
+			entry.GeometryRevision = mesh.GeometryRevision;
+			entry.IndexCount = mesh.LocalIndices.size();
+			entry.Transform = tc.GetTransform();
 
-			// 3. 遍历物体 meshes 里的所有三角形
-			// LocalVertices 是 CubeVertex 结构体
-			size_t numIndices = mesh.LocalIndices.size();
-			for (size_t i = 0; i < numIndices; i += 3)
+			Entity entity = { entityHandle, &scene };
+			if (entity.HasComponent<MaterialComponent>())
 			{
-				// 1. 从索引数组拿顶点下标
-				uint32_t idx0 = mesh.LocalIndices[i];
-				uint32_t idx1 = mesh.LocalIndices[i + 1];
-				uint32_t idx2 = mesh.LocalIndices[i + 2];
+				const auto& material = entity.GetComponent<MaterialComponent>();
+				entry.Albedo = material.Albedo;
+				entry.Roughness = material.Roughness;
+				entry.Metallic = material.Metallic;
+			}
+			// 否则保持默认材质 (灰色塑料)
+
+			if (entity.HasComponent<SpectralMaterialComponent>())
+				entry.MaterialType = (int)entity.GetComponent<SpectralMaterialComponent>().Type;
+
+			instances.push_back(entry);
+		}
+
+		// 2. 脏检查：实体集合、网格和变换都没变时沿用上一帧的三角形和 BVH
+		//    只改了材质不用重建 BVH，但之前累积的样本已经失效，同样要返回 true 让调用方重置累积
+		bool dirty = instances.size() != m_Instances.size();
+		bool materialChanged = false;
+		for (size_t i = 0; !dirty && i < instances.size(); i++)
+		{
+			const InstanceEntry& a = instances[i];
+			const InstanceEntry& b = m_Instances[i];
+			dirty = a.Entity != b.Entity || a.GeometryRevision != b.GeometryRevision || a.Transform != b.Transform;
+			materialChanged = materialChanged || a.Albedo != b.Albedo || a.Roughness != b.Roughness
+				|| a.Metallic != b.Metallic || a.MaterialType != b.MaterialType;
+		}
 
-				// 2. 用下标去顶点数组拿数据
-				glm::vec3 localV0 = mesh.LocalVertices[idx0].Position;
-				glm::vec3 localV1 = mesh.LocalVertices[idx1].Position;
-				glm::vec3 localV2 = mesh.LocalVertices[idx2].Position;
+		m_Instances = std::move(instances);
+		if (!dirty) return materialChanged;
 
-				// 3. 变换到世界坐标
-				glm::vec3 worldV0 = glm::vec3(transform * glm::vec4(localV0, 1.0f));
-				glm::vec3 worldV1 = glm::vec3(transform * glm::vec4(localV1, 1.0f));
-				glm::vec3 worldV2 = glm::vec3(transform * glm::vec4(localV2, 1.0f));
+		auto startTime = std::chrono::high_resolution_clock::now();
 
-				float t = 0.0f;
-				glm::vec3 n;
+		// 3. 每个实例先把顶点变换一次，再按索引并行拼出世界空间三角形
+		size_t triangleCount = 0;
+		for (const auto& entry : m_Instances)
+			triangleCount += entry.IndexCount / 3;
 
-				if (RayTriangleIntersect(ray, worldV0, worldV1, worldV2, t, n))
+		m_Triangles.resize(triangleCount);
+		m_TriangleInstance.resize(triangleCount);
+
+		std::vector<glm::vec3> worldPositions;
+		uint32_t triangleOffset = 0;
+		for (uint32_t instanceIndex = 0; instanceIndex < (uint32_t)m_Instances.size(); instanceIndex++)
+		{
+			const InstanceEntry& entry = m_Instances[instanceIndex];
+			const auto& mesh = scene.getRegistry().get<MeshComponent>(entry.Entity);
+
+			worldPositions.resize(mesh.LocalVertices.size());
+			for (size_t v = 0; v < mesh.LocalVertices.size(); v++)
+				worldPositions[v] = glm::vec3(entry.Transform * glm::vec4(mesh.LocalVertices[v].Position, 1.0f));
+
+			uint32_t count = (uint32_t)(entry.IndexCount / 3);
+			std::vector<uint32_t> triIter(count);
+			std::iota(triIter.begin(), triIter.end(), 0);
+			std::for_each(std::execution::par, triIter.begin(), triIter.end(),
+				[&, triangleOffset, instanceIndex](uint32_t t)
 				{
-					if (t < payload.HitDistance)
-					{
-						payload.HitDistance = t;
-						payload.EntityID = (int)(uint32_t)entityHandle;
-						payload.WorldPosition = ray.Origin + ray.Direction * t;
-						payload.WorldNormal = n;
-					}
-
-					Entity entity = { entityHandle, &scene };
-					if (entity.HasComponent<MaterialComponent>())
-					{
-						const auto& material = entity.GetComponent<MaterialComponent>();
-						payload.Albedo = material.Albedo;
-						payload.Roughness = material.Roughness;
-						payload.Metallic = material.Metallic;
-					}
-					else
-					{
-						// 默认材质 (灰色塑料)
-						payload.Albedo = { 0.8f, 0.8f, 0.8f };
-						payload.Roughness = 0.5f;
-						payload.Metallic = 0.0f;
-					}
-				}
-			}
+					BVHTriangle& tri = m_Triangles[triangleOffset + t];
+					tri.V0 = worldPositions[mesh.LocalIndices[t * 3]];
+					tri.V1 = worldPositions[mesh.LocalIndices[t * 3 + 1]];
+					tri.V2 = worldPositions[mesh.LocalIndices[t * 3 + 2]];
+					tri.Centroid = (tri.V0 + tri.V1 + tri.V2) / 3.0f;
+					tri.Index = triangleOffset + t;
+					m_TriangleInstance[triangleOffset + t] = instanceIndex;
+				});
+
+			triangleOffset += count;
 		}
 
-		// 如果没打中任何东西，距离重置为 -1
-		if (payload.HitDistance == std::numeric_limits<float>::max())
-			payload.HitDistance = -1.0f;
+		// 4. 构建 BVH4 (二叉 SAH 树折叠而成)
+		m_BVH = BVH4(m_Triangles);
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		float ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+		RONG_CORE_INFO("SpectralRenderer Scene Cache Rebuilt: {0} Instances, {1} Triangles in {2}ms", m_Instances.size(), m_Triangles.size(), ms);
+		return true;
+	}
+
+	SpectralRenderer::HitPayload SpectralRenderer::TraceRay(const Ray& ray) const
+	{
+		HitPayload payload;
+
+		// 1. BVH4 求交 (替代原来遍历所有物体所有三角形的暴力求交)
+		BVH4::Hit hit;
+		if (!m_BVH.Intersect(ray.Origin, ray.Direction, hit))
+			return payload; // HitDistance = -1 表示没打中
+
+		const BVHTriangle& tri = m_Triangles[hit.Triangle];
+		const InstanceEntry& instance = m_Instances[m_TriangleInstance[hit.Triangle]];
+
+		payload.HitDistance = hit.T;
+		payload.EntityID = (int)(uint32_t)instance.Entity;
+		payload.WorldPosition = ray.Origin + ray.Direction * hit.T;
+
+		// 简单的面法线 (Flat Shading)
+		// 如果要光滑着色，需要用 u,v 插值顶点法线
+		payload.WorldNormal = glm::normalize(glm::cross(tri.V1 - tri.V0, tri.V2 - tri.V0));
+
+		// 2. 材质已在 UpdateSceneCache 中缓存，不再访问 Registry
+		payload.Albedo = instance.Albedo;
+		payload.Roughness = instance.Roughness;
+		payload.Metallic = instance.Metallic;
+		payload.MaterialType = instance.MaterialType;
 
 		return payload;
 	}
 
+	bool SpectralRenderer::RenderToFile(Scene& scene, const PerspectiveCamera& camera, uint32_t width, uint32_t height,
+		uint32_t sampleCount, const std::string& filepath)
+	{
+		if (width == 0 || height == 0 || sampleCount == 0) return false;
+
+		RenderMode previousMode = m_Mode;
+		m_Mode = RenderMode::PathTrace;
+		OnResize(width, height);
+		ResetAccumulation();
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for (uint32_t i = 0; i < sampleCount; i++)
+			RenderFrame(scene, camera);
+		auto endTime = std::chrono::high_resolution_clock::now();
+		float ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+
+		float maxError = 0.0f;
+		for (const auto& stats : m_TileStats)
+			maxError = std::max(maxError, stats.RelativeError);
+
+		RONG_CORE_INFO("SpectralRenderer Reference: {0}x{1}, {2} Samples in {3}ms, {4}/{5} Tiles Converged, Max Tile Error {6:.4f}",
+			width, height, m_FrameIndex, ms, GetConvergedTileCount(), m_TileStats.size(), maxError);
+
+		bool ok = WriteImage(filepath);
+		m_Mode = previousMode;
+		return ok;
+	}
+
+	bool SpectralRenderer::RenderSceneFile(const std::string& scenePath, const std::string& imagePath,
+		uint32_t width, uint32_t height, uint32_t sampleCount)
+	{
+		Ref<Scene> scene = CreateRef<Scene>();
+		SceneSerializer serializer(scene);
+		serializer.SetCreateGPUResources(false); // CPU 渲染只用 LocalVertices/LocalIndices，不创建 VertexArray
+		if (!serializer.Deserialize(scenePath))
+		{
+			RONG_CORE_ERROR("SpectralRenderer: Failed to load scene: {0}", scenePath);
+			return false;
+		}
+
+		// 相机从斜上方对准场景包围盒
+		AABB bounds;
+		auto view = scene->getAllEntitiesWith<TransformComponent, MeshComponent>();
+		for (auto entityHandle : view)
+		{
+			auto [tc, mesh] = view.get<TransformComponent, MeshComponent>(entityHandle);
+			glm::mat4 transform = tc.GetTransform();
+			for (const auto& v : mesh.LocalVertices)
+				bounds.Grow(glm::vec3(transform * glm::vec4(v.Position, 1.0f)));
+		}
+		if (bounds.Min.x > bounds.Max.x)
+		{
+			RONG_CORE_WARN("SpectralRenderer: Scene has no geometry: {0}", scenePath);
+			bounds.Grow(glm::vec3(-1.0f));
+			bounds.Grow(glm::vec3(1.0f));
+		}
+
+		float fov = 45.0f;
+		float radius = glm::length(bounds.GetSize()) * 0.5f;
+		float distance = radius / std::tan(glm::radians(fov) * 0.5f) + radius;
+
+		PerspectiveCamera camera(fov, (float)width / (float)height, 0.01f, distance * 4.0f);
+		camera.setRotation(0.5f, -0.6f);
+		camera.setPosition(bounds.GetCenter() - camera.getForwardDirection() * distance);
+
+		SpectralRenderer renderer;
+		return renderer.RenderToFile(*scene, camera, width, height, sampleCount, imagePath);
+	}
+
+	bool SpectralRenderer::WriteImage(const std::string& filepath) const
+	{
+		std::ofstream out(filepath, std::ios::binary);
+		if (!out)
+		{
+			RONG_CORE_ERROR("SpectralRenderer: Cannot open {0} for writing", filepath);
+			return false;
+		}
+
+		bool pfm = filepath.size() >= 4 && filepath.compare(filepath.size() - 4, 4, ".pfm") == 0;
+		if (pfm)
+		{
+			// PFM: 线性浮点 RGB，小端 (比例因子为负)，行顺序从下到上 (与 m_ImageData 相同)
+			out << "PF\n" << m_Width << " " << m_Height << "\n-1.0\n";
+			std::vector<float> row(m_Width * 3);
+			for (uint32_t y = 0; y < m_Height; y++)
+			{
+				for (uint32_t x = 0; x < m_Width; x++)
+				{
+					uint32_t tile = (y / TileSize) * ((m_Width + TileSize - 1) / TileSize) + x / TileSize;
+					float n = (float)std::max(m_TileStats[tile].SampleCount, 1u);
+					const glm::vec4& accum = m_AccumulationData[x + y * m_Width];
+					row[x * 3 + 0] = accum.r / n;
+					row[x * 3 + 1] = accum.g / n;
+					row[x * 3 + 2] = accum.b / n;
+				}
+				out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(float));
+			}
+		}
+		else
+		{
+			// PPM (P6): 色调映射后的 8 位 RGB，行顺序从上到下
+			out << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+			std::vector<uint8_t> row(m_Width * 3);
+			for (uint32_t y = m_Height; y-- > 0;)
+			{
+				for (uint32_t x = 0; x < m_Width; x++)
+				{
+					uint32_t rgba = m_ImageData[x + y * m_Width];
+					row[x * 3 + 0] = (uint8_t)(rgba & 0xFF);
+					row[x * 3 + 1] = (uint8_t)((rgba >> 8) & 0xFF);
+					row[x * 3 + 2] = (uint8_t)((rgba >> 16) & 0xFF);
+				}
+				out.write(reinterpret_cast<const char*>(row.data()), row.size());
+			}
+		}
+
+		RONG_CORE_INFO("SpectralRenderer: Image written to {0}", filepath);
+		return (bool)out;
+	}
+
 }
\ No newline at end of file
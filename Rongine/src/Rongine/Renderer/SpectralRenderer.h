@@ -2,25 +2,74 @@
 
 #include <glm/glm.hpp>
 #include <memory>
+#include <string>
 #include <vector>
 #include "Rongine/Scene/Scene.h"
 #include "Rongine/Renderer/PerspectiveCamera.h"
 #include "Rongine/Renderer/Texture.h"
 #include "Rongine/Scene/Components.h"
+#include "Rongine/Renderer/WideBVH.h"
 
 namespace Rongine {
 
 	class SpectralRenderer
 	{
+	public:
+		enum class RenderMode
+		{
+			Preview = 0,  // 每像素一次直接光照，每帧重画 (交互预览)
+			PathTrace = 1 // 渐进式路径追踪，与 Raytrace.glsl 相同的材质模型，结果累加到浮点 Buffer
+		};
+
+		struct PathTraceSettings
+		{
+			int MaxBounces = 8;                // 与 Raytrace.glsl 的 MAX_BOUNCES 一致
+			float ConvergenceThreshold = 0.0f; // Tile 相对误差低于该值后停止采样，0 表示不停止 (参考图需要固定采样数)
+			uint32_t MinTileSamples = 16;      // 判定收敛前至少需要的采样数
+		};
+
+		// 每个 Tile 的收敛统计 (同一 Tile 内所有像素的采样数相同)
+		struct TileStats
+		{
+			uint32_t SampleCount = 0;
+			float MeanLuminance = 0.0f;
+			float RelativeError = 1.0f; // 像素亮度均值的标准误差之和 / 亮度之和
+			bool Converged = false;
+		};
+
 	public:
 		SpectralRenderer();
 		~SpectralRenderer() = default;
 
 		void OnResize(uint32_t width, uint32_t height);
 
+		// 渲染一帧并上传到 m_FinalTexture
 		void Render(Scene& scene, const PerspectiveCamera& camera);
 
-		uint32_t GetFinalTextureID() const { return m_FinalTexture->getRendererID(); }
+		// 只在 CPU 上渲染一帧，不访问任何 GL 资源 (Headless 模式使用)
+		void RenderFrame(Scene& scene, const PerspectiveCamera& camera);
+
+		// Headless 参考渲染：路径追踪 sampleCount 帧后写入图片
+		// .pfm 输出未经色调映射的线性 RGB 均值 (用于和 GPU 结果做数值对比)，其它扩展名输出 8 位 PPM
+		bool RenderToFile(Scene& scene, const PerspectiveCamera& camera, uint32_t width, uint32_t height,
+			uint32_t sampleCount, const std::string& filepath);
+
+		// 读取 .rong 场景，相机自动对准场景包围盒，渲染后写入 imagePath
+		static bool RenderSceneFile(const std::string& scenePath, const std::string& imagePath,
+			uint32_t width, uint32_t height, uint32_t sampleCount);
+
+		void SetRenderMode(RenderMode mode) { if (m_Mode != mode) { m_Mode = mode; ResetAccumulation(); } }
+		RenderMode GetRenderMode() const { return m_Mode; }
+
+		void SetPathTraceSettings(const PathTraceSettings& settings) { m_Settings = settings; ResetAccumulation(); }
+		const PathTraceSettings& GetPathTraceSettings() const { return m_Settings; }
+
+		void ResetAccumulation();
+		uint32_t GetFrameIndex() const { return m_FrameIndex; }
+		const std::vector<TileStats>& GetTileStats() const { return m_TileStats; }
+		uint32_t GetConvergedTileCount() const;
+
+		uint32_t GetFinalTextureID() const { return m_FinalTexture ? m_FinalTexture->getRendererID() : 0; }
 
 	private:
 		// 一个简单的光线结构体
@@ -39,23 +88,70 @@ namespace Rongine {
 			glm::vec3 Albedo = { 0.8f, 0.8f, 0.8f };
 			float Roughness = 0.5f;
 			float Metallic = 0.0f;
+			int MaterialType = 0; // 0=Diffuse, 1=Conductor, 2=Dielectric (SpectralMaterialComponent::MaterialType)
 		};
 
+		// 缓存的实体状态，用于每帧的脏检查
+		struct InstanceEntry
+		{
+			entt::entity Entity = entt::null;
+			uint64_t GeometryRevision = 0; // MeshComponent::GeometryRevision，网格替换后会变化
+			size_t IndexCount = 0;
+			glm::mat4 Transform = glm::mat4(1.0f);
+
+			// 材质每帧刷新，变化时只重置累积，不重建 BVH
+			glm::vec3 Albedo = { 0.8f, 0.8f, 0.8f };
+			float Roughness = 0.5f;
+			float Metallic = 0.0f;
+			int MaterialType = 0;
+		};
+
+		Ray GenerateRay(float x, float y) const;
+
 		//渲染每一个像素
-		glm::vec4 PerPixel(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const PerspectiveCamera& camera, Scene& scene);
+		glm::vec4 PerPixel(uint32_t x, uint32_t y);
 
-		HitPayload TraceRay(const Ray& ray, Scene& scene);
+		// 路径追踪一条相机射线，返回辐射度 (线性 RGB)
+		glm::vec3 PathTracePixel(uint32_t x, uint32_t y, uint32_t& seed) const;
 
-		//光线-三角形求交辅助函数
-		bool RayTriangleIntersect(const Ray& ray,
-			const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
-			float& t, glm::vec3& normal);
+		HitPayload TraceRay(const Ray& ray) const;
+
+		void RenderTile(uint32_t tile, uint32_t tilesX);
+		void UpdateTileStats(uint32_t tile, uint32_t tilesX);
+
+		bool WriteImage(const std::string& filepath) const;
+
+		// 脏检查：实体、网格或变换有变化时才重新收集世界空间三角形并构建 BVH4，否则只刷新材质
+		// 返回几何或材质是否发生变化 (需要重置累积)
+		bool UpdateSceneCache(Scene& scene);
 
 	private:
 		Ref<Texture2D> m_FinalTexture;
 		std::vector<uint32_t> m_ImageData; // CPU 端的像素 Buffer (RGBA8)
 
 		uint32_t m_Width = 0, m_Height = 0;
+
+		// 按 Tile 并行渲染，每个任务处理一块 TileSize x TileSize 的像素
+		static constexpr uint32_t TileSize = 16;
+
+		RenderMode m_Mode = RenderMode::Preview;
+		PathTraceSettings m_Settings;
+
+		// 渐进累加 (与 GPU 端 AccumulationTexture 对应): rgb = 辐射度之和, a = 亮度平方之和 (用于估计方差)
+		std::vector<glm::vec4> m_AccumulationData;
+		std::vector<TileStats> m_TileStats;
+		uint32_t m_FrameIndex = 0;
+
+		// 每帧缓存的相机参数 (避免每个像素求逆矩阵)
+		glm::mat4 m_InverseProjection = glm::mat4(1.0f);
+		glm::mat4 m_InverseView = glm::mat4(1.0f);
+		glm::mat4 m_LastViewProjection = glm::mat4(0.0f);
+		glm::vec3 m_CameraPosition = glm::vec3(0.0f);
+
+		std::vector<InstanceEntry> m_Instances;
+		std::vector<BVHTriangle> m_Triangles;       // 预先变换好的世界空间三角形 (Index 即数组下标)
+		std::vector<uint32_t> m_TriangleInstance;   // 三角形所属实例 (m_Instances 下标)
+		BVH4 m_BVH;
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,368 @@
+#include "Rongpch.h"
+#include "TwoLevelBVH.h"
+#include "BVH.h"
+#include "LBVH.h"
+#include "Rongine/Core/Log.h"
+#include "Rongine/Math/Math.h"
+#include "Rongine/Scene/Scene.h"
+#include "Rongine/Scene/Components.h"
+
+#include <numeric>
+#include <random>
+
+namespace Rongine {
+
+    static bool IntersectAABB(const glm::vec3& orig, const glm::vec3& invDir, const GPUBVHNode& node, float closestT)
+    {
+        return Math::RayAABBIntersection(orig, invDir,
+            glm::vec3(node.MinX, node.MinY, node.MinZ), glm::vec3(node.MaxX, node.MaxY, node.MaxZ), closestT);
+    }
+
+    static AABB TransformBounds(const AABB& box, const glm::mat4& transform)
+    {
+        AABB result;
+        for (int i = 0; i < 8; i++)
+        {
+            glm::vec3 corner(
+                (i & 1) ? box.Max.x : box.Min.x,
+                (i & 2) ? box.Max.y : box.Min.y,
+                (i & 4) ? box.Max.z : box.Min.z);
+            result.Grow(glm::vec3(transform * glm::vec4(corner, 1.0f)));
+        }
+        return result;
+    }
+
+    static void SetNodeBounds(GPUBVHNode& node, const AABB& box)
+    {
+        node.MinX = box.Min.x; node.MinY = box.Min.y; node.MinZ = box.Min.z;
+        node.MaxX = box.Max.x; node.MaxY = box.Max.y; node.MaxZ = box.Max.z;
+    }
+
+    TwoLevelBVH::BuildStats TwoLevelBVH::Build(Scene* scene, BVHBuildQuality quality, bool parallel)
+    {
+        BuildStats stats;
+
+        for (auto& [key, entry] : m_BLASCache)
+            entry.Visited = false;
+
+        std::vector<uint32_t> entities;
+        std::vector<glm::mat4> transforms;
+
+        // 1. 收集实例，网格变化的实体重建 BLAS
+        auto view = scene->getAllEntitiesWith<TransformComponent, MeshComponent>();
+        for (auto entity : view)
+        {
+            auto [tc, mesh] = view.get<TransformComponent, MeshComponent>(entity);
+
+            // 跳过空 Mesh (与 UploadSceneDataToGPU 保持一致)
+            if (mesh.LocalVertices.empty() || mesh.LocalIndices.empty())
+                continue;
+
+            uint32_t key = (uint32_t)entity;
+            BLASEntry& entry = m_BLASCache[key];
+            entry.Visited = true;
+
+            if (entry.Nodes.empty() || entry.GeometryRevision != mesh.GeometryRevision || entry.Quality != quality)
+            {
+                entry.GeometryRevision = mesh.GeometryRevision;
+                entry.Quality = quality;
+                BuildBLAS(entry, mesh.LocalVertices, mesh.LocalIndices, quality, parallel);
+                stats.BLASRebuilt++;
+            }
+
+            entities.push_back(key);
+            transforms.push_back(tc.GetTransform());
+        }
+
+        // 2. 清理已经删除的实体
+        for (auto it = m_BLASCache.begin(); it != m_BLASCache.end();)
+        {
+            if (!it->second.Visited) it = m_BLASCache.erase(it);
+            else ++it;
+        }
+
+        // 3. 只有 BLAS 重建或实例增删/换序时才重新拼接
+        stats.BLASLayoutChanged = stats.BLASRebuilt > 0 || entities != m_InstanceEntities;
+        if (stats.BLASLayoutChanged)
+        {
+            m_InstanceEntities = std::move(entities);
+            FlattenBLAS();
+        }
+
+        // 4. 更新实例变换并重建 TLAS
+        m_InstanceBounds.resize(m_Instances.size());
+        for (size_t i = 0; i < m_Instances.size(); i++)
+        {
+            m_Instances[i].InverseTransform = glm::inverse(transforms[i]);
+            m_InstanceBounds[i] = TransformBounds(m_BLASCache[m_InstanceEntities[i]].LocalBounds, transforms[i]);
+        }
+        BuildTLAS();
+
+        stats.InstanceCount = (uint32_t)m_Instances.size();
+        return stats;
+    }
+
+    void TwoLevelBVH::Clear()
+    {
+        m_BLASCache.clear();
+        m_InstanceEntities.clear();
+        m_InstanceBounds.clear();
+        m_TLASNodes.clear();
+        m_Instances.clear();
+        m_BLASNodes.clear();
+        m_BLASIndices.clear();
+        m_LocalPositions.clear();
+    }
+
+    void TwoLevelBVH::BuildBLAS(BLASEntry& entry, ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices,
+        BVHBuildQuality quality, bool parallel)
+    {
+        // 局部空间三角形，Index 为网格内的三角形序号
+        std::vector<BVHTriangle> localTriangles;
+        localTriangles.reserve(indices.size() / 3);
+        entry.Positions.clear();
+        entry.Positions.reserve(indices.size());
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            BVHTriangle tri;
+            tri.V0 = vertices[indices[i]].Position;
+            tri.V1 = vertices[indices[i + 1]].Position;
+            tri.V2 = vertices[indices[i + 2]].Position;
+            tri.Centroid = (tri.V0 + tri.V1 + tri.V2) / 3.0f;
+            tri.Index = (uint32_t)localTriangles.size();
+            localTriangles.push_back(tri);
+
+            entry.Positions.push_back(tri.V0);
+            entry.Positions.push_back(tri.V1);
+            entry.Positions.push_back(tri.V2);
+        }
+
+        if (quality == BVHBuildQuality::LBVH)
+        {
+            LBVHBuilder builder(localTriangles);
+            entry.Nodes = builder.GetNodes();
+            entry.Indices = builder.GetSortedIndices();
+        }
+        else
+        {
+            BVHBuilder builder(localTriangles, quality, parallel);
+            entry.Nodes = builder.GetNodes();
+            entry.Indices = builder.GetSortedIndices();
+        }
+
+        const GPUBVHNode& root = entry.Nodes[0];
+        entry.LocalBounds = AABB({ root.MinX, root.MinY, root.MinZ }, { root.MaxX, root.MaxY, root.MaxZ });
+    }
+
+    void TwoLevelBVH::FlattenBLAS()
+    {
+        m_BLASNodes.clear();
+        m_BLASIndices.clear();
+        m_LocalPositions.clear();
+        m_Instances.assign(m_InstanceEntities.size(), GPUInstance());
+
+        uint32_t triangleOffset = 0;
+        for (size_t i = 0; i < m_InstanceEntities.size(); i++)
+        {
+            const BLASEntry& entry = m_BLASCache[m_InstanceEntities[i]];
+            uint32_t nodeOffset = (uint32_t)m_BLASNodes.size();
+            uint32_t indexOffset = (uint32_t)m_BLASIndices.size();
+
+            // 局部索引 -> 拼接后的绝对索引
+            for (GPUBVHNode node : entry.Nodes)
+            {
+                if (node.IsLeaf())
+                    node.SetLeaf(node.GetFirstPrim() + indexOffset, node.GetPrimCount());
+                else
+                    node.SetChildren(node.GetLeftChild() + nodeOffset, node.GetRightChild() + nodeOffset);
+                m_BLASNodes.push_back(node);
+            }
+
+            // 局部三角形 ID -> 全局三角形 ID
+            for (uint32_t localIndex : entry.Indices)
+                m_BLASIndices.push_back(localIndex + triangleOffset);
+
+            m_LocalPositions.insert(m_LocalPositions.end(), entry.Positions.begin(), entry.Positions.end());
+
+            GPUInstance& instance = m_Instances[i];
+            instance.BLASRootIndex = nodeOffset;
+            instance.TriangleOffset = triangleOffset;
+            instance.TriangleCount = (uint32_t)(entry.Positions.size() / 3);
+            instance._pad = 0;
+
+            triangleOffset += instance.TriangleCount;
+        }
+    }
+
+    void TwoLevelBVH::BuildTLAS()
+    {
+        m_TLASNodes.clear();
+        if (m_Instances.empty()) return;
+
+        m_TLASNodes.reserve(m_Instances.size() * 2);
+        m_TLASNodes.push_back(GPUBVHNode());
+
+        std::vector<uint32_t> order(m_Instances.size());
+        std::iota(order.begin(), order.end(), 0u);
+        SplitTLASNode(0, order, 0, (int)order.size());
+    }
+
+    void TwoLevelBVH::SplitTLASNode(int nodeIndex, std::vector<uint32_t>& order, int start, int end)
+    {
+        int count = end - start;
+
+        AABB bounds, centroidBounds;
+        for (int i = start; i < end; i++)
+        {
+            const AABB& box = m_InstanceBounds[order[i]];
+            bounds.Grow(box);
+            centroidBounds.Grow(box.GetCenter());
+        }
+        SetNodeBounds(m_TLASNodes[nodeIndex], bounds);
+
+        // 叶子只放一个实例，叶子编码与 BVH 相同：LeftFirst 为实例下标，数量 1
+        if (count == 1)
+        {
+            m_TLASNodes[nodeIndex].SetLeaf(order[start], 1);
+            return;
+        }
+
+        // 按质心最长轴的中位数切分 (实例数量少，不需要 SAH)
+        glm::vec3 extent = centroidBounds.GetSize();
+        int axis = 0;
+        if (extent.y > extent.x) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+
+        int mid = start + count / 2;
+        std::nth_element(order.begin() + start, order.begin() + mid, order.begin() + end,
+            [&](uint32_t a, uint32_t b) {
+                return m_InstanceBounds[a].GetCenter()[axis] < m_InstanceBounds[b].GetCenter()[axis];
+            });
+
+        int leftChildIdx = (int)m_TLASNodes.size();
+        m_TLASNodes.push_back(GPUBVHNode());
+        m_TLASNodes.push_back(GPUBVHNode());
+        m_TLASNodes[nodeIndex].SetChildren((uint32_t)leftChildIdx, (uint32_t)(leftChildIdx + 1));
+
+        SplitTLASNode(leftChildIdx, order, start, mid);
+        SplitTLASNode(leftChildIdx + 1, order, mid, end);
+    }
+
+    bool TwoLevelBVH::Intersect(const glm::vec3& origin, const glm::vec3& dir, float& outT, uint32_t& outTriangle) const
+    {
+        outT = 1e30f;
+        bool hit = false;
+        if (m_TLASNodes.empty()) return false;
+
+        glm::vec3 invDir = 1.0f / dir;
+
+        std::vector<int> stack;
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            const GPUBVHNode& node = m_TLASNodes[stack.back()];
+            stack.pop_back();
+
+            if (!IntersectAABB(origin, invDir, node, outT)) continue;
+
+            if (!node.IsLeaf())
+            {
+                stack.push_back((int)node.GetLeftChild());
+                stack.push_back((int)node.GetRightChild());
+                continue;
+            }
+
+            // TLAS 叶子：把光线变换到实例的局部空间
+            // 方向不归一化，这样局部空间的 t 与世界空间的 t 完全相同
+            const GPUInstance& instance = m_Instances[node.GetFirstPrim()];
+            glm::vec3 localOrigin = glm::vec3(instance.InverseTransform * glm::vec4(origin, 1.0f));
+            glm::vec3 localDir = glm::vec3(instance.InverseTransform * glm::vec4(dir, 0.0f));
+            glm::vec3 localInvDir = 1.0f / localDir;
+
+            std::vector<int> blasStack;
+            blasStack.push_back((int)instance.BLASRootIndex);
+            while (!blasStack.empty())
+            {
+                const GPUBVHNode& blasNode = m_BLASNodes[blasStack.back()];
+                blasStack.pop_back();
+
+                if (!IntersectAABB(localOrigin, localInvDir, blasNode, outT)) continue;
+
+                if (!blasNode.IsLeaf())
+                {
+                    blasStack.push_back((int)blasNode.GetLeftChild());
+                    blasStack.push_back((int)blasNode.GetRightChild());
+                    continue;
+                }
+
+                int start = (int)blasNode.GetFirstPrim();
+                int count = (int)blasNode.GetPrimCount();
+                for (int i = 0; i < count; i++)
+                {
+                    uint32_t triIndex = m_BLASIndices[start + i];
+                    const glm::vec3* p = &m_LocalPositions[triIndex * 3];
+                    float t = Math::RayTriangleIntersection(localOrigin, localDir, p[0], p[1], p[2]);
+                    if (t > 0.0f && t < outT)
+                    {
+                        outT = t;
+                        outTriangle = triIndex;
+                        hit = true;
+                    }
+                }
+            }
+        }
+        return hit;
+    }
+
+    uint32_t TwoLevelBVH::Validate(const std::vector<BVHTriangle>& worldTriangles, int rayCount) const
+    {
+        if (worldTriangles.empty()) return 0;
+
+        AABB sceneBounds;
+        for (const auto& tri : worldTriangles)
+        {
+            sceneBounds.Grow(tri.V0);
+            sceneBounds.Grow(tri.V1);
+            sceneBounds.Grow(tri.V2);
+        }
+        glm::vec3 margin = sceneBounds.GetSize() * 0.25f + glm::vec3(0.01f);
+
+        // 固定种子，结果可复现
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        uint32_t mismatches = 0, hits = 0;
+        for (int r = 0; r < rayCount; r++)
+        {
+            glm::vec3 lo = sceneBounds.Min - margin;
+            glm::vec3 size = sceneBounds.GetSize() + margin * 2.0f;
+            glm::vec3 origin = lo + glm::vec3(unit(rng) * size.x, unit(rng) * size.y, unit(rng) * size.z);
+            glm::vec3 dir = glm::normalize(glm::vec3(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f) + glm::vec3(1e-4f));
+
+            // 暴力求交作为参考
+            float refT = 1e30f;
+            bool refHit = false;
+            for (const auto& tri : worldTriangles)
+            {
+                float t = Math::RayTriangleIntersection(origin, dir, tri.V0, tri.V1, tri.V2);
+                if (t > 0.0f && t < refT) { refT = t; refHit = true; }
+            }
+
+            float t;
+            uint32_t triIndex;
+            bool hit = Intersect(origin, dir, t, triIndex);
+
+            if (refHit) hits++;
+            if (hit != refHit || (hit && std::abs(t - refT) > 1e-3f * std::max(1.0f, refT)))
+                mismatches++;
+        }
+
+        if (mismatches == 0)
+            RONG_CORE_INFO("Two-Level BVH Validation: {0} rays ({1} hits) match brute force", rayCount, hits);
+        else
+            RONG_CORE_WARN("Two-Level BVH Validation: {0} / {1} rays differ from brute force", mismatches, rayCount);
+
+        return mismatches;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Rongine/Renderer/AccelerationStructures.h"
+#include "Rongine/Renderer/RenderTypes.h"
+#include "Rongine/Renderer/MeshArray.h"
+
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+namespace Rongine {
+
+    class Scene;
+
+    // 两层加速结构
+    // BLAS：每个 MeshComponent 在局部空间构建一次并缓存，只有网格本身变了才重建
+    // TLAS：建立在实例 (世界包围盒 + 逆变换) 之上，规模很小，每次变换改动都重建
+    // 所有 BLAS 拼接成一个节点数组，子节点/叶子偏移均为绝对索引，叶子中存的是全局三角形 ID
+    // 三角形在局部空间求交 (GPU 上传的也是局部空间顶点)，只改变换时顶点和 BLAS 都不用重新上传
+    class TwoLevelBVH {
+    public:
+        struct BuildStats {
+            uint32_t InstanceCount = 0;
+            uint32_t BLASRebuilt = 0;        // 本次重建的 BLAS 数量 (纯变换改动时为 0)
+            bool BLASLayoutChanged = false;  // 拼接后的 BLAS 数组是否需要重新上传
+        };
+
+        // 遍历顺序与 UploadSceneDataToGPU 一致，保证全局三角形 ID 对得上
+        BuildStats Build(Scene* scene, BVHBuildQuality quality = BVHBuildQuality::SAH, bool parallel = true);
+        void Clear();
+
+        const std::vector<GPUBVHNode>& GetTLASNodes() const { return m_TLASNodes; }
+        const std::vector<GPUInstance>& GetInstances() const { return m_Instances; }
+        const std::vector<GPUBVHNode>& GetBLASNodes() const { return m_BLASNodes; }
+        const std::vector<uint32_t>& GetBLASIndices() const { return m_BLASIndices; }
+
+        // CPU 参考求交 (与 Shader 中 TraverseTwoLevel 的逻辑一致)，返回最近交点和全局三角形 ID
+        bool Intersect(const glm::vec3& origin, const glm::vec3& dir, float& outT, uint32_t& outTriangle) const;
+
+        // 随机射线与暴力求交对比，校验结构正确性 (不需要 GPU)
+        uint32_t Validate(const std::vector<BVHTriangle>& worldTriangles, int rayCount) const;
+
+    private:
+        struct BLASEntry {
+            uint64_t GeometryRevision = 0;   // MeshComponent::GeometryRevision，网格替换时会变
+            BVHBuildQuality Quality = BVHBuildQuality::SAH;
+
+            std::vector<GPUBVHNode> Nodes;   // 局部索引
+            std::vector<uint32_t> Indices;   // 局部三角形 ID
+            std::vector<glm::vec3> Positions; // 局部空间三角形顶点 (每个三角形 3 个)
+            AABB LocalBounds;
+            bool Visited = false;
+        };
+
+        void BuildBLAS(BLASEntry& entry, ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices,
+            BVHBuildQuality quality, bool parallel);
+        void FlattenBLAS();
+        void BuildTLAS();
+        void SplitTLASNode(int nodeIndex, std::vector<uint32_t>& order, int start, int end);
+
+        std::unordered_map<uint32_t, BLASEntry> m_BLASCache; // 以实体句柄为 key
+        std::vector<uint32_t> m_InstanceEntities;            // 实例顺序 (用于检测布局变化)
+        std::vector<AABB> m_InstanceBounds;                  // 实例的世界包围盒
+
+        std::vector<GPUBVHNode> m_TLASNodes;
+        std::vector<GPUInstance> m_Instances;
+        std::vector<GPUBVHNode> m_BLASNodes;
+        std::vector<uint32_t> m_BLASIndices;
+        std::vector<glm::vec3> m_LocalPositions;             // 按全局三角形 ID 排列的局部顶点 (CPU 求交用)
+    };
+
+}
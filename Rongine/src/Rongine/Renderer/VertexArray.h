@@ -1,5 +1,6 @@
 #pragma once
 #include "Buffer.h"
+#include <glm/glm.hpp>
 
 
 
@@ -18,7 +19,19 @@ namespace Rongine {
 		virtual const std::vector<Ref<VertexBuffer>>& getVertexBuffers()const = 0;
 		virtual const Ref<IndexBuffer>& getIndexBuffer() const = 0;
 
+		// 紧凑顶点格式 (CADVertex) 的位置还原参数：position = offset + quantized * scale
+		// 设置后 Renderer3D::drawModel 改用 CADMesh Shader
+		void setPositionDequantization(const glm::vec3& offset, const glm::vec3& scale) { m_dequantOffset = offset; m_dequantScale = scale; m_quantized = true; }
+		bool isPositionQuantized() const { return m_quantized; }
+		const glm::vec3& getDequantizationOffset() const { return m_dequantOffset; }
+		const glm::vec3& getDequantizationScale() const { return m_dequantScale; }
+
 		static Ref<VertexArray> create();
+
+	private:
+		glm::vec3 m_dequantOffset = glm::vec3(0.0f);
+		glm::vec3 m_dequantScale = glm::vec3(1.0f);
+		bool m_quantized = false;
 	};
 }
 
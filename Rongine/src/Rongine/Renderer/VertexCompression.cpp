@@ -0,0 +1,172 @@
+#include "Rongpch.h"
+#include "VertexCompression.h"
+#include "Rongine/Core/Log.h"
+
+#include <cmath>
+
+namespace Rongine {
+
+    static glm::vec2 SignNotZero(const glm::vec2& v)
+    {
+        return { v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f };
+    }
+
+    glm::vec2 OctEncode(const glm::vec3& normal)
+    {
+        float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (l1 < 1e-20f) return { 0.0f, 0.0f }; // 退化法线 -> +Z
+
+        glm::vec2 p = glm::vec2(normal.x, normal.y) / l1;
+        // 下半球折到上半球的四个角
+        if (normal.z < 0.0f)
+            p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * SignNotZero(p);
+        return p;
+    }
+
+    glm::vec3 OctDecode(const glm::vec2& encoded)
+    {
+        glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        if (n.z < 0.0f)
+        {
+            glm::vec2 xy = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * SignNotZero(glm::vec2(n.x, n.y));
+            n.x = xy.x;
+            n.y = xy.y;
+        }
+        return glm::normalize(n);
+    }
+
+    void CompressCADVertices(ArrayView<CubeVertex> vertices, std::vector<CADVertex>& outVertices,
+        glm::vec3& outOffset, glm::vec3& outScale)
+    {
+        AABB bounds;
+        for (const auto& v : vertices)
+            bounds.Grow(v.Position);
+        if (vertices.empty())
+            bounds = AABB(glm::vec3(0.0f), glm::vec3(0.0f));
+
+        // 某个轴上没有跨度 (平面网格) 时 scale 取 0，还原结果正好是 offset
+        outOffset = bounds.Min;
+        outScale = bounds.GetSize() / 65535.0f;
+        QuantizeCADVertices(vertices, outOffset, outScale, outVertices);
+    }
+
+    void QuantizeCADVertices(ArrayView<CubeVertex> vertices, const glm::vec3& offset, const glm::vec3& scale,
+        std::vector<CADVertex>& outVertices)
+    {
+        outVertices.resize(vertices.size());
+
+        glm::vec3 extent = scale * 65535.0f;
+        glm::vec3 invExtent = { extent.x > 0.0f ? 1.0f / extent.x : 0.0f, extent.y > 0.0f ? 1.0f / extent.y : 0.0f, extent.z > 0.0f ? 1.0f / extent.z : 0.0f };
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            const CubeVertex& src = vertices[i];
+            CADVertex& dst = outVertices[i];
+
+            glm::vec3 q = glm::clamp((src.Position - offset) * invExtent, 0.0f, 1.0f) * 65535.0f + 0.5f;
+            dst.Position[0] = (uint16_t)q.x;
+            dst.Position[1] = (uint16_t)q.y;
+            dst.Position[2] = (uint16_t)q.z;
+            dst.Position[3] = 0;
+
+            glm::vec2 oct = glm::clamp(OctEncode(src.Normal), -1.0f, 1.0f) * 32767.0f;
+            dst.Normal[0] = (int16_t)std::lround(oct.x);
+            dst.Normal[1] = (int16_t)std::lround(oct.y);
+
+            dst.FaceID = src.FaceID;
+        }
+    }
+
+    uint32_t WeldVertices(ArrayView<CubeVertex> vertices, std::vector<uint32_t>& outRemap, std::vector<uint32_t>& outUnique,
+        float relativeTolerance, float normalCosTolerance)
+    {
+        outRemap.resize(vertices.size());
+        outUnique.clear();
+        if (vertices.empty()) return 0;
+
+        AABB bounds;
+        for (const auto& v : vertices)
+            bounds.Grow(v.Position);
+        float tolerance = std::max(glm::length(bounds.GetSize()) * relativeTolerance, 1e-12f);
+        float invCell = 1.0f / tolerance;
+
+        // 哈希网格，格子边长 = 容差；查询相邻 27 个格子，容差内的点不会因为落在格子边界两侧而漏掉
+        auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+            return (uint64_t)(x * 73856093) ^ (uint64_t)(y * 19349663) ^ (uint64_t)(z * 83492791);
+        };
+        std::unordered_map<uint64_t, std::vector<uint32_t>> grid;
+        grid.reserve(vertices.size());
+
+        for (uint32_t i = 0; i < (uint32_t)vertices.size(); i++)
+        {
+            const CubeVertex& v = vertices[i];
+            glm::vec3 cellPos = (v.Position - bounds.Min) * invCell;
+            int64_t cx = (int64_t)std::floor(cellPos.x), cy = (int64_t)std::floor(cellPos.y), cz = (int64_t)std::floor(cellPos.z);
+
+            uint32_t match = UINT32_MAX;
+            for (int64_t dz = -1; dz <= 1 && match == UINT32_MAX; dz++)
+                for (int64_t dy = -1; dy <= 1 && match == UINT32_MAX; dy++)
+                    for (int64_t dx = -1; dx <= 1 && match == UINT32_MAX; dx++)
+                    {
+                        auto it = grid.find(cellKey(cx + dx, cy + dy, cz + dz));
+                        if (it == grid.end()) continue;
+
+                        for (uint32_t candidate : it->second)
+                        {
+                            const CubeVertex& u = vertices[outUnique[candidate]];
+                            if (glm::length(u.Position - v.Position) <= tolerance && glm::dot(u.Normal, v.Normal) >= normalCosTolerance)
+                            {
+                                match = candidate;
+                                break;
+                            }
+                        }
+                    }
+
+            if (match == UINT32_MAX)
+            {
+                match = (uint32_t)outUnique.size();
+                outUnique.push_back(i);
+                grid[cellKey(cx, cy, cz)].push_back(match);
+            }
+            outRemap[i] = match;
+        }
+        return (uint32_t)outUnique.size();
+    }
+
+    void MeshMemoryReport::Add(const MeshMemoryReport& other)
+    {
+        Triangles += other.Triangles;
+        Vertices += other.Vertices;
+        WeldedVertices += other.WeldedVertices;
+        RasterBytesBefore += other.RasterBytesBefore;
+        RasterBytesAfter += other.RasterBytesAfter;
+        RayTracingBytesBefore += other.RayTracingBytesBefore;
+        RayTracingBytesAfter += other.RayTracingBytesAfter;
+    }
+
+    void MeshMemoryReport::Log(const char* name) const
+    {
+        double tris = (double)std::max<uint64_t>(Triangles, 1);
+        RONG_CORE_INFO("Mesh Memory [{0}]: {1} Tris, {2} -> {3} Verts (Welded) | Raster {4:.1f} -> {5:.1f} B/Tri | RT Upload {6:.1f} -> {7:.1f} B/Tri",
+            name, Triangles, Vertices, WeldedVertices,
+            RasterBytesBefore / tris, RasterBytesAfter / tris, RayTracingBytesBefore / tris, RayTracingBytesAfter / tris);
+    }
+
+    MeshMemoryReport MeasureMeshMemory(ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices)
+    {
+        MeshMemoryReport report;
+        report.Triangles = indices.size() / 3;
+        report.Vertices = vertices.size();
+
+        std::vector<uint32_t> remap, unique;
+        report.WeldedVertices = WeldVertices(vertices, remap, unique);
+
+        size_t indexSize = vertices.size() < 65536 ? sizeof(uint16_t) : sizeof(uint32_t);
+        report.RasterBytesBefore = vertices.size() * sizeof(CubeVertex) + indices.size() * sizeof(uint32_t);
+        report.RasterBytesAfter = vertices.size() * sizeof(CADVertex) + indices.size() * indexSize;
+        report.RayTracingBytesBefore = vertices.size() * sizeof(GPUVertex) + report.Triangles * sizeof(TriangleData);
+        report.RayTracingBytesAfter = report.WeldedVertices * sizeof(GPUVertex) + report.Triangles * sizeof(TriangleData);
+        return report;
+    }
+
+}
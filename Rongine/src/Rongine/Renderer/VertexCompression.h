@@ -0,0 +1,47 @@
+#pragma once
+#include "Rongine/Renderer/RenderTypes.h"
+#include "Rongine/Renderer/MeshArray.h"
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Rongine {
+
+    // 八面体映射：单位法线 <-> [-1,1]^2，存成两个 snorm16
+    glm::vec2 OctEncode(const glm::vec3& normal);
+    glm::vec3 OctDecode(const glm::vec2& encoded);
+
+    // 把网格顶点转成紧凑格式，位置在顶点包围盒内量化为 unorm16
+    // 还原: position = outOffset + quantized * outScale (quantized 为 0..65535 的整数)
+    void CompressCADVertices(ArrayView<CubeVertex> vertices, std::vector<CADVertex>& outVertices,
+        glm::vec3& outOffset, glm::vec3& outScale);
+    // 按给定的还原参数量化 (超出量化范围的坐标会被截断)，用于沿用上一次的参数
+    void QuantizeCADVertices(ArrayView<CubeVertex> vertices, const glm::vec3& offset, const glm::vec3& scale,
+        std::vector<CADVertex>& outVertices);
+
+    // 跨面焊接：位置重合且法线夹角足够小的顶点合并 (光顺接缝)，锐边两侧法线不同的顶点保持独立
+    // relativeTolerance: 位置容差，相对于网格包围盒对角线
+    // outRemap[i] 为原顶点 i 在 outUnique 中的新下标，outUnique 存保留下来的原顶点下标
+    // 返回焊接后的顶点数
+    uint32_t WeldVertices(ArrayView<CubeVertex> vertices, std::vector<uint32_t>& outRemap, std::vector<uint32_t>& outUnique,
+        float relativeTolerance = 1e-6f, float normalCosTolerance = 0.9999f);
+
+    // 网格显存占用 (字节/三角形)：原始 CubeVertex + 32 位索引、紧凑格式 + 16/32 位索引、光追上传 (焊接前后)
+    struct MeshMemoryReport
+    {
+        uint64_t Triangles = 0;
+        uint64_t Vertices = 0;
+        uint64_t WeldedVertices = 0;
+
+        uint64_t RasterBytesBefore = 0;
+        uint64_t RasterBytesAfter = 0;
+        uint64_t RayTracingBytesBefore = 0;
+        uint64_t RayTracingBytesAfter = 0;
+
+        void Add(const MeshMemoryReport& other);
+        void Log(const char* name) const;
+    };
+
+    MeshMemoryReport MeasureMeshMemory(ArrayView<CubeVertex> vertices, ArrayView<uint32_t> indices);
+
+}
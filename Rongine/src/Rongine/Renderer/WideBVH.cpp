@@ -0,0 +1,401 @@
+#include "Rongpch.h"
+#include "WideBVH.h"
+#include "BVH.h"
+#include "Rongine/Core/Log.h"
+
+#include <immintrin.h> // SSE / AVX
+#include <chrono>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace Rongine {
+
+    // 广播到 SIMD 寄存器的光线
+    struct SIMDRay {
+        __m128 OriginX, OriginY, OriginZ;
+        __m128 InvDirX, InvDirY, InvDirZ;
+#if defined(__AVX__)
+        __m256 OriginX8, OriginY8, OriginZ8;
+        __m256 InvDirX8, InvDirY8, InvDirZ8;
+#endif
+
+        SIMDRay(const glm::vec3& origin, const glm::vec3& invDir)
+        {
+            OriginX = _mm_set1_ps(origin.x); OriginY = _mm_set1_ps(origin.y); OriginZ = _mm_set1_ps(origin.z);
+            InvDirX = _mm_set1_ps(invDir.x); InvDirY = _mm_set1_ps(invDir.y); InvDirZ = _mm_set1_ps(invDir.z);
+#if defined(__AVX__)
+            OriginX8 = _mm256_set1_ps(origin.x); OriginY8 = _mm256_set1_ps(origin.y); OriginZ8 = _mm256_set1_ps(origin.z);
+            InvDirX8 = _mm256_set1_ps(invDir.x); InvDirY8 = _mm256_set1_ps(invDir.y); InvDirZ8 = _mm256_set1_ps(invDir.z);
+#endif
+        }
+    };
+
+    // 4 个包围盒的 slab 测试，返回命中掩码 (bit i = 第 i 个盒子)，tNear 写出进入距离
+    // 与 Math::RayAABBIntersection 相同：只接受 [0, closestT] 区间内的盒子
+    static inline int IntersectBoxes4(const float* minX, const float* minY, const float* minZ,
+        const float* maxX, const float* maxY, const float* maxZ, const SIMDRay& ray, float closestT, float* tNear)
+    {
+        __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(minX), ray.OriginX), ray.InvDirX);
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(maxX), ray.OriginX), ray.InvDirX);
+        __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(minY), ray.OriginY), ray.InvDirY);
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(maxY), ray.OriginY), ray.InvDirY);
+        __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(minZ), ray.OriginZ), ray.InvDirZ);
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(maxZ), ray.OriginZ), ray.InvDirZ);
+
+        __m128 tMin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+            _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+        __m128 tMax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+            _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_set1_ps(closestT)));
+
+        _mm_storeu_ps(tNear, tMin);
+        return _mm_movemask_ps(_mm_cmple_ps(tMin, tMax));
+    }
+
+#if defined(__AVX__)
+    static inline int IntersectBoxes8(const float* minX, const float* minY, const float* minZ,
+        const float* maxX, const float* maxY, const float* maxZ, const SIMDRay& ray, float closestT, float* tNear)
+    {
+        __m256 t0x = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(minX), ray.OriginX8), ray.InvDirX8);
+        __m256 t1x = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(maxX), ray.OriginX8), ray.InvDirX8);
+        __m256 t0y = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(minY), ray.OriginY8), ray.InvDirY8);
+        __m256 t1y = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(maxY), ray.OriginY8), ray.InvDirY8);
+        __m256 t0z = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(minZ), ray.OriginZ8), ray.InvDirZ8);
+        __m256 t1z = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(maxZ), ray.OriginZ8), ray.InvDirZ8);
+
+        __m256 tMin = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t0x, t1x), _mm256_min_ps(t0y, t1y)),
+            _mm256_max_ps(_mm256_min_ps(t0z, t1z), _mm256_setzero_ps()));
+        __m256 tMax = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t0x, t1x), _mm256_max_ps(t0y, t1y)),
+            _mm256_min_ps(_mm256_max_ps(t0z, t1z), _mm256_set1_ps(closestT)));
+
+        _mm256_storeu_ps(tNear, tMin);
+        return _mm256_movemask_ps(_mm256_cmp_ps(tMin, tMax, _CMP_LE_OQ));
+    }
+#endif
+
+    template<int Width>
+    static inline int IntersectChildren(const typename WideBVH<Width>::Node& node, const SIMDRay& ray, float closestT, float* tNear)
+    {
+        int mask;
+        if constexpr (Width == 4)
+        {
+            mask = IntersectBoxes4(node.MinX, node.MinY, node.MinZ, node.MaxX, node.MaxY, node.MaxZ, ray, closestT, tNear);
+        }
+        else
+        {
+#if defined(__AVX__)
+            mask = IntersectBoxes8(node.MinX, node.MinY, node.MinZ, node.MaxX, node.MaxY, node.MaxZ, ray, closestT, tNear);
+#else
+            int lo = IntersectBoxes4(node.MinX, node.MinY, node.MinZ, node.MaxX, node.MaxY, node.MaxZ, ray, closestT, tNear);
+            int hi = IntersectBoxes4(node.MinX + 4, node.MinY + 4, node.MinZ + 4, node.MaxX + 4, node.MaxY + 4, node.MaxZ + 4,
+                ray, closestT, tNear + 4);
+            mask = lo | (hi << 4);
+#endif
+        }
+        // 屏蔽空槽位
+        return mask & ((1 << node.ChildCount) - 1);
+    }
+
+    // Möller–Trumbore，边已预先算好 (与 Math::RayTriangleIntersection 一致，额外输出重心坐标)
+    template<typename Tri>
+    static inline bool IntersectTriangle(const Tri& tri, const glm::vec3& origin, const glm::vec3& dir, float& t, float& u, float& v)
+    {
+        const float epsilon = 1e-6f;
+        glm::vec3 h = glm::cross(dir, tri.Edge2);
+        float a = glm::dot(tri.Edge1, h);
+        if (a > -epsilon && a < epsilon) return false;
+        float f = 1.0f / a;
+        glm::vec3 s = origin - tri.V0;
+        u = f * glm::dot(s, h);
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, tri.Edge1);
+        v = f * glm::dot(dir, q);
+        if (v < 0.0f || u + v > 1.0f) return false;
+        t = f * glm::dot(tri.Edge2, q);
+        return t > epsilon;
+    }
+
+    template<int Width>
+    WideBVH<Width>::WideBVH(const std::vector<BVHTriangle>& triangles, BVHBuildQuality quality, bool parallel)
+    {
+        if (triangles.empty()) return;
+
+        // 1. 先构建二叉 BVH (LBVH 同样输出 GPUBVHNode，但 CPU 查询更看重树质量，这里只用 BVHBuilder)
+        if (quality == BVHBuildQuality::LBVH) quality = BVHBuildQuality::SAH;
+        BVHBuilder binary(triangles, quality, parallel);
+        const auto& binaryNodes = binary.GetNodes();
+        const auto& indices = binary.GetSortedIndices();
+
+        // 2. 三角形按叶子顺序重排，叶子直接引用连续区间
+        m_Triangles.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            const BVHTriangle& tri = triangles[indices[i]];
+            m_Triangles[i] = { tri.V0, tri.V1 - tri.V0, tri.V2 - tri.V0, tri.Index };
+        }
+
+        // 3. 折叠
+        m_Nodes.reserve(binaryNodes.size() / (Width / 2) + 1);
+        m_Nodes.push_back(Node{});
+
+        const GPUBVHNode& root = binaryNodes[0];
+        if (root.IsLeaf())
+        {
+            // 整棵树只有一个叶子：根节点只有一个槽位
+            Node& node = m_Nodes[0];
+            node.MinX[0] = root.MinX; node.MinY[0] = root.MinY; node.MinZ[0] = root.MinZ;
+            node.MaxX[0] = root.MaxX; node.MaxY[0] = root.MaxY; node.MaxZ[0] = root.MaxZ;
+            node.Child[0] = root.GetFirstPrim();
+            node.Count[0] = root.GetPrimCount();
+            node.ChildCount = root.GetPrimCount() > 0 ? 1 : 0;
+        }
+        else
+        {
+            Collapse(binaryNodes, 0, 0);
+        }
+    }
+
+    template<int Width>
+    void WideBVH<Width>::Collapse(const std::vector<GPUBVHNode>& binaryNodes, uint32_t binaryIndex, uint32_t wideIndex)
+    {
+        auto nodeArea = [](const GPUBVHNode& n) {
+            return AABB({ n.MinX, n.MinY, n.MinZ }, { n.MaxX, n.MaxY, n.MaxZ }).Area();
+        };
+
+        // 1. 从二叉节点的两个孩子开始，反复展开表面积最大的内部孩子
+        uint32_t children[Width];
+        int childCount = 0;
+        children[childCount++] = binaryNodes[binaryIndex].GetLeftChild();
+        children[childCount++] = binaryNodes[binaryIndex].GetRightChild();
+
+        while (childCount < Width)
+        {
+            int best = -1;
+            float bestArea = -1.0f;
+            for (int i = 0; i < childCount; i++)
+            {
+                const GPUBVHNode& child = binaryNodes[children[i]];
+                if (child.IsLeaf()) continue;
+                float area = nodeArea(child);
+                if (area > bestArea) { bestArea = area; best = i; }
+            }
+            if (best < 0) break; // 全是叶子
+
+            const GPUBVHNode& expand = binaryNodes[children[best]];
+            children[best] = expand.GetLeftChild();
+            children[childCount++] = expand.GetRightChild();
+        }
+
+        // 2. 填写槽位 (push_back 可能扩容，始终通过下标访问当前节点)
+        for (int i = 0; i < childCount; i++)
+        {
+            const GPUBVHNode& child = binaryNodes[children[i]];
+
+            uint32_t childWide = 0;
+            if (!child.IsLeaf())
+            {
+                childWide = (uint32_t)m_Nodes.size();
+                m_Nodes.push_back(Node{});
+            }
+
+            Node& node = m_Nodes[wideIndex];
+            node.MinX[i] = child.MinX; node.MinY[i] = child.MinY; node.MinZ[i] = child.MinZ;
+            node.MaxX[i] = child.MaxX; node.MaxY[i] = child.MaxY; node.MaxZ[i] = child.MaxZ;
+            node.Child[i] = child.IsLeaf() ? child.GetFirstPrim() : childWide;
+            node.Count[i] = child.IsLeaf() ? child.GetPrimCount() : 0;
+        }
+        m_Nodes[wideIndex].ChildCount = (uint32_t)childCount;
+
+        // 3. 递归折叠内部孩子
+        for (int i = 0; i < childCount; i++)
+        {
+            if (!binaryNodes[children[i]].IsLeaf())
+                Collapse(binaryNodes, children[i], m_Nodes[wideIndex].Child[i]);
+        }
+    }
+
+    template<int Width>
+    bool WideBVH<Width>::Intersect(const glm::vec3& origin, const glm::vec3& dir, Hit& hit, RayQueryStats* stats) const
+    {
+        if (IsEmpty()) return false;
+
+        glm::vec3 invDir = 1.0f / dir;
+        SIMDRay ray(origin, invDir);
+        bool found = false;
+
+        // 栈中带上进入距离，弹出时已经比当前最近交点远的节点直接跳过
+        struct StackEntry { uint32_t NodeIndex; float TNear; };
+        StackEntry stack[256];
+        int stackPtr = 0;
+        stack[stackPtr++] = { 0, 0.0f };
+
+        while (stackPtr > 0)
+        {
+            StackEntry entry = stack[--stackPtr];
+            if (entry.TNear > hit.T) continue;
+
+            const Node& node = m_Nodes[entry.NodeIndex];
+            if (stats) stats->NodesVisited++;
+
+            alignas(32) float tNear[Width];
+            int mask = IntersectChildren<Width>(node, ray, hit.T, tNear);
+            if (mask == 0) continue;
+
+            // 命中的槽位按进入距离从近到远排序 (最多 8 个，插入排序即可)
+            int order[Width];
+            int hitCount = 0;
+            while (mask)
+            {
+                int lane = 0;
+                while (!(mask & (1 << lane))) lane++;
+                mask &= mask - 1;
+
+                int j = hitCount++;
+                while (j > 0 && tNear[order[j - 1]] > tNear[lane]) { order[j] = order[j - 1]; j--; }
+                order[j] = lane;
+            }
+
+            // 叶子由近到远立即求交，内部节点由远到近压栈 (近的先弹出)
+            for (int k = 0; k < hitCount; k++)
+            {
+                int lane = order[k];
+                if (node.Count[lane] == 0 || tNear[lane] > hit.T) continue;
+
+                uint32_t first = node.Child[lane];
+                uint32_t last = first + node.Count[lane];
+                for (uint32_t i = first; i < last; i++)
+                {
+                    if (stats) stats->TrianglesTested++;
+                    float t, u, v;
+                    if (IntersectTriangle(m_Triangles[i], origin, dir, t, u, v) && t < hit.T)
+                    {
+                        hit.T = t;
+                        hit.U = u;
+                        hit.V = v;
+                        hit.Triangle = m_Triangles[i].Index;
+                        found = true;
+                    }
+                }
+            }
+            for (int k = hitCount - 1; k >= 0; k--)
+            {
+                int lane = order[k];
+                if (node.Count[lane] == 0 && tNear[lane] <= hit.T)
+                    stack[stackPtr++] = { node.Child[lane], tNear[lane] };
+            }
+        }
+        return found;
+    }
+
+    template class WideBVH<4>;
+    template class WideBVH<8>;
+
+    void BenchmarkRayQueries(const std::vector<BVHTriangle>& triangles, int rayCount)
+    {
+        if (triangles.empty())
+        {
+            RONG_CORE_WARN("Ray Benchmark: no triangles in scene");
+            return;
+        }
+
+        // 1. 构建三种结构
+        auto t0 = std::chrono::high_resolution_clock::now();
+        BVHBuilder binary(triangles, BVHBuildQuality::SAH, true);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        BVH4 bvh4(triangles);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        BVH8 bvh8(triangles);
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        // 2. 射线：从包住场景的球面射向场景内的随机点 (近似主光线/拾取光线)
+        AABB bounds;
+        for (const auto& tri : triangles)
+        {
+            bounds.Grow(tri.V0);
+            bounds.Grow(tri.V1);
+            bounds.Grow(tri.V2);
+        }
+        glm::vec3 center = bounds.GetCenter();
+        glm::vec3 size = bounds.GetSize();
+        float radius = glm::length(size) * 1.5f + 1e-3f;
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<glm::vec3> origins(rayCount), dirs(rayCount);
+        for (int r = 0; r < rayCount; r++)
+        {
+            glm::vec3 onSphere = glm::normalize(glm::vec3(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f) + glm::vec3(1e-4f));
+            glm::vec3 target = bounds.Min + glm::vec3(unit(rng) * size.x, unit(rng) * size.y, unit(rng) * size.z);
+            origins[r] = center + onSphere * radius;
+            dirs[r] = glm::normalize(target - origins[r]);
+        }
+
+        // 3. 单线程 + 多线程各跑一遍，返回每秒射线数 (百万)
+        std::vector<float> binaryT(rayCount), wide4T(rayCount), wide8T(rayCount);
+        auto measure = [&](const char* name, size_t memoryBytes, float buildMs, auto&& trace) {
+            RayQueryStats stats;
+            auto s0 = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < rayCount; r++) trace(r, &stats);
+            auto s1 = std::chrono::high_resolution_clock::now();
+
+            std::vector<int> chunks((rayCount + 4095) / 4096);
+            std::iota(chunks.begin(), chunks.end(), 0);
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](int chunk) {
+                int end = std::min(rayCount, (chunk + 1) * 4096);
+                for (int r = chunk * 4096; r < end; r++) trace(r, nullptr);
+            });
+            auto s2 = std::chrono::high_resolution_clock::now();
+
+            float serialSec = std::chrono::duration<float>(s1 - s0).count();
+            float parallelSec = std::chrono::duration<float>(s2 - s1).count();
+            RONG_CORE_INFO("Ray Benchmark [{0}]: Build {1}ms, {2} KB, {3} Rays, 1 Thread {4:.2f} MRays/s, x{5} Threads {6:.2f} MRays/s, {7:.1f} Nodes/Ray, {8:.1f} Tris/Ray",
+                name, buildMs, memoryBytes / 1024, rayCount,
+                serialSec > 0.0f ? rayCount / serialSec / 1e6f : 0.0f,
+                std::thread::hardware_concurrency(),
+                parallelSec > 0.0f ? rayCount / parallelSec / 1e6f : 0.0f,
+                (double)stats.NodesVisited / rayCount, (double)stats.TrianglesTested / rayCount);
+        };
+
+        measure("BVH2 Scalar", binary.GetNodes().size() * sizeof(GPUBVHNode),
+            std::chrono::duration<float, std::milli>(t1 - t0).count(),
+            [&](int r, RayQueryStats* stats) {
+                uint32_t tri;
+                float t;
+                binaryT[r] = BVHBuilder::Intersect(binary.GetNodes(), binary.GetSortedIndices(), triangles, origins[r], dirs[r], t, tri, stats) ? t : -1.0f;
+            });
+
+        measure("BVH4 SSE", bvh4.GetMemorySize(),
+            std::chrono::duration<float, std::milli>(t2 - t1).count(),
+            [&](int r, RayQueryStats* stats) {
+                BVH4::Hit hit;
+                wide4T[r] = bvh4.Intersect(origins[r], dirs[r], hit, stats) ? hit.T : -1.0f;
+            });
+
+#if defined(__AVX__)
+        const char* bvh8Name = "BVH8 AVX";
+#else
+        const char* bvh8Name = "BVH8 SSE x2";
+#endif
+        measure(bvh8Name, bvh8.GetMemorySize(),
+            std::chrono::duration<float, std::milli>(t3 - t2).count(),
+            [&](int r, RayQueryStats* stats) {
+                BVH8::Hit hit;
+                wide8T[r] = bvh8.Intersect(origins[r], dirs[r], hit, stats) ? hit.T : -1.0f;
+            });
+
+        // 4. 校验：三种结构的最近交点必须一致
+        int mismatches = 0, hits = 0;
+        for (int r = 0; r < rayCount; r++)
+        {
+            float tol = 1e-4f * std::max(1.0f, std::abs(binaryT[r]));
+            if (std::abs(binaryT[r] - wide4T[r]) > tol || std::abs(binaryT[r] - wide8T[r]) > tol) mismatches++;
+            if (binaryT[r] > 0.0f) hits++;
+        }
+
+        if (mismatches > 0)
+            RONG_CORE_WARN("Ray Benchmark: {0} / {1} rays disagree between BVH2 / BVH4 / BVH8", mismatches, rayCount);
+        else
+            RONG_CORE_INFO("Ray Benchmark: all {0} rays agree ({1} hits)", rayCount, hits);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Rongine/Renderer/AccelerationStructures.h"
+#include "Rongine/Renderer/RenderTypes.h"
+
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Rongine {
+
+    // 宽 BVH (BVH4 / BVH8)，只用于 CPU 端射线查询 (SpectralRenderer 等)，不上传 GPU
+    // 由 BVHBuilder 的二叉树折叠而来：反复把表面积最大的内部子节点展开成它的两个孩子，直到孩子数达到 Width
+    // 子节点包围盒按 SoA 存储，一条 SSE (BVH4) / AVX (BVH8) 指令同时测试全部子节点
+    // 没有开启 AVX 编译选项时，BVH8 用两组 SSE 指令完成
+    template<int Width>
+    class WideBVH {
+    public:
+        static_assert(Width == 4 || Width == 8, "WideBVH only supports 4 or 8 children per node");
+
+        struct alignas(Width * 4) Node {
+            float MinX[Width], MinY[Width], MinZ[Width];
+            float MaxX[Width], MaxY[Width], MaxZ[Width];
+            uint32_t Child[Width]; // 内部: 子节点索引; 叶子: 第一个三角形 (m_Triangles 中的位置)
+            uint32_t Count[Width]; // 叶子: 三角形数量; 内部: 0
+            uint32_t ChildCount;   // 有效的子节点数，其余槽位为空
+        };
+
+        // 叶子中的三角形按遍历顺序连续存放，预先算好两条边
+        struct Triangle {
+            glm::vec3 V0, Edge1, Edge2;
+            uint32_t Index; // 原始三角形 ID (BVHTriangle::Index)
+        };
+
+        struct Hit {
+            float T = 1e30f;
+            float U = 0.0f, V = 0.0f; // 重心坐标 (P = V0 + U * Edge1 + V * Edge2)
+            uint32_t Triangle = 0;    // 原始三角形 ID
+        };
+
+        WideBVH() = default;
+        WideBVH(const std::vector<BVHTriangle>& triangles, BVHBuildQuality quality = BVHBuildQuality::SAH, bool parallel = true);
+
+        // 最近交点查询，hit.T 的初始值作为最大距离
+        bool Intersect(const glm::vec3& origin, const glm::vec3& dir, Hit& hit, RayQueryStats* stats = nullptr) const;
+
+        bool IsEmpty() const { return m_Nodes.empty() || m_Nodes[0].ChildCount == 0; }
+        const std::vector<Node>& GetNodes() const { return m_Nodes; }
+        size_t GetMemorySize() const { return m_Nodes.size() * sizeof(Node) + m_Triangles.size() * sizeof(Triangle); }
+
+    private:
+        void Collapse(const std::vector<GPUBVHNode>& binaryNodes, uint32_t binaryIndex, uint32_t wideIndex);
+
+        std::vector<Node> m_Nodes;
+        std::vector<Triangle> m_Triangles;
+    };
+
+    using BVH4 = WideBVH<4>;
+    using BVH8 = WideBVH<8>;
+
+    // 性能测试：同一组随机射线分别用二叉 BVH (标量)、BVH4 (SSE)、BVH8 (AVX) 遍历，
+    // 打印单线程与多线程的每秒射线数，并校验三者结果一致
+    void BenchmarkRayQueries(const std::vector<BVHTriangle>& triangles, int rayCount = 1 << 18);
+
+}
@@ -2,12 +2,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <string>
+#include <atomic>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
 #include "Rongine/Renderer/VertexArray.h" // 包含你的 VertexArray
 #include "Rongine/Renderer/RenderTypes.h"
+#include "Rongine/Renderer/MeshArray.h"
 
 #include <TopoDS_Edge.hxx>
 #include <gp_Ax3.hxx> // OCCT 的坐标系类
@@ -18,6 +20,9 @@ class TopoDS_Shape;
 
 namespace Rongine {
 
+    class TopologyIndex;
+    class MeshBuffer;
+
     struct SketchLine
     {
         glm::vec3 P0;
@@ -31,6 +36,9 @@ namespace Rongine {
         int EntityID; // 存 EdgeID，复用 EntityID 这个名字传入 Shader
     };
 
+    // 边框线带的重启索引 (GL_PRIMITIVE_RESTART_FIXED_INDEX，32 位索引的最大值)
+    constexpr uint32_t LineStripRestartIndex = 0xFFFFFFFFu;
+
     struct IDComponent
     {
         uint64_t ID = 0;
@@ -84,23 +92,76 @@ namespace Rongine {
     {
         Ref<VertexArray> VA;
         AABB BoundingBox;
-
-        Ref<VertexArray> EdgeVA;             // 边的显存对象
-
-        std::vector<LineVertex> LocalLines;  // 边的内存数据 (用于做 CPU 射线检测)
-        std::vector<CubeVertex> LocalVertices;
-        std::vector<uint32_t> LocalIndices;//索引数据
-
-        std::map<int, TopoDS_Edge> m_IDToEdgeMap;
+        // 按面分段的网格显存，局部编辑后只上传变化的面 (VA 每次更新都是新对象，共享这里的缓冲)
+        Ref<MeshBuffer> GPUBuffer;
+
+        // 边框线：每条边一段线带，相邻线段共享顶点，边之间用 LineStripRestartIndex 断开
+        // 显存统一放在 Renderer3D 的场景线缓冲里，按 EdgeRevision 判断是否需要重新打包
+        std::vector<LineVertex> LocalLines;
+        std::vector<uint32_t> LocalLineIndices;
+        uint64_t EdgeRevision = 0;
+        // 三角网格的 CPU 副本 (拾取/吸附/光追/BVH 用)，从网格缓存加载时直接引用映射文件，不复制
+        // 通过 SetGeometry 整体替换，GeometryRevision 随之递增；BLAS/光追场景/焊接缓存按实体 + 版本号判断网格是否变化
+        MeshArray<CubeVertex> LocalVertices;
+        MeshArray<uint32_t> LocalIndices;//索引数据
+        uint64_t GeometryRevision = 0;
+
+        bool MeshPending = false; // 后台网格任务还没完成 (边框线可能是包围盒占位)
+
+        // 视距相关的粗网格，VA 本身是 LOD0，CoarseLODs[k - 1] 是 LODk (弦高逐级放大)
+        // 只用于绘制；拾取、吸附和光追仍然使用 LOD0 的 CPU 数据
+        struct LODLevel
+        {
+            Ref<VertexArray> VA;           // 为空表示还没生成
+            float Deflection = 0.0f;
+            uint32_t TriangleCount = 0;
+            bool Requested = false;        // 已经提交后台任务
+        };
+        std::vector<LODLevel> CoarseLODs;
+        std::weak_ptr<VertexArray> LODSource; // 粗网格是按哪个 VA 生成的，VA 被替换后全部作废
+        int CurrentLOD = 0;
 
         MeshComponent() = default;
         MeshComponent(const MeshComponent&) = default;
         MeshComponent(const Ref<VertexArray>& va) : VA(va) {}
-        MeshComponent(const Ref<VertexArray>& va, const std::vector<CubeVertex>& verts)
-            : VA(va), LocalVertices(verts) {
+        MeshComponent(const Ref<VertexArray>& va, MeshArray<CubeVertex> verts)
+            : VA(va), LocalVertices(std::move(verts)), GeometryRevision(NextGeometryRevision()) {
         }
-        MeshComponent(const Ref<VertexArray>& va, const std::vector<CubeVertex>& verts,const std::vector<uint32_t> indices)
-            : VA(va), LocalVertices(verts),LocalIndices(indices) {
+        MeshComponent(const Ref<VertexArray>& va, MeshArray<CubeVertex> verts, MeshArray<uint32_t> indices)
+            : VA(va), LocalVertices(std::move(verts)),LocalIndices(std::move(indices)), GeometryRevision(NextGeometryRevision()) {
+        }
+
+        // 替换三角网格的 CPU 数据；版本号全局递增 (实体句柄或 VA 地址被复用时也不会误判)
+        void SetGeometry(MeshArray<CubeVertex> vertices, MeshArray<uint32_t> indices)
+        {
+            LocalVertices = std::move(vertices);
+            LocalIndices = std::move(indices);
+            GeometryRevision = NextGeometryRevision();
+        }
+
+        void SetIndices(MeshArray<uint32_t> indices)
+        {
+            LocalIndices = std::move(indices);
+            GeometryRevision = NextGeometryRevision();
+        }
+
+        // 替换边框线数据；版本号全局递增，场景线缓冲据此发现变化 (实体句柄被复用时也不会误判)
+        void SetEdges(std::vector<LineVertex> lines, std::vector<uint32_t> indices)
+        {
+            static std::atomic<uint64_t> s_NextEdgeRevision{ 1 };
+            LocalLines = std::move(lines);
+            LocalLineIndices = std::move(indices);
+            EdgeRevision = s_NextEdgeRevision++;
+        }
+
+        void ClearEdges() { SetEdges({}, {}); }
+        bool HasEdges() const { return !LocalLineIndices.empty(); }
+
+    private:
+        static uint64_t NextGeometryRevision()
+        {
+            static std::atomic<uint64_t> s_NextGeometryRevision{ 1 };
+            return s_NextGeometryRevision++;
         }
     };
 
@@ -146,6 +207,10 @@ namespace Rongine {
         // 实际上它指向的是 new TopoDS_Shape()
         void* ShapeHandle = nullptr;
 
+        // 面/边/顶点的拓扑索引表 (按 ID 取子形状 O(1))，通过 TopologyIndex::Get 访问，形状被替换后自动重建
+        // 只读且不可变，复制组件时共享同一张表
+        Ref<TopologyIndex> Topology;
+
         // --- 参数化数据 (为以后的序列化做准备) ---
         struct {
             float Width = 1.0f, Height = 1.0f, Depth = 1.0f; // 立方体参数
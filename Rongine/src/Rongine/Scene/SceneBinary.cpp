@@ -0,0 +1,401 @@
+#include "Rongpch.h"
+#include "SceneBinary.h"
+#include "Rongine/Core/Log.h"
+
+#include <fstream>
+#include <cstring>
+
+namespace Rongine {
+
+	static constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+	}
+
+	static constexpr uint32_t FileMagic = MakeFourCC('R', 'O', 'N', 'B');
+	static constexpr uint32_t ChunkName = MakeFourCC('N', 'A', 'M', 'E');
+	static constexpr uint32_t ChunkEntities = MakeFourCC('E', 'N', 'T', 'S');
+	static constexpr uint32_t ChunkIDs = MakeFourCC('I', 'D', 'S', ' ');
+	static constexpr uint32_t ChunkTags = MakeFourCC('T', 'A', 'G', 'S');
+	static constexpr uint32_t ChunkTransforms = MakeFourCC('X', 'F', 'R', 'M');
+	static constexpr uint32_t ChunkCADParams = MakeFourCC('C', 'A', 'D', 'P');
+	static constexpr uint32_t ChunkPaths = MakeFourCC('P', 'A', 'T', 'H');
+
+	// 组件表里的掩码位
+	enum ComponentBits : uint32_t
+	{
+		ComponentTag = 1u << 0,
+		ComponentTransform = 1u << 1,
+		ComponentCAD = 1u << 2,
+	};
+
+	static constexpr uint32_t NoPath = 0xFFFFFFFFu;
+
+	struct FileHeader
+	{
+		uint32_t Magic = FileMagic;
+		uint32_t Version = SceneBinary::Version;
+		uint32_t HeaderSize = sizeof(FileHeader);
+		uint32_t ChunkCount = 0;
+		uint64_t EntityCount = 0;
+		uint64_t Reserved = 0;
+	};
+
+	struct ChunkEntry
+	{
+		uint32_t Type = 0;
+		uint32_t Version = 1;
+		uint64_t Offset = 0; // 相对文件开头
+		uint64_t Size = 0;   // 字节数
+		uint64_t Count = 0;  // 元素个数
+	};
+
+	struct TransformPOD
+	{
+		float Translation[3];
+		float Rotation[3];
+		float Scale[3];
+	};
+
+	struct CADParamsPOD
+	{
+		int32_t Type;
+		float Width, Height, Depth, Radius;
+		float LinearDeflection;
+		uint32_t BRepPath; // PATH 表下标，NoPath = 没有
+	};
+
+	static_assert(sizeof(FileHeader) == 32 && sizeof(ChunkEntry) == 32, "Scene binary header layout changed");
+	static_assert(sizeof(TransformPOD) == 36 && sizeof(CADParamsPOD) == 28, "Scene binary chunk layout changed");
+
+	// 文件按小端序直接拷贝内存，只支持小端平台 (x86/x64/ARM64)
+	static bool IsLittleEndian()
+	{
+		const uint16_t probe = 1;
+		return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+	}
+
+	// =============================================================
+	// 写入
+	// =============================================================
+	class ChunkWriter
+	{
+	public:
+		void begin(uint32_t type, uint64_t count)
+		{
+			// 每块 8 字节对齐 (块数据紧跟在头和块表之后，偏移在 finish 时统一加上)
+			m_body.resize((m_body.size() + 7) & ~(size_t)7, 0);
+			ChunkEntry entry;
+			entry.Type = type;
+			entry.Offset = m_body.size();
+			entry.Count = count;
+			m_chunks.push_back(entry);
+		}
+
+		void write(const void* data, size_t size)
+		{
+			if (size == 0) return;
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			m_body.insert(m_body.end(), bytes, bytes + size);
+			m_chunks.back().Size += size;
+		}
+
+		template<typename T>
+		void writeArray(const std::vector<T>& values) { write(values.data(), values.size() * sizeof(T)); }
+
+		void writeStringTable(const std::vector<const std::string*>& strings)
+		{
+			std::vector<uint32_t> offsets(strings.size() + 1, 0);
+			for (size_t i = 0; i < strings.size(); i++)
+				offsets[i + 1] = offsets[i] + (uint32_t)strings[i]->size();
+			writeArray(offsets);
+			for (const std::string* s : strings)
+				write(s->data(), s->size());
+		}
+
+		bool finish(const std::string& filepath, uint64_t entityCount)
+		{
+			FileHeader header;
+			header.ChunkCount = (uint32_t)m_chunks.size();
+			header.EntityCount = entityCount;
+
+			uint64_t bodyOffset = sizeof(FileHeader) + m_chunks.size() * sizeof(ChunkEntry);
+			for (auto& chunk : m_chunks)
+				chunk.Offset += bodyOffset;
+
+			std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+			if (!out) return false;
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(m_chunks.data()), m_chunks.size() * sizeof(ChunkEntry));
+			out.write(reinterpret_cast<const char*>(m_body.data()), m_body.size());
+			return (bool)out;
+		}
+
+	private:
+		std::vector<ChunkEntry> m_chunks;
+		std::vector<uint8_t> m_body;
+	};
+
+	bool SceneBinary::Write(const std::string& filepath, const SceneRecord& scene)
+	{
+		if (!IsLittleEndian())
+		{
+			RONG_CORE_ERROR("Binary scene format requires a little-endian host");
+			return false;
+		}
+
+		const auto& entities = scene.Entities;
+		std::vector<uint32_t> masks(entities.size(), 0);
+		std::vector<uint64_t> ids(entities.size());
+		std::vector<const std::string*> tags;
+		std::vector<TransformPOD> transforms;
+		std::vector<CADParamsPOD> cadParams;
+		std::vector<const std::string*> paths;
+
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			const EntityRecord& e = entities[i];
+			ids[i] = e.ID;
+
+			if (e.HasTag)
+			{
+				masks[i] |= ComponentTag;
+				tags.push_back(&e.Tag);
+			}
+
+			if (e.HasTransform)
+			{
+				masks[i] |= ComponentTransform;
+				TransformPOD t;
+				std::memcpy(t.Translation, &e.Translation[0], sizeof(t.Translation));
+				std::memcpy(t.Rotation, &e.Rotation[0], sizeof(t.Rotation));
+				std::memcpy(t.Scale, &e.Scale[0], sizeof(t.Scale));
+				transforms.push_back(t);
+			}
+
+			if (e.HasCAD)
+			{
+				masks[i] |= ComponentCAD;
+				CADParamsPOD p;
+				p.Type = e.CADType;
+				p.Width = e.Width;
+				p.Height = e.Height;
+				p.Depth = e.Depth;
+				p.Radius = e.Radius;
+				p.LinearDeflection = e.LinearDeflection;
+				p.BRepPath = NoPath;
+				if (!e.BRepPath.empty())
+				{
+					p.BRepPath = (uint32_t)paths.size();
+					paths.push_back(&e.BRepPath);
+				}
+				cadParams.push_back(p);
+			}
+		}
+
+		ChunkWriter writer;
+		writer.begin(ChunkName, scene.Name.size());
+		writer.write(scene.Name.data(), scene.Name.size());
+		writer.begin(ChunkEntities, masks.size());
+		writer.writeArray(masks);
+		writer.begin(ChunkIDs, ids.size());
+		writer.writeArray(ids);
+		writer.begin(ChunkTags, tags.size());
+		writer.writeStringTable(tags);
+		writer.begin(ChunkTransforms, transforms.size());
+		writer.writeArray(transforms);
+		writer.begin(ChunkCADParams, cadParams.size());
+		writer.writeArray(cadParams);
+		writer.begin(ChunkPaths, paths.size());
+		writer.writeStringTable(paths);
+
+		if (!writer.finish(filepath, entities.size()))
+		{
+			RONG_CORE_ERROR("Failed to write binary scene: {0}", filepath);
+			return false;
+		}
+		return true;
+	}
+
+	// =============================================================
+	// 读取
+	// =============================================================
+	struct ChunkView
+	{
+		const uint8_t* Data = nullptr;
+		uint64_t Size = 0;
+		uint64_t Count = 0;
+	};
+
+	template<typename T>
+	static bool ReadArray(const ChunkView& chunk, uint64_t expectedCount, std::vector<T>& out)
+	{
+		if (chunk.Count != expectedCount || chunk.Size != expectedCount * sizeof(T)) return false;
+		out.resize((size_t)expectedCount);
+		if (expectedCount > 0) std::memcpy(out.data(), chunk.Data, (size_t)chunk.Size);
+		return true;
+	}
+
+	static bool ReadStringTable(const ChunkView& chunk, uint64_t expectedCount, std::vector<std::string>& out)
+	{
+		out.clear();
+		if (expectedCount == 0 && !chunk.Data) return true; // 没有这一块
+
+		uint64_t offsetBytes = (expectedCount + 1) * sizeof(uint32_t);
+		if (chunk.Count != expectedCount || chunk.Size < offsetBytes) return false;
+
+		std::vector<uint32_t> offsets((size_t)expectedCount + 1);
+		std::memcpy(offsets.data(), chunk.Data, (size_t)offsetBytes);
+		const char* chars = reinterpret_cast<const char*>(chunk.Data + offsetBytes);
+		uint64_t charCount = chunk.Size - offsetBytes;
+
+		out.resize((size_t)expectedCount);
+		for (size_t i = 0; i < out.size(); i++)
+		{
+			if (offsets[i] > offsets[i + 1] || offsets[i + 1] > charCount) return false;
+			out[i].assign(chars + offsets[i], offsets[i + 1] - offsets[i]);
+		}
+		return true;
+	}
+
+	bool SceneBinary::Read(const std::string& filepath, SceneRecord& outScene)
+	{
+		if (!IsLittleEndian())
+		{
+			RONG_CORE_ERROR("Binary scene format requires a little-endian host");
+			return false;
+		}
+
+		// 1. 整个文件一次读入
+		std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+		if (!in) return false;
+		std::streamsize fileSize = in.tellg();
+		if (fileSize < (std::streamsize)sizeof(FileHeader)) return false;
+
+		std::vector<uint8_t> file((size_t)fileSize);
+		in.seekg(0);
+		if (!in.read(reinterpret_cast<char*>(file.data()), fileSize)) return false;
+
+		// 2. 文件头和块表
+		FileHeader header;
+		std::memcpy(&header, file.data(), sizeof(header));
+		if (header.Magic != FileMagic) return false;
+		if (header.Version > Version)
+		{
+			RONG_CORE_ERROR("Binary scene {0} has version {1}, this build reads up to {2}", filepath, header.Version, Version);
+			return false;
+		}
+		uint64_t tableEnd = (uint64_t)header.HeaderSize + (uint64_t)header.ChunkCount * sizeof(ChunkEntry);
+		if (header.HeaderSize < sizeof(FileHeader) || tableEnd > file.size()) return false;
+
+		ChunkView name, masks, ids, tags, transforms, cadParams, paths;
+		for (uint32_t i = 0; i < header.ChunkCount; i++)
+		{
+			ChunkEntry entry;
+			std::memcpy(&entry, file.data() + header.HeaderSize + i * sizeof(ChunkEntry), sizeof(entry));
+			if (entry.Offset > file.size() || entry.Size > file.size() - entry.Offset)
+			{
+				RONG_CORE_ERROR("Binary scene {0}: chunk {1} out of range", filepath, i);
+				return false;
+			}
+
+			ChunkView view{ file.data() + entry.Offset, entry.Size, entry.Count };
+			switch (entry.Type)
+			{
+			case ChunkName:       name = view; break;
+			case ChunkEntities:   masks = view; break;
+			case ChunkIDs:        ids = view; break;
+			case ChunkTags:       tags = view; break;
+			case ChunkTransforms: transforms = view; break;
+			case ChunkCADParams:  cadParams = view; break;
+			case ChunkPaths:      paths = view; break;
+			default: break; // 新版本追加的块
+			}
+		}
+
+		// 3. 组件表决定每个数组的长度
+		uint64_t entityCount = header.EntityCount;
+		std::vector<uint32_t> maskArray;
+		std::vector<uint64_t> idArray;
+		if (!ReadArray(masks, entityCount, maskArray) || !ReadArray(ids, entityCount, idArray))
+		{
+			RONG_CORE_ERROR("Binary scene {0}: corrupt entity table", filepath);
+			return false;
+		}
+
+		uint64_t tagCount = 0, transformCount = 0, cadCount = 0;
+		for (uint32_t mask : maskArray)
+		{
+			tagCount += (mask & ComponentTag) ? 1 : 0;
+			transformCount += (mask & ComponentTransform) ? 1 : 0;
+			cadCount += (mask & ComponentCAD) ? 1 : 0;
+		}
+
+		std::vector<std::string> tagArray, pathArray;
+		std::vector<TransformPOD> transformArray;
+		std::vector<CADParamsPOD> cadArray;
+		if (!ReadStringTable(tags, tagCount, tagArray) || !ReadArray(transforms, transformCount, transformArray) ||
+			!ReadArray(cadParams, cadCount, cadArray) || !ReadStringTable(paths, paths.Count, pathArray))
+		{
+			RONG_CORE_ERROR("Binary scene {0}: corrupt component chunk", filepath);
+			return false;
+		}
+
+		// 4. 拼回每个实体
+		outScene.Name = name.Data ? std::string(reinterpret_cast<const char*>(name.Data), (size_t)name.Size) : std::string("Untitled");
+		outScene.Entities.clear();
+		outScene.Entities.resize((size_t)entityCount);
+
+		size_t tagIndex = 0, transformIndex = 0, cadIndex = 0;
+		for (size_t i = 0; i < outScene.Entities.size(); i++)
+		{
+			EntityRecord& e = outScene.Entities[i];
+			e.ID = idArray[i];
+
+			if (maskArray[i] & ComponentTag)
+			{
+				e.HasTag = true;
+				e.Tag = std::move(tagArray[tagIndex++]);
+			}
+
+			if (maskArray[i] & ComponentTransform)
+			{
+				const TransformPOD& t = transformArray[transformIndex++];
+				e.HasTransform = true;
+				std::memcpy(&e.Translation[0], t.Translation, sizeof(t.Translation));
+				std::memcpy(&e.Rotation[0], t.Rotation, sizeof(t.Rotation));
+				std::memcpy(&e.Scale[0], t.Scale, sizeof(t.Scale));
+			}
+
+			if (maskArray[i] & ComponentCAD)
+			{
+				const CADParamsPOD& p = cadArray[cadIndex++];
+				e.HasCAD = true;
+				e.CADType = p.Type;
+				e.Width = p.Width;
+				e.Height = p.Height;
+				e.Depth = p.Depth;
+				e.Radius = p.Radius;
+				e.LinearDeflection = p.LinearDeflection;
+				if (p.BRepPath != NoPath)
+				{
+					if (p.BRepPath >= pathArray.size())
+					{
+						RONG_CORE_ERROR("Binary scene {0}: BRep path index {1} out of range", filepath, p.BRepPath);
+						return false;
+					}
+					e.BRepPath = pathArray[p.BRepPath];
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool SceneBinary::IsBinaryFile(const std::string& filepath)
+	{
+		std::ifstream in(filepath, std::ios::binary);
+		uint32_t magic = 0;
+		return in.read(reinterpret_cast<char*>(&magic), sizeof(magic)) && magic == FileMagic;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Rongine {
+
+	// 与文件格式无关的实体数据，YAML 和二进制格式共用 (只包含会被保存的字段)
+	struct EntityRecord
+	{
+		uint64_t ID = 0;
+
+		bool HasTag = false;
+		std::string Tag;
+
+		bool HasTransform = false;
+		glm::vec3 Translation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 Rotation = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
+
+		bool HasCAD = false;
+		int CADType = 0; // CADGeometryComponent::GeometryType
+		float Width = 1.0f, Height = 1.0f, Depth = 1.0f, Radius = 1.0f;
+		float LinearDeflection = 0.1f;
+		std::string BRepPath; // 导入/编辑过的形状另存的 BRep 文件，空 = 按参数重建
+	};
+
+	struct SceneRecord
+	{
+		std::string Name = "Untitled";
+		std::vector<EntityRecord> Entities;
+	};
+
+	// 分块二进制场景格式 (.rongb)，所有数值都是小端序
+	//
+	//   Header      Magic "RONB", 版本号, 块数量, 实体数量
+	//   ChunkTable  每块: 类型 (FourCC), 块版本, 偏移, 字节数, 元素个数
+	//   Chunks      每块按 8 字节对齐:
+	//     NAME  场景名
+	//     ENTS  组件表：每个实体一个 uint32 掩码 (Tag / Transform / CAD)
+	//     IDS   uint64[实体数]
+	//     TAGS  字符串表 (uint32 偏移[n + 1] + 字符)，只含有 Tag 的实体
+	//     XFRM  float[9] (平移/旋转/缩放)，只含有 Transform 的实体
+	//     CADP  CAD 参数结构体数组，只含有 CAD 组件的实体
+	//     PATH  BRep 路径字符串表 (CADP 里按下标引用)
+	//
+	// 加载时整个文件一次读入，POD 数组直接 memcpy；不认识的块跳过，文件版本比程序新时拒绝加载
+	class SceneBinary
+	{
+	public:
+		static constexpr uint32_t Version = 1;
+
+		static bool Write(const std::string& filepath, const SceneRecord& scene);
+		static bool Read(const std::string& filepath, SceneRecord& outScene);
+
+		// 按文件头判断 (不看扩展名)
+		static bool IsBinaryFile(const std::string& filepath);
+	};
+}
@@ -0,0 +1,388 @@
+#include "Rongpch.h"
+#include "SceneMeshCache.h"
+#include "Rongine/Core/Log.h"
+#include "Rongine/Utils/ProcessMemory.h"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+
+namespace Rongine {
+
+	static constexpr uint32_t CacheMagic = 0x4D4E4F52; // "RONM"
+
+	struct CacheHeader
+	{
+		uint32_t Magic = CacheMagic;
+		uint32_t Version = SceneMeshCache::Version;
+		uint32_t HeaderSize = sizeof(CacheHeader);
+		uint32_t EntryCount = 0;
+		uint64_t DataOffset = 0; // 数据区起点 (表之后，16 字节对齐)
+		uint64_t Reserved = 0;
+	};
+
+	struct CacheEntryPOD
+	{
+		uint64_t EntityID;
+		uint64_t ContentHash;
+		float Deflection;
+		uint32_t FaceCount;
+		uint32_t EdgeCount;
+		uint32_t Reserved;
+		float BoundsMin[3];
+		float BoundsMax[3];
+
+		// 相对文件开头的字节偏移 + 元素个数
+		uint64_t VertexOffset, IndexOffset, LineOffset, LineIndexOffset;
+		uint32_t VertexCount, IndexCount, LineCount, LineIndexCount;
+	};
+
+	static_assert(sizeof(CacheHeader) == 32 && sizeof(CacheEntryPOD) == 104, "Mesh cache layout changed");
+	static_assert(sizeof(CubeVertex) == 60 && sizeof(LineVertex) == 16, "Mesh cache vertex layout changed");
+
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	uint64_t SceneMeshCache::HashBytes(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::string SceneMeshCache::GetPath(const std::string& scenePath)
+	{
+		return std::filesystem::path(scenePath).replace_extension(".rongmesh").string();
+	}
+
+	// getEntry(i) 按需给出第 i 个条目 (排布和写出各调用一次)，性能测试可以不把整个文件的数据放在内存里
+	using EntrySource = std::function<const MeshCacheEntry&(size_t)>;
+
+	static bool WriteEntries(const std::string& filepath, size_t count, const EntrySource& getEntry)
+	{
+		// 1. 排布：表在前，数组按顺序放在数据区
+		CacheHeader header;
+		header.EntryCount = (uint32_t)count;
+		header.DataOffset = AlignUp(sizeof(CacheHeader) + count * sizeof(CacheEntryPOD), 16);
+
+		std::vector<CacheEntryPOD> table(count);
+		uint64_t cursor = header.DataOffset;
+		auto place = [&](uint64_t bytes) {
+			uint64_t offset = cursor;
+			cursor = AlignUp(cursor + bytes, 16);
+			return offset;
+		};
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const MeshCacheEntry& e = getEntry(i);
+			CacheEntryPOD& pod = table[i];
+			std::memset(&pod, 0, sizeof(pod));
+			pod.EntityID = e.EntityID;
+			pod.ContentHash = e.ContentHash;
+			pod.Deflection = e.Deflection;
+			pod.FaceCount = e.FaceCount;
+			pod.EdgeCount = e.EdgeCount;
+			std::memcpy(pod.BoundsMin, &e.BoundingBox.Min[0], sizeof(pod.BoundsMin));
+			std::memcpy(pod.BoundsMax, &e.BoundingBox.Max[0], sizeof(pod.BoundsMax));
+
+			pod.VertexCount = (uint32_t)e.Vertices.size();
+			pod.IndexCount = (uint32_t)e.Indices.size();
+			pod.LineCount = (uint32_t)e.Lines.size();
+			pod.LineIndexCount = (uint32_t)e.LineIndices.size();
+			pod.VertexOffset = place(e.Vertices.size() * sizeof(CubeVertex));
+			pod.IndexOffset = place(e.Indices.size() * sizeof(uint32_t));
+			pod.LineOffset = place(e.Lines.size() * sizeof(LineVertex));
+			pod.LineIndexOffset = place(e.LineIndices.size() * sizeof(uint32_t));
+		}
+
+		// 2. 顺序写出 (对齐空隙补 0)
+		std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			RONG_CORE_ERROR("Failed to write mesh cache: {0}", filepath);
+			return false;
+		}
+
+		uint64_t written = 0;
+		auto writeAt = [&](uint64_t offset, const void* data, uint64_t bytes) {
+			static const char zeros[16] = {};
+			while (written < offset)
+			{
+				uint64_t pad = std::min<uint64_t>(offset - written, sizeof(zeros));
+				out.write(zeros, (std::streamsize)pad);
+				written += pad;
+			}
+			if (bytes > 0) out.write(static_cast<const char*>(data), (std::streamsize)bytes);
+			written += bytes;
+		};
+
+		writeAt(0, &header, sizeof(header));
+		writeAt(sizeof(header), table.data(), table.size() * sizeof(CacheEntryPOD));
+		for (size_t i = 0; i < count; i++)
+		{
+			const MeshCacheEntry& e = getEntry(i);
+			const CacheEntryPOD& pod = table[i];
+			writeAt(pod.VertexOffset, e.Vertices.data(), e.Vertices.size() * sizeof(CubeVertex));
+			writeAt(pod.IndexOffset, e.Indices.data(), e.Indices.size() * sizeof(uint32_t));
+			writeAt(pod.LineOffset, e.Lines.data(), e.Lines.size() * sizeof(LineVertex));
+			writeAt(pod.LineIndexOffset, e.LineIndices.data(), e.LineIndices.size() * sizeof(uint32_t));
+		}
+
+		if (!out)
+		{
+			RONG_CORE_ERROR("Failed to write mesh cache: {0}", filepath);
+			return false;
+		}
+		return true;
+	}
+
+	bool SceneMeshCache::Write(const std::string& filepath, const std::vector<MeshCacheEntry>& entries)
+	{
+		// 旧文件可能还被已加载实体的网格映射着：写临时文件再整体替换
+		// (Linux 上旧映射继续指向原来的 inode；Windows 上旧文件仍被映射时替换会失败)
+		std::string tempPath = filepath + ".tmp";
+		if (!WriteEntries(tempPath, entries.size(), [&](size_t i) -> const MeshCacheEntry& { return entries[i]; }))
+			return false;
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, filepath, error);
+		if (error)
+		{
+			RONG_CORE_ERROR("Failed to replace mesh cache {0}: {1}", filepath, error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+		return true;
+	}
+
+	void SceneMeshCache::Clear()
+	{
+		m_Entries.clear();
+		m_File.reset();
+	}
+
+	bool SceneMeshCache::Load(const std::string& filepath)
+	{
+		Clear();
+
+		// 只建立映射，这里只会碰到文件头和条目表所在的页
+		m_File = MappedFile::Open(filepath);
+		if (!m_File || m_File->GetSize() < sizeof(CacheHeader))
+		{
+			Clear();
+			return false;
+		}
+		const uint8_t* data = m_File->GetData();
+		uint64_t fileBytes = m_File->GetSize();
+
+		CacheHeader header;
+		std::memcpy(&header, data, sizeof(header));
+		uint64_t tableEnd = (uint64_t)header.HeaderSize + (uint64_t)header.EntryCount * sizeof(CacheEntryPOD);
+		if (header.Magic != CacheMagic || header.Version != Version || header.HeaderSize < sizeof(CacheHeader) || tableEnd > fileBytes)
+		{
+			RONG_CORE_WARN("Mesh cache {0} is invalid or from another version, ignored", filepath);
+			Clear();
+			return false;
+		}
+
+		// 数组范围越界或没有对齐的条目直接丢弃 (按缓存未命中处理)
+		auto inRange = [&](uint64_t offset, uint64_t count, uint64_t stride) {
+			return offset % 4 == 0 && offset <= fileBytes && count * stride <= fileBytes - offset;
+		};
+
+		for (uint32_t i = 0; i < header.EntryCount; i++)
+		{
+			CacheEntryPOD pod;
+			std::memcpy(&pod, data + header.HeaderSize + i * sizeof(CacheEntryPOD), sizeof(pod));
+
+			if (!inRange(pod.VertexOffset, pod.VertexCount, sizeof(CubeVertex)) ||
+				!inRange(pod.IndexOffset, pod.IndexCount, sizeof(uint32_t)) ||
+				!inRange(pod.LineOffset, pod.LineCount, sizeof(LineVertex)) ||
+				!inRange(pod.LineIndexOffset, pod.LineIndexCount, sizeof(uint32_t)))
+			{
+				RONG_CORE_WARN("Mesh cache {0}: entry {1} out of range, ignored", filepath, pod.EntityID);
+				continue;
+			}
+
+			Entry entry;
+			entry.ContentHash = pod.ContentHash;
+			entry.Deflection = pod.Deflection;
+			MeshCacheView& view = entry.View;
+			view.Source = m_File;
+			view.FaceCount = pod.FaceCount;
+			view.EdgeCount = pod.EdgeCount;
+			std::memcpy(&view.BoundingBox.Min[0], pod.BoundsMin, sizeof(pod.BoundsMin));
+			std::memcpy(&view.BoundingBox.Max[0], pod.BoundsMax, sizeof(pod.BoundsMax));
+			view.Vertices = reinterpret_cast<const CubeVertex*>(data + pod.VertexOffset);
+			view.VertexCount = pod.VertexCount;
+			view.Indices = reinterpret_cast<const uint32_t*>(data + pod.IndexOffset);
+			view.IndexCount = pod.IndexCount;
+			view.Lines = reinterpret_cast<const LineVertex*>(data + pod.LineOffset);
+			view.LineCount = pod.LineCount;
+			view.LineIndices = reinterpret_cast<const uint32_t*>(data + pod.LineIndexOffset);
+			view.LineIndexCount = pod.LineIndexCount;
+
+			m_Entries[pod.EntityID] = entry;
+		}
+
+		return true;
+	}
+
+	bool SceneMeshCache::Find(uint64_t entityID, uint64_t contentHash, float deflection, MeshCacheView& outView) const
+	{
+		auto it = m_Entries.find(entityID);
+		if (it == m_Entries.end()) return false;
+		// 精度经过 YAML 文本往返可能有末位误差
+		float tolerance = 1e-6f * std::max(std::abs(deflection), std::abs(it->second.Deflection));
+		if (it->second.ContentHash != contentHash || std::abs(it->second.Deflection - deflection) > tolerance) return false;
+
+		outView = it->second.View;
+		return true;
+	}
+
+	void SceneMeshCache::BenchmarkLoad(uint64_t targetBytes)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedMs = [](Clock::time_point a, Clock::time_point b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+		auto toMB = [](uint64_t bytes) { return (double)bytes / (1024.0 * 1024.0); };
+
+		// 1. 生成缓存文件：所有条目内容相同 (约 1 MB)，只有实体 ID 不同，内存里只放一份
+		MeshCacheEntry entry;
+		entry.ContentHash = 0x9E3779B97F4A7C15ull;
+		entry.Deflection = 0.1f;
+		entry.FaceCount = 64;
+		const uint32_t vertexCount = 12000;
+		entry.Vertices.resize(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			CubeVertex& vertex = entry.Vertices[v];
+			std::memset(&vertex, 0, sizeof(vertex));
+			vertex.Position = { (float)(v % 100), (float)(v / 100), (float)(v % 7) };
+			vertex.Normal = { 0.0f, 0.0f, 1.0f };
+			vertex.FaceID = (int)(v * entry.FaceCount / vertexCount);
+		}
+		for (uint32_t v = 0; v + 2 < vertexCount; v++)
+		{
+			entry.Indices.push_back(v);
+			entry.Indices.push_back(v + 1);
+			entry.Indices.push_back(v + 2);
+		}
+		entry.BoundingBox.Min = glm::vec3(0.0f);
+		entry.BoundingBox.Max = glm::vec3(100.0f, 120.0f, 7.0f);
+
+		uint64_t entryBytes = entry.Vertices.size() * sizeof(CubeVertex) + entry.Indices.size() * sizeof(uint32_t);
+		size_t entryCount = (size_t)std::max<uint64_t>(1, targetBytes / entryBytes);
+
+		std::string filepath = (std::filesystem::temp_directory_path() / "rongine_benchmark.rongmesh").string();
+		auto w0 = Clock::now();
+		bool written = WriteEntries(filepath, entryCount, [&](size_t i) -> const MeshCacheEntry& {
+			entry.EntityID = i + 1;
+			return entry;
+		});
+		auto w1 = Clock::now();
+		if (!written) return;
+
+		uint64_t fileBytes = std::filesystem::file_size(filepath);
+		RONG_CORE_INFO("Mesh Cache Load Benchmark: {0} Entries, {1:.1f} MB, written in {2:.1f} ms", entryCount, toMB(fileBytes), elapsedMs(w0, w1));
+
+		bool cold = MappedFile::DropPageCache(filepath);
+		if (!cold)
+			RONG_CORE_WARN("  Page cache could not be dropped, loads below are warm");
+
+		// 之后的读取都把所有顶点/索引扫一遍 (相当于 GPU 上传/BVH 构建)，结果用来防止被优化掉
+		auto touch = [](const CubeVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+			double sum = 0.0;
+			for (size_t v = 0; v < vertexCount; v++) sum += vertices[v].Position.x;
+			for (size_t i = 0; i < indexCount; i++) sum += indices[i];
+			return sum;
+		};
+
+		// 2. 原来的方式：整个文件读进内存，每个实体再复制一份到自己的数组
+		//    复制期间文件缓冲和副本同时存在 (峰值约为文件大小的两倍)，复制完先释放文件缓冲再扫描
+		{
+			ProcessMemory::PageFaults f0 = ProcessMemory::GetPageFaults();
+			uint64_t resident0 = ProcessMemory::GetResidentBytes();
+			auto t0 = Clock::now();
+
+			std::vector<uint8_t> file((size_t)fileBytes);
+			std::ifstream in(filepath, std::ios::binary);
+			in.read(reinterpret_cast<char*>(file.data()), (std::streamsize)fileBytes);
+			auto t1 = Clock::now();
+
+			std::vector<std::vector<CubeVertex>> vertexCopies(entryCount);
+			std::vector<std::vector<uint32_t>> indexCopies(entryCount);
+			for (size_t i = 0; i < entryCount; i++)
+			{
+				CacheEntryPOD pod;
+				std::memcpy(&pod, file.data() + sizeof(CacheHeader) + i * sizeof(CacheEntryPOD), sizeof(pod));
+				const CubeVertex* vertices = reinterpret_cast<const CubeVertex*>(file.data() + pod.VertexOffset);
+				const uint32_t* indices = reinterpret_cast<const uint32_t*>(file.data() + pod.IndexOffset);
+				vertexCopies[i].assign(vertices, vertices + pod.VertexCount);
+				indexCopies[i].assign(indices, indices + pod.IndexCount);
+			}
+			auto t2 = Clock::now();
+			uint64_t residentCopy = ProcessMemory::GetResidentBytes();
+			std::vector<uint8_t>().swap(file);
+
+			double sum = 0.0;
+			for (size_t i = 0; i < entryCount; i++)
+				sum += touch(vertexCopies[i].data(), vertexCopies[i].size(), indexCopies[i].data(), indexCopies[i].size());
+			auto t3 = Clock::now();
+
+			ProcessMemory::PageFaults f1 = ProcessMemory::GetPageFaults();
+			uint64_t resident1 = ProcessMemory::GetResidentBytes();
+			RONG_CORE_INFO("  Read + Copy: read {0:.1f} ms, copy {1:.1f} ms, scan {2:.1f} ms, faults {3} minor / {4} major, resident +{5:.1f} MB while copying (file + copies), +{6:.1f} MB after releasing the file ({7})",
+				elapsedMs(t0, t1), elapsedMs(t1, t2), elapsedMs(t2, t3), f1.Minor - f0.Minor, f1.Major - f0.Major,
+				toMB(residentCopy > resident0 ? residentCopy - resident0 : 0), toMB(resident1 > resident0 ? resident1 - resident0 : 0), sum);
+		}
+
+		if (cold) MappedFile::DropPageCache(filepath);
+
+		// 3. 映射：Load 只读文件头和条目表，实体直接引用映射里的数组，扫描时才按页读入
+		{
+			ProcessMemory::PageFaults f0 = ProcessMemory::GetPageFaults();
+			uint64_t resident0 = ProcessMemory::GetResidentBytes();
+			auto t0 = Clock::now();
+
+			SceneMeshCache cache;
+			cache.Load(filepath);
+			std::vector<MeshArray<CubeVertex>> vertexViews;
+			std::vector<MeshArray<uint32_t>> indexViews;
+			vertexViews.reserve(entryCount);
+			indexViews.reserve(entryCount);
+			for (size_t i = 0; i < entryCount; i++)
+			{
+				MeshCacheView view;
+				if (!cache.Find(i + 1, entry.ContentHash, entry.Deflection, view)) continue;
+				vertexViews.emplace_back(view.Vertices, view.VertexCount, view.Source);
+				indexViews.emplace_back(view.Indices, view.IndexCount, view.Source);
+			}
+			auto t1 = Clock::now();
+			ProcessMemory::PageFaults fLoad = ProcessMemory::GetPageFaults();
+
+			double sum = 0.0;
+			for (size_t i = 0; i < vertexViews.size(); i++)
+				sum += touch(vertexViews[i].data(), vertexViews[i].size(), indexViews[i].data(), indexViews[i].size());
+			auto t2 = Clock::now();
+
+			ProcessMemory::PageFaults f1 = ProcessMemory::GetPageFaults();
+			uint64_t resident1 = ProcessMemory::GetResidentBytes();
+			RONG_CORE_INFO("  Mapped: load {0:.1f} ms ({1} minor / {2} major faults), scan {3:.1f} ms ({4} minor / {5} major faults), resident +{6:.1f} MB ({7})",
+				elapsedMs(t0, t1), fLoad.Minor - f0.Minor, fLoad.Major - f0.Major, elapsedMs(t1, t2), f1.Minor - fLoad.Minor, f1.Major - fLoad.Major,
+				toMB(resident1 > resident0 ? resident1 - resident0 : 0), sum);
+		}
+
+		std::error_code error;
+		std::filesystem::remove(filepath, error);
+	}
+}
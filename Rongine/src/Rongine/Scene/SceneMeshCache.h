@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Rongine/Renderer/RenderTypes.h"
+#include "Rongine/Scene/Components.h"
+#include "Rongine/Utils/MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Rongine {
+
+	// 一个实体的网格缓存 (保存时填写)
+	struct MeshCacheEntry
+	{
+		uint64_t EntityID = 0;
+		uint64_t ContentHash = 0;  // BRep 文件内容 (参数化物体为参数) 的哈希
+		float Deflection = 0.0f;   // 离散精度，和 ContentHash 一起决定缓存是否有效
+		uint32_t FaceCount = 0;    // 拓扑面/边数量，加载时再核对一次
+		uint32_t EdgeCount = 0;
+		AABB BoundingBox;
+
+		// FaceID / EdgeID 按形状自身的拓扑顺序 (TopologyIndex(shape)) 编号，重新加载的形状直接对得上
+		std::vector<CubeVertex> Vertices;
+		std::vector<uint32_t> Indices;
+		std::vector<LineVertex> Lines;
+		std::vector<uint32_t> LineIndices;
+	};
+
+	// 加载后的只读视图，指向映射的缓存文件内部；Source 保证映射在使用期间有效
+	struct MeshCacheView
+	{
+		Ref<MappedFile> Source;
+		uint32_t FaceCount = 0;
+		uint32_t EdgeCount = 0;
+		AABB BoundingBox;
+
+		const CubeVertex* Vertices = nullptr;
+		uint32_t VertexCount = 0;
+		const uint32_t* Indices = nullptr;
+		uint32_t IndexCount = 0;
+		const LineVertex* Lines = nullptr;
+		uint32_t LineCount = 0;
+		const uint32_t* LineIndices = nullptr;
+		uint32_t LineIndexCount = 0;
+	};
+
+	// 场景网格缓存 (.rongmesh)：保存场景时把每个 CAD 实体已有的 CPU 网格 (三角形 + 边框线) 写到场景文件旁边
+	// 加载时形状内容哈希和精度都对得上的实体直接用缓存建 GPU 缓冲，跳过 OCCT 离散化
+// 文件整体只读映射，实体的顶点/索引直接引用映射里的数组 (MeshArray)，没有用到的页不会读入内存
+	//
+	//   Header   Magic "RONM", 版本号, 条目数
+	//   Table    每个条目: 实体 ID, 内容哈希, 精度, 拓扑数量, 包围盒, 四个数组的偏移和长度
+	//   Data     顶点 (CubeVertex) / 索引 / 线顶点 (LineVertex) / 线索引，每个数组 16 字节对齐，小端序
+	class SceneMeshCache
+	{
+	public:
+		static constexpr uint32_t Version = 1;
+
+		// 场景文件旁的同名 .rongmesh
+		static std::string GetPath(const std::string& scenePath);
+
+		// 先写到临时文件再替换，正在被映射的旧文件不会被截断
+		static bool Write(const std::string& filepath, const std::vector<MeshCacheEntry>& entries);
+
+		// 映射文件并建立实体 ID 索引 (只读文件头和条目表)，文件不存在或损坏时返回 false (缓存为空)
+		bool Load(const std::string& filepath);
+		void Clear();
+
+		// 实体 ID、内容哈希和精度都一致时返回视图，否则返回 false
+		bool Find(uint64_t entityID, uint64_t contentHash, float deflection, MeshCacheView& outView) const;
+
+		size_t GetEntryCount() const { return m_Entries.size(); }
+		uint64_t GetFileSize() const { return m_File ? m_File->GetSize() : 0; }
+
+		// FNV-1a，用于计算内容哈希
+		static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+		// 生成约 targetBytes 的缓存文件，对比整体读入 + 复制和映射两种加载方式的耗时、缺页次数和常驻内存
+		// 每轮之前把文件从页缓存中丢掉 (Linux)，测的是冷加载；读入 + 复制那一轮的峰值内存约为 targetBytes 的两倍
+		static void BenchmarkLoad(uint64_t targetBytes = 2ull << 30);
+
+	private:
+		struct Entry
+		{
+			uint64_t ContentHash = 0;
+			float Deflection = 0.0f;
+			MeshCacheView View;
+		};
+
+		Ref<MappedFile> m_File;
+		std::unordered_map<uint64_t, Entry> m_Entries;
+	};
+}
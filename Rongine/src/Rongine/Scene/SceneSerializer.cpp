@@ -1,5 +1,7 @@
 #include "Rongpch.h"
 #include "SceneSerializer.h"
+#include "SceneBinary.h"
+#include "SceneMeshCache.h"
 
 #include "Rongine/Scene/Entity.h"
 #include "Rongine/Scene/Components.h"
@@ -8,6 +10,9 @@
 #include "Rongine/CAD/CADModeler.h"
 #include "Rongine/CAD/CADMesher.h"
 #include "Rongine/CAD/CADImporter.h"
+#include "Rongine/CAD/ShapeStore.h"
+#include "Rongine/CAD/MeshJobSystem.h"
+#include "Rongine/Utils/ProcessMemory.h"
 #include <TopoDS_Shape.hxx> 
 
 #include <BRepTools.hxx> // OCCT BRep 读写工具
@@ -15,6 +20,8 @@
 
 #include <yaml-cpp/yaml.h>
 #include <fstream>
+#include <chrono>
+#include <execution>
 
 namespace YAML {
 
@@ -96,91 +103,210 @@ namespace Rongine {
 	}
 
 	// =============================================================
-	// 核心保存逻辑：序列化单个实体
+	// 核心保存逻辑：把单个实体整理成与格式无关的记录
 	// =============================================================
-	static void SerializeEntity(YAML::Emitter& out, Entity entity)
+	static EntityRecord MakeEntityRecord(Entity entity)
 	{
-		// 检查实体有效性
-		if (!entity.HasComponent<IDComponent>()) // 假设你有 IDComponent，如果没有请用 uint32_t 强转
-		{
-			// 如果没有 ID 组件，至少确保它是个有效实体
-		}
+		EntityRecord record;
 
-		out << YAML::BeginMap; // Entity Start
-
-		// 序列化实体 ID (如果你还没有 IDComponent，这里简单转成整数存一下，虽然加载时不一定能复原同一个ID)
-		out << YAML::Key << "Entity" << YAML::Value << (uint64_t)(uint32_t)entity;
+		// 实体 ID：有 IDComponent 时用它 (加载时原样恢复)，否则退回句柄
+		record.ID = entity.HasComponent<IDComponent>() ? entity.GetComponent<IDComponent>().ID : (uint64_t)(uint32_t)entity;
 
 		// 1. Tag 组件 (名字)
 		if (entity.HasComponent<TagComponent>())
 		{
-			out << YAML::Key << "TagComponent";
-			out << YAML::BeginMap; // TagComponent Map
-
-			auto& tag = entity.GetComponent<TagComponent>().Tag;
-			out << YAML::Key << "Tag" << YAML::Value << tag;
-
-			out << YAML::EndMap; // TagComponent Map
+			record.HasTag = true;
+			record.Tag = entity.GetComponent<TagComponent>().Tag;
 		}
 
 		// 2. Transform 组件 (变换)
 		if (entity.HasComponent<TransformComponent>())
 		{
-			out << YAML::Key << "TransformComponent";
-			out << YAML::BeginMap; // TransformComponent Map
-
 			auto& tc = entity.GetComponent<TransformComponent>();
-			out << YAML::Key << "Translation" << YAML::Value << tc.Translation;
-			out << YAML::Key << "Rotation" << YAML::Value << tc.Rotation;
-			out << YAML::Key << "Scale" << YAML::Value << tc.Scale;
-
-			out << YAML::EndMap; // TransformComponent Map
+			record.HasTransform = true;
+			record.Translation = tc.Translation;
+			record.Rotation = tc.Rotation;
+			record.Scale = tc.Scale;
 		}
 
 		// 3. CAD Geometry 组件 (核心)
 		if (entity.HasComponent<CADGeometryComponent>())
 		{
-			out << YAML::Key << "CADGeometryComponent";
-			out << YAML::BeginMap; // CADGeometryComponent Map
-
 			auto& cadComp = entity.GetComponent<CADGeometryComponent>();
+			record.HasCAD = true;
+			record.CADType = (int)cadComp.Type;
+			record.Width = cadComp.Params.Width;
+			record.Height = cadComp.Params.Height;
+			record.Depth = cadComp.Params.Depth;
+			record.Radius = cadComp.Params.Radius;
+			record.LinearDeflection = cadComp.LinearDeflection;
+
+			// 导入/编辑过的形状存进按内容寻址的 BRep 仓库 (没改过的形状不会重新写)
+			bool needsBRepSave = (cadComp.Type == CADGeometryComponent::GeometryType::Imported);
+			if (needsBRepSave && cadComp.ShapeHandle)
+			{
+				TopoDS_Shape* shape = (TopoDS_Shape*)cadComp.ShapeHandle;
+				record.BRepPath = ShapeStore::Put(*shape);
+			}
+		}
 
-			// 保存类型 (转为 int 存储)
-			out << YAML::Key << "Type" << YAML::Value << (int)cadComp.Type;
+		return record;
+	}
 
-			// 保存参数
-			out << YAML::Key << "Params" << YAML::BeginMap;
-			out << YAML::Key << "Width" << YAML::Value << cadComp.Params.Width;
-			out << YAML::Key << "Height" << YAML::Value << cadComp.Params.Height;
-			out << YAML::Key << "Depth" << YAML::Value << cadComp.Params.Depth;
-			out << YAML::Key << "Radius" << YAML::Value << cadComp.Params.Radius;
-			out << YAML::Key << "LinearDeflection" << YAML::Value << cadComp.LinearDeflection;
-			out << YAML::EndMap; // Params Map
+	// 网格缓存的有效性依据：BRep 文件内容 (参数化物体用类型和参数)，离散精度另外比较
+	// brepBytes 是已经读入的 BRep 文件内容 (没有 BRep 路径或在 BRep 仓库里时不用)
+	static uint64_t ComputeContentHash(const EntityRecord& record, const std::string& brepBytes)
+	{
+		uint64_t hash = SceneMeshCache::HashBytes(&record.CADType, sizeof(record.CADType));
 
-			bool needsBRepSave = (cadComp.Type == CADGeometryComponent::GeometryType::Imported);
+		// 仓库的文件名就是内容哈希，不用再读文件
+		if (ShapeStore::IsStorePath(record.BRepPath))
+		{
+			std::string key = std::filesystem::path(record.BRepPath).filename().string();
+			return SceneMeshCache::HashBytes(key.data(), key.size(), hash);
+		}
+		if (!record.BRepPath.empty())
+			return SceneMeshCache::HashBytes(brepBytes.data(), brepBytes.size(), hash);
 
-			std::string brepFileName = "";
+		float params[4] = { record.Width, record.Height, record.Depth, record.Radius };
+		return SceneMeshCache::HashBytes(params, sizeof(params), hash);
+	}
 
-			if (needsBRepSave && cadComp.ShapeHandle)
-			{
-				uint64_t uuid = entity.GetComponent<IDComponent>().ID; 
+	static uint64_t ComputeContentHash(const EntityRecord& record)
+	{
+		std::string bytes;
+		if (!record.BRepPath.empty() && !ShapeStore::IsStorePath(record.BRepPath))
+		{
+			std::ifstream in(record.BRepPath, std::ios::binary);
+			bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		}
+		return ComputeContentHash(record, bytes);
+	}
 
-				// 构造相对路径
-				brepFileName = "assets/cache/" + std::to_string(uuid) + ".brep";
+	// 把实体当前的 CPU 网格整理成缓存条目，网格还没生成 (后台任务未完成) 或已经过期时返回 false
+	static bool MakeMeshCacheEntry(Entity entity, const EntityRecord& record, MeshCacheEntry& out)
+	{
+		if (!record.HasCAD || !entity.HasComponent<MeshComponent>())
+			return false;
 
-				// 确保目录存在
-				std::filesystem::create_directories("assets/cache");
+		auto& cad = entity.GetComponent<CADGeometryComponent>();
+		auto& mesh = entity.GetComponent<MeshComponent>();
+		TopoDS_Shape* shape = static_cast<TopoDS_Shape*>(cad.ShapeHandle);
+		if (!shape || shape->IsNull() || mesh.MeshPending || mesh.LocalVertices.empty())
+			return false;
+		if (cad.Topology && !cad.Topology->IsBuiltFrom(*shape))
+			return false;
 
-				// 调用 OCCT 保存文件
-				TopoDS_Shape* shape = (TopoDS_Shape*)cadComp.ShapeHandle;
-				if (!BRepTools::Write(*shape, brepFileName.c_str()))
-				{
-					RONG_CORE_ERROR("Failed to write BRep file: {0}", brepFileName);
-				}
+		// 加载时形状是从 BRep 重新读入/按参数重建的，拓扑顺序和 TopologyIndex(shape) 相同
+		TopologyIndex ordered(*shape);
+		out.EntityID = record.ID;
+		out.ContentHash = ComputeContentHash(record);
+		out.Deflection = record.LinearDeflection;
+		out.FaceCount = (uint32_t)ordered.GetFaceCount();
+		out.EdgeCount = (uint32_t)ordered.GetEdgeCount();
+		out.BoundingBox = mesh.BoundingBox;
+		out.Vertices.assign(mesh.LocalVertices.begin(), mesh.LocalVertices.end());
+		out.Indices.assign(mesh.LocalIndices.begin(), mesh.LocalIndices.end());
+		out.Lines = mesh.LocalLines;
+		out.LineIndices = mesh.LocalLineIndices;
+
+		// 组件上的索引表延续过建模操作前的 ID 时，把网格里的 FaceID/EdgeID 换成形状自身的顺序
+		if (cad.Topology)
+		{
+			const TopologyIndex& carried = *cad.Topology;
+			std::vector<int> faceMap(carried.GetFaceCount()), edgeMap(carried.GetEdgeCount());
+			bool identity = true;
+			for (int id = 0; id < (int)faceMap.size(); id++)
+			{
+				faceMap[id] = ordered.FindFace(carried.GetFace(id));
+				identity &= faceMap[id] == id;
 			}
+			for (int id = 0; id < (int)edgeMap.size(); id++)
+			{
+				edgeMap[id] = ordered.FindEdge(carried.GetEdge(id));
+				identity &= edgeMap[id] == id;
+			}
+
+			if (!identity)
+			{
+				for (auto& v : out.Vertices)
+					if (v.FaceID >= 0 && v.FaceID < (int)faceMap.size()) v.FaceID = faceMap[v.FaceID];
+				for (auto& line : out.Lines)
+					if (line.EntityID >= 0 && line.EntityID < (int)edgeMap.size()) line.EntityID = edgeMap[line.EntityID];
+			}
+		}
+		return true;
+	}
+
+	// outMeshes 非空时同时收集网格缓存条目
+	static SceneRecord MakeSceneRecord(Scene* scene, std::vector<MeshCacheEntry>* outMeshes = nullptr)
+	{
+		// 后台网格任务会往组件形状上写三角网格和边的曲线表，而 ShapeStore::Put 要遍历同一个形状
+		// 先等任务全部完成并装进组件，网格缓存也能把刚生成的网格一起写出
+		MeshJobSystem::WaitAll();
+		MeshJobSystem::Update(scene);
+
+		SceneRecord record;
+		scene->getRegistry().each([&](auto entityID)
+			{
+				Entity entity = { entityID, scene };
+				if (!entity)
+					return;
+
+				record.Entities.push_back(MakeEntityRecord(entity));
+
+				MeshCacheEntry mesh;
+				if (outMeshes && MakeMeshCacheEntry(entity, record.Entities.back(), mesh))
+					outMeshes->push_back(std::move(mesh));
+			});
+		return record;
+	}
+
+	// =============================================================
+	// YAML 读写
+	// =============================================================
+	static void EmitEntity(YAML::Emitter& out, const EntityRecord& record)
+	{
+		out << YAML::BeginMap; // Entity Start
+		out << YAML::Key << "Entity" << YAML::Value << record.ID;
+
+		if (record.HasTag)
+		{
+			out << YAML::Key << "TagComponent";
+			out << YAML::BeginMap;
+			out << YAML::Key << "Tag" << YAML::Value << record.Tag;
+			out << YAML::EndMap;
+		}
+
+		if (record.HasTransform)
+		{
+			out << YAML::Key << "TransformComponent";
+			out << YAML::BeginMap;
+			out << YAML::Key << "Translation" << YAML::Value << record.Translation;
+			out << YAML::Key << "Rotation" << YAML::Value << record.Rotation;
+			out << YAML::Key << "Scale" << YAML::Value << record.Scale;
+			out << YAML::EndMap;
+		}
+
+		if (record.HasCAD)
+		{
+			out << YAML::Key << "CADGeometryComponent";
+			out << YAML::BeginMap;
+
+			// 保存类型 (转为 int 存储)
+			out << YAML::Key << "Type" << YAML::Value << record.CADType;
+
+			// 保存参数
+			out << YAML::Key << "Params" << YAML::BeginMap;
+			out << YAML::Key << "Width" << YAML::Value << record.Width;
+			out << YAML::Key << "Height" << YAML::Value << record.Height;
+			out << YAML::Key << "Depth" << YAML::Value << record.Depth;
+			out << YAML::Key << "Radius" << YAML::Value << record.Radius;
+			out << YAML::Key << "LinearDeflection" << YAML::Value << record.LinearDeflection;
+			out << YAML::EndMap; // Params Map
 
 			// 将路径写入 YAML
-			out << YAML::Key << "BRepPath" << YAML::Value << brepFileName;
+			out << YAML::Key << "BRepPath" << YAML::Value << record.BRepPath;
 
 			out << YAML::EndMap; // CADGeometryComponent Map
 		}
@@ -188,36 +314,23 @@ namespace Rongine {
 		out << YAML::EndMap; // Entity End
 	}
 
-	// =============================================================
-	// 保存整个场景
-	// =============================================================
-	void SceneSerializer::Serialize(const std::string& filepath)
+	static bool WriteYAML(const std::string& filepath, const SceneRecord& scene)
 	{
 		YAML::Emitter out;
 		out << YAML::BeginMap;
-		out << YAML::Key << "Scene" << YAML::Value << "Untitled";
+		out << YAML::Key << "Scene" << YAML::Value << scene.Name;
 		out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
-
-		m_Context->getRegistry().each([&](auto entityID)
-			{
-				Entity entity = { entityID, m_Context.get() };
-				if (!entity)
-					return;
-
-				SerializeEntity(out, entity);
-			});
-
+		for (const auto& record : scene.Entities)
+			EmitEntity(out, record);
 		out << YAML::EndSeq;
 		out << YAML::EndMap;
 
 		std::ofstream fout(filepath);
 		fout << out.c_str();
+		return (bool)fout;
 	}
 
-	// =============================================================
-	// 核心加载逻辑：从文件读取并重建场景
-	// =============================================================
-	bool SceneSerializer::Deserialize(const std::string& filepath)
+	static bool ReadYAML(const std::string& filepath, SceneRecord& outScene)
 	{
 		std::ifstream stream(filepath);
 		std::stringstream strStream;
@@ -227,137 +340,713 @@ namespace Rongine {
 		if (!data["Scene"])
 			return false;
 
-		std::string sceneName = data["Scene"].as<std::string>();
-		RONG_CORE_TRACE("Deserializing scene '{0}'", sceneName);
+		outScene.Name = data["Scene"].as<std::string>();
+		outScene.Entities.clear();
 
 		auto entities = data["Entities"];
-		if (entities)
+		if (!entities)
+			return true;
+
+		outScene.Entities.reserve(entities.size());
+		for (auto entity : entities)
 		{
-			for (auto entity : entities)
+			EntityRecord record;
+			record.ID = entity["Entity"].as<uint64_t>();
+
+			auto tagComponent = entity["TagComponent"];
+			if (tagComponent)
+			{
+				record.HasTag = true;
+				record.Tag = tagComponent["Tag"].as<std::string>();
+			}
+
+			auto transformComponent = entity["TransformComponent"];
+			if (transformComponent)
 			{
-				uint64_t uuid = entity["Entity"].as<uint64_t>();
+				record.HasTransform = true;
+				record.Translation = transformComponent["Translation"].as<glm::vec3>();
+				record.Rotation = transformComponent["Rotation"].as<glm::vec3>();
+				record.Scale = transformComponent["Scale"].as<glm::vec3>();
+			}
 
-				// 1. 读取名字并创建实体
-				std::string name;
-				auto tagComponent = entity["TagComponent"];
-				if (tagComponent)
-					name = tagComponent["Tag"].as<std::string>();
+			auto cadComponent = entity["CADGeometryComponent"];
+			if (cadComponent)
+			{
+				record.HasCAD = true;
+				record.CADType = cadComponent["Type"].as<int>();
+				auto params = cadComponent["Params"];
+				record.Width = params["Width"].as<float>();
+				record.Height = params["Height"].as<float>();
+				record.Depth = params["Depth"].as<float>();
+				record.Radius = params["Radius"].as<float>();
+				if (params["LinearDeflection"])
+					record.LinearDeflection = params["LinearDeflection"].as<float>();
+				if (cadComponent["BRepPath"])
+					record.BRepPath = cadComponent["BRepPath"].as<std::string>();
+			}
 
-				Entity deserializedEntity = m_Context->createEntity(name);
-				if (deserializedEntity.HasComponent<IDComponent>())
-					deserializedEntity.GetComponent<IDComponent>().ID = uuid; // 恢复 UUID
+			outScene.Entities.push_back(std::move(record));
+		}
+		return true;
+	}
 
-				RONG_CORE_TRACE("Deserialized entity '{0}' (UUID: {1})", name, uuid);
+	// 按扩展名选择格式
+	static bool IsBinaryPath(const std::string& filepath)
+	{
+		std::string extension = std::filesystem::path(filepath).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		return extension == ".rongb";
+	}
 
-				// 2. 加载 Transform
-				auto transformComponent = entity["TransformComponent"];
-				if (transformComponent)
-				{
-					auto& tc = deserializedEntity.GetComponent<TransformComponent>();
-					tc.Translation = transformComponent["Translation"].as<glm::vec3>();
-					tc.Rotation = transformComponent["Rotation"].as<glm::vec3>();
-					tc.Scale = transformComponent["Scale"].as<glm::vec3>();
-				}
+	// =============================================================
+	// 核心加载逻辑：流水线
+	//   1. 解析实体表 (ReadYAML / SceneBinary::Read)，得到 SceneRecord
+	//   2. 工作线程：读 BRep (或按参数建模)、建拓扑索引表、查网格缓存，未命中的离散化并提取边框线
+	//   3. 主线程：按记录顺序创建实体和组件，上传 GPU 缓冲 (结果与串行加载完全相同)
+	// =============================================================
+	struct RestoreContext
+	{
+		bool RebuildGeometry = true;
+		bool CreateGPUResources = true; // 关闭时不创建 VertexArray (没有 GL 上下文)
+		bool Parallel = true;
+		const SceneMeshCache* MeshCache = nullptr;
+
+		// 各阶段耗时 (ms)；Read/Mesh 是所有工作线程的累计
+		double ParseMs = 0.0, CacheMs = 0.0, PrepareMs = 0.0, ReadMs = 0.0, MeshMs = 0.0, EntityMs = 0.0, UploadMs = 0.0;
+		uint32_t Shapes = 0;
+		uint32_t CacheHits = 0;
+		uint32_t CacheMisses = 0;
+	};
+
+	// 第 2 步的结果，工作线程只写自己的这一份，不碰 registry 和 GL
+	struct PreparedGeometry
+	{
+		TopoDS_Shape* Shape = nullptr; // 装到组件之前由这里持有
+		Ref<TopologyIndex> Topology;
+
+		bool FromCache = false;
+		MeshCacheView Cached;
+
+		std::vector<CubeVertex> Vertices;
+		std::vector<uint32_t> Indices;
+		std::vector<LineVertex> Lines;
+		std::vector<uint32_t> LineIndices;
+		AABB BoundingBox;
+
+		double ReadMs = 0.0;
+		double MeshMs = 0.0;
+	};
+
+	using LoadClock = std::chrono::high_resolution_clock;
+
+	static double ElapsedMs(LoadClock::time_point a, LoadClock::time_point b)
+	{
+		return std::chrono::duration<double, std::milli>(b - a).count();
+	}
+
+	// 工作线程：准备一个 CAD 实体的形状和网格
+	static void PrepareGeometry(const EntityRecord& record, const SceneMeshCache* cache, PreparedGeometry& out)
+	{
+		auto t0 = LoadClock::now();
+
+		// A. 优先从文件加载 (针对拉伸、布尔运算后的物体)；文件只读一次，内容同时用于缓存哈希
+		std::string brepBytes;
+		// 仓库文件被其它场景保存时移进了隔离区 (这个场景是编辑器外复制的，没有自己的清单) 就先移回来
+		if (!record.BRepPath.empty() && ShapeStore::Restore(record.BRepPath))
+		{
+			std::ifstream in(record.BRepPath, std::ios::binary);
+			brepBytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+			TopoDS_Shape shape;
+			if (ShapeStore::Parse(record.BRepPath, brepBytes, shape))
+			{
+				out.Shape = new TopoDS_Shape(shape);
+				ShapeStore::Remember(shape, record.BRepPath); // 没改动的话下次保存直接用这个文件
+			}
+			else
+			{
+				RONG_CORE_ERROR("Failed to load BRep file: {0}", record.BRepPath);
+			}
+		}
 
-				// 3. 加载 CAD 组件并现场重建 (Rebuild)
-				auto cadComponent = entity["CADGeometryComponent"];
-				if (cadComponent)
+		// 如果没从磁盘加载 (说明是纯参数化物体，或者文件丢失)，则尝试参数化重建
+		if (!out.Shape)
+		{
+			switch ((CADGeometryComponent::GeometryType)record.CADType)
+			{
+			case CADGeometryComponent::GeometryType::Cube:
+				out.Shape = static_cast<TopoDS_Shape*>(CADModeler::MakeCube(record.Width, record.Height, record.Depth));
+				break;
+			case CADGeometryComponent::GeometryType::Sphere:
+				out.Shape = static_cast<TopoDS_Shape*>(CADModeler::MakeSphere(record.Radius));
+				break;
+			case CADGeometryComponent::GeometryType::Cylinder:
+				out.Shape = static_cast<TopoDS_Shape*>(CADModeler::MakeCylinder(record.Radius, record.Height));
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (!out.Shape)
+			return;
+
+		out.Topology = CreateRef<TopologyIndex>(*out.Shape);
+		auto t1 = LoadClock::now();
+		out.ReadMs = ElapsedMs(t0, t1);
+
+		// B. 网格缓存命中 (拓扑数量也要对得上，BRep 读入失败后按参数重建等情况不能用)：跳过离散化
+		if (cache && cache->Find(record.ID, ComputeContentHash(record, brepBytes), record.LinearDeflection, out.Cached) &&
+			(uint32_t)out.Topology->GetFaceCount() == out.Cached.FaceCount && (uint32_t)out.Topology->GetEdgeCount() == out.Cached.EdgeCount)
+		{
+			out.FromCache = true;
+			return;
+		}
+
+		// C. 重新生成网格 (Mesh + Edge)
+		// 并行在实体之间展开，单个形状内部串行；不进面缓存 (它的锁会让所有工作线程排队)
+		CADMesher::BuildMeshData(*out.Topology, out.Vertices, out.Indices, record.LinearDeflection, 1, false);
+		CADMesher::BuildEdgeData(*out.Topology, out.Lines, out.LineIndices, record.LinearDeflection);
+		out.BoundingBox = CADImporter::CalculateAABB(*out.Shape);
+		out.MeshMs = ElapsedMs(t1, LoadClock::now());
+	}
+
+	// 主线程：把准备好的网格装进组件并上传 GPU
+	static void ApplyPreparedMesh(Entity entity, PreparedGeometry& prepared, RestoreContext& context)
+	{
+		auto& mesh = entity.GetOrAddComponent<MeshComponent>();
+		if (prepared.FromCache)
+		{
+			// 三角网格直接引用映射文件 (零拷贝)，GPU 缓冲也从映射上传；边框线要打包进场景线缓冲，仍然复制
+			const MeshCacheView& view = prepared.Cached;
+			mesh.SetGeometry(MeshArray<CubeVertex>(view.Vertices, view.VertexCount, view.Source),
+				MeshArray<uint32_t>(view.Indices, view.IndexCount, view.Source));
+			mesh.SetEdges(std::vector<LineVertex>(view.Lines, view.Lines + view.LineCount),
+				std::vector<uint32_t>(view.LineIndices, view.LineIndices + view.LineIndexCount));
+			mesh.BoundingBox = view.BoundingBox;
+		}
+		else
+		{
+			mesh.SetGeometry(std::move(prepared.Vertices), std::move(prepared.Indices));
+			mesh.SetEdges(std::move(prepared.Lines), std::move(prepared.LineIndices));
+			mesh.BoundingBox = prepared.BoundingBox;
+		}
+		mesh.MeshPending = false;
+
+		if (context.CreateGPUResources)
+		{
+			auto u0 = LoadClock::now();
+			mesh.VA = CADMesher::UpdateMeshVertexArray(mesh, mesh.LocalVertices, mesh.LocalIndices);
+			context.UploadMs += ElapsedMs(u0, LoadClock::now());
+		}
+	}
+
+	static void RestoreEntity(Scene* scene, const EntityRecord& record, PreparedGeometry* prepared, RestoreContext& context)
+	{
+		// 1. 读取名字并创建实体
+		Entity deserializedEntity = scene->createEntity(record.HasTag ? record.Tag : std::string());
+		if (deserializedEntity.HasComponent<IDComponent>())
+			deserializedEntity.GetComponent<IDComponent>().ID = record.ID; // 恢复 UUID
+
+		// 2. 加载 Transform
+		if (record.HasTransform)
+		{
+			auto& tc = deserializedEntity.GetComponent<TransformComponent>();
+			tc.Translation = record.Translation;
+			tc.Rotation = record.Rotation;
+			tc.Scale = record.Scale;
+		}
+
+		// 3. 加载 CAD 组件，装上工作线程准备好的形状和网格
+		if (!record.HasCAD)
+			return;
+
+		auto& cadComp = deserializedEntity.AddComponent<CADGeometryComponent>();
+		cadComp.Type = (CADGeometryComponent::GeometryType)record.CADType;
+		cadComp.Params.Width = record.Width;
+		cadComp.Params.Height = record.Height;
+		cadComp.Params.Depth = record.Depth;
+		cadComp.Params.Radius = record.Radius;
+		cadComp.LinearDeflection = record.LinearDeflection;
+
+		if (!prepared || !prepared->Shape)
+			return;
+
+		cadComp.ShapeHandle = prepared->Shape;
+		cadComp.Topology = prepared->Topology;
+		prepared->Shape = nullptr; // 交给组件
+
+		if (prepared->FromCache) context.CacheHits++;
+		else context.CacheMisses++;
+		ApplyPreparedMesh(deserializedEntity, *prepared, context);
+	}
+
+	static void RestoreScene(Scene* scene, const SceneRecord& record, RestoreContext& context)
+	{
+		RONG_CORE_TRACE("Deserializing scene '{0}' ({1} Entities)", record.Name, record.Entities.size());
+
+		// 2. 工作线程准备形状和网格，结果按记录下标存放
+		std::vector<PreparedGeometry> prepared;
+		std::vector<size_t> jobs;
+		if (context.RebuildGeometry)
+		{
+			prepared.resize(record.Entities.size());
+			for (size_t i = 0; i < record.Entities.size(); i++)
+				if (record.Entities[i].HasCAD) jobs.push_back(i);
+		}
+
+		auto p0 = LoadClock::now();
+		auto prepare = [&](size_t i) { PrepareGeometry(record.Entities[i], context.MeshCache, prepared[i]); };
+		if (context.Parallel && jobs.size() > 1)
+			std::for_each(std::execution::par, jobs.begin(), jobs.end(), prepare);
+		else
+			std::for_each(jobs.begin(), jobs.end(), prepare);
+		auto p1 = LoadClock::now();
+		context.PrepareMs = ElapsedMs(p0, p1);
+
+		for (size_t i : jobs)
+		{
+			context.ReadMs += prepared[i].ReadMs;
+			context.MeshMs += prepared[i].MeshMs;
+			if (prepared[i].Shape) context.Shapes++;
+		}
+
+		// 3. 主线程按记录顺序创建实体 (实体句柄和 ID 与串行加载一致)
+		for (size_t i = 0; i < record.Entities.size(); i++)
+			RestoreEntity(scene, record.Entities[i], prepared.empty() ? nullptr : &prepared[i], context);
+		context.EntityMs = ElapsedMs(p1, LoadClock::now()) - context.UploadMs;
+
+		// 没有被组件接手的形状 (不应出现) 在这里释放
+		for (auto& item : prepared)
+			delete item.Shape;
+
+		if (context.RebuildGeometry)
+		{
+			RONG_CORE_INFO("Scene Load '{0}': {1} Entities, {2} Shapes ({3} from mesh cache, {4} meshed)",
+				record.Name, record.Entities.size(), context.Shapes, context.CacheHits, context.CacheMisses);
+			RONG_CORE_INFO("  Parse {0:.1f}ms | Mesh Cache {1:.1f}ms | Read + Mesh {2:.1f}ms{3} (Read {4:.1f}ms, Mesh {5:.1f}ms summed) | Entities {6:.1f}ms | GPU Upload {7:.1f}ms",
+				context.ParseMs, context.CacheMs, context.PrepareMs, context.Parallel ? " parallel" : "", context.ReadMs, context.MeshMs,
+				context.EntityMs, context.UploadMs);
+		}
+	}
+
+	static void LoadScene(Scene* scene, const std::string& filepath, const SceneRecord& record, RestoreContext& context)
+	{
+		// 场景旁的网格缓存 (没有或无效时全部重新离散)
+		auto c0 = LoadClock::now();
+		SceneMeshCache cache;
+		std::string cachePath = SceneMeshCache::GetPath(filepath);
+		if (context.RebuildGeometry && std::filesystem::exists(cachePath) && cache.Load(cachePath))
+			context.MeshCache = &cache;
+		context.CacheMs = ElapsedMs(c0, LoadClock::now());
+
+		RestoreScene(scene, record, context);
+		context.MeshCache = nullptr;
+	}
+
+	static void SaveMeshCache(Scene* scene, const std::string& filepath, const std::vector<MeshCacheEntry>& meshes)
+	{
+		std::string cachePath = SceneMeshCache::GetPath(filepath);
+
+		// 还引用着要被覆盖的缓存文件的网格先复制出来，释放旧映射
+		std::error_code error;
+		auto view = scene->getAllEntitiesWith<MeshComponent>();
+		for (auto entityID : view)
+		{
+			auto& mesh = view.get<MeshComponent>(entityID);
+			const Ref<MappedFile>& source = mesh.LocalVertices.getSource();
+			if (source && std::filesystem::equivalent(source->GetPath(), cachePath, error))
+			{
+				mesh.LocalVertices.detach();
+				mesh.LocalIndices.detach();
+			}
+		}
+
+		if (SceneMeshCache::Write(cachePath, meshes))
+			RONG_CORE_INFO("Mesh Cache: {0} Entities saved to {1}", meshes.size(), cachePath);
+	}
+
+	// 场景文件写完后更新 BRep 仓库的引用清单，这个场景不再引用的文件移进隔离区
+	static void CommitShapeStore(const std::string& filepath, const SceneRecord& record)
+	{
+		std::vector<std::string> blobs;
+		for (const auto& entity : record.Entities)
+			if (!entity.BRepPath.empty()) blobs.push_back(entity.BRepPath);
+		ShapeStore::CommitSave(filepath, blobs);
+
+		const ShapeStore::Stats& stats = ShapeStore::GetStats();
+		RONG_CORE_TRACE("BRep Store: {0} written ({1} Bytes), {2} unchanged, {3} shared, {4} unreferenced quarantined",
+			stats.Written, stats.BytesWritten, stats.Unchanged, stats.Shared, stats.Quarantined);
+	}
+
+	// =============================================================
+	// 保存/加载整个场景
+	// =============================================================
+	void SceneSerializer::Serialize(const std::string& filepath)
+	{
+		if (IsBinaryPath(filepath))
+			SerializeBinary(filepath);
+		else
+			SerializeYAML(filepath);
+	}
+
+	bool SceneSerializer::Deserialize(const std::string& filepath)
+	{
+		if (SceneBinary::IsBinaryFile(filepath))
+			return DeserializeBinary(filepath);
+		return DeserializeYAML(filepath);
+	}
+
+	void SceneSerializer::SerializeYAML(const std::string& filepath)
+	{
+		ShapeStore::ResetStats();
+		std::vector<MeshCacheEntry> meshes;
+		SceneRecord record = MakeSceneRecord(m_Context.get(), m_WriteMeshCache ? &meshes : nullptr);
+		if (!WriteYAML(filepath, record))
+			return;
+		CommitShapeStore(filepath, record);
+		if (m_WriteMeshCache)
+			SaveMeshCache(m_Context.get(), filepath, meshes);
+	}
+
+	bool SceneSerializer::DeserializeYAML(const std::string& filepath)
+	{
+		auto t0 = LoadClock::now();
+		SceneRecord record;
+		if (!ReadYAML(filepath, record))
+			return false;
+
+		RestoreContext context;
+		context.RebuildGeometry = m_RebuildGeometry;
+		context.CreateGPUResources = m_CreateGPUResources;
+		context.Parallel = m_ParallelLoad;
+		context.ParseMs = ElapsedMs(t0, LoadClock::now());
+		LoadScene(m_Context.get(), filepath, record, context);
+		return true;
+	}
+
+	void SceneSerializer::SerializeBinary(const std::string& filepath)
+	{
+		ShapeStore::ResetStats();
+		std::vector<MeshCacheEntry> meshes;
+		SceneRecord record = MakeSceneRecord(m_Context.get(), m_WriteMeshCache ? &meshes : nullptr);
+		if (!SceneBinary::Write(filepath, record))
+			return;
+		CommitShapeStore(filepath, record);
+		if (m_WriteMeshCache)
+			SaveMeshCache(m_Context.get(), filepath, meshes);
+	}
+
+	bool SceneSerializer::DeserializeBinary(const std::string& filepath)
+	{
+		auto t0 = LoadClock::now();
+		SceneRecord record;
+		if (!SceneBinary::Read(filepath, record))
+			return false;
+
+		RestoreContext context;
+		context.RebuildGeometry = m_RebuildGeometry;
+		context.CreateGPUResources = m_CreateGPUResources;
+		context.Parallel = m_ParallelLoad;
+		context.ParseMs = ElapsedMs(t0, LoadClock::now());
+		LoadScene(m_Context.get(), filepath, record, context);
+		return true;
+	}
+
+	bool SceneSerializer::Convert(const std::string& srcPath, const std::string& dstPath)
+	{
+		SceneRecord record;
+		bool loaded = SceneBinary::IsBinaryFile(srcPath) ? SceneBinary::Read(srcPath, record) : ReadYAML(srcPath, record);
+		if (!loaded)
+		{
+			RONG_CORE_ERROR("Scene Convert: failed to read {0}", srcPath);
+			return false;
+		}
+
+		bool written = IsBinaryPath(dstPath) ? SceneBinary::Write(dstPath, record) : WriteYAML(dstPath, record);
+		if (!written)
+		{
+			RONG_CORE_ERROR("Scene Convert: failed to write {0}", dstPath);
+			return false;
+		}
+
+		// 目标场景引用的仓库文件登记到它自己的清单里，之后保存其它场景时不会被移进隔离区
+		std::vector<std::string> blobs;
+		for (const auto& entity : record.Entities)
+			if (!entity.BRepPath.empty()) blobs.push_back(entity.BRepPath);
+		ShapeStore::UpdateReferences(dstPath, blobs);
+
+		RONG_CORE_INFO("Scene Convert: {0} -> {1}, {2} Entities", srcPath, dstPath, record.Entities.size());
+		return true;
+	}
+
+	void SceneSerializer::BenchmarkFormats(uint32_t entityCount)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto elapsedMs = [](Clock::time_point a, Clock::time_point b) { return std::chrono::duration<float, std::milli>(b - a).count(); };
+		auto toMB = [](uint64_t bytes) { return (double)bytes / (1024.0 * 1024.0); };
+
+		// 1. 合成场景：参数化立方体/球/圆柱排成网格 (不读写 BRep，只测格式本身)
+		SceneRecord scene;
+		scene.Name = "FormatBenchmark";
+		scene.Entities.resize(entityCount);
+		uint32_t side = (uint32_t)std::ceil(std::sqrt((double)std::max(entityCount, 1u)));
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			EntityRecord& e = scene.Entities[i];
+			e.ID = i + 1;
+			e.HasTag = true;
+			e.Tag = "Part_" + std::to_string(i);
+			e.HasTransform = true;
+			e.Translation = { (float)(i % side) * 2.0f, 0.0f, (float)(i / side) * 2.0f };
+			e.Rotation = { 0.0f, (float)(i % 360) * 0.0174533f, 0.0f };
+			e.Scale = { 1.0f, 1.0f + (float)(i % 7) * 0.25f, 1.0f };
+			e.HasCAD = true;
+			e.CADType = 1 + (int)(i % 3);
+			e.Width = 1.0f + (float)(i % 5) * 0.1f;
+			e.Height = 1.0f + (float)(i % 11) * 0.1f;
+			e.Radius = 0.5f + (float)(i % 3) * 0.1f;
+		}
+
+		std::filesystem::create_directories("assets/cache");
+		const std::string yamlPath = "assets/cache/format_benchmark.rong";
+		const std::string binaryPath = "assets/cache/format_benchmark.rongb";
+		const std::string roundTripPath = "assets/cache/format_benchmark_roundtrip.rongb";
+
+		// 2. 保存
+		auto s0 = Clock::now();
+		WriteYAML(yamlPath, scene);
+		auto s1 = Clock::now();
+		SceneBinary::Write(binaryPath, scene);
+		auto s2 = Clock::now();
+		scene.Entities.clear();
+		scene.Entities.shrink_to_fit();
+
+		// 3. 加载到空场景 (不重建形状)，记录耗时、加载后常驻内存的增量和进程峰值的增量
+		//    峰值只增不减：先测二进制 (预期更小)，YAML 的峰值增量才不会被它掩盖
+		struct LoadResult { float ParseMs = 0.0f, TotalMs = 0.0f; uint64_t Resident = 0, Peak = 0; size_t Entities = 0; bool Ok = false; };
+		auto measureLoad = [&](const std::string& path, bool binary) {
+			LoadResult result;
+			uint64_t residentBefore = ProcessMemory::GetResidentBytes();
+			uint64_t peakBefore = ProcessMemory::GetPeakResidentBytes();
+			{
+				Ref<Scene> target = CreateRef<Scene>();
+				auto t0 = Clock::now();
+				SceneRecord record;
+				result.Ok = binary ? SceneBinary::Read(path, record) : ReadYAML(path, record);
+				auto t1 = Clock::now();
+				RestoreContext context;
+				context.RebuildGeometry = false;
+				RestoreScene(target.get(), record, context);
+				auto t2 = Clock::now();
+
+				result.ParseMs = elapsedMs(t0, t1);
+				result.TotalMs = elapsedMs(t0, t2);
+				result.Entities = target->getRegistry().alive();
+				uint64_t resident = ProcessMemory::GetResidentBytes();
+				result.Resident = resident > residentBefore ? resident - residentBefore : 0;
+			}
+			uint64_t peak = ProcessMemory::GetPeakResidentBytes();
+			result.Peak = peak > peakBefore ? peak - peakBefore : 0;
+			return result;
+		};
+
+		LoadResult binaryLoad = measureLoad(binaryPath, true);
+		LoadResult yamlLoad = measureLoad(yamlPath, false);
+
+		// 4. 互转校验：YAML -> 二进制应与直接写出的二进制逐字节相同
+		Convert(yamlPath, roundTripPath);
+		auto readFile = [](const std::string& path) {
+			std::ifstream in(path, std::ios::binary);
+			return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		};
+		bool identical = readFile(binaryPath) == readFile(roundTripPath);
+
+		uint64_t yamlSize = std::filesystem::file_size(yamlPath);
+		uint64_t binarySize = std::filesystem::file_size(binaryPath);
+
+		RONG_CORE_INFO("Scene Format Benchmark: {0} Entities, File YAML {1:.2f}MB / Binary {2:.2f}MB, Save YAML {3}ms / Binary {4}ms",
+			entityCount, toMB(yamlSize), toMB(binarySize), elapsedMs(s0, s1), elapsedMs(s1, s2));
+		RONG_CORE_INFO("Scene Format Benchmark [YAML]: Parse {0}ms, Load {1}ms, Resident +{2:.1f}MB, Peak +{3:.1f}MB, {4} Entities",
+			yamlLoad.ParseMs, yamlLoad.TotalMs, toMB(yamlLoad.Resident), toMB(yamlLoad.Peak), yamlLoad.Entities);
+		RONG_CORE_INFO("Scene Format Benchmark [Binary]: Parse {0}ms, Load {1}ms, Resident +{2:.1f}MB, Peak +{3:.1f}MB, {4} Entities",
+			binaryLoad.ParseMs, binaryLoad.TotalMs, toMB(binaryLoad.Resident), toMB(binaryLoad.Peak), binaryLoad.Entities);
+		RONG_CORE_INFO("Scene Format Benchmark: Load x{0:.2f} Faster, Round Trip Identical: {1}",
+			yamlLoad.TotalMs / std::max(binaryLoad.TotalMs, 1e-3f), identical);
+		if (!binaryLoad.Ok || !yamlLoad.Ok || !identical)
+			RONG_CORE_ERROR("Scene Format Benchmark: round trip failed!");
+
+		std::filesystem::remove(yamlPath);
+		std::filesystem::remove(binaryPath);
+		std::filesystem::remove(roundTripPath);
+	}
+
+	bool SceneSerializer::TestHeadlessLoad(uint32_t partCount)
+	{
+		// 1. 合成场景：立方体/球/圆柱交替，参数各不相同 (纯参数化，不写 BRep)
+		SceneRecord scene;
+		scene.Name = "Headless Load Test";
+		scene.Entities.reserve(partCount);
+		for (uint32_t i = 0; i < partCount; i++)
+		{
+			EntityRecord record;
+			record.ID = 1000 + i;
+			record.HasTag = true;
+			record.Tag = "Part " + std::to_string(i);
+			record.HasTransform = true;
+			record.Translation = { (float)(i % 25) * 3.0f, (float)(i / 25) * 3.0f, 0.0f };
+			record.HasCAD = true;
+			record.CADType = (int)CADGeometryComponent::GeometryType::Cube + (int)(i % 3);
+			record.Width = 1.0f + (float)(i % 7) * 0.1f;
+			record.Height = 1.0f + (float)(i % 5) * 0.2f;
+			record.Depth = 1.0f + (float)(i % 3) * 0.3f;
+			record.Radius = 0.5f + (float)(i % 11) * 0.05f;
+			record.LinearDeflection = 0.01f;
+			scene.Entities.push_back(record);
+		}
+
+		std::filesystem::create_directories("assets/cache");
+		const std::string path = "assets/cache/headless_load_test.rongb";
+		std::filesystem::remove(SceneMeshCache::GetPath(path)); // 不走网格缓存，测的是完整的读取 + 离散化
+		if (!SceneBinary::Write(path, scene))
+			return false;
+
+		// 2. 串行/并行各加载一次 (不创建 VertexArray)，按 registry 顺序记下实体 ID 和网格内容的哈希
+		struct LoadSnapshot
+		{
+			bool Ok = false;
+			double Milliseconds = 0.0;
+			uint32_t Meshed = 0;
+			bool HasGPUResources = false;
+			std::vector<uint64_t> IDs;
+			std::vector<uint64_t> MeshHashes;
+		};
+
+		auto load = [&](bool parallel) {
+			LoadSnapshot snapshot;
+			Ref<Scene> target = CreateRef<Scene>();
+			SceneSerializer serializer(target);
+			serializer.SetCreateGPUResources(false);
+			serializer.SetParallelLoad(parallel);
+
+			auto t0 = LoadClock::now();
+			snapshot.Ok = serializer.Deserialize(path);
+			snapshot.Milliseconds = ElapsedMs(t0, LoadClock::now());
+
+			target->getRegistry().each([&](auto entityID) {
+				Entity entity = { entityID, target.get() };
+				snapshot.IDs.push_back(entity.GetComponent<IDComponent>().ID);
+
+				uint64_t hash = SceneMeshCache::HashBytes(nullptr, 0);
+				if (entity.HasComponent<MeshComponent>())
 				{
-					auto& cadComp = deserializedEntity.AddComponent<CADGeometryComponent>();
-
-					// A. 读取参数
-					cadComp.Type = (CADGeometryComponent::GeometryType)cadComponent["Type"].as<int>();
-					auto params = cadComponent["Params"];
-					cadComp.Params.Width = params["Width"].as<float>();
-					cadComp.Params.Height = params["Height"].as<float>();
-					cadComp.Params.Depth = params["Depth"].as<float>();
-					cadComp.Params.Radius = params["Radius"].as<float>();
-
-					if (params["LinearDeflection"])
-						cadComp.LinearDeflection = params["LinearDeflection"].as<float>();
-					else
-						cadComp.LinearDeflection = 0.1f;
-
-					// 加载 BRep 文件
-					void* shapeHandle = nullptr;
-					std::string brepPath = "";
-					if (cadComponent["BRepPath"])
-						brepPath = cadComponent["BRepPath"].as<std::string>();
-
-					// 优先尝试从文件加载 (针对拉伸、布尔运算后的物体)
-					bool loadedFromDisk = false;
-					if (!brepPath.empty() && std::filesystem::exists(brepPath))
-					{
-						BRep_Builder builder;
-						TopoDS_Shape shape;
-						if (BRepTools::Read(shape, brepPath.c_str(), builder))
-						{
-							shapeHandle = new TopoDS_Shape(shape);
-							loadedFromDisk = true;
-						}
-						else
-						{
-							RONG_CORE_ERROR("Failed to load BRep file: {0}", brepPath);
-						}
-					}
-
-					// 如果没从磁盘加载 (说明是纯参数化物体，或者文件丢失)，则尝试参数化重建
-					if (!shapeHandle)
-					{
-						switch (cadComp.Type)
-						{
-						case CADGeometryComponent::GeometryType::Cube:
-							shapeHandle = CADModeler::MakeCube(cadComp.Params.Width, cadComp.Params.Height, cadComp.Params.Depth);
-							break;
-						case CADGeometryComponent::GeometryType::Sphere:
-							shapeHandle = CADModeler::MakeSphere(cadComp.Params.Radius);
-							break;
-						case CADGeometryComponent::GeometryType::Cylinder:
-							shapeHandle = CADModeler::MakeCylinder(cadComp.Params.Radius, cadComp.Params.Height);
-							break;
-						}
-					}
-
-					cadComp.ShapeHandle = shapeHandle;
-					// ========================================================================
-
-					// C. 重新生成网格 (Mesh + Edge)
-					if (shapeHandle)
-					{
-						TopoDS_Shape* occShape = (TopoDS_Shape*)shapeHandle;
-						std::vector<CubeVertex> verticesData;
-						std::vector<uint32_t> newIndices;
-
-
-						// 1. 生成面网格
-						auto va = CADMesher::CreateMeshFromShape(*occShape, verticesData, newIndices, cadComp.LinearDeflection);
-
-						if (va)
-						{
-							auto& meshComp = deserializedEntity.AddComponent<MeshComponent>(va, verticesData);
-
-							// 2. 更新包围盒
-							meshComp.BoundingBox = CADImporter::CalculateAABB(*occShape);
-							meshComp.LocalVertices = verticesData;
-							meshComp.LocalIndices = newIndices;
-
-							std::vector<LineVertex> lineVerts;
-							auto edgeVA = CADMesher::CreateEdgeMeshFromShape(
-								*occShape,
-								lineVerts,
-								meshComp.m_IDToEdgeMap, // 恢复 ID 映射表，确保能被选中
-								cadComp.LinearDeflection
-							);
-							meshComp.EdgeVA = edgeVA;
-							meshComp.LocalLines = lineVerts;
-							// =================================================================
-						}
-					}
+					const auto& mesh = entity.GetComponent<MeshComponent>();
+					hash = SceneMeshCache::HashBytes(mesh.LocalVertices.data(), mesh.LocalVertices.size() * sizeof(CubeVertex), hash);
+					hash = SceneMeshCache::HashBytes(mesh.LocalIndices.data(), mesh.LocalIndices.size() * sizeof(uint32_t), hash);
+					hash = SceneMeshCache::HashBytes(mesh.LocalLines.data(), mesh.LocalLines.size() * sizeof(LineVertex), hash);
+					if (!mesh.LocalIndices.empty() && mesh.HasEdges()) snapshot.Meshed++;
+					snapshot.HasGPUResources |= mesh.VA != nullptr;
 				}
+				snapshot.MeshHashes.push_back(hash);
+			});
+
+			// CAD 组件只持有形状指针，测试场景释放前自己回收
+			for (auto entityID : target->getAllEntitiesWith<CADGeometryComponent>())
+			{
+				auto& cad = target->getRegistry().get<CADGeometryComponent>(entityID);
+				delete static_cast<TopoDS_Shape*>(cad.ShapeHandle);
+				cad.ShapeHandle = nullptr;
 			}
+			return snapshot;
+		};
+
+		LoadSnapshot serial = load(false);
+		LoadSnapshot parallel = load(true);
+		std::filesystem::remove(path);
+
+		bool deterministic = serial.IDs == parallel.IDs && serial.MeshHashes == parallel.MeshHashes;
+		bool complete = serial.Ok && parallel.Ok && parallel.IDs.size() == partCount && parallel.Meshed == partCount;
+		bool headless = !serial.HasGPUResources && !parallel.HasGPUResources;
+
+		RONG_CORE_INFO("Headless Load Test: {0} Parts, Serial {1:.1f}ms, Parallel {2:.1f}ms (x{3:.2f}), Meshed {4}/{0}, Deterministic: {5}, No GPU Resources: {6}",
+			partCount, serial.Milliseconds, parallel.Milliseconds, serial.Milliseconds / std::max(parallel.Milliseconds, 1e-3),
+			parallel.Meshed, deterministic, headless);
+
+		bool passed = deterministic && complete && headless;
+		if (!passed)
+			RONG_CORE_ERROR("Headless Load Test: failed!");
+		return passed;
+	}
+
+	void SceneSerializer::BenchmarkShapeStore(uint32_t partCount)
+	{
+		// 1. 合成装配：partCount 个导入零件，每 5 个零件形状相同 (各自独立的 TShape，内容一样)
+		Ref<Scene> scene = CreateRef<Scene>();
+		std::vector<Entity> parts;
+		parts.reserve(partCount);
+		for (uint32_t i = 0; i < partCount; i++)
+		{
+			uint32_t variant = i / 5;
+			Entity entity = scene->createEntity("Part " + std::to_string(i));
+			auto& cad = entity.AddComponent<CADGeometryComponent>();
+			cad.Type = CADGeometryComponent::GeometryType::Imported;
+			float size = 1.0f + (float)variant * 0.01f;
+			cad.ShapeHandle = (variant % 2 == 0)
+				? CADModeler::MakeCylinder(size * 0.5f, size * 2.0f)
+				: CADModeler::MakeCube(size, size * 1.5f, size * 0.5f);
+			parts.push_back(entity);
 		}
 
-		return true;
+		std::filesystem::create_directories("assets/cache");
+		const std::string scenePath = "assets/cache/shape_store_benchmark.rongb";
+		const std::string legacyDirectory = "assets/cache/shape_store_benchmark_legacy";
+		std::filesystem::create_directories(legacyDirectory);
+
+		// 2. 原来的方式：每次保存都把每个零件写成 ASCII BRep (一个零件改动和全部改动一样)
+		auto l0 = LoadClock::now();
+		uint64_t legacyBytes = 0;
+		for (uint32_t i = 0; i < partCount; i++)
+		{
+			auto& cad = parts[i].GetComponent<CADGeometryComponent>();
+			std::string path = legacyDirectory + "/" + std::to_string(i) + ".brep";
+			BRepTools::Write(*static_cast<TopoDS_Shape*>(cad.ShapeHandle), path.c_str());
+			legacyBytes += std::filesystem::file_size(path);
+		}
+		double legacyMs = ElapsedMs(l0, LoadClock::now());
+
+		// 3. BRep 仓库：首次保存 / 没有改动 / 改动一个零件
+		SceneSerializer serializer(scene);
+		auto save = [&](ShapeStore::Stats& outStats) {
+			auto t0 = LoadClock::now();
+			serializer.SerializeBinary(scenePath);
+			outStats = ShapeStore::GetStats();
+			return ElapsedMs(t0, LoadClock::now());
+		};
+
+		ShapeStore::Stats first, unchanged, modified;
+		double firstMs = save(first);
+		double unchangedMs = save(unchanged);
+
+		auto& edited = parts[partCount / 2].GetComponent<CADGeometryComponent>();
+		delete static_cast<TopoDS_Shape*>(edited.ShapeHandle);
+		edited.ShapeHandle = CADModeler::MakeCube(3.0f, 2.0f, 1.0f);
+		double modifiedMs = save(modified);
+
+		RONG_CORE_INFO("BRep Store Benchmark: {0} Parts ({1} distinct shapes), Legacy ASCII per save {2:.1f}ms ({3:.2f}MB)",
+			partCount, (partCount + 4) / 5, legacyMs, legacyBytes / (1024.0 * 1024.0));
+		RONG_CORE_INFO("  First Save {0:.1f}ms: {1} written ({2:.2f}MB), {3} shared",
+			firstMs, first.Written, first.BytesWritten / (1024.0 * 1024.0), first.Shared);
+		RONG_CORE_INFO("  Unchanged Save {0:.1f}ms: {1} written, {2} unchanged",
+			unchangedMs, unchanged.Written, unchanged.Unchanged);
+		RONG_CORE_INFO("  One Part Modified {0:.1f}ms: {1} written, {2} unchanged, {3} unreferenced quarantined (x{4:.1f} faster than legacy)",
+			modifiedMs, modified.Written, modified.Unchanged, modified.Quarantined, legacyMs / std::max(modifiedMs, 1e-3));
+
+		// 4. 清理：删掉场景和旧方式写的文件，仓库文件随清单释放移进隔离区 (下次运行按内容移回)
+		for (auto& entity : parts)
+			delete static_cast<TopoDS_Shape*>(entity.GetComponent<CADGeometryComponent>().ShapeHandle);
+		std::filesystem::remove(scenePath);
+		std::filesystem::remove_all(legacyDirectory);
+		ShapeStore::ReleaseScene(scenePath);
 	}
 
-}
\ No newline at end of file
+}
@@ -10,18 +10,51 @@ namespace Rongine {
 	public:
 		SceneSerializer(const Ref<Scene>& scene);
 
-		// 泡ļ
+		// 泡ļ (չΪ .rongb ʱдƸʽд YAML)
 		void Serialize(const std::string& filepath);
 
-		// ļس
+		// ļس (ļͷԶʶ/YAML)
 		bool Deserialize(const std::string& filepath);
 
-		// (ѡ) лʱı YAML
-		// void SerializeRuntime(const std::string& filepath);
-		// bool DeserializeRuntime(const std::string& filepath);
+		// YAML ΪɶĽ/ʽƸʽ (SceneBinary) ظ졢ڴʡ
+		void SerializeYAML(const std::string& filepath);
+		bool DeserializeYAML(const std::string& filepath);
+		void SerializeBinary(const std::string& filepath);
+		bool DeserializeBinary(const std::string& filepath);
+
+		// رպʱָֻݣ BRepؽ״ɢ (ʽ)
+		void SetRebuildGeometry(bool rebuild) { m_RebuildGeometry = rebuild; }
+
+		// ˮߣʵ -> ̶߳ BRep/ɢ -> ̰߳˳򴴽ʵ GPU 
+		// ر GPU Դֻ CPU  (VA Ϊ)ûд/GL ʱ
+		void SetCreateGPUResources(bool create) { m_CreateGPUResources = create; }
+		void SetParallelLoad(bool parallel) { m_ParallelLoad = parallel; }
+
+		// ʱѾɵ CAD дԵ .rongmesh (SceneMeshCache)
+		// ʱ᳢ܻʹã״ݹϣ;һµʵɢ
+		void SetWriteMeshCache(bool write) { m_WriteMeshCache = write; }
+
+		// ʽת (Ҳд BRep)Ŀʽչ
+		static bool Convert(const std::string& srcPath, const std::string& dstPath);
+
+		// ܲԣϳ entityCount ʵĳԱ YAML/Ƶı桢غʱڴֵ (־)
+		static void BenchmarkFormats(uint32_t entityCount = 50000);
+
+		// ޽زԣϳ partCount  CAD ĳ GL Դֱ/м
+		// ʵ˳ID ֽһ£׶κʱҪڣʧʱ false
+		//  --headless-test ʱڴ Application ֮ǰ ( EntryPoint.h)
+		static bool TestHeadlessLoad(uint32_t partCount = 500);
+
+		// BRep ֿ (ShapeStore) ܲԣpartCount Աԭÿα涼д ASCII BRep
+		// Ͳֿ״α桢޸Ķ桢Ķһ󱣴ĺʱд
+		static void BenchmarkShapeStore(uint32_t partCount = 500);
 
 	private:
 		Ref<Scene> m_Context;
+		bool m_RebuildGeometry = true;
+		bool m_WriteMeshCache = false;
+		bool m_CreateGPUResources = true;
+		bool m_ParallelLoad = true;
 	};
 
 }
\ No newline at end of file
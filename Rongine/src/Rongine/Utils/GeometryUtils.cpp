@@ -86,7 +86,7 @@ namespace Rongine {
         return va;
     }
 
-    FaceInfo GeometryUtils::CalculateFaceCenter(const std::vector<CubeVertex>& vertices, int targetFaceID)
+    FaceInfo GeometryUtils::CalculateFaceCenter(ArrayView<CubeVertex> vertices, int targetFaceID)
     {
         glm::vec3 sumPos(0.0f);
         glm::vec3 sumNormal(0.0f);
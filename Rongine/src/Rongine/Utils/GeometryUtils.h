@@ -1,6 +1,7 @@
 #pragma once
 #include "Rongine/Renderer/VertexArray.h"
 #include "Rongine/Renderer/Renderer3D.h" // 获取 CubeVertex 定义
+#include "Rongine/Renderer/MeshArray.h"
 #include <vector>
 #include <cmath>
 
@@ -16,6 +17,6 @@ namespace Rongine {
         // majorRadius: 大环半径, minorRadius: 管子半径
         static Ref<VertexArray> CreateTorus(float majorRadius, float minorRadius, int majorSegments, int minorSegments);
 
-        static FaceInfo CalculateFaceCenter(const std::vector<CubeVertex>& vertices, int targetFaceID);
+        static FaceInfo CalculateFaceCenter(ArrayView<CubeVertex> vertices, int targetFaceID);
     };
 }
\ No newline at end of file
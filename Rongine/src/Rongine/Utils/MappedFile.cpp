@@ -0,0 +1,97 @@
+#include "Rongpch.h"
+#include "MappedFile.h"
+#include "Rongine/Core/Log.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Rongine {
+
+	Ref<MappedFile> MappedFile::Open(const std::string& filepath)
+	{
+		Ref<MappedFile> file(new MappedFile());
+		file->m_Path = filepath;
+
+#ifdef _WIN32
+		HANDLE handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) return nullptr;
+		file->m_FileHandle = handle;
+
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) return nullptr;
+		file->m_Size = (uint64_t)size.QuadPart;
+
+		HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			RONG_CORE_ERROR("Failed to map file: {0}", filepath);
+			return nullptr;
+		}
+		file->m_MappingHandle = mapping;
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			RONG_CORE_ERROR("Failed to map file: {0}", filepath);
+			return nullptr;
+		}
+		file->m_Data = static_cast<const uint8_t*>(view);
+#else
+		int fd = open(filepath.c_str(), O_RDONLY);
+		if (fd < 0) return nullptr;
+
+		struct stat info = {};
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+		file->m_Size = (uint64_t)info.st_size;
+
+		// 映射建立后描述符可以关掉
+		void* view = mmap(nullptr, (size_t)file->m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (view == MAP_FAILED)
+		{
+			RONG_CORE_ERROR("Failed to map file: {0}", filepath);
+			return nullptr;
+		}
+		file->m_Data = static_cast<const uint8_t*>(view);
+#endif
+		return file;
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef _WIN32
+		if (m_Data) UnmapViewOfFile(m_Data);
+		if (m_MappingHandle) CloseHandle(m_MappingHandle);
+		if (m_FileHandle) CloseHandle(m_FileHandle);
+#else
+		if (m_Data) munmap(const_cast<uint8_t*>(m_Data), (size_t)m_Size);
+#endif
+	}
+
+	bool MappedFile::DropPageCache(const std::string& filepath)
+	{
+#if defined(_WIN32) || !defined(POSIX_FADV_DONTNEED)
+		(void)filepath;
+		return false;
+#else
+		int fd = open(filepath.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		// 只丢掉干净页，脏页先落盘
+		fdatasync(fd);
+		bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(fd);
+		return ok;
+#endif
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Rongine/Core/Core.h"
+
+#include <string>
+#include <cstdint>
+
+namespace Rongine {
+
+	// 只读内存映射文件：打开时只建立映射，页面在第一次访问时才由系统读入 (缺页)
+	// 通过 Ref 共享，最后一个引用释放时解除映射；映射期间不要覆盖同一个文件 (Windows 上会失败，Linux 上截断会导致 SIGBUS)
+	class MappedFile
+	{
+	public:
+		// 文件不存在、为空或映射失败时返回 nullptr
+		static Ref<MappedFile> Open(const std::string& filepath);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const uint8_t* GetData() const { return m_Data; }
+		uint64_t GetSize() const { return m_Size; }
+		const std::string& GetPath() const { return m_Path; }
+
+		// 把文件的页从系统页缓存中丢掉，下次访问重新从磁盘读 (冷启动测试用，只有 Linux 支持)
+		static bool DropPageCache(const std::string& filepath);
+
+	private:
+		MappedFile() = default;
+
+	private:
+		std::string m_Path;
+		const uint8_t* m_Data = nullptr;
+		uint64_t m_Size = 0;
+#ifdef _WIN32
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,64 @@
+#include "Rongpch.h"
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace Rongine {
+
+	uint64_t ProcessMemory::GetResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters = {};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return counters.WorkingSetSize;
+		return 0;
+#else
+		// /proc/self/statm 的第二项是常驻页数
+		long pages = 0;
+		FILE* file = std::fopen("/proc/self/statm", "r");
+		if (!file) return 0;
+		if (std::fscanf(file, "%*ld %ld", &pages) != 1) pages = 0;
+		std::fclose(file);
+		return (uint64_t)pages * (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+	}
+
+	uint64_t ProcessMemory::GetPeakResidentBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters = {};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return counters.PeakWorkingSetSize;
+		return 0;
+#else
+		struct rusage usage = {};
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+		return (uint64_t)usage.ru_maxrss * 1024; // Linux 上单位是 KB
+#endif
+	}
+
+	ProcessMemory::PageFaults ProcessMemory::GetPageFaults()
+	{
+		PageFaults faults;
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters = {};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			faults.Minor = counters.PageFaultCount;
+#else
+		struct rusage usage = {};
+		if (getrusage(RUSAGE_SELF, &usage) == 0)
+		{
+			faults.Minor = (uint64_t)usage.ru_minflt;
+			faults.Major = (uint64_t)usage.ru_majflt;
+		}
+#endif
+		return faults;
+	}
+}
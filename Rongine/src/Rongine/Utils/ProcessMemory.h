@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+
+namespace Rongine {
+
+	// 进程内存统计 (性能测试用)，取不到时返回 0
+	class ProcessMemory
+	{
+	public:
+		static uint64_t GetResidentBytes();     // 当前常驻内存 (Windows: Working Set, Linux: RSS)
+		static uint64_t GetPeakResidentBytes(); // 进程启动以来的峰值，只增不减
+
+		// 进程启动以来的缺页次数，Minor 不需要读盘 (页已在页缓存中)，Major 需要读盘
+		// Windows 不区分两者，全部计入 Minor
+		struct PageFaults
+		{
+			uint64_t Minor = 0;
+			uint64_t Major = 0;
+		};
+		static PageFaults GetPageFaults();
+	};
+}